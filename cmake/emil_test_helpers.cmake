@@ -34,6 +34,28 @@ function(emil_enable_fuzzing)
     endif()
 endfunction()
 
+function(emil_fetch_benchmark)
+    FetchContent_Declare(
+        benchmark
+        GIT_REPOSITORY https://github.com/google/benchmark
+        GIT_TAG        v1.8.3
+    )
+
+    set(BENCHMARK_ENABLE_TESTING Off CACHE BOOL "" FORCE)
+    set(BENCHMARK_ENABLE_INSTALL Off CACHE BOOL "" FORCE)
+    set(BENCHMARK_ENABLE_GTEST_TESTS Off CACHE BOOL "" FORCE)
+
+    FetchContent_MakeAvailable(benchmark)
+
+    set_target_properties(benchmark benchmark_main PROPERTIES FOLDER External/GoogleBenchmark)
+    set_target_properties(benchmark benchmark_main PROPERTIES EXCLUDE_FROM_COVERAGE TRUE)
+    mark_as_advanced(BENCHMARK_ENABLE_TESTING BENCHMARK_ENABLE_INSTALL BENCHMARK_ENABLE_GTEST_TESTS)
+endfunction()
+
+function(emil_enable_benchmarking)
+    emil_fetch_benchmark()
+endfunction()
+
 function(emil_add_test target)
     get_target_property(exclude ${target} EXCLUDE_FROM_ALL)
     if (NOT ${exclude})
@@ -51,3 +73,9 @@ function(emil_add_fuzzing_executable target)
     add_executable(${target})
     target_link_options(${target} PRIVATE -fsanitize=fuzzer)
 endfunction()
+
+function(emil_add_benchmark_executable target)
+    add_executable(${target})
+    target_link_libraries(${target} PRIVATE benchmark::benchmark_main)
+    emil_exclude_from_coverage(${target})
+endfunction()
@@ -4,32 +4,28 @@
 
 namespace infra
 {
-    EventDispatcherWorkerImpl::EventDispatcherWorkerImpl(MemoryRange<std::pair<infra::Function<void()>, std::atomic<bool>>> scheduledActionsStorage)
-        : scheduledActions(scheduledActionsStorage)
-        , minCapacity(scheduledActions.size())
+    EventDispatcherWorkerImpl::EventDispatcherWorkerImpl(MemoryRange<ScheduledAction> scheduledActionsStorage)
+        : EventDispatcherWorkerImpl(scheduledActionsStorage, 0)
+    {}
+
+    EventDispatcherWorkerImpl::EventDispatcherWorkerImpl(MemoryRange<ScheduledAction> scheduledActionsStorage, std::size_t firstSlot)
+        : scheduledActions(scheduledActionsStorage, firstSlot)
+    {}
+
+    void EventDispatcherWorker::ScheduleBatch(infra::MemoryRange<const infra::Function<void()>> actions)
     {
-        for (auto& action : scheduledActions)
-            action.second = false;
+        for (auto& action : actions)
+            Schedule(action);
     }
 
     void EventDispatcherWorkerImpl::Schedule(const infra::Function<void()>& action)
     {
-        uint32_t pushIndex = scheduledActionsPushIndex;
-        uint32_t newPushIndex;
-
-        do
-        {
-            newPushIndex = (pushIndex + 1) % scheduledActions.size();
-        } while (!scheduledActionsPushIndex.compare_exchange_weak(pushIndex, newPushIndex));
-
-        scheduledActions[pushIndex].first = action;
-        really_assert(!scheduledActions[pushIndex].second);
-        scheduledActions[pushIndex].second = true;
-
-        minCapacity = std::min<std::size_t>(minCapacity, (scheduledActions.size() + scheduledActionsPopIndex - pushIndex - 1) % scheduledActions.size() + 1);
-        really_assert(minCapacity >= 1);
+        PushActions(scheduledActions, infra::MakeRange(&action, &action + 1));
+    }
 
-        RequestExecution();
+    void EventDispatcherWorkerImpl::ScheduleBatch(infra::MemoryRange<const infra::Function<void()>> actions)
+    {
+        PushActions(scheduledActions, actions);
     }
 
     void EventDispatcherWorkerImpl::Run()
@@ -62,43 +58,26 @@ namespace infra
 
     void EventDispatcherWorkerImpl::ExecuteFirstAction()
     {
-        if (scheduledActions[scheduledActionsPopIndex].second)
-        {
-            struct ExceptionSafePop
-            {
-                ExceptionSafePop(EventDispatcherWorkerImpl& worker)
-                    : worker(worker)
-                {}
-
-                ExceptionSafePop(const ExceptionSafePop&) = delete;
-                ExceptionSafePop& operator=(const ExceptionSafePop&) = delete;
-
-                ~ExceptionSafePop()
-                {
-                    worker.scheduledActions[worker.scheduledActionsPopIndex].first = nullptr;
-                    worker.scheduledActions[worker.scheduledActionsPopIndex].second = false;
-                    worker.scheduledActionsPopIndex = (worker.scheduledActionsPopIndex + 1) % worker.scheduledActions.size();
-                }
-
-                EventDispatcherWorkerImpl& worker;
-            };
-
-            ExceptionSafePop popAction{ *this };
-
-            scheduledActions[scheduledActionsPopIndex]
-                .first();
-        }
+        if (!scheduledActions.IsIdle())
+            ExecuteFirstActionOf(scheduledActions);
     }
 
     bool EventDispatcherWorkerImpl::IsIdle() const
     {
-        return !scheduledActions[scheduledActionsPopIndex].second;
+        return scheduledActions.IsIdle();
     }
 
     std::size_t EventDispatcherWorkerImpl::MinCapacity() const
     {
-        return minCapacity;
+        return scheduledActions.MinCapacity();
+    }
+
+#ifdef EMIL_EVENT_DISPATCHER_INSTRUMENTATION
+    void EventDispatcherWorkerImpl::SetInstrumentation(EventDispatcherInstrumentation* instrumentation)
+    {
+        this->instrumentation = instrumentation;
     }
+#endif
 
     void EventDispatcherWorkerImpl::RequestExecution()
     {}
@@ -106,14 +85,60 @@ namespace infra
     void EventDispatcherWorkerImpl::Idle()
     {}
 
+    EventDispatcherWorkerImpl::Queue& EventDispatcherWorkerImpl::ScheduledActions()
+    {
+        return scheduledActions;
+    }
+
+    const EventDispatcherWorkerImpl::Queue& EventDispatcherWorkerImpl::ScheduledActions() const
+    {
+        return scheduledActions;
+    }
+
+    void EventDispatcherWorkerImpl::PushActions(Queue& queue, infra::MemoryRange<const infra::Function<void()>> actions)
+    {
+        if (actions.empty())
+            return;
+
+        auto action = actions.begin();
+        queue.Push(actions.size(), [this, &action](infra::Function<void()>& scheduledAction, std::size_t slot)
+            {
+                scheduledAction = *action++;
+#ifdef EMIL_EVENT_DISPATCHER_INSTRUMENTATION
+                if (instrumentation != nullptr)
+                    instrumentation->Scheduled(slot, scheduledAction.TargetType());
+#endif
+            });
+
+        RequestExecution();
+    }
+
+    void EventDispatcherWorkerImpl::ExecuteFirstActionOf(Queue& queue)
+    {
+        queue.ExecuteFirstAction([this](infra::Function<void()>& action, std::size_t slot)
+            {
+#ifdef EMIL_EVENT_DISPATCHER_INSTRUMENTATION
+                if (instrumentation != nullptr)
+                    instrumentation->Started(slot, action.TargetType());
+#endif
+                action();
+            },
+            [this](infra::Function<void()>& action, std::size_t slot)
+            {
+#ifdef EMIL_EVENT_DISPATCHER_INSTRUMENTATION
+                if (instrumentation != nullptr)
+                    instrumentation->Finished(slot, action.TargetType());
+#endif
+                action = nullptr;
+            });
+    }
+
     bool EventDispatcherWorkerImpl::TryExecuteAction()
     {
-        if (scheduledActions[scheduledActionsPopIndex].second)
-        {
-            ExecuteFirstAction();
-            return true;
-        }
-        else
+        if (IsIdle())
             return false;
+
+        ExecuteFirstAction();
+        return true;
     }
 }
@@ -1,6 +1,8 @@
 #ifndef INFRA_EVENT_DISPATCHER_HPP
 #define INFRA_EVENT_DISPATCHER_HPP
 
+#include "infra/event/EventDispatcherActionQueue.hpp"
+#include "infra/event/EventDispatcherInstrumentation.hpp"
 #include "infra/util/Function.hpp"
 #include "infra/util/InterfaceConnector.hpp"
 #include "infra/util/WithStorage.hpp"
@@ -18,6 +20,8 @@ namespace infra
 
     public:
         virtual void Schedule(const infra::Function<void()>& action) = 0;
+        // Schedules all actions in order, requesting execution only once for the whole batch
+        virtual void ScheduleBatch(infra::MemoryRange<const infra::Function<void()>> actions);
         virtual void ExecuteFirstAction() = 0;
         virtual void ExecuteUntil(const infra::Function<bool()>& predicate) = 0;
         virtual std::size_t MinCapacity() const = 0;
@@ -28,12 +32,15 @@ namespace infra
         : public EventDispatcherWorker
     {
     public:
+        using ScheduledAction = std::pair<infra::Function<void()>, std::atomic<bool>>;
+
         template<std::size_t StorageSize, class T = EventDispatcherWorkerImpl>
-        using WithSize = infra::WithStorage<T, std::array<std::pair<infra::Function<void()>, std::atomic<bool>>, StorageSize>>;
+        using WithSize = infra::WithStorage<T, std::array<ScheduledAction, StorageSize>>;
 
-        explicit EventDispatcherWorkerImpl(MemoryRange<std::pair<infra::Function<void()>, std::atomic<bool>>> scheduledActionsStorage);
+        explicit EventDispatcherWorkerImpl(MemoryRange<ScheduledAction> scheduledActionsStorage);
 
         void Schedule(const infra::Function<void()>& action) override;
+        void ScheduleBatch(infra::MemoryRange<const infra::Function<void()>> actions) override;
         void ExecuteFirstAction() override;
         void ExecuteUntil(const infra::Function<bool()>& predicate) override;
         std::size_t MinCapacity() const override;
@@ -42,18 +49,32 @@ namespace infra
         void Run();
         void ExecuteAllActions();
 
+#ifdef EMIL_EVENT_DISPATCHER_INSTRUMENTATION
+        void SetInstrumentation(EventDispatcherInstrumentation* instrumentation);
+#endif
+
     protected:
+        using Queue = EventDispatcherActionQueue<infra::Function<void()>>;
+
+        // firstSlot offsets the slots reported to instrumentation, for derived workers that own additional queues
+        EventDispatcherWorkerImpl(MemoryRange<ScheduledAction> scheduledActionsStorage, std::size_t firstSlot);
+
         virtual void RequestExecution();
         virtual void Idle();
 
+        Queue& ScheduledActions();
+        const Queue& ScheduledActions() const;
+        void PushActions(Queue& queue, infra::MemoryRange<const infra::Function<void()>> actions);
+        void ExecuteFirstActionOf(Queue& queue);
+
     private:
         bool TryExecuteAction();
 
     private:
-        infra::MemoryRange<std::pair<infra::Function<void()>, std::atomic<bool>>> scheduledActions;
-        std::atomic<uint32_t> scheduledActionsPushIndex{ 0 };
-        uint32_t scheduledActionsPopIndex{ 0 };
-        std::size_t minCapacity;
+        Queue scheduledActions;
+#ifdef EMIL_EVENT_DISPATCHER_INSTRUMENTATION
+        EventDispatcherInstrumentation* instrumentation = nullptr;
+#endif
     };
 
     template<class T>
@@ -66,7 +87,7 @@ namespace infra
         using WithSize = typename T::template WithSize<StorageSize, EventDispatcherConnector<T>>;
 
         template<class... ConstructionArgs>
-        explicit EventDispatcherConnector(MemoryRange<std::pair<infra::Function<void()>, std::atomic<bool>>> scheduledActionsStorage, ConstructionArgs&&... args);
+        explicit EventDispatcherConnector(MemoryRange<EventDispatcherWorkerImpl::ScheduledAction> scheduledActionsStorage, ConstructionArgs&&... args);
     };
 
     using EventDispatcher = EventDispatcherConnector<EventDispatcherWorkerImpl>;
@@ -75,7 +96,7 @@ namespace infra
 
     template<class T>
     template<class... ConstructionArgs>
-    EventDispatcherConnector<T>::EventDispatcherConnector(MemoryRange<std::pair<infra::Function<void()>, std::atomic<bool>>> scheduledActionsStorage, ConstructionArgs&&... args)
+    EventDispatcherConnector<T>::EventDispatcherConnector(MemoryRange<EventDispatcherWorkerImpl::ScheduledAction> scheduledActionsStorage, ConstructionArgs&&... args)
         : infra::InterfaceConnector<EventDispatcherWorker>(this)
         , T(scheduledActionsStorage, std::forward<ConstructionArgs>(args)...)
     {}
@@ -0,0 +1,147 @@
+#ifndef INFRA_EVENT_DISPATCHER_ACTION_QUEUE_HPP
+#define INFRA_EVENT_DISPATCHER_ACTION_QUEUE_HPP
+
+#include "infra/util/MemoryRange.hpp"
+#include "infra/util/ReallyAssert.hpp"
+#include <algorithm>
+#include <atomic>
+#include <cstdint>
+#include <utility>
+
+namespace infra
+{
+    // Lock-free ring of scheduled actions, shared by the event dispatcher workers. Actions may be pushed from any context,
+    // including interrupts, and are executed in order by the event loop. Slots are numbered from firstSlot onwards, so that
+    // several queues of one dispatcher report distinct slots to instrumentation.
+    template<class Action>
+    class EventDispatcherActionQueue
+    {
+    public:
+        using ScheduledAction = std::pair<Action, std::atomic<bool>>;
+
+        explicit EventDispatcherActionQueue(MemoryRange<ScheduledAction> scheduledActions, std::size_t firstSlot = 0);
+        EventDispatcherActionQueue(const EventDispatcherActionQueue& other) = delete;
+        EventDispatcherActionQueue& operator=(const EventDispatcherActionQueue& other) = delete;
+        ~EventDispatcherActionQueue() = default;
+
+        // Reserves count consecutive slots with a single compare-exchange, and fills them in order by invoking construct(action, slot)
+        template<class Construct>
+        void Push(std::size_t count, Construct&& construct);
+
+        // Invokes execute(action, slot) for the first action, after which destroy(action, slot) releases its slot, also when execute throws
+        template<class Execute, class Destroy>
+        void ExecuteFirstAction(Execute&& execute, Destroy&& destroy);
+
+        bool IsIdle() const;
+        std::size_t Size() const;
+        std::size_t MinCapacity() const;
+
+    private:
+        uint32_t Reserve(std::size_t count);
+
+    private:
+        MemoryRange<ScheduledAction> scheduledActions;
+        std::size_t firstSlot;
+        std::atomic<uint32_t> scheduledActionsPushIndex{ 0 };
+        uint32_t scheduledActionsPopIndex{ 0 };
+        std::size_t minCapacity;
+    };
+
+    ////    Implementation    ////
+
+    template<class Action>
+    EventDispatcherActionQueue<Action>::EventDispatcherActionQueue(MemoryRange<ScheduledAction> scheduledActions, std::size_t firstSlot)
+        : scheduledActions(scheduledActions)
+        , firstSlot(firstSlot)
+        , minCapacity(scheduledActions.size())
+    {
+        for (auto& action : scheduledActions)
+            action.second = false;
+    }
+
+    template<class Action>
+    template<class Construct>
+    void EventDispatcherActionQueue<Action>::Push(std::size_t count, Construct&& construct)
+    {
+        really_assert(count <= scheduledActions.size());
+        uint32_t pushIndex = Reserve(count);
+
+        for (std::size_t i = 0; i != count; ++i)
+        {
+            construct(scheduledActions[pushIndex].first, firstSlot + pushIndex);
+            really_assert(!scheduledActions[pushIndex].second);
+            scheduledActions[pushIndex].second = true;
+
+            minCapacity = std::min<std::size_t>(minCapacity, (scheduledActions.size() + scheduledActionsPopIndex - pushIndex - 1) % scheduledActions.size() + 1);
+            really_assert(minCapacity >= 1);
+
+            pushIndex = (pushIndex + 1) % scheduledActions.size();
+        }
+    }
+
+    template<class Action>
+    template<class Execute, class Destroy>
+    void EventDispatcherActionQueue<Action>::ExecuteFirstAction(Execute&& execute, Destroy&& destroy)
+    {
+        struct ExceptionSafePop
+        {
+            ExceptionSafePop(EventDispatcherActionQueue& queue, Destroy& destroy)
+                : queue(queue)
+                , destroy(destroy)
+            {}
+
+            ExceptionSafePop(const ExceptionSafePop&) = delete;
+            ExceptionSafePop& operator=(const ExceptionSafePop&) = delete;
+
+            ~ExceptionSafePop()
+            {
+                auto& scheduledAction = queue.scheduledActions[queue.scheduledActionsPopIndex];
+                destroy(scheduledAction.first, queue.firstSlot + queue.scheduledActionsPopIndex);
+                scheduledAction.second = false;
+                queue.scheduledActionsPopIndex = (queue.scheduledActionsPopIndex + 1) % queue.scheduledActions.size();
+            }
+
+            EventDispatcherActionQueue& queue;
+            Destroy& destroy;
+        };
+
+        really_assert(!IsIdle());
+
+        ExceptionSafePop popAction{ *this, destroy };
+        execute(scheduledActions[scheduledActionsPopIndex].first, firstSlot + scheduledActionsPopIndex);
+    }
+
+    template<class Action>
+    bool EventDispatcherActionQueue<Action>::IsIdle() const
+    {
+        return scheduledActions.empty() || !scheduledActions[scheduledActionsPopIndex].second;
+    }
+
+    template<class Action>
+    std::size_t EventDispatcherActionQueue<Action>::Size() const
+    {
+        return scheduledActions.size();
+    }
+
+    template<class Action>
+    std::size_t EventDispatcherActionQueue<Action>::MinCapacity() const
+    {
+        return minCapacity;
+    }
+
+    template<class Action>
+    uint32_t EventDispatcherActionQueue<Action>::Reserve(std::size_t count)
+    {
+        uint32_t pushIndex = scheduledActionsPushIndex;
+        uint32_t newPushIndex;
+
+        do
+        {
+            newPushIndex = (pushIndex + count) % scheduledActions.size();
+        } while (!scheduledActionsPushIndex.compare_exchange_weak(pushIndex, newPushIndex));
+
+        return pushIndex;
+    }
+}
+
+#endif
@@ -0,0 +1,98 @@
+#include "infra/event/EventDispatcherHistogramCollector.hpp"
+#include "infra/util/ReallyAssert.hpp"
+#include <algorithm>
+
+namespace infra
+{
+    EventDispatcherHistogramCollector::EventDispatcherHistogramCollector(infra::MemoryRange<uint32_t> scheduledTimestamps, infra::MemoryRange<SourceStatistics> sources, const infra::Function<uint32_t()>& now)
+        : scheduledTimestamps(scheduledTimestamps)
+        , sources(sources)
+        , now(now)
+    {}
+
+    void EventDispatcherHistogramCollector::Scheduled(std::size_t slot, const void* source)
+    {
+        really_assert(slot < scheduledTimestamps.size());
+        scheduledTimestamps[slot] = now();
+    }
+
+    void EventDispatcherHistogramCollector::Started(std::size_t slot, const void* source)
+    {
+        startTimestamp = now();
+        currentLatency = startTimestamp - scheduledTimestamps[slot];
+        ++latencies[Bucket(currentLatency)];
+    }
+
+    void EventDispatcherHistogramCollector::Finished(std::size_t slot, const void* source)
+    {
+        auto duration = now() - startTimestamp;
+        ++durations[Bucket(duration)];
+
+        auto statistics = FindOrAddSource(source);
+        if (statistics != nullptr)
+        {
+            ++statistics->executions;
+            statistics->totalDuration += duration;
+            statistics->maxDuration = std::max(statistics->maxDuration, duration);
+            statistics->maxLatency = std::max(statistics->maxLatency, currentLatency);
+        }
+        else
+            ++untrackedExecutions;
+    }
+
+    const EventDispatcherHistogramCollector::Histogram& EventDispatcherHistogramCollector::Latencies() const
+    {
+        return latencies;
+    }
+
+    const EventDispatcherHistogramCollector::Histogram& EventDispatcherHistogramCollector::Durations() const
+    {
+        return durations;
+    }
+
+    infra::MemoryRange<const EventDispatcherHistogramCollector::SourceStatistics> EventDispatcherHistogramCollector::Sources() const
+    {
+        return infra::Head(infra::MemoryRange<const SourceStatistics>(sources), usedSources);
+    }
+
+    uint32_t EventDispatcherHistogramCollector::UntrackedExecutions() const
+    {
+        return untrackedExecutions;
+    }
+
+    void EventDispatcherHistogramCollector::Reset()
+    {
+        usedSources = 0;
+        untrackedExecutions = 0;
+        latencies.fill(0);
+        durations.fill(0);
+    }
+
+    std::size_t EventDispatcherHistogramCollector::Bucket(uint32_t ticks)
+    {
+        std::size_t bucket = 0;
+
+        for (; ticks != 0 && bucket != numberOfBuckets - 1; ticks >>= 1)
+            ++bucket;
+
+        return bucket;
+    }
+
+    EventDispatcherHistogramCollector::SourceStatistics* EventDispatcherHistogramCollector::FindOrAddSource(const void* source)
+    {
+        auto used = infra::Head(sources, usedSources);
+        auto statistics = std::find_if(used.begin(), used.end(), [source](const SourceStatistics& statistics)
+            {
+                return statistics.source == source;
+            });
+
+        if (statistics != used.end())
+            return statistics;
+
+        if (usedSources == sources.size())
+            return nullptr;
+
+        sources[usedSources] = SourceStatistics{ source };
+        return &sources[usedSources++];
+    }
+}
@@ -0,0 +1,69 @@
+#ifndef INFRA_EVENT_DISPATCHER_HISTOGRAM_COLLECTOR_HPP
+#define INFRA_EVENT_DISPATCHER_HISTOGRAM_COLLECTOR_HPP
+
+#include "infra/event/EventDispatcherInstrumentation.hpp"
+#include "infra/util/Function.hpp"
+#include "infra/util/MemoryRange.hpp"
+#include "infra/util/WithStorage.hpp"
+#include <array>
+#include <cstdint>
+
+namespace infra
+{
+    // Collects histograms of the time actions wait in the event dispatcher and of the time they take to execute, and
+    // keeps per-source statistics so that actions starving the event loop can be found. Time is measured in ticks
+    // of the now function, e.g. a cycle counter. Bucket 0 counts durations of 0 ticks, bucket i counts durations in
+    // [2^(i-1), 2^i), and the last bucket counts everything longer.
+    // The number of slots must be equal to the size of the event dispatcher, or to the sum of its lanes when it has priorities.
+    class EventDispatcherHistogramCollector
+        : public EventDispatcherInstrumentation
+    {
+    public:
+        static constexpr std::size_t numberOfBuckets = 16;
+        using Histogram = std::array<uint32_t, numberOfBuckets>;
+
+        struct SourceStatistics
+        {
+            const void* source = nullptr;
+            uint32_t executions = 0;
+            uint32_t totalDuration = 0;
+            uint32_t maxDuration = 0;
+            uint32_t maxLatency = 0;
+        };
+
+        template<std::size_t NumberOfSlots, std::size_t NumberOfSources>
+        using WithSize = infra::WithStorage<infra::WithStorage<EventDispatcherHistogramCollector, std::array<uint32_t, NumberOfSlots>>, std::array<SourceStatistics, NumberOfSources>>;
+
+        EventDispatcherHistogramCollector(infra::MemoryRange<uint32_t> scheduledTimestamps, infra::MemoryRange<SourceStatistics> sources, const infra::Function<uint32_t()>& now);
+
+        // Implementation of EventDispatcherInstrumentation
+        void Scheduled(std::size_t slot, const void* source) override;
+        void Started(std::size_t slot, const void* source) override;
+        void Finished(std::size_t slot, const void* source) override;
+
+        const Histogram& Latencies() const;
+        const Histogram& Durations() const;
+        infra::MemoryRange<const SourceStatistics> Sources() const;
+        // Executions of sources that did not fit in the table of sources
+        uint32_t UntrackedExecutions() const;
+        void Reset();
+
+        static std::size_t Bucket(uint32_t ticks);
+
+    private:
+        SourceStatistics* FindOrAddSource(const void* source);
+
+    private:
+        infra::MemoryRange<uint32_t> scheduledTimestamps;
+        infra::MemoryRange<SourceStatistics> sources;
+        infra::Function<uint32_t()> now;
+        std::size_t usedSources = 0;
+        uint32_t untrackedExecutions = 0;
+        uint32_t startTimestamp = 0;
+        uint32_t currentLatency = 0;
+        Histogram latencies{};
+        Histogram durations{};
+    };
+}
+
+#endif
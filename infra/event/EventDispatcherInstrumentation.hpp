@@ -0,0 +1,28 @@
+#ifndef INFRA_EVENT_DISPATCHER_INSTRUMENTATION_HPP
+#define INFRA_EVENT_DISPATCHER_INSTRUMENTATION_HPP
+
+#include <cstddef>
+
+namespace infra
+{
+    // Observes every action passing through EventDispatcherWorkerImpl, EventDispatcherWithWeakPtrWorker and the priority
+    // workers built on them. The hooks are only called when infra.event is compiled with EMIL_EVENT_DISPATCHER_INSTRUMENTATION;
+    // otherwise they add no code or data to the dispatcher. slot is the index of the action in the ring of scheduled actions,
+    // where the lanes of a priority worker are numbered consecutively, high priority first. source is the Function's
+    // TargetType(), which can be looked up in the linker map. Scheduled may be invoked from interrupt context.
+    class EventDispatcherInstrumentation
+    {
+    protected:
+        EventDispatcherInstrumentation() = default;
+        EventDispatcherInstrumentation(const EventDispatcherInstrumentation& other) = delete;
+        EventDispatcherInstrumentation& operator=(const EventDispatcherInstrumentation& other) = delete;
+        ~EventDispatcherInstrumentation() = default;
+
+    public:
+        virtual void Scheduled(std::size_t slot, const void* source) = 0;
+        virtual void Started(std::size_t slot, const void* source) = 0;
+        virtual void Finished(std::size_t slot, const void* source) = 0;
+    };
+}
+
+#endif
@@ -0,0 +1,177 @@
+#include "infra/event/EventDispatcherMultiThreaded.hpp"
+#include <algorithm>
+
+namespace infra
+{
+    namespace
+    {
+        thread_local const EventDispatcherMultiThreadedWorker* currentDispatcher = nullptr;
+        thread_local std::size_t currentQueue = 0;
+    }
+
+    Strand::Strand()
+        : Strand(EventDispatcherMultiThreadedWorker::Instance())
+    {}
+
+    Strand::Strand(EventDispatcherMultiThreadedWorker& dispatcher)
+        : dispatcher(dispatcher)
+    {}
+
+    Strand::~Strand()
+    {
+        std::unique_lock lock{ mutex };
+
+        drained.wait(lock, [this]()
+            {
+                return !queued;
+            });
+    }
+
+    void Strand::Schedule(const infra::Function<void()>& action)
+    {
+        bool enqueue;
+
+        {
+            std::lock_guard lock{ mutex };
+
+            actions.push_back(action);
+            enqueue = !queued;
+            queued = true;
+        }
+
+        if (enqueue)
+            dispatcher.Enqueue(*this);
+    }
+
+    EventDispatcherMultiThreadedWorker::EventDispatcherMultiThreadedWorker(MemoryRange<std::pair<ActionStorage, std::atomic<bool>>> scheduledActionsStorage, std::size_t numberOfThreads)
+        : EventDispatcherThreadAwareWorker(scheduledActionsStorage)
+        , queues(std::max<std::size_t>(numberOfThreads, 1))
+    {
+        for (std::size_t index = 0; index != queues.size(); ++index)
+            threads.emplace_back([this, index]()
+                {
+                    WorkerThread(index);
+                });
+    }
+
+    EventDispatcherMultiThreadedWorker::~EventDispatcherMultiThreadedWorker()
+    {
+        {
+            std::lock_guard lock{ idleMutex };
+            stopping = true;
+        }
+
+        idleCondition.notify_all();
+
+        for (auto& thread : threads)
+            thread.join();
+    }
+
+    std::size_t EventDispatcherMultiThreadedWorker::NumberOfThreads() const
+    {
+        return threads.size();
+    }
+
+    void EventDispatcherMultiThreadedWorker::Enqueue(Strand& strand)
+    {
+        // Strands scheduled from a worker thread stay on that worker, so that related work stays on the same core
+        auto index = currentDispatcher == this ? currentQueue : nextQueue++ % queues.size();
+
+        {
+            std::lock_guard lock{ idleMutex };
+            std::lock_guard queueLock{ queues[index].mutex };
+
+            queues[index].strands.push_back(&strand);
+            ++queuedStrands;
+        }
+
+        idleCondition.notify_one();
+    }
+
+    void EventDispatcherMultiThreadedWorker::WorkerThread(std::size_t index)
+    {
+        currentDispatcher = this;
+        currentQueue = index;
+
+        while (true)
+        {
+            auto strand = TakeStrand(index);
+
+            if (strand != nullptr)
+                ExecuteStrand(*strand);
+            else
+            {
+                std::unique_lock lock{ idleMutex };
+
+                idleCondition.wait(lock, [this]()
+                    {
+                        return stopping || queuedStrands != 0;
+                    });
+
+                if (queuedStrands == 0)
+                    break;
+            }
+        }
+    }
+
+    Strand* EventDispatcherMultiThreadedWorker::TakeStrand(std::size_t index)
+    {
+        Strand* strand = nullptr;
+
+        // Take the oldest strand from the own queue, or else steal the newest strand from another worker
+        for (std::size_t i = 0; i != queues.size() && strand == nullptr; ++i)
+        {
+            auto& queue = queues[(index + i) % queues.size()];
+            std::lock_guard lock{ queue.mutex };
+
+            if (!queue.strands.empty())
+            {
+                if (i == 0)
+                {
+                    strand = queue.strands.front();
+                    queue.strands.pop_front();
+                }
+                else
+                {
+                    strand = queue.strands.back();
+                    queue.strands.pop_back();
+                }
+            }
+        }
+
+        if (strand != nullptr)
+        {
+            std::lock_guard lock{ idleMutex };
+            --queuedStrands;
+        }
+
+        return strand;
+    }
+
+    void EventDispatcherMultiThreadedWorker::ExecuteStrand(Strand& strand)
+    {
+        for (std::size_t i = 0; i != maxActionsPerTurn; ++i)
+        {
+            infra::Function<void()> action;
+
+            {
+                std::lock_guard lock{ strand.mutex };
+
+                if (strand.actions.empty())
+                {
+                    strand.queued = false;
+                    strand.drained.notify_all();
+                    return;
+                }
+
+                action = strand.actions.front();
+                strand.actions.pop_front();
+            }
+
+            action();
+        }
+
+        // Give other strands a turn before continuing with this one
+        Enqueue(strand);
+    }
+}
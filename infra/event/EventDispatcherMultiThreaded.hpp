@@ -0,0 +1,88 @@
+#ifndef INFRA_EVENT_DISPATCHER_MULTI_THREADED_HPP
+#define INFRA_EVENT_DISPATCHER_MULTI_THREADED_HPP
+
+#include "infra/event/EventDispatcherThreadAware.hpp"
+#include "infra/util/InterfaceConnector.hpp"
+#include <atomic>
+#include <condition_variable>
+#include <deque>
+#include <mutex>
+#include <thread>
+#include <vector>
+
+namespace infra
+{
+    class EventDispatcherMultiThreadedWorker;
+
+    // Actions scheduled on a strand never run concurrently with each other and run in the order in which they are
+    // scheduled, but actions of different strands run in parallel on the worker threads of an EventDispatcherMultiThreaded.
+    // A strand must not be destroyed from one of its own actions; its destructor waits until its pending actions have run.
+    class Strand
+    {
+    public:
+        Strand();
+        explicit Strand(EventDispatcherMultiThreadedWorker& dispatcher);
+        Strand(const Strand& other) = delete;
+        Strand& operator=(const Strand& other) = delete;
+        ~Strand();
+
+        void Schedule(const infra::Function<void()>& action);
+
+    private:
+        friend class EventDispatcherMultiThreadedWorker;
+
+        EventDispatcherMultiThreadedWorker& dispatcher;
+        std::mutex mutex;
+        std::condition_variable drained;
+        std::deque<infra::Function<void()>> actions;
+        bool queued = false;
+    };
+
+    // Actions scheduled via the EventDispatcher interface are executed on the thread calling Run or ExecuteUntil,
+    // just like EventDispatcherThreadAware does, so that existing code keeps its single-threaded guarantees.
+    // Actions scheduled on a Strand are executed by a pool of worker threads. Each worker thread has its own queue of
+    // strands that have pending actions; a worker thread that runs out of work steals strands from other workers.
+    class EventDispatcherMultiThreadedWorker
+        : public EventDispatcherThreadAwareWorker
+        , public infra::InterfaceConnector<EventDispatcherMultiThreadedWorker>
+    {
+    public:
+        template<std::size_t StorageSize, class T = EventDispatcherMultiThreadedWorker>
+        using WithSize = infra::WithStorage<T, std::array<std::pair<ActionStorage, std::atomic<bool>>, StorageSize>>;
+
+        explicit EventDispatcherMultiThreadedWorker(MemoryRange<std::pair<ActionStorage, std::atomic<bool>>> scheduledActionsStorage, std::size_t numberOfThreads = std::thread::hardware_concurrency());
+        ~EventDispatcherMultiThreadedWorker();
+
+        std::size_t NumberOfThreads() const;
+
+    private:
+        friend class Strand;
+
+        struct WorkerQueue
+        {
+            std::mutex mutex;
+            std::deque<Strand*> strands;
+        };
+
+        void Enqueue(Strand& strand);
+        void WorkerThread(std::size_t index);
+        Strand* TakeStrand(std::size_t index);
+        void ExecuteStrand(Strand& strand);
+
+    private:
+        static constexpr std::size_t maxActionsPerTurn = 16;
+
+        std::deque<WorkerQueue> queues;
+        std::vector<std::thread> threads;
+        std::atomic<std::size_t> nextQueue{ 0 };
+
+        std::mutex idleMutex;
+        std::condition_variable idleCondition;
+        std::size_t queuedStrands = 0;
+        bool stopping = false;
+    };
+
+    using EventDispatcherMultiThreaded = EventDispatcherWithWeakPtrConnector<EventDispatcherMultiThreadedWorker>;
+}
+
+#endif
@@ -0,0 +1,243 @@
+#ifndef INFRA_EVENT_DISPATCHER_WITH_PRIORITIES_HPP
+#define INFRA_EVENT_DISPATCHER_WITH_PRIORITIES_HPP
+
+#include "infra/event/EventDispatcher.hpp"
+#include "infra/event/EventDispatcherWithWeakPtr.hpp"
+#include <algorithm>
+#include <array>
+
+namespace infra
+{
+    enum class EventDispatcherPriority : uint8_t
+    {
+        high,
+        normal,
+        low
+    };
+
+    // Each priority has its own ring of scheduled actions. An action is only executed when all rings of higher
+    // priority are empty, so a burst of low priority work does not delay latency-critical actions.
+    // The ring of Worker itself holds Priority::normal, which is also used by Schedule without a priority.
+    template<class Worker>
+    class EventDispatcherWithPrioritiesWorkerBase
+        : public Worker
+    {
+    public:
+        using Priority = EventDispatcherPriority;
+
+        static constexpr std::size_t numberOfPriorities = 3;
+
+        using ScheduledAction = typename Worker::ScheduledAction;
+        using Lanes = std::array<MemoryRange<ScheduledAction>, numberOfPriorities>;
+
+        template<std::size_t HighSize, std::size_t NormalSize, std::size_t LowSize>
+        struct LaneStorage
+        {
+            operator Lanes();
+
+            std::array<ScheduledAction, HighSize> high;
+            std::array<ScheduledAction, NormalSize> normal;
+            std::array<ScheduledAction, LowSize> low;
+        };
+
+        explicit EventDispatcherWithPrioritiesWorkerBase(const Lanes& lanes);
+
+        using Worker::Schedule;
+        using Worker::ScheduleBatch;
+        void Schedule(const infra::Function<void()>& action, Priority priority);
+        void ScheduleBatch(infra::MemoryRange<const infra::Function<void()>> actions, Priority priority);
+        void ExecuteFirstAction() override;
+        // Returns the lowest MinCapacity of all priorities
+        std::size_t MinCapacity() const override;
+        std::size_t MinCapacity(Priority priority) const;
+        bool IsIdle() const override;
+
+    protected:
+        typename Worker::Queue& Lane(Priority priority);
+        const typename Worker::Queue& Lane(Priority priority) const;
+
+    private:
+        typename Worker::Queue high;
+        typename Worker::Queue low;
+    };
+
+    class EventDispatcherWithPrioritiesWorker
+        : public EventDispatcherWithPrioritiesWorkerBase<EventDispatcherWorkerImpl>
+    {
+    public:
+        template<std::size_t HighSize, std::size_t NormalSize = HighSize, std::size_t LowSize = NormalSize, class T = EventDispatcherWithPrioritiesWorker>
+        using WithSize = infra::WithStorage<T, LaneStorage<HighSize, NormalSize, LowSize>>;
+
+        using EventDispatcherWithPrioritiesWorkerBase<EventDispatcherWorkerImpl>::EventDispatcherWithPrioritiesWorkerBase;
+    };
+
+    // Priorities on top of EventDispatcherWithWeakPtrWorker, so that it can be used wherever an EventDispatcherWithWeakPtr is expected
+    class EventDispatcherWithPrioritiesAndWeakPtrWorker
+        : public EventDispatcherWithPrioritiesWorkerBase<EventDispatcherWithWeakPtrWorker>
+    {
+    public:
+        template<std::size_t HighSize, std::size_t NormalSize = HighSize, std::size_t LowSize = NormalSize, class T = EventDispatcherWithPrioritiesAndWeakPtrWorker>
+        using WithSize = infra::WithStorage<T, LaneStorage<HighSize, NormalSize, LowSize>>;
+
+        using EventDispatcherWithPrioritiesWorkerBase<EventDispatcherWithWeakPtrWorker>::EventDispatcherWithPrioritiesWorkerBase;
+        using EventDispatcherWithPrioritiesWorkerBase<EventDispatcherWithWeakPtrWorker>::Schedule;
+
+        template<class T>
+        void Schedule(const typename std::decay<infra::Function<void(const infra::SharedPtr<T>& object)>>::type& action, const infra::SharedPtr<T>& object, Priority priority);
+        template<class T>
+        void Schedule(const typename std::decay<infra::Function<void(const infra::SharedPtr<T>& object)>>::type& action, const infra::WeakPtr<T>& object, Priority priority);
+    };
+
+    template<class T>
+    class EventDispatcherWithPrioritiesConnector
+        : public infra::InterfaceConnector<EventDispatcherWorker>
+        , public infra::InterfaceConnector<EventDispatcherWithPrioritiesWorker>
+        , public T
+    {
+    public:
+        using infra::InterfaceConnector<EventDispatcherWithPrioritiesWorker>::Instance;
+
+        template<std::size_t HighSize, std::size_t NormalSize = HighSize, std::size_t LowSize = NormalSize>
+        using WithSize = typename T::template WithSize<HighSize, NormalSize, LowSize, EventDispatcherWithPrioritiesConnector<T>>;
+
+        template<class... ConstructionArgs>
+        explicit EventDispatcherWithPrioritiesConnector(const EventDispatcherWithPrioritiesWorker::Lanes& lanes, ConstructionArgs&&... args);
+    };
+
+    template<class T>
+    class EventDispatcherWithPrioritiesAndWeakPtrConnector
+        : public infra::InterfaceConnector<EventDispatcherWorker>
+        , public infra::InterfaceConnector<EventDispatcherWithWeakPtrWorker>
+        , public infra::InterfaceConnector<EventDispatcherWithPrioritiesAndWeakPtrWorker>
+        , public T
+    {
+    public:
+        using infra::InterfaceConnector<EventDispatcherWithPrioritiesAndWeakPtrWorker>::Instance;
+
+        template<std::size_t HighSize, std::size_t NormalSize = HighSize, std::size_t LowSize = NormalSize>
+        using WithSize = typename T::template WithSize<HighSize, NormalSize, LowSize, EventDispatcherWithPrioritiesAndWeakPtrConnector<T>>;
+
+        template<class... ConstructionArgs>
+        explicit EventDispatcherWithPrioritiesAndWeakPtrConnector(const EventDispatcherWithPrioritiesAndWeakPtrWorker::Lanes& lanes, ConstructionArgs&&... args);
+    };
+
+    using EventDispatcherWithPriorities = EventDispatcherWithPrioritiesConnector<EventDispatcherWithPrioritiesWorker>;
+    using EventDispatcherWithPrioritiesAndWeakPtr = EventDispatcherWithPrioritiesAndWeakPtrConnector<EventDispatcherWithPrioritiesAndWeakPtrWorker>;
+
+    ////    Implementation    ////
+
+    template<class Worker>
+    template<std::size_t HighSize, std::size_t NormalSize, std::size_t LowSize>
+    EventDispatcherWithPrioritiesWorkerBase<Worker>::LaneStorage<HighSize, NormalSize, LowSize>::operator Lanes()
+    {
+        return Lanes{ high, normal, low };
+    }
+
+    template<class Worker>
+    EventDispatcherWithPrioritiesWorkerBase<Worker>::EventDispatcherWithPrioritiesWorkerBase(const Lanes& lanes)
+        : Worker(lanes[static_cast<std::size_t>(Priority::normal)], lanes[static_cast<std::size_t>(Priority::high)].size())
+        , high(lanes[static_cast<std::size_t>(Priority::high)], 0)
+        , low(lanes[static_cast<std::size_t>(Priority::low)], lanes[static_cast<std::size_t>(Priority::high)].size() + lanes[static_cast<std::size_t>(Priority::normal)].size())
+    {}
+
+    template<class Worker>
+    void EventDispatcherWithPrioritiesWorkerBase<Worker>::Schedule(const infra::Function<void()>& action, Priority priority)
+    {
+        this->PushActions(Lane(priority), infra::MakeRange(&action, &action + 1));
+    }
+
+    template<class Worker>
+    void EventDispatcherWithPrioritiesWorkerBase<Worker>::ScheduleBatch(infra::MemoryRange<const infra::Function<void()>> actions, Priority priority)
+    {
+        this->PushActions(Lane(priority), actions);
+    }
+
+    template<class Worker>
+    void EventDispatcherWithPrioritiesWorkerBase<Worker>::ExecuteFirstAction()
+    {
+        for (auto priority : { Priority::high, Priority::normal, Priority::low })
+            if (!Lane(priority).IsIdle())
+            {
+                this->ExecuteFirstActionOf(Lane(priority));
+                break;
+            }
+    }
+
+    template<class Worker>
+    std::size_t EventDispatcherWithPrioritiesWorkerBase<Worker>::MinCapacity() const
+    {
+        return std::min({ high.MinCapacity(), Worker::MinCapacity(), low.MinCapacity() });
+    }
+
+    template<class Worker>
+    std::size_t EventDispatcherWithPrioritiesWorkerBase<Worker>::MinCapacity(Priority priority) const
+    {
+        return Lane(priority).MinCapacity();
+    }
+
+    template<class Worker>
+    bool EventDispatcherWithPrioritiesWorkerBase<Worker>::IsIdle() const
+    {
+        return high.IsIdle() && Worker::IsIdle() && low.IsIdle();
+    }
+
+    template<class Worker>
+    typename Worker::Queue& EventDispatcherWithPrioritiesWorkerBase<Worker>::Lane(Priority priority)
+    {
+        switch (priority)
+        {
+            case Priority::high:
+                return high;
+            case Priority::low:
+                return low;
+            default:
+                return this->ScheduledActions();
+        }
+    }
+
+    template<class Worker>
+    const typename Worker::Queue& EventDispatcherWithPrioritiesWorkerBase<Worker>::Lane(Priority priority) const
+    {
+        switch (priority)
+        {
+            case Priority::high:
+                return high;
+            case Priority::low:
+                return low;
+            default:
+                return this->ScheduledActions();
+        }
+    }
+
+    template<class T>
+    void EventDispatcherWithPrioritiesAndWeakPtrWorker::Schedule(const typename std::decay<infra::Function<void(const infra::SharedPtr<T>& object)>>::type& action, const infra::SharedPtr<T>& object, Priority priority)
+    {
+        assert(object != nullptr);
+        Schedule(action, infra::WeakPtr<T>(object), priority);
+    }
+
+    template<class T>
+    void EventDispatcherWithPrioritiesAndWeakPtrWorker::Schedule(const typename std::decay<infra::Function<void(const infra::SharedPtr<T>& object)>>::type& action, const infra::WeakPtr<T>& object, Priority priority)
+    {
+        PushAction(Lane(priority), action, object);
+    }
+
+    template<class T>
+    template<class... ConstructionArgs>
+    EventDispatcherWithPrioritiesConnector<T>::EventDispatcherWithPrioritiesConnector(const EventDispatcherWithPrioritiesWorker::Lanes& lanes, ConstructionArgs&&... args)
+        : infra::InterfaceConnector<EventDispatcherWorker>(this)
+        , infra::InterfaceConnector<EventDispatcherWithPrioritiesWorker>(this)
+        , T(lanes, std::forward<ConstructionArgs>(args)...)
+    {}
+
+    template<class T>
+    template<class... ConstructionArgs>
+    EventDispatcherWithPrioritiesAndWeakPtrConnector<T>::EventDispatcherWithPrioritiesAndWeakPtrConnector(const EventDispatcherWithPrioritiesAndWeakPtrWorker::Lanes& lanes, ConstructionArgs&&... args)
+        : infra::InterfaceConnector<EventDispatcherWorker>(this)
+        , infra::InterfaceConnector<EventDispatcherWithWeakPtrWorker>(this)
+        , infra::InterfaceConnector<EventDispatcherWithPrioritiesAndWeakPtrWorker>(this)
+        , T(lanes, std::forward<ConstructionArgs>(args)...)
+    {}
+}
+
+#endif
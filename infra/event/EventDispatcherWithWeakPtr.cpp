@@ -4,32 +4,22 @@
 
 namespace infra
 {
-    EventDispatcherWithWeakPtrWorker::EventDispatcherWithWeakPtrWorker(MemoryRange<std::pair<ActionStorage, std::atomic<bool>>> scheduledActionsStorage)
-        : scheduledActions(scheduledActionsStorage)
-        , minCapacity(scheduledActions.size())
-    {
-        for (auto& action : scheduledActions)
-            action.second = false;
-    }
+    EventDispatcherWithWeakPtrWorker::EventDispatcherWithWeakPtrWorker(MemoryRange<ScheduledAction> scheduledActionsStorage)
+        : EventDispatcherWithWeakPtrWorker(scheduledActionsStorage, 0)
+    {}
+
+    EventDispatcherWithWeakPtrWorker::EventDispatcherWithWeakPtrWorker(MemoryRange<ScheduledAction> scheduledActionsStorage, std::size_t firstSlot)
+        : scheduledActions(scheduledActionsStorage, firstSlot)
+    {}
 
     void EventDispatcherWithWeakPtrWorker::Schedule(const infra::Function<void()>& action)
     {
-        uint32_t pushIndex = scheduledActionsPushIndex;
-        uint32_t newPushIndex;
-
-        do
-        {
-            newPushIndex = (pushIndex + 1) % scheduledActions.size();
-        } while (!scheduledActionsPushIndex.compare_exchange_weak(pushIndex, newPushIndex));
-
-        scheduledActions[pushIndex].first.Construct<ActionFunction>(action);
-        really_assert(!scheduledActions[pushIndex].second);
-        scheduledActions[pushIndex].second = true;
-
-        minCapacity = std::min<std::size_t>(minCapacity, (scheduledActions.size() + scheduledActionsPopIndex - pushIndex - 1) % scheduledActions.size() + 1);
-        really_assert(minCapacity >= 1);
+        PushActions(scheduledActions, infra::MakeRange(&action, &action + 1));
+    }
 
-        RequestExecution();
+    void EventDispatcherWithWeakPtrWorker::ScheduleBatch(infra::MemoryRange<const infra::Function<void()>> actions)
+    {
+        PushActions(scheduledActions, actions);
     }
 
     void EventDispatcherWithWeakPtrWorker::Run()
@@ -62,13 +52,20 @@ namespace infra
 
     bool EventDispatcherWithWeakPtrWorker::IsIdle() const
     {
-        return !scheduledActions[scheduledActionsPopIndex].second;
+        return scheduledActions.IsIdle();
     }
 
     std::size_t EventDispatcherWithWeakPtrWorker::MinCapacity() const
     {
-        return minCapacity;
+        return scheduledActions.MinCapacity();
+    }
+
+#ifdef EMIL_EVENT_DISPATCHER_INSTRUMENTATION
+    void EventDispatcherWithWeakPtrWorker::SetInstrumentation(EventDispatcherInstrumentation* instrumentation)
+    {
+        this->instrumentation = instrumentation;
     }
+#endif
 
     void EventDispatcherWithWeakPtrWorker::RequestExecution()
     {}
@@ -78,41 +75,65 @@ namespace infra
 
     void EventDispatcherWithWeakPtrWorker::ExecuteFirstAction()
     {
-        if (scheduledActions[scheduledActionsPopIndex].second)
-        {
-            struct ExceptionSafePop
-            {
-                ExceptionSafePop(EventDispatcherWithWeakPtrWorker& worker)
-                    : worker(worker)
-                {}
+        if (!scheduledActions.IsIdle())
+            ExecuteFirstActionOf(scheduledActions);
+    }
+
+    EventDispatcherWithWeakPtrWorker::Queue& EventDispatcherWithWeakPtrWorker::ScheduledActions()
+    {
+        return scheduledActions;
+    }
 
-                ExceptionSafePop(const ExceptionSafePop&) = delete;
-                ExceptionSafePop& operator=(const ExceptionSafePop&) = delete;
+    const EventDispatcherWithWeakPtrWorker::Queue& EventDispatcherWithWeakPtrWorker::ScheduledActions() const
+    {
+        return scheduledActions;
+    }
 
-                ~ExceptionSafePop()
-                {
-                    worker.scheduledActions[worker.scheduledActionsPopIndex].first.Destruct();
-                    worker.scheduledActions[worker.scheduledActionsPopIndex].second = false;
-                    worker.scheduledActionsPopIndex = (worker.scheduledActionsPopIndex + 1) % worker.scheduledActions.size();
-                }
+    void EventDispatcherWithWeakPtrWorker::PushActions(Queue& queue, infra::MemoryRange<const infra::Function<void()>> actions)
+    {
+        if (actions.empty())
+            return;
 
-                EventDispatcherWithWeakPtrWorker& worker;
-            };
+        auto action = actions.begin();
+        queue.Push(actions.size(), [this, &action](ActionStorage& scheduledAction, std::size_t slot)
+            {
+                scheduledAction.Construct<ActionFunction>(*action++);
+#ifdef EMIL_EVENT_DISPATCHER_INSTRUMENTATION
+                if (instrumentation != nullptr)
+                    instrumentation->Scheduled(slot, scheduledAction->TargetType());
+#endif
+            });
 
-            ExceptionSafePop popAction{ *this };
-            scheduledActions[scheduledActionsPopIndex].first->Execute();
-        }
+        RequestExecution();
+    }
+
+    void EventDispatcherWithWeakPtrWorker::ExecuteFirstActionOf(Queue& queue)
+    {
+        queue.ExecuteFirstAction([this](ActionStorage& action, std::size_t slot)
+            {
+#ifdef EMIL_EVENT_DISPATCHER_INSTRUMENTATION
+                if (instrumentation != nullptr)
+                    instrumentation->Started(slot, action->TargetType());
+#endif
+                action->Execute();
+            },
+            [this](ActionStorage& action, std::size_t slot)
+            {
+#ifdef EMIL_EVENT_DISPATCHER_INSTRUMENTATION
+                if (instrumentation != nullptr)
+                    instrumentation->Finished(slot, action->TargetType());
+#endif
+                action.Destruct();
+            });
     }
 
     bool EventDispatcherWithWeakPtrWorker::TryExecuteAction()
     {
-        if (scheduledActions[scheduledActionsPopIndex].second)
-        {
-            ExecuteFirstAction();
-            return true;
-        }
-        else
+        if (IsIdle())
             return false;
+
+        ExecuteFirstAction();
+        return true;
     }
 
     EventDispatcherWithWeakPtrWorker::ActionFunction::ActionFunction(const Function<void()>& function)
@@ -123,4 +144,11 @@ namespace infra
     {
         function();
     }
+
+#ifdef EMIL_EVENT_DISPATCHER_INSTRUMENTATION
+    const void* EventDispatcherWithWeakPtrWorker::ActionFunction::TargetType() const
+    {
+        return function.TargetType();
+    }
+#endif
 }
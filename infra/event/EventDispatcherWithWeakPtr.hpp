@@ -20,6 +20,9 @@ namespace infra
             virtual ~Action() = default;
 
             virtual void Execute() = 0;
+#ifdef EMIL_EVENT_DISPATCHER_INSTRUMENTATION
+            virtual const void* TargetType() const = 0;
+#endif
         };
 
         class ActionFunction
@@ -29,6 +32,9 @@ namespace infra
             explicit ActionFunction(const Function<void()>& function);
 
             void Execute() override;
+#ifdef EMIL_EVENT_DISPATCHER_INSTRUMENTATION
+            const void* TargetType() const override;
+#endif
 
         private:
             Function<void()> function;
@@ -42,6 +48,9 @@ namespace infra
             ActionWithWeakPtr(const infra::Function<void(const infra::SharedPtr<T>& object)>& function, const infra::WeakPtr<T>& object);
 
             void Execute() override;
+#ifdef EMIL_EVENT_DISPATCHER_INSTRUMENTATION
+            const void* TargetType() const override;
+#endif
 
         private:
             infra::Function<void(const infra::SharedPtr<T>& object)> function;
@@ -50,12 +59,15 @@ namespace infra
 
     public:
         using ActionStorage = StaticStorageForPolymorphicObjects<Action, INFRA_EVENT_DISPATCHER_WITH_WEAK_PTR_FUNCTION_EXTRA_SIZE>;
+        using ScheduledAction = std::pair<ActionStorage, std::atomic<bool>>;
+
         template<std::size_t StorageSize, class T = EventDispatcherWithWeakPtrWorker>
-        using WithSize = infra::WithStorage<T, std::array<std::pair<ActionStorage, std::atomic<bool>>, StorageSize>>;
+        using WithSize = infra::WithStorage<T, std::array<ScheduledAction, StorageSize>>;
 
-        explicit EventDispatcherWithWeakPtrWorker(MemoryRange<std::pair<ActionStorage, std::atomic<bool>>> scheduledActionsStorage);
+        explicit EventDispatcherWithWeakPtrWorker(MemoryRange<ScheduledAction> scheduledActionsStorage);
 
         void Schedule(const infra::Function<void()>& action) override;
+        void ScheduleBatch(infra::MemoryRange<const infra::Function<void()>> actions) override;
 
         template<class T>
         void Schedule(const typename std::decay<infra::Function<void(const infra::SharedPtr<T>& object)>>::type& action, const infra::SharedPtr<T>& object);
@@ -70,18 +82,34 @@ namespace infra
         void Run();
         void ExecuteAllActions();
 
+#ifdef EMIL_EVENT_DISPATCHER_INSTRUMENTATION
+        void SetInstrumentation(EventDispatcherInstrumentation* instrumentation);
+#endif
+
     protected:
+        using Queue = EventDispatcherActionQueue<ActionStorage>;
+
+        // firstSlot offsets the slots of this worker's queue, for derived workers that own additional queues
+        EventDispatcherWithWeakPtrWorker(MemoryRange<ScheduledAction> scheduledActionsStorage, std::size_t firstSlot);
+
         virtual void RequestExecution();
         virtual void Idle();
 
+        Queue& ScheduledActions();
+        const Queue& ScheduledActions() const;
+        void PushActions(Queue& queue, infra::MemoryRange<const infra::Function<void()>> actions);
+        template<class T>
+        void PushAction(Queue& queue, const infra::Function<void(const infra::SharedPtr<T>& object)>& action, const infra::WeakPtr<T>& object);
+        void ExecuteFirstActionOf(Queue& queue);
+
     private:
         bool TryExecuteAction();
 
     private:
-        infra::MemoryRange<std::pair<ActionStorage, std::atomic<bool>>> scheduledActions;
-        std::atomic<uint32_t> scheduledActionsPushIndex{ 0 };
-        uint32_t scheduledActionsPopIndex{ 0 };
-        std::size_t minCapacity;
+        Queue scheduledActions;
+#ifdef EMIL_EVENT_DISPATCHER_INSTRUMENTATION
+        EventDispatcherInstrumentation* instrumentation = nullptr;
+#endif
     };
 
     template<class T>
@@ -97,7 +125,7 @@ namespace infra
         using WithSize = typename T::template WithSize<StorageSize, EventDispatcherWithWeakPtrConnector<T>>;
 
         template<class... ConstructionArgs>
-        explicit EventDispatcherWithWeakPtrConnector(MemoryRange<std::pair<EventDispatcherWithWeakPtrWorker::ActionStorage, std::atomic<bool>>> scheduledActionsStorage, ConstructionArgs&&... args);
+        explicit EventDispatcherWithWeakPtrConnector(MemoryRange<EventDispatcherWithWeakPtrWorker::ScheduledAction> scheduledActionsStorage, ConstructionArgs&&... args);
     };
 
     using EventDispatcherWithWeakPtr = EventDispatcherWithWeakPtrConnector<EventDispatcherWithWeakPtrWorker>;
@@ -114,20 +142,20 @@ namespace infra
     template<class T>
     void EventDispatcherWithWeakPtrWorker::Schedule(const typename std::decay<infra::Function<void(const infra::SharedPtr<T>& object)>>::type& action, const infra::WeakPtr<T>& object)
     {
-        uint32_t pushIndex = scheduledActionsPushIndex;
-        uint32_t newPushIndex;
-
-        do
-        {
-            newPushIndex = (pushIndex + 1) % scheduledActions.size();
-        } while (!scheduledActionsPushIndex.compare_exchange_weak(pushIndex, newPushIndex));
-
-        scheduledActions[pushIndex].first.Construct<ActionWithWeakPtr<T>>(action, object);
-        assert(!scheduledActions[pushIndex].second);
-        scheduledActions[pushIndex].second = true;
+        PushAction(scheduledActions, action, object);
+    }
 
-        minCapacity = std::min<std::size_t>(minCapacity, (scheduledActions.size() + scheduledActionsPopIndex - pushIndex - 1) % scheduledActions.size() + 1);
-        assert(minCapacity >= 1);
+    template<class T>
+    void EventDispatcherWithWeakPtrWorker::PushAction(Queue& queue, const infra::Function<void(const infra::SharedPtr<T>& object)>& action, const infra::WeakPtr<T>& object)
+    {
+        queue.Push(1, [this, &action, &object](ActionStorage& scheduledAction, std::size_t slot)
+            {
+                scheduledAction.Construct<ActionWithWeakPtr<T>>(action, object);
+#ifdef EMIL_EVENT_DISPATCHER_INSTRUMENTATION
+                if (instrumentation != nullptr)
+                    instrumentation->Scheduled(slot, scheduledAction->TargetType());
+#endif
+            });
 
         RequestExecution();
     }
@@ -146,9 +174,17 @@ namespace infra
             function(sharedObject);
     }
 
+#ifdef EMIL_EVENT_DISPATCHER_INSTRUMENTATION
+    template<class T>
+    const void* EventDispatcherWithWeakPtrWorker::ActionWithWeakPtr<T>::TargetType() const
+    {
+        return function.TargetType();
+    }
+#endif
+
     template<class T>
     template<class... ConstructionArgs>
-    EventDispatcherWithWeakPtrConnector<T>::EventDispatcherWithWeakPtrConnector(MemoryRange<std::pair<EventDispatcherWithWeakPtrWorker::ActionStorage, std::atomic<bool>>> scheduledActionsStorage, ConstructionArgs&&... args)
+    EventDispatcherWithWeakPtrConnector<T>::EventDispatcherWithWeakPtrConnector(MemoryRange<EventDispatcherWithWeakPtrWorker::ScheduledAction> scheduledActionsStorage, ConstructionArgs&&... args)
         : infra::InterfaceConnector<EventDispatcherWorker>(this)
         , infra::InterfaceConnector<EventDispatcherWithWeakPtrWorker>(this)
         , T(scheduledActionsStorage, std::forward<ConstructionArgs>(args)...)
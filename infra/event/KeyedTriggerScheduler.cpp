@@ -0,0 +1,44 @@
+#include "infra/event/KeyedTriggerScheduler.hpp"
+#include "infra/util/ReallyAssert.hpp"
+
+namespace infra
+{
+    KeyedTriggerScheduler::KeyedTriggerScheduler(infra::MemoryRange<infra::AutoResetFunction<void()>> actions)
+        : actions(actions)
+    {
+        really_assert(actions.size() <= 32);
+    }
+
+    void KeyedTriggerScheduler::Schedule(std::size_t key, const infra::Function<void()>& action)
+    {
+        really_assert(key < actions.size());
+        uint32_t bit = 1u << key;
+
+        if ((claimedKeys.fetch_or(bit) & bit) == 0)
+        {
+            actions[key] = action;
+            readyKeys.fetch_or(bit);
+
+            if (!executionScheduled.exchange(true))
+                infra::EventDispatcher::Instance().Schedule([this]()
+                    {
+                        ExecutePending();
+                    });
+        }
+    }
+
+    void KeyedTriggerScheduler::ExecutePending()
+    {
+        // Keys that become ready after this point are handled by a newly scheduled action
+        executionScheduled = false;
+        uint32_t keys = readyKeys.exchange(0);
+
+        for (std::size_t key = 0; keys != 0; ++key, keys >>= 1)
+            if ((keys & 1) != 0)
+            {
+                auto actionCopy = std::move(actions[key]);
+                claimedKeys.fetch_and(~(1u << key));
+                actionCopy();
+            }
+    }
+}
@@ -0,0 +1,39 @@
+#ifndef INFRA_KEYED_TRIGGER_SCHEDULER_HPP
+#define INFRA_KEYED_TRIGGER_SCHEDULER_HPP
+
+#include "infra/event/EventDispatcher.hpp"
+#include "infra/util/AutoResetFunction.hpp"
+#include "infra/util/MemoryRange.hpp"
+#include "infra/util/WithStorage.hpp"
+#include <array>
+#include <atomic>
+
+namespace infra
+{
+    // Like AtomicTriggerScheduler, but for multiple keys: while an action is pending for a key, scheduling another
+    // action for that key has no effect. All pending keys share a single action on the event dispatcher, so a burst of
+    // triggers for different keys costs one scheduled action and one wake-up. At most 32 keys are supported.
+    class KeyedTriggerScheduler
+    {
+    public:
+        template<std::size_t NumberOfKeys>
+        using WithNumberOfKeys = infra::WithStorage<KeyedTriggerScheduler, std::array<infra::AutoResetFunction<void()>, NumberOfKeys>>;
+
+        explicit KeyedTriggerScheduler(infra::MemoryRange<infra::AutoResetFunction<void()>> actions);
+        KeyedTriggerScheduler(const KeyedTriggerScheduler& other) = delete;
+        KeyedTriggerScheduler& operator=(const KeyedTriggerScheduler& other) = delete;
+
+        void Schedule(std::size_t key, const infra::Function<void()>& action);
+
+    private:
+        void ExecutePending();
+
+    private:
+        infra::MemoryRange<infra::AutoResetFunction<void()>> actions;
+        std::atomic<uint32_t> claimedKeys{ 0 };
+        std::atomic<uint32_t> readyKeys{ 0 };
+        std::atomic_bool executionScheduled{ false };
+    };
+}
+
+#endif
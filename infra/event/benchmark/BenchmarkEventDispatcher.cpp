@@ -0,0 +1,58 @@
+#include "infra/event/EventDispatcher.hpp"
+#include "infra/event/EventDispatcherWithWeakPtr.hpp"
+#include <array>
+#include <benchmark/benchmark.h>
+
+namespace
+{
+    constexpr std::size_t dispatcherSize = 256;
+
+    template<class Dispatcher>
+    void ScheduleAndExecute(benchmark::State& state)
+    {
+        typename Dispatcher::template WithSize<dispatcherSize> dispatcher;
+        int counter = 0;
+
+        for (auto _ : state)
+        {
+            for (int64_t i = 0; i != state.range(0); ++i)
+                dispatcher.Schedule([&counter]()
+                    {
+                        ++counter;
+                    });
+
+            dispatcher.ExecuteAllActions();
+        }
+
+        benchmark::DoNotOptimize(counter);
+        state.SetItemsProcessed(state.iterations() * state.range(0));
+    }
+
+    template<class Dispatcher>
+    void ScheduleBatchAndExecute(benchmark::State& state)
+    {
+        typename Dispatcher::template WithSize<dispatcherSize> dispatcher;
+        int counter = 0;
+        std::array<infra::Function<void()>, dispatcherSize> actions;
+
+        for (auto& action : actions)
+            action = [&counter]()
+            {
+                ++counter;
+            };
+
+        for (auto _ : state)
+        {
+            dispatcher.ScheduleBatch(infra::MakeRange(actions.data(), actions.data() + state.range(0)));
+            dispatcher.ExecuteAllActions();
+        }
+
+        benchmark::DoNotOptimize(counter);
+        state.SetItemsProcessed(state.iterations() * state.range(0));
+    }
+}
+
+BENCHMARK_TEMPLATE(ScheduleAndExecute, infra::EventDispatcher)->Arg(1)->Arg(16)->Arg(200);
+BENCHMARK_TEMPLATE(ScheduleAndExecute, infra::EventDispatcherWithWeakPtr)->Arg(1)->Arg(16)->Arg(200);
+BENCHMARK_TEMPLATE(ScheduleBatchAndExecute, infra::EventDispatcher)->Arg(1)->Arg(16)->Arg(200);
+BENCHMARK_TEMPLATE(ScheduleBatchAndExecute, infra::EventDispatcherWithWeakPtr)->Arg(1)->Arg(16)->Arg(200);
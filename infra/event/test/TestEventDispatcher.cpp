@@ -4,6 +4,7 @@
 #include "infra/util/test_helper/MockCallback.hpp"
 #include "gmock/gmock.h"
 #include "gtest/gtest.h"
+#include <array>
 #include <stdexcept>
 
 class EventDispatcherTest
@@ -75,6 +76,40 @@ class EventDispatcherDetailedTest
     , public EventDispatcherMock
 {};
 
+TEST_F(EventDispatcherDetailedTest, ScheduleBatch_requests_execution_once_and_executes_in_order)
+{
+    infra::MockCallback<void(int)> callback;
+    std::array<infra::Function<void()>, 3> actions{ { [&callback]()
+                                                          {
+                                                              callback.callback(1);
+                                                          },
+        [&callback]()
+        {
+            callback.callback(2);
+        },
+        [&callback]()
+        {
+            callback.callback(3);
+        } } };
+
+    EXPECT_CALL(*this, RequestExecution());
+    infra::EventDispatcher::Instance().ScheduleBatch(actions);
+
+    testing::InSequence s;
+    EXPECT_CALL(callback, callback(1));
+    EXPECT_CALL(callback, callback(2));
+    EXPECT_CALL(callback, callback(3));
+    ExecuteAllActions();
+}
+
+TEST_F(EventDispatcherDetailedTest, empty_batch_does_not_request_execution)
+{
+    EXPECT_CALL(*this, RequestExecution()).Times(0);
+    infra::EventDispatcher::Instance().ScheduleBatch(infra::MemoryRange<const infra::Function<void()>>());
+
+    EXPECT_TRUE(IsIdle());
+}
+
 TEST_F(EventDispatcherDetailedTest, ExecuteUntil_executes_until_first_action_sets_predicate_true)
 {
     bool done = false;
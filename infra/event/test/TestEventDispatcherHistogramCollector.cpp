@@ -0,0 +1,218 @@
+#include "infra/event/EventDispatcher.hpp"
+#include "infra/event/EventDispatcherHistogramCollector.hpp"
+#include "infra/event/EventDispatcherWithPriorities.hpp"
+#include "infra/event/EventDispatcherWithWeakPtr.hpp"
+#include "infra/util/SharedObjectAllocatorFixedSize.hpp"
+#include "gmock/gmock.h"
+#include "gtest/gtest.h"
+
+class EventDispatcherHistogramCollectorTest
+    : public testing::Test
+{
+public:
+    void Execute(std::size_t slot, const void* source, uint32_t latency, uint32_t duration)
+    {
+        collector.Scheduled(slot, source);
+        time += latency;
+        collector.Started(slot, source);
+        time += duration;
+        collector.Finished(slot, source);
+    }
+
+    uint32_t time = 1000;
+    infra::EventDispatcherHistogramCollector::WithSize<4, 2> collector{ [this]()
+        {
+            return time;
+        } };
+    const int sourceA = 0;
+    const int sourceB = 0;
+    const int sourceC = 0;
+};
+
+TEST_F(EventDispatcherHistogramCollectorTest, Bucket_is_number_of_significant_bits)
+{
+    EXPECT_EQ(0, infra::EventDispatcherHistogramCollector::Bucket(0));
+    EXPECT_EQ(1, infra::EventDispatcherHistogramCollector::Bucket(1));
+    EXPECT_EQ(2, infra::EventDispatcherHistogramCollector::Bucket(2));
+    EXPECT_EQ(2, infra::EventDispatcherHistogramCollector::Bucket(3));
+    EXPECT_EQ(3, infra::EventDispatcherHistogramCollector::Bucket(4));
+    EXPECT_EQ(15, infra::EventDispatcherHistogramCollector::Bucket(0x4000));
+    EXPECT_EQ(15, infra::EventDispatcherHistogramCollector::Bucket(0xffffffff));
+}
+
+TEST_F(EventDispatcherHistogramCollectorTest, latency_and_duration_are_recorded)
+{
+    Execute(0, &sourceA, 3, 8);
+
+    infra::EventDispatcherHistogramCollector::Histogram expectedLatencies{};
+    expectedLatencies[2] = 1;
+    infra::EventDispatcherHistogramCollector::Histogram expectedDurations{};
+    expectedDurations[4] = 1;
+
+    EXPECT_EQ(expectedLatencies, collector.Latencies());
+    EXPECT_EQ(expectedDurations, collector.Durations());
+}
+
+TEST_F(EventDispatcherHistogramCollectorTest, latency_is_measured_per_slot)
+{
+    collector.Scheduled(0, &sourceA);
+    time += 10;
+    collector.Scheduled(1, &sourceA);
+    collector.Started(0, &sourceA);
+    collector.Finished(0, &sourceA);
+    collector.Started(1, &sourceA);
+    collector.Finished(1, &sourceA);
+
+    EXPECT_EQ(1, collector.Latencies()[0]);
+    EXPECT_EQ(1, collector.Latencies()[4]);
+}
+
+TEST_F(EventDispatcherHistogramCollectorTest, statistics_are_kept_per_source)
+{
+    Execute(0, &sourceA, 1, 10);
+    Execute(1, &sourceB, 5, 2);
+    Execute(2, &sourceA, 3, 20);
+
+    ASSERT_EQ(2, collector.Sources().size());
+
+    EXPECT_EQ(&sourceA, collector.Sources()[0].source);
+    EXPECT_EQ(2, collector.Sources()[0].executions);
+    EXPECT_EQ(30, collector.Sources()[0].totalDuration);
+    EXPECT_EQ(20, collector.Sources()[0].maxDuration);
+    EXPECT_EQ(3, collector.Sources()[0].maxLatency);
+
+    EXPECT_EQ(&sourceB, collector.Sources()[1].source);
+    EXPECT_EQ(1, collector.Sources()[1].executions);
+}
+
+TEST_F(EventDispatcherHistogramCollectorTest, executions_of_sources_that_do_not_fit_are_counted)
+{
+    Execute(0, &sourceA, 0, 0);
+    Execute(1, &sourceB, 0, 0);
+    Execute(2, &sourceC, 0, 0);
+
+    EXPECT_EQ(2, collector.Sources().size());
+    EXPECT_EQ(1, collector.UntrackedExecutions());
+    EXPECT_EQ(3, collector.Durations()[0]);
+}
+
+TEST_F(EventDispatcherHistogramCollectorTest, Reset_clears_statistics)
+{
+    Execute(0, &sourceA, 0, 0);
+    Execute(1, &sourceB, 0, 0);
+    Execute(2, &sourceC, 0, 0);
+
+    collector.Reset();
+
+    EXPECT_EQ(infra::EventDispatcherHistogramCollector::Histogram{}, collector.Latencies());
+    EXPECT_EQ(infra::EventDispatcherHistogramCollector::Histogram{}, collector.Durations());
+    EXPECT_TRUE(collector.Sources().empty());
+    EXPECT_EQ(0, collector.UntrackedExecutions());
+}
+
+#ifdef EMIL_EVENT_DISPATCHER_INSTRUMENTATION
+class EventDispatcherInstrumentationMock
+    : public infra::EventDispatcherInstrumentation
+{
+public:
+    MOCK_METHOD(void, Scheduled, (std::size_t slot, const void* source), (override));
+    MOCK_METHOD(void, Started, (std::size_t slot, const void* source), (override));
+    MOCK_METHOD(void, Finished, (std::size_t slot, const void* source), (override));
+};
+
+class EventDispatcherInstrumentationTest
+    : public testing::Test
+    , public infra::EventDispatcher::WithSize<4>
+{
+public:
+    EventDispatcherInstrumentationTest()
+    {
+        SetInstrumentation(&instrumentation);
+    }
+
+    testing::StrictMock<EventDispatcherInstrumentationMock> instrumentation;
+};
+
+TEST_F(EventDispatcherInstrumentationTest, hooks_are_called_for_each_action)
+{
+    infra::Function<void()> action = []() {};
+
+    testing::InSequence s;
+    EXPECT_CALL(instrumentation, Scheduled(0, action.TargetType()));
+    EXPECT_CALL(instrumentation, Scheduled(1, action.TargetType()));
+    Schedule(action);
+    Schedule(action);
+
+    EXPECT_CALL(instrumentation, Started(0, action.TargetType()));
+    EXPECT_CALL(instrumentation, Finished(0, action.TargetType()));
+    EXPECT_CALL(instrumentation, Started(1, action.TargetType()));
+    EXPECT_CALL(instrumentation, Finished(1, action.TargetType()));
+    ExecuteAllActions();
+}
+
+class EventDispatcherWithWeakPtrInstrumentationTest
+    : public testing::Test
+    , public infra::EventDispatcherWithWeakPtr::WithSize<4>
+{
+public:
+    EventDispatcherWithWeakPtrInstrumentationTest()
+    {
+        SetInstrumentation(&instrumentation);
+    }
+
+    testing::StrictMock<EventDispatcherInstrumentationMock> instrumentation;
+};
+
+TEST_F(EventDispatcherWithWeakPtrInstrumentationTest, hooks_are_called_for_actions_with_and_without_object)
+{
+    infra::Function<void()> action = []() {};
+    infra::Function<void(const infra::SharedPtr<int>& object)> actionWithObject = [](const infra::SharedPtr<int>& object) {};
+    infra::SharedObjectAllocatorFixedSize<int, void()>::WithStorage<1> allocator;
+    infra::SharedPtr<int> object = allocator.Allocate();
+
+    testing::InSequence s;
+    EXPECT_CALL(instrumentation, Scheduled(0, action.TargetType()));
+    EXPECT_CALL(instrumentation, Scheduled(1, actionWithObject.TargetType()));
+    Schedule(action);
+    Schedule(actionWithObject, object);
+
+    EXPECT_CALL(instrumentation, Started(0, action.TargetType()));
+    EXPECT_CALL(instrumentation, Finished(0, action.TargetType()));
+    EXPECT_CALL(instrumentation, Started(1, actionWithObject.TargetType()));
+    EXPECT_CALL(instrumentation, Finished(1, actionWithObject.TargetType()));
+    ExecuteAllActions();
+}
+
+class EventDispatcherWithPrioritiesInstrumentationTest
+    : public testing::Test
+    , public infra::EventDispatcherWithPrioritiesAndWeakPtr::WithSize<2, 4, 2>
+{
+public:
+    EventDispatcherWithPrioritiesInstrumentationTest()
+    {
+        SetInstrumentation(&instrumentation);
+    }
+
+    testing::StrictMock<EventDispatcherInstrumentationMock> instrumentation;
+};
+
+TEST_F(EventDispatcherWithPrioritiesInstrumentationTest, lanes_report_consecutive_slots)
+{
+    infra::Function<void()> action = []() {};
+
+    testing::InSequence s;
+    EXPECT_CALL(instrumentation, Scheduled(6, action.TargetType()));
+    EXPECT_CALL(instrumentation, Scheduled(2, action.TargetType()));
+    EXPECT_CALL(instrumentation, Scheduled(0, action.TargetType()));
+    Schedule(action, Priority::low);
+    Schedule(action);
+    Schedule(action, Priority::high);
+
+    for (auto slot : { 0, 2, 6 })
+    {
+        EXPECT_CALL(instrumentation, Started(slot, action.TargetType()));
+        EXPECT_CALL(instrumentation, Finished(slot, action.TargetType()));
+    }
+    ExecuteAllActions();
+}
+#endif
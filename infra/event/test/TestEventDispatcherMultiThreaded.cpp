@@ -0,0 +1,152 @@
+#include "infra/event/EventDispatcherMultiThreaded.hpp"
+#include "gmock/gmock.h"
+#include "gtest/gtest.h"
+#include <atomic>
+#include <thread>
+#include <vector>
+
+class EventDispatcherMultiThreadedTest
+    : public testing::Test
+{
+public:
+    void ExecuteUntilDone()
+    {
+        eventDispatcher.ExecuteUntil([this]()
+            {
+                return done;
+            });
+    }
+
+    void Done()
+    {
+        infra::EventDispatcher::Instance().Schedule([this]()
+            {
+                done = true;
+            });
+    }
+
+    infra::EventDispatcherMultiThreaded::WithSize<50> eventDispatcher{ 2 };
+    bool done = false;
+
+    std::atomic<int> active{ 0 };
+    std::atomic<int> finished{ 0 };
+    std::atomic<int> met{ 0 };
+    std::atomic<bool> overlapped{ false };
+    std::atomic<bool> released{ false };
+};
+
+TEST_F(EventDispatcherMultiThreadedTest, scheduled_action_is_executed_on_thread_calling_execute_until)
+{
+    std::thread::id executingThread;
+
+    std::thread t([&]()
+        {
+            infra::EventDispatcher::Instance().Schedule([&]()
+                {
+                    executingThread = std::this_thread::get_id();
+                    done = true;
+                });
+        });
+
+    ExecuteUntilDone();
+    t.join();
+
+    EXPECT_EQ(std::this_thread::get_id(), executingThread);
+}
+
+TEST_F(EventDispatcherMultiThreadedTest, actions_on_strand_execute_in_order)
+{
+    infra::Strand strand;
+    std::vector<int> executed;
+
+    for (int i = 0; i != 100; ++i)
+        strand.Schedule([&executed, i]()
+            {
+                executed.push_back(i);
+            });
+
+    strand.Schedule([this]()
+        {
+            Done();
+        });
+
+    ExecuteUntilDone();
+
+    ASSERT_EQ(100, executed.size());
+    for (int i = 0; i != 100; ++i)
+        EXPECT_EQ(i, executed[i]);
+}
+
+TEST_F(EventDispatcherMultiThreadedTest, actions_on_strand_do_not_overlap)
+{
+    infra::Strand strand;
+
+    for (int i = 0; i != 50; ++i)
+        strand.Schedule([this]()
+            {
+                if (++active != 1)
+                    overlapped = true;
+
+                std::this_thread::sleep_for(std::chrono::microseconds(100));
+                --active;
+
+                if (++finished == 50)
+                    Done();
+            });
+
+    ExecuteUntilDone();
+
+    EXPECT_FALSE(overlapped);
+}
+
+TEST_F(EventDispatcherMultiThreadedTest, different_strands_execute_in_parallel)
+{
+    infra::Strand strand1;
+    infra::Strand strand2;
+
+    auto meet = [this]()
+    {
+        ++active;
+
+        auto timeout = std::chrono::steady_clock::now() + std::chrono::seconds(5);
+        while (active != 2 && std::chrono::steady_clock::now() < timeout)
+            std::this_thread::yield();
+
+        if (active == 2)
+            ++met;
+
+        if (++finished == 2)
+            Done();
+    };
+
+    strand1.Schedule(meet);
+    strand2.Schedule(meet);
+
+    ExecuteUntilDone();
+
+    EXPECT_EQ(2, met);
+}
+
+TEST_F(EventDispatcherMultiThreadedTest, idle_worker_steals_from_busy_worker)
+{
+    infra::Strand busy;
+    infra::Strand other;
+
+    busy.Schedule([this, &other]()
+        {
+            other.Schedule([this]()
+                {
+                    released = true;
+                });
+
+            auto timeout = std::chrono::steady_clock::now() + std::chrono::seconds(5);
+            while (!released && std::chrono::steady_clock::now() < timeout)
+                std::this_thread::yield();
+
+            Done();
+        });
+
+    ExecuteUntilDone();
+
+    EXPECT_TRUE(released);
+}
@@ -0,0 +1,236 @@
+#include "infra/event/EventDispatcherWithPriorities.hpp"
+#include "infra/util/SharedObjectAllocatorFixedSize.hpp"
+#include "infra/util/test_helper/MockCallback.hpp"
+#include "gmock/gmock.h"
+#include "gtest/gtest.h"
+#include <array>
+
+class EventDispatcherWithPrioritiesTest
+    : public testing::Test
+    , public infra::EventDispatcherWithPriorities::WithSize<4, 8, 4>
+{
+public:
+    using Priority = infra::EventDispatcherWithPriorities::Priority;
+};
+
+TEST_F(EventDispatcherWithPrioritiesTest, scheduled_action_without_priority_is_executed)
+{
+    infra::MockCallback<void()> callback;
+    EXPECT_CALL(callback, callback());
+
+    infra::EventDispatcher::Instance().Schedule([&callback]()
+        {
+            callback.callback();
+        });
+    ExecuteAllActions();
+}
+
+TEST_F(EventDispatcherWithPrioritiesTest, higher_priority_actions_are_executed_first)
+{
+    infra::MockCallback<void(int)> callback;
+    testing::InSequence s;
+    EXPECT_CALL(callback, callback(1));
+    EXPECT_CALL(callback, callback(2));
+    EXPECT_CALL(callback, callback(3));
+    EXPECT_CALL(callback, callback(4));
+
+    infra::EventDispatcherWithPriorities::Instance().Schedule([&callback]()
+        {
+            callback.callback(4);
+        },
+        Priority::low);
+    infra::EventDispatcherWithPriorities::Instance().Schedule([&callback]()
+        {
+            callback.callback(2);
+        });
+    infra::EventDispatcherWithPriorities::Instance().Schedule([&callback]()
+        {
+            callback.callback(1);
+        },
+        Priority::high);
+    infra::EventDispatcherWithPriorities::Instance().Schedule([&callback]()
+        {
+            callback.callback(3);
+        });
+
+    ExecuteAllActions();
+}
+
+TEST_F(EventDispatcherWithPrioritiesTest, high_priority_action_scheduled_during_execution_overtakes_pending_actions)
+{
+    infra::MockCallback<void(int)> callback;
+    testing::InSequence s;
+    EXPECT_CALL(callback, callback(1));
+    EXPECT_CALL(callback, callback(2));
+    EXPECT_CALL(callback, callback(3));
+
+    Schedule([this, &callback]()
+        {
+            callback.callback(1);
+            Schedule([&callback]()
+                {
+                    callback.callback(2);
+                },
+                Priority::high);
+        },
+        Priority::low);
+    Schedule([&callback]()
+        {
+            callback.callback(3);
+        },
+        Priority::low);
+
+    ExecuteAllActions();
+}
+
+TEST_F(EventDispatcherWithPrioritiesTest, batch_is_scheduled_with_priority)
+{
+    infra::MockCallback<void(int)> callback;
+    testing::InSequence s;
+    EXPECT_CALL(callback, callback(1));
+    EXPECT_CALL(callback, callback(2));
+    EXPECT_CALL(callback, callback(3));
+
+    std::array<infra::Function<void()>, 2> actions{ { [&callback]()
+                                                          {
+                                                              callback.callback(1);
+                                                          },
+        [&callback]()
+        {
+            callback.callback(2);
+        } } };
+
+    Schedule([&callback]()
+        {
+            callback.callback(3);
+        });
+    ScheduleBatch(actions, Priority::high);
+
+    ExecuteAllActions();
+}
+
+TEST_F(EventDispatcherWithPrioritiesTest, ExecuteFirstAction_executes_action_with_highest_priority)
+{
+    infra::MockCallback<void(int)> callback;
+
+    Schedule([&callback]()
+        {
+            callback.callback(2);
+        });
+    Schedule([&callback]()
+        {
+            callback.callback(1);
+        },
+        Priority::high);
+
+    EXPECT_CALL(callback, callback(1));
+    ExecuteFirstAction();
+
+    EXPECT_CALL(callback, callback(2));
+    ExecuteFirstAction();
+
+    EXPECT_TRUE(IsIdle());
+}
+
+TEST_F(EventDispatcherWithPrioritiesTest, IsIdle_when_all_lanes_are_empty)
+{
+    EXPECT_TRUE(IsIdle());
+
+    Schedule([]() {}, Priority::low);
+    EXPECT_FALSE(IsIdle());
+
+    ExecuteAllActions();
+    EXPECT_TRUE(IsIdle());
+}
+
+TEST_F(EventDispatcherWithPrioritiesTest, MinCapacity_is_reported_per_priority)
+{
+    EXPECT_EQ(4, MinCapacity(Priority::high));
+    EXPECT_EQ(8, MinCapacity(Priority::normal));
+    EXPECT_EQ(4, MinCapacity(Priority::low));
+
+    Schedule([]() {});
+    Schedule([]() {});
+    Schedule([]() {}, Priority::low);
+    Schedule([]() {}, Priority::low);
+
+    EXPECT_EQ(4, MinCapacity(Priority::high));
+    EXPECT_EQ(7, MinCapacity(Priority::normal));
+    EXPECT_EQ(3, MinCapacity(Priority::low));
+    EXPECT_EQ(3, MinCapacity());
+
+    ExecuteAllActions();
+
+    EXPECT_EQ(7, MinCapacity(Priority::normal));
+}
+
+class EventDispatcherWithPrioritiesAndWeakPtrTest
+    : public testing::Test
+    , public infra::EventDispatcherWithPrioritiesAndWeakPtr::WithSize<4, 8, 4>
+{
+public:
+    using Priority = infra::EventDispatcherWithPrioritiesAndWeakPtr::Priority;
+};
+
+TEST_F(EventDispatcherWithPrioritiesAndWeakPtrTest, is_available_as_EventDispatcherWithWeakPtr)
+{
+    infra::MockCallback<void()> callback;
+    EXPECT_CALL(callback, callback());
+
+    infra::SharedObjectAllocatorFixedSize<int, void()>::WithStorage<1> allocator;
+    infra::SharedPtr<int> object = allocator.Allocate();
+
+    infra::EventDispatcherWithWeakPtr::Instance().Schedule([&callback](const infra::SharedPtr<int>& object)
+        {
+            callback.callback();
+        },
+        object);
+    ExecuteAllActions();
+}
+
+TEST_F(EventDispatcherWithPrioritiesAndWeakPtrTest, higher_priority_actions_are_executed_first)
+{
+    infra::MockCallback<void(int)> callback;
+    testing::InSequence s;
+    EXPECT_CALL(callback, callback(1));
+    EXPECT_CALL(callback, callback(2));
+    EXPECT_CALL(callback, callback(3));
+
+    infra::SharedObjectAllocatorFixedSize<int, void()>::WithStorage<1> allocator;
+    infra::SharedPtr<int> object = allocator.Allocate();
+
+    Schedule([&callback]()
+        {
+            callback.callback(3);
+        },
+        Priority::low);
+    Schedule([&callback]()
+        {
+            callback.callback(2);
+        });
+    infra::EventDispatcherWithPrioritiesAndWeakPtr::Instance().Schedule([&callback](const infra::SharedPtr<int>& object)
+        {
+            callback.callback(1);
+        },
+        object, Priority::high);
+
+    ExecuteAllActions();
+}
+
+TEST_F(EventDispatcherWithPrioritiesAndWeakPtrTest, action_with_expired_object_is_not_executed)
+{
+    infra::MockCallback<void()> callback;
+
+    infra::SharedObjectAllocatorFixedSize<int, void()>::WithStorage<1> allocator;
+    infra::SharedPtr<int> object = allocator.Allocate();
+
+    Schedule([&callback](const infra::SharedPtr<int>& object)
+        {
+            callback.callback();
+        },
+        object, Priority::high);
+    object = nullptr;
+
+    ExecuteAllActions();
+    EXPECT_TRUE(IsIdle());
+}
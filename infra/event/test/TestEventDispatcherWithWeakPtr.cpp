@@ -4,6 +4,7 @@
 #include "infra/util/test_helper/MockCallback.hpp"
 #include "gmock/gmock.h"
 #include "gtest/gtest.h"
+#include <array>
 #include <stdexcept>
 
 class EventDispatcherWithWeakPtrTest
@@ -62,6 +63,26 @@ TEST_F(EventDispatcherWithWeakPtrTest, ExecuteFirstAction_executes_first_action)
     ExecuteFirstAction();
 }
 
+TEST_F(EventDispatcherWithWeakPtrTest, batch_of_actions_is_executed_in_order)
+{
+    infra::MockCallback<void(int)> callback;
+    testing::InSequence s;
+    EXPECT_CALL(callback, callback(1));
+    EXPECT_CALL(callback, callback(2));
+
+    std::array<infra::Function<void()>, 2> actions{ { [&callback]()
+                                                          {
+                                                              callback.callback(1);
+                                                          },
+        [&callback]()
+        {
+            callback.callback(2);
+        } } };
+
+    infra::EventDispatcherWithWeakPtr::Instance().ScheduleBatch(actions);
+    ExecuteAllActions();
+}
+
 TEST_F(EventDispatcherWithWeakPtrTest, scheduled_action_with_SharedPtr_is_executed)
 {
     infra::MockCallback<void()> callback;
@@ -0,0 +1,68 @@
+#include "infra/event/KeyedTriggerScheduler.hpp"
+#include "infra/event/test_helper/EventDispatcherFixture.hpp"
+#include "infra/util/test_helper/MockCallback.hpp"
+#include "gtest/gtest.h"
+
+class KeyedTriggerSchedulerTest
+    : public infra::EventDispatcherFixture
+    , public testing::Test
+{
+public:
+    infra::KeyedTriggerScheduler::WithNumberOfKeys<4> scheduler;
+};
+
+TEST_F(KeyedTriggerSchedulerTest, scheduled_once_per_key)
+{
+    infra::VerifyingFunction<void()> mock;
+
+    scheduler.Schedule(1, [&]()
+        {
+            mock.callback();
+        });
+    scheduler.Schedule(1, [&]()
+        {
+            mock.callback();
+        });
+
+    ExecuteAllActions();
+}
+
+TEST_F(KeyedTriggerSchedulerTest, different_keys_are_executed_from_one_scheduled_action)
+{
+    infra::MockCallback<void(int)> callback;
+    testing::InSequence s;
+    EXPECT_CALL(callback, callback(0));
+    EXPECT_CALL(callback, callback(3));
+
+    scheduler.Schedule(3, [&]()
+        {
+            callback.callback(3);
+        });
+    scheduler.Schedule(0, [&]()
+        {
+            callback.callback(0);
+        });
+
+    ExecuteFirstAction();
+    EXPECT_TRUE(IsIdle());
+}
+
+TEST_F(KeyedTriggerSchedulerTest, key_can_be_scheduled_again_from_its_action)
+{
+    infra::MockCallback<void(int)> callback;
+    EXPECT_CALL(callback, callback(1));
+    EXPECT_CALL(callback, callback(2));
+
+    scheduler.Schedule(2, [&]()
+        {
+            callback.callback(1);
+            scheduler.Schedule(2, [&]()
+                {
+                    callback.callback(2);
+                });
+        });
+
+    ExecuteFirstAction();
+    EXPECT_FALSE(IsIdle());
+    ExecuteAllActions();
+}
@@ -1,4 +1,5 @@
 #include "infra/stream/BufferingStreamReader.hpp"
+#include <algorithm>
 
 namespace infra
 {
@@ -59,7 +60,8 @@ namespace infra
         if (index + start < buffer.size())
             return buffer.contiguous_range(buffer.begin() + index + start);
 
-        return input.PeekContiguousRange(index + start - buffer.size());
+        // Bytes extracted from input beyond the buffer are already consumed from input
+        return input.PeekContiguousRange(index + start - std::max(index, buffer.size()));
     }
 
     bool BufferingStreamReader::Empty() const
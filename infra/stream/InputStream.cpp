@@ -480,6 +480,20 @@ namespace infra
 
         while (!helper.data.empty() && !stream.Empty())
         {
+            if (bitIndex == 0)
+            {
+                // Decode all complete groups that are contiguously available at once, padding and
+                // groups split over multiple ranges are handled character by character
+                auto decoded = DecodeBase64Groups(ReinterpretCastMemoryRange<const char>(stream.PeekContiguousRange()), helper.data);
+
+                if (decoded != 0)
+                {
+                    stream.Consume(decoded * 4);
+                    helper.data = DiscardHead(helper.data, decoded * 3);
+                    continue;
+                }
+            }
+
             char currentChar;
             stream >> currentChar;
 
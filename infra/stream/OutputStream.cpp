@@ -1,6 +1,7 @@
 #include "infra/stream/OutputStream.hpp"
 #include "infra/util/Base64.hpp"
 #include "infra/util/LogAndAbort.hpp"
+#include <algorithm>
 #include <cmath>
 #include <limits>
 
@@ -398,42 +399,52 @@ namespace infra
 
     Base64Encoder::~Base64Encoder()
     {
-        if ((size & 3) != 0)
+        if (pendingSize != 0)
         {
-            stream << detail::base64Table[encodedByte];
-            ++size;
-        }
-        if ((size & 3) != 0)
-        {
-            stream << '=';
-            ++size;
-        }
-        if ((size & 3) != 0)
-        {
-            stream << '=';
-            ++size;
+            std::array<uint8_t, 3> group{};
+            std::copy(pending.begin(), pending.begin() + pendingSize, group.begin());
+
+            std::array<char, 4> encoded;
+            EncodeBase64Groups(group, encoded);
+            std::fill(encoded.begin() + pendingSize + 1, encoded.end(), '=');
+
+            stream << BoundedConstString(encoded.data(), encoded.size());
         }
     }
 
     void Base64Encoder::Encode(infra::ConstByteRange data)
     {
-        for (uint8_t byte : data)
+        if (pendingSize != 0)
         {
-            encodedByte |= byte >> bitIndex;
-            stream << detail::base64Table[encodedByte];
-            ++size;
+            auto size = std::min<std::size_t>(data.size(), pending.size() - pendingSize);
+            std::copy(data.begin(), data.begin() + size, pending.begin() + pendingSize);
+            pendingSize += static_cast<uint8_t>(size);
+            data = infra::DiscardHead(data, size);
 
-            encodedByte = static_cast<uint8_t>(byte << (8 - bitIndex)) >> 2;
+            if (pendingSize != pending.size())
+                return;
 
-            bitIndex += 2;
+            EncodeGroups(pending);
+            pendingSize = 0;
+        }
 
-            if (bitIndex == 8)
-            {
-                stream << detail::base64Table[encodedByte];
-                ++size;
-                encodedByte = 0;
-                bitIndex = 2;
-            }
+        EncodeGroups(infra::Head(data, data.size() - data.size() % 3));
+
+        data = infra::DiscardHead(data, data.size() - data.size() % 3);
+        std::copy(data.begin(), data.end(), pending.begin());
+        pendingSize = static_cast<uint8_t>(data.size());
+    }
+
+    void Base64Encoder::EncodeGroups(infra::ConstByteRange data)
+    {
+        std::array<char, chunkSize / 3 * 4> encoded;
+
+        while (!data.empty())
+        {
+            auto chunk = infra::Head(data, chunkSize);
+            EncodeBase64Groups(chunk, encoded);
+            stream << BoundedConstString(encoded.data(), chunk.size() / 3 * 4);
+            data = infra::DiscardHead(data, chunk.size());
         }
     }
 
@@ -7,6 +7,7 @@
 #include "infra/util/ByteRange.hpp"
 #include "infra/util/Function.hpp"
 #include "infra/util/IntegerNormalization.hpp"
+#include <array>
 #include <type_traits>
 
 namespace infra
@@ -271,6 +272,9 @@ namespace infra
         infra::ConstByteRange data;
     };
 
+    // Encodes data chunk by chunk while it is passed to Encode, so that the complete input never has to be
+    // present in memory. Bytes that do not complete a group of three are kept until the next call to Encode,
+    // the encoding is finished with padding upon destruction.
     class Base64Encoder
     {
     public:
@@ -280,10 +284,14 @@ namespace infra
         void Encode(infra::ConstByteRange data);
 
     private:
+        void EncodeGroups(infra::ConstByteRange data);
+
+    private:
+        static constexpr std::size_t chunkSize = 96;
+
         infra::TextOutputStream& stream;
-        uint8_t bitIndex = 2;
-        uint8_t encodedByte = 0;
-        uint32_t size = 0;
+        std::array<uint8_t, 3> pending;
+        uint8_t pendingSize = 0;
     };
 
     class AsBase64Helper
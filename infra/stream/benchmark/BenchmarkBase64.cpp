@@ -0,0 +1,48 @@
+#include "infra/stream/InputStream.hpp"
+#include "infra/stream/OutputStream.hpp"
+#include "infra/stream/StringInputStream.hpp"
+#include "infra/stream/StringOutputStream.hpp"
+#include <benchmark/benchmark.h>
+#include <numeric>
+#include <vector>
+
+namespace
+{
+    constexpr std::size_t maxEncodedSize = 8192;
+
+    void Base64Encode(benchmark::State& state)
+    {
+        std::vector<uint8_t> data(static_cast<std::size_t>(state.range(0)));
+        std::iota(data.begin(), data.end(), 0);
+        infra::StringOutputStream::WithStorage<maxEncodedSize> stream;
+
+        for (auto _ : state)
+        {
+            stream << infra::AsBase64(infra::MakeRange(data));
+            benchmark::DoNotOptimize(stream.Storage().data());
+            stream.Storage().clear();
+        }
+
+        state.SetBytesProcessed(state.iterations() * state.range(0));
+    }
+
+    void Base64Decode(benchmark::State& state)
+    {
+        std::vector<uint8_t> data(static_cast<std::size_t>(state.range(0)));
+        std::iota(data.begin(), data.end(), 0);
+        infra::StringOutputStream::WithStorage<maxEncodedSize> encoded;
+        encoded << infra::AsBase64(infra::MakeRange(data));
+
+        for (auto _ : state)
+        {
+            infra::StringInputStream stream(encoded.Storage());
+            stream >> infra::FromBase64(infra::MakeRange(data));
+            benchmark::DoNotOptimize(data.data());
+        }
+
+        state.SetBytesProcessed(state.iterations() * state.range(0));
+    }
+}
+
+BENCHMARK(Base64Encode)->Arg(48)->Arg(3072);
+BENCHMARK(Base64Decode)->Arg(48)->Arg(3072);
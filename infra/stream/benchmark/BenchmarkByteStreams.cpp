@@ -0,0 +1,83 @@
+#include "infra/stream/ByteInputStream.hpp"
+#include "infra/stream/ByteOutputStream.hpp"
+#include <benchmark/benchmark.h>
+#include <vector>
+
+namespace
+{
+    void ByteOutputStreamWriteWords(benchmark::State& state)
+    {
+        std::vector<uint8_t> storage(static_cast<std::size_t>(state.range(0)) * sizeof(uint32_t));
+        infra::ByteOutputStream stream(infra::MakeRange(storage));
+
+        for (auto _ : state)
+        {
+            for (int64_t i = 0; i != state.range(0); ++i)
+                stream << static_cast<uint32_t>(i);
+
+            benchmark::DoNotOptimize(storage.data());
+            stream.Writer().Reset();
+        }
+
+        state.SetBytesProcessed(state.iterations() * state.range(0) * sizeof(uint32_t));
+    }
+
+    void ByteOutputStreamWriteRange(benchmark::State& state)
+    {
+        std::vector<uint8_t> storage(static_cast<std::size_t>(state.range(0)));
+        std::vector<uint8_t> data(storage.size(), 0x5a);
+        infra::ByteOutputStream stream(infra::MakeRange(storage));
+
+        for (auto _ : state)
+        {
+            stream << infra::MakeRange(data);
+            benchmark::DoNotOptimize(storage.data());
+            stream.Writer().Reset();
+        }
+
+        state.SetBytesProcessed(state.iterations() * state.range(0));
+    }
+
+    void ByteInputStreamReadWords(benchmark::State& state)
+    {
+        std::vector<uint8_t> storage(static_cast<std::size_t>(state.range(0)) * sizeof(uint32_t), 0x5a);
+        infra::ByteInputStream stream(infra::MakeRange(storage));
+
+        for (auto _ : state)
+        {
+            uint32_t sum = 0;
+            for (int64_t i = 0; i != state.range(0); ++i)
+            {
+                uint32_t value;
+                stream >> value;
+                sum += value;
+            }
+
+            benchmark::DoNotOptimize(sum);
+            stream.Reader().Rewind(0);
+        }
+
+        state.SetBytesProcessed(state.iterations() * state.range(0) * sizeof(uint32_t));
+    }
+
+    void ByteInputStreamReadRange(benchmark::State& state)
+    {
+        std::vector<uint8_t> storage(static_cast<std::size_t>(state.range(0)), 0x5a);
+        std::vector<uint8_t> destination(storage.size());
+        infra::ByteInputStream stream(infra::MakeRange(storage));
+
+        for (auto _ : state)
+        {
+            stream >> infra::MakeRange(destination);
+            benchmark::DoNotOptimize(destination.data());
+            stream.Reader().Rewind(0);
+        }
+
+        state.SetBytesProcessed(state.iterations() * state.range(0));
+    }
+}
+
+BENCHMARK(ByteOutputStreamWriteWords)->Arg(16)->Arg(1024);
+BENCHMARK(ByteOutputStreamWriteRange)->Arg(64)->Arg(4096);
+BENCHMARK(ByteInputStreamReadWords)->Arg(16)->Arg(1024);
+BENCHMARK(ByteInputStreamReadRange)->Arg(64)->Arg(4096);
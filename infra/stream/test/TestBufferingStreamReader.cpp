@@ -121,6 +121,18 @@ TEST_F(BufferingStreamReaderTest, PeekContiguous_range_from_input)
     EXPECT_EQ((std::array<uint8_t, 2>{ 3, 4 }), reader.PeekContiguousRange(2));
 }
 
+TEST_F(BufferingStreamReaderTest, PeekContiguous_range_from_input_after_extracting_from_input)
+{
+    std::array<uint8_t, 3> data;
+    std::array<uint8_t, 1> extracted{ 3 };
+    EXPECT_CALL(input, ExtractContiguousRange(1)).WillOnce(testing::Return(infra::MakeRange(extracted)));
+    reader.Extract(data, errorPolicy);
+
+    std::array<uint8_t, 1> inputData{ 4 };
+    EXPECT_CALL(input, PeekContiguousRange(0)).WillOnce(testing::Return(infra::MakeRange(inputData)));
+    EXPECT_EQ((std::array<uint8_t, 1>{ 4 }), reader.PeekContiguousRange(0));
+}
+
 TEST_F(BufferingStreamReaderTest, Peek_from_buffer)
 {
     EXPECT_EQ(1, reader.Peek(errorPolicy));
@@ -170,7 +182,7 @@ TEST_F(BufferingStreamReaderTest, Rewind_from_input_to_input)
     EXPECT_CALL(input, Rewind(99));
     reader.Rewind(3);
     std::array<uint8_t, 1> inputData2{ 4 };
-    EXPECT_CALL(input, PeekContiguousRange(1)).WillOnce(testing::Invoke([&](std::size_t start)
+    EXPECT_CALL(input, PeekContiguousRange(0)).WillOnce(testing::Invoke([&](std::size_t start)
         {
             return infra::MakeRange(inputData2);
         }));
@@ -158,6 +158,27 @@ TEST(StringInputStreamTest, FromBase64_with_two_pads)
     EXPECT_TRUE(stream.Empty());
 }
 
+TEST(StringInputStreamTest, FromBase64_with_long_input)
+{
+    infra::StringInputStream stream(infra::BoundedConstString("VGhlIHF1aWNrIGJyb3duIGZveCBqdW1wcyBvdmVyIHRoZSBsYXp5IGRvZy4gVGhlIHF1aWNrIGJyb3duIGZveCBqdW1wcyBvdmVyIHRoZSBsYXp5IGRvZy4gVGhlIHF1aWNrIGJyb3duIGZveCBqdW1wcyBvdmVyIHRoZSBsYXp5IGRvZy4="));
+
+    infra::BoundedString::WithStorage<134> output(134, ' ');
+    stream >> infra::FromBase64(infra::StringAsByteRange(output));
+
+    EXPECT_EQ("The quick brown fox jumps over the lazy dog. The quick brown fox jumps over the lazy dog. The quick brown fox jumps over the lazy dog.", output);
+    EXPECT_TRUE(stream.Empty());
+}
+
+TEST(StringInputStreamTest, FromBase64_with_invalid_character_in_long_input_reports_error)
+{
+    infra::StringInputStream stream(infra::BoundedConstString("VGhlIHF1aWNrIGJyb3duIGZveCBqdW1wcyBvdmVyIHRo!SBsYXp5IGRvZy4="), infra::softFail);
+
+    std::array<uint8_t, 43> output;
+    stream >> infra::FromBase64(output);
+
+    EXPECT_TRUE(stream.ErrorPolicy().Failed());
+}
+
 TEST(StringInputStreamTest, FromBase64_with_insufficient_input_reports_error)
 {
     infra::StringInputStream stream(infra::BoundedConstString("YWJ"), infra::softFail);
@@ -494,6 +494,35 @@ TEST(StringOutputStreamTest, stream_byte_range_as_combined_base64)
     EXPECT_EQ("YQ==", stream5.Storage());
 }
 
+TEST(StringOutputStreamTest, stream_long_byte_range_as_base64)
+{
+    infra::BoundedConstString text("The quick brown fox jumps over the lazy dog. The quick brown fox jumps over the lazy dog. The quick brown fox jumps over the lazy dog.");
+
+    infra::StringOutputStream::WithStorage<256> stream;
+    stream << infra::AsBase64(infra::StringAsByteRange(text));
+    EXPECT_EQ("VGhlIHF1aWNrIGJyb3duIGZveCBqdW1wcyBvdmVyIHRoZSBsYXp5IGRvZy4gVGhlIHF1aWNrIGJyb3duIGZveCBqdW1wcyBvdmVyIHRoZSBsYXp5IGRvZy4gVGhlIHF1aWNrIGJyb3duIGZveCBqdW1wcyBvdmVyIHRoZSBsYXp5IGRvZy4=", stream.Storage());
+}
+
+TEST(StringOutputStreamTest, Base64Encoder_encodes_chunk_by_chunk)
+{
+    infra::BoundedConstString text("The quick brown fox jumps over the lazy dog. The quick brown fox jumps over the lazy dog. The quick brown fox jumps over the lazy dog.");
+    auto data = infra::StringAsByteRange(text);
+
+    infra::StringOutputStream::WithStorage<256> stream;
+
+    {
+        infra::Base64Encoder encoder(stream);
+
+        for (std::size_t chunkSize = 1; !data.empty(); ++chunkSize)
+        {
+            encoder.Encode(infra::Head(data, chunkSize));
+            data = infra::DiscardHead(data, chunkSize);
+        }
+    }
+
+    EXPECT_EQ("VGhlIHF1aWNrIGJyb3duIGZveCBqdW1wcyBvdmVyIHRoZSBsYXp5IGRvZy4gVGhlIHF1aWNrIGJyb3duIGZveCBqdW1wcyBvdmVyIHRoZSBsYXp5IGRvZy4gVGhlIHF1aWNrIGJyb3duIGZveCBqdW1wcyBvdmVyIHRoZSBsYXp5IGRvZy4=", stream.Storage());
+}
+
 TEST(StringOutputStreamTest, reserve_type)
 {
     infra::StringOutputStream::WithStorage<64> stream;
@@ -35,6 +35,83 @@ namespace
     }
 
     constexpr std::size_t nanoValueWidth = 9;
+
+    infra::JsonValue ReadInteger(const infra::JsonBiggerInt& value)
+    {
+        if ((!value.Negative() && value.Value() <= std::numeric_limits<int32_t>::max()) || (value.Negative() && value.Value() <= static_cast<uint64_t>(-static_cast<int64_t>(std::numeric_limits<int32_t>::min()))))
+            return infra::JsonValue(static_cast<int32_t>(value.Value() * (value.Negative() ? -1 : 1)));
+        else
+            return infra::JsonValue(value);
+    }
+
+    infra::JsonValue ReadIndexedValue(infra::BoundedConstString value)
+    {
+        infra::JsonTokenizer tokenizer(value);
+
+        const infra::Overloaded visitor{
+            [](const infra::JsonToken::String& token) -> infra::JsonValue
+            {
+                return token.Value();
+            },
+            [](const infra::JsonBiggerInt& token)
+            {
+                return ReadInteger(token);
+            },
+            [](const infra::JsonFloat& token) -> infra::JsonValue
+            {
+                return token;
+            },
+            [](const infra::JsonToken::Boolean& token) -> infra::JsonValue
+            {
+                return token.Value();
+            },
+            [value](const infra::JsonToken::LeftBrace&) -> infra::JsonValue
+            {
+                return infra::JsonObject(value);
+            },
+            [value](const infra::JsonToken::LeftBracket&) -> infra::JsonValue
+            {
+                return infra::JsonArray(value);
+            },
+            [](auto) -> infra::JsonValue
+            {
+                return infra::JsonObject();
+            },
+        };
+
+        return std::visit(visitor, tokenizer.Token());
+    }
+
+    std::optional<infra::BoundedConstString> ReadIndexableValue(infra::JsonTokenizer& tokenizer, infra::BoundedConstString objectString)
+    {
+        auto start = tokenizer.ParseIndex();
+        auto token = tokenizer.Token();
+
+        if (std::holds_alternative<infra::JsonToken::LeftBrace>(token) || std::holds_alternative<infra::JsonToken::LeftBracket>(token))
+        {
+            start = std::holds_alternative<infra::JsonToken::LeftBrace>(token) ? std::get<infra::JsonToken::LeftBrace>(token).Index() : std::get<infra::JsonToken::LeftBracket>(token).Index();
+            std::size_t nested = 1;
+
+            while (nested != 0)
+            {
+                token = tokenizer.Token();
+
+                if (std::holds_alternative<infra::JsonToken::LeftBrace>(token) || std::holds_alternative<infra::JsonToken::LeftBracket>(token))
+                    ++nested;
+                else if (std::holds_alternative<infra::JsonToken::RightBrace>(token) || std::holds_alternative<infra::JsonToken::RightBracket>(token))
+                    --nested;
+                else if (std::holds_alternative<infra::JsonToken::End>(token) || std::holds_alternative<infra::JsonToken::Error>(token))
+                    return std::nullopt;
+            }
+
+            if (objectString[start] == '{' ? !std::holds_alternative<infra::JsonToken::RightBrace>(token) : !std::holds_alternative<infra::JsonToken::RightBracket>(token))
+                return std::nullopt;
+        }
+        else if (!std::holds_alternative<infra::JsonToken::String>(token) && !std::holds_alternative<infra::JsonBiggerInt>(token) && !std::holds_alternative<infra::JsonFloat>(token) && !std::holds_alternative<infra::JsonToken::Boolean>(token) && !std::holds_alternative<infra::JsonToken::Null>(token))
+            return std::nullopt;
+
+        return objectString.substr(start, tokenizer.ParseIndex() - start);
+    }
 }
 
 namespace infra
@@ -573,6 +650,11 @@ namespace infra
         }
     }
 
+    std::size_t JsonTokenizer::ParseIndex() const
+    {
+        return parseIndex;
+    }
+
     bool JsonTokenizer::operator==(const JsonTokenizer& other) const
     {
         return parseIndex == other.parseIndex;
@@ -676,10 +758,128 @@ namespace infra
         return JsonFloat(integer, fractionalValue, sign);
     }
 
+    JsonObjectIndex::JsonObjectIndex(infra::MemoryRange<Member> storage)
+        : storage(storage)
+    {}
+
+    bool JsonObjectIndex::Build(infra::BoundedConstString objectString)
+    {
+        size = 0;
+
+        JsonTokenizer tokenizer(objectString);
+        if (!std::holds_alternative<JsonToken::LeftBrace>(tokenizer.Token()))
+            return false;
+
+        auto token = tokenizer.Token();
+        if (!std::holds_alternative<JsonToken::RightBrace>(token))
+            while (true)
+            {
+                if (!std::holds_alternative<JsonToken::String>(token) || size == storage.size())
+                    return false;
+
+                auto key = std::get<JsonToken::String>(token).RawValue();
+                if (key.find('\\') != infra::BoundedConstString::npos)
+                    return false;
+
+                if (!std::holds_alternative<JsonToken::Colon>(tokenizer.Token()))
+                    return false;
+
+                auto value = ReadIndexableValue(tokenizer, objectString);
+                if (!value)
+                    return false;
+
+                storage[size++] = Member{ key, *value };
+
+                token = tokenizer.Token();
+                if (std::holds_alternative<JsonToken::RightBrace>(token))
+                    break;
+                if (!std::holds_alternative<JsonToken::Comma>(token))
+                    return false;
+
+                token = tokenizer.Token();
+            }
+
+        // Members with equal keys keep the order in which they appear in the object
+        std::sort(storage.begin(), storage.begin() + size, [](const Member& x, const Member& y)
+            {
+                return x.key < y.key || (x.key == y.key && x.value.begin() < y.value.begin());
+            });
+
+        return true;
+    }
+
+    std::size_t JsonObjectIndex::Size() const
+    {
+        return size;
+    }
+
+    infra::MemoryRange<const JsonObjectIndex::Member> JsonObjectIndex::Find(infra::BoundedConstString key) const
+    {
+        auto range = std::equal_range(storage.begin(), storage.begin() + size, Member{ key, {} }, [](const Member& x, const Member& y)
+            {
+                return x.key < y.key;
+            });
+
+        return infra::MemoryRange<const Member>(range.first, range.second);
+    }
+
+    JsonArrayIndex::JsonArrayIndex(infra::MemoryRange<infra::BoundedConstString> storage)
+        : storage(storage)
+    {}
+
+    bool JsonArrayIndex::Build(infra::BoundedConstString arrayString)
+    {
+        size = 0;
+
+        JsonTokenizer tokenizer(arrayString);
+        if (!std::holds_alternative<JsonToken::LeftBracket>(tokenizer.Token()))
+            return false;
+
+        auto emptyArrayTokenizer = tokenizer;
+        if (std::holds_alternative<JsonToken::RightBracket>(emptyArrayTokenizer.Token()))
+            return true;
+
+        while (true)
+        {
+            if (size == storage.size())
+                return false;
+
+            auto value = ReadIndexableValue(tokenizer, arrayString);
+            if (!value)
+                return false;
+
+            storage[size++] = *value;
+
+            auto token = tokenizer.Token();
+            if (std::holds_alternative<JsonToken::RightBracket>(token))
+                return true;
+            if (!std::holds_alternative<JsonToken::Comma>(token))
+                return false;
+        }
+    }
+
+    std::size_t JsonArrayIndex::Size() const
+    {
+        return size;
+    }
+
+    infra::BoundedConstString JsonArrayIndex::operator[](std::size_t position) const
+    {
+        assert(position < size);
+        return storage[position];
+    }
+
     JsonObject::JsonObject(infra::BoundedConstString objectString)
         : objectString(objectString)
     {}
 
+    JsonObject::JsonObject(infra::BoundedConstString objectString, JsonObjectIndex& index)
+        : objectString(objectString)
+    {
+        if (index.Build(objectString))
+            this->index = &index;
+    }
+
     infra::BoundedConstString JsonObject::ObjectString() const
     {
         return objectString;
@@ -697,6 +897,9 @@ namespace infra
 
     bool JsonObject::HasKey(infra::BoundedConstString key)
     {
+        if (index != nullptr)
+            return !index->Find(key).empty();
+
         return std::any_of(begin(), end(), [key](const auto& keyValue)
             {
                 return keyValue.key == key;
@@ -735,6 +938,16 @@ namespace infra
 
     JsonValue JsonObject::GetValue(infra::BoundedConstString key)
     {
+        if (index != nullptr)
+        {
+            auto members = index->Find(key);
+            if (!members.empty())
+                return ReadIndexedValue(members.front().value);
+
+            SetError();
+            return JsonValue();
+        }
+
         for (const auto& keyValue : *this)
         {
             if (keyValue.key == key)
@@ -802,6 +1015,19 @@ namespace infra
     template<class T>
     T JsonObject::GetValue(infra::BoundedConstString key)
     {
+        if (index != nullptr)
+        {
+            for (auto& member : index->Find(key))
+            {
+                auto value = ReadIndexedValue(member.value);
+                if (std::holds_alternative<T>(value))
+                    return std::get<T>(value);
+            }
+
+            SetError();
+            return T();
+        }
+
         for (auto& keyValue : *this)
         {
             if (keyValue.key == key && std::holds_alternative<T>(keyValue.value))
@@ -815,6 +1041,18 @@ namespace infra
     template<class T>
     std::optional<T> JsonObject::GetOptionalValue(infra::BoundedConstString key)
     {
+        if (index != nullptr)
+        {
+            for (auto& member : index->Find(key))
+            {
+                auto value = ReadIndexedValue(member.value);
+                if (std::holds_alternative<T>(value))
+                    return std::make_optional(std::get<T>(value));
+            }
+
+            return std::nullopt;
+        }
+
         for (auto& keyValue : *this)
         {
             if (keyValue.key == key && std::holds_alternative<T>(keyValue.value))
@@ -824,10 +1062,28 @@ namespace infra
         return std::nullopt;
     }
 
+    template<class T>
+    T JsonArray::GetValue(std::size_t position)
+    {
+        auto value = GetValue(position);
+        if (std::holds_alternative<T>(value))
+            return std::get<T>(value);
+
+        SetError();
+        return T();
+    }
+
     JsonArray::JsonArray(infra::BoundedConstString objectString)
         : objectString(objectString)
     {}
 
+    JsonArray::JsonArray(infra::BoundedConstString objectString, JsonArrayIndex& index)
+        : objectString(objectString)
+    {
+        if (index.Build(objectString))
+            this->index = &index;
+    }
+
     infra::BoundedConstString JsonArray::ObjectString() const
     {
         return objectString;
@@ -853,6 +1109,67 @@ namespace infra
         return JsonArrayIterator();
     }
 
+    std::size_t JsonArray::Size()
+    {
+        if (index != nullptr)
+            return index->Size();
+
+        return std::distance(begin(), end());
+    }
+
+    JsonString JsonArray::GetString(std::size_t position)
+    {
+        return GetValue<JsonString>(position);
+    }
+
+    JsonFloat JsonArray::GetFloat(std::size_t position)
+    {
+        return GetValue<JsonFloat>(position);
+    }
+
+    bool JsonArray::GetBoolean(std::size_t position)
+    {
+        return GetValue<bool>(position);
+    }
+
+    int32_t JsonArray::GetInteger(std::size_t position)
+    {
+        return GetValue<int32_t>(position);
+    }
+
+    JsonObject JsonArray::GetObject(std::size_t position)
+    {
+        return GetValue<JsonObject>(position);
+    }
+
+    JsonArray JsonArray::GetArray(std::size_t position)
+    {
+        return GetValue<JsonArray>(position);
+    }
+
+    JsonValue JsonArray::GetValue(std::size_t position)
+    {
+        if (index != nullptr)
+        {
+            if (position < index->Size())
+                return ReadIndexedValue((*index)[position]);
+
+            SetError();
+            return JsonValue();
+        }
+
+        for (const auto& value : *this)
+        {
+            if (position == 0)
+                return value;
+
+            --position;
+        }
+
+        SetError();
+        return JsonValue();
+    }
+
     bool JsonArray::operator==(const JsonArray& other) const
     {
         JsonArray left(*this);
@@ -924,10 +1241,7 @@ namespace infra
 
     std::optional<JsonValue> JsonIterator::ReadInteger(const JsonToken::Token& token)
     {
-        if ((!std::get<JsonBiggerInt>(token).Negative() && std::get<JsonBiggerInt>(token).Value() <= std::numeric_limits<int32_t>::max()) || (std::get<JsonBiggerInt>(token).Negative() && std::get<JsonBiggerInt>(token).Value() <= static_cast<uint64_t>(-static_cast<int64_t>(std::numeric_limits<int32_t>::min()))))
-            return std::make_optional(JsonValue(static_cast<int32_t>(std::get<JsonBiggerInt>(token).Value() * (std::get<JsonBiggerInt>(token).Negative() ? -1 : 1))));
-        else
-            return std::make_optional(JsonValue(std::get<JsonBiggerInt>(token)));
+        return std::make_optional(::ReadInteger(std::get<JsonBiggerInt>(token)));
     }
 
     std::optional<JsonValue> JsonIterator::ReadObjectValue(const JsonToken::Token& token)
@@ -5,6 +5,8 @@
 #include "infra/util/BoundedString.hpp"
 #include "infra/util/Compatibility.hpp"
 #include "infra/util/ReverseRange.hpp"
+#include "infra/util/WithStorage.hpp"
+#include <array>
 #include <cstdint>
 #include <optional>
 #include <variant>
@@ -251,6 +253,7 @@ namespace infra
         explicit JsonTokenizer(infra::BoundedConstString objectString);
 
         JsonToken::Token Token();
+        std::size_t ParseIndex() const;
 
         bool operator==(const JsonTokenizer& other) const;
         bool operator!=(const JsonTokenizer& other) const;
@@ -274,11 +277,71 @@ namespace infra
 
     using JsonValue = std::variant<bool, int32_t, JsonBiggerInt, JsonString, JsonFloat, JsonObject, JsonArray>;
 
+    // Structural index of the members of a JSON object, built in a single pass over the object string. Each member
+    // refers to its key and its value in place, nested objects and arrays are skipped while building, and members are
+    // kept sorted on key so that a lookup is a binary search instead of tokenizing the object again.
+    // Building fails when the object is malformed, when it has more members than fit in storage, or when a key
+    // contains escape sequences; a JsonObject then falls back to searching the object string.
+    class JsonObjectIndex
+    {
+    public:
+        struct Member
+        {
+            infra::BoundedConstString key;
+            infra::BoundedConstString value;
+        };
+
+        template<std::size_t Max>
+        using WithMaxMembers = infra::WithStorage<JsonObjectIndex, std::array<Member, Max>>;
+
+        explicit JsonObjectIndex(infra::MemoryRange<Member> storage);
+        JsonObjectIndex(const JsonObjectIndex& other) = delete;
+        JsonObjectIndex& operator=(const JsonObjectIndex& other) = delete;
+
+        bool Build(infra::BoundedConstString objectString);
+
+        std::size_t Size() const;
+
+        // Returns all members with key, in the order in which they appear in the object
+        infra::MemoryRange<const Member> Find(infra::BoundedConstString key) const;
+
+    private:
+        infra::MemoryRange<Member> storage;
+        std::size_t size = 0;
+    };
+
+    // Structural index of the elements of a JSON array, built in a single pass over the array string. Each element
+    // refers to its value in place, and nested objects and arrays are skipped while building, so that an element is
+    // accessed by its position instead of by iterating the array again.
+    // Building fails when the array is malformed or when it has more elements than fit in storage; a JsonArray then
+    // falls back to iterating the array string.
+    class JsonArrayIndex
+    {
+    public:
+        template<std::size_t Max>
+        using WithMaxElements = infra::WithStorage<JsonArrayIndex, std::array<infra::BoundedConstString, Max>>;
+
+        explicit JsonArrayIndex(infra::MemoryRange<infra::BoundedConstString> storage);
+        JsonArrayIndex(const JsonArrayIndex& other) = delete;
+        JsonArrayIndex& operator=(const JsonArrayIndex& other) = delete;
+
+        bool Build(infra::BoundedConstString arrayString);
+
+        std::size_t Size() const;
+        infra::BoundedConstString operator[](std::size_t position) const;
+
+    private:
+        infra::MemoryRange<infra::BoundedConstString> storage;
+        std::size_t size = 0;
+    };
+
     class JsonObject
     {
     public:
         JsonObject() = default;
         explicit JsonObject(infra::BoundedConstString objectString);
+        // Builds index over objectString; when that fails, lookups search the object string as usual
+        JsonObject(infra::BoundedConstString objectString, JsonObjectIndex& index);
 
         infra::BoundedConstString ObjectString() const;
 
@@ -323,6 +386,7 @@ namespace infra
 
     private:
         infra::BoundedConstString objectString;
+        JsonObjectIndex* index = nullptr;
         bool error = false;
     };
 
@@ -331,12 +395,24 @@ namespace infra
     public:
         JsonArray() = default;
         explicit JsonArray(infra::BoundedConstString objectString);
+        // Builds index over objectString; when that fails, elements are accessed by iterating the array string
+        JsonArray(infra::BoundedConstString objectString, JsonArrayIndex& index);
 
         infra::BoundedConstString ObjectString() const;
 
         JsonArrayIterator begin();
         JsonArrayIterator end();
 
+        std::size_t Size();
+
+        JsonString GetString(std::size_t position);
+        JsonFloat GetFloat(std::size_t position);
+        bool GetBoolean(std::size_t position);
+        int32_t GetInteger(std::size_t position);
+        JsonObject GetObject(std::size_t position);
+        JsonArray GetArray(std::size_t position);
+        JsonValue GetValue(std::size_t position);
+
         bool operator==(const JsonArray& other) const;
         bool operator!=(const JsonArray& other) const;
 
@@ -344,8 +420,13 @@ namespace infra
         void SetError();
         bool Error() const;
 
+    private:
+        template<class T>
+        T GetValue(std::size_t position);
+
     private:
         infra::BoundedConstString objectString{ "[]" };
+        JsonArrayIndex* index = nullptr;
         bool error = false;
     };
 
@@ -1,8 +1,90 @@
 #include "infra/syntax/JsonStreamingParser.hpp"
 #include "infra/util/Function.hpp"
+#include <algorithm>
 #include <cctype>
 #include <optional>
 
+#if defined(__SSE2__)
+#include <emmintrin.h>
+#endif
+
+namespace
+{
+    bool IsWhitespace(char c)
+    {
+        return c == ' ' || (c >= '\t' && c <= '\r');
+    }
+
+#if defined(__SSE2__)
+    // Scans 16 characters at a time, and returns the offset of the first character for which
+    // match is set in the mask of the block, or the offset from which less than 16 characters remain
+    template<class Match>
+    std::size_t ScanBlocks(infra::MemoryRange<const char> data, Match match)
+    {
+        std::size_t offset = 0;
+
+        for (; data.size() - offset >= 16; offset += 16)
+        {
+            auto mask = _mm_movemask_epi8(match(_mm_loadu_si128(reinterpret_cast<const __m128i*>(data.begin() + offset))));
+
+            if (mask != 0)
+                return offset + __builtin_ctz(static_cast<unsigned int>(mask));
+        }
+
+        return offset;
+    }
+
+    std::size_t ScanStringContentBlocks(infra::MemoryRange<const char> data)
+    {
+        return ScanBlocks(data, [](__m128i block)
+            {
+                return _mm_or_si128(_mm_cmpeq_epi8(block, _mm_set1_epi8('"')), _mm_cmpeq_epi8(block, _mm_set1_epi8('\\')));
+            });
+    }
+
+    std::size_t ScanWhitespaceBlocks(infra::MemoryRange<const char> data)
+    {
+        return ScanBlocks(data, [](__m128i block)
+            {
+                // Characters '\t' up to '\r' are mapped to 0 up to 4, so that an unsigned minimum detects them
+                auto controlOffset = _mm_sub_epi8(block, _mm_set1_epi8('\t'));
+                auto isControl = _mm_cmpeq_epi8(_mm_min_epu8(controlOffset, _mm_set1_epi8(4)), controlOffset);
+                auto isSpace = _mm_cmpeq_epi8(block, _mm_set1_epi8(' '));
+                return _mm_xor_si128(_mm_or_si128(isControl, isSpace), _mm_set1_epi8(-1));
+            });
+    }
+#else
+    std::size_t ScanStringContentBlocks(infra::MemoryRange<const char> data)
+    {
+        return 0;
+    }
+
+    std::size_t ScanWhitespaceBlocks(infra::MemoryRange<const char> data)
+    {
+        return 0;
+    }
+#endif
+
+    // Returns the length of the string content at the start of data, up to a quote or backslash
+    std::size_t StringContentLength(infra::MemoryRange<const char> data)
+    {
+        auto begin = data.begin() + ScanStringContentBlocks(data);
+
+        return std::find_if(begin, data.end(), [](char c)
+                   {
+                       return c == '"' || c == '\\';
+                   }) -
+               data.begin();
+    }
+
+    std::size_t WhitespaceLength(infra::MemoryRange<const char> data)
+    {
+        auto begin = data.begin() + ScanWhitespaceBlocks(data);
+
+        return std::find_if_not(begin, data.end(), IsWhitespace) - data.begin();
+    }
+}
+
 namespace infra
 {
     void JsonObjectVisitor::VisitString(infra::BoundedConstString tag, infra::BoundedConstString value)
@@ -126,6 +208,8 @@ namespace infra
                 else
                     FoundToken(Token::number);
             }
+            else if (tokenState == TokenState::stringOpen || tokenState == TokenState::stringOverflowOpen)
+                FeedString(data, saveValue);
             else if (tokenState == TokenState::identifierOpen)
             {
                 if (std::isalpha(c))
@@ -149,11 +233,8 @@ namespace infra
                 switch (tokenState)
                 {
                     case TokenState::open:
-                        if (std::isspace(c))
-                        {
-                            while (!data.empty() && std::isspace(data.front()))
-                                data.pop_front();
-                        }
+                        if (IsWhitespace(c))
+                            data = infra::DiscardHead(data, WhitespaceLength(data));
                         else
                             switch (c)
                             {
@@ -199,24 +280,6 @@ namespace infra
                                         FoundToken(Token::error);
                             }
                         break;
-                    case TokenState::stringOpen:
-                    case TokenState::stringOverflowOpen:
-                        while (true)
-                        {
-                            if (c == '\\')
-                                tokenState = TokenState::stringOpenAndEscaped;
-                            else if (c == '"')
-                                FoundToken(tokenState == TokenState::stringOpen ? Token::string : Token::stringOverflow);
-                            else
-                                AddToValueBuffer(c, saveValue, true);
-
-                            if ((tokenState != TokenState::stringOpen && tokenState != TokenState::stringOverflowOpen) || data.empty())
-                                break;
-
-                            c = data.front();
-                            data.pop_front();
-                        }
-                        break;
                     case TokenState::stringOpenAndEscaped:
                         tokenState = TokenState::stringOpen;
                         ProcessEscapedData(c, saveValue);
@@ -263,6 +326,36 @@ namespace infra
         }
     }
 
+    void JsonSubParser::FeedString(infra::MemoryRange<const char>& data, bool saveValue)
+    {
+        auto content = infra::Head(data, StringContentLength(data));
+        data = infra::DiscardHead(data, content.size());
+
+        if (!content.empty())
+        {
+            if (saveValue)
+            {
+                auto size = std::min(content.size(), valueBuffer.max_size() - valueBuffer.size());
+                valueBuffer.append(content.begin(), size);
+
+                if (size != content.size())
+                    tokenState = TokenState::stringOverflowOpen;
+            }
+            else if (valueBuffer.full())
+                tokenState = TokenState::stringOverflowOpen;
+        }
+
+        if (!data.empty())
+        {
+            if (data.front() == '\\')
+                tokenState = TokenState::stringOpenAndEscaped;
+            else
+                FoundToken(tokenState == TokenState::stringOpen ? Token::string : Token::stringOverflow);
+
+            data.pop_front();
+        }
+    }
+
     void JsonSubParser::ReportParseError()
     {
         bool destructed = false;
@@ -121,6 +121,7 @@ namespace infra
 
     private:
         void FoundToken(Token found);
+        void FeedString(infra::MemoryRange<const char>& data, bool saveValue);
         void ProcessEscapedData(char c, bool saveValue);
         void AddToValueBuffer(char c, bool saveValue, bool inString);
 
@@ -3,6 +3,11 @@
 
 namespace infra
 {
+    namespace
+    {
+        constexpr std::size_t maxVarIntSize = 10;
+    }
+
     uint32_t MaxVarIntSize(uint64_t value)
     {
         uint32_t result = 1;
@@ -47,15 +52,9 @@ namespace infra
 
     void ProtoFormatter::PutVarInt(uint64_t value)
     {
-        do
-        {
-            if (value > 127)
-                output << static_cast<uint8_t>((value & 0x7f) | 0x80);
-            else
-                output << static_cast<uint8_t>(value);
-
-            value >>= 7;
-        } while (value != 0);
+        ProtoFieldBuffer::WithMaxSize<maxVarIntSize> buffer;
+        buffer.PutVarInt(value);
+        PutFields(buffer);
     }
 
     void ProtoFormatter::PutSignedVarInt(uint64_t value)
@@ -89,8 +88,9 @@ namespace infra
 
     void ProtoFormatter::PutVarIntField(uint64_t value, uint32_t fieldNumber)
     {
-        PutVarInt((fieldNumber << 3) | 0);
-        PutVarInt(value);
+        ProtoFieldBuffer::WithMaxSize<2 * maxVarIntSize> buffer;
+        buffer.PutVarIntField(value, fieldNumber);
+        PutFields(buffer);
     }
 
     void ProtoFormatter::PutSignedVarIntField(uint64_t value, uint32_t fieldNumber)
@@ -101,14 +101,16 @@ namespace infra
 
     void ProtoFormatter::PutFixed32Field(uint32_t value, uint32_t fieldNumber)
     {
-        PutVarInt((fieldNumber << 3) | 5);
-        PutFixed32(value);
+        ProtoFieldBuffer::WithMaxSize<maxVarIntSize + sizeof(uint32_t)> buffer;
+        buffer.PutFixed32Field(value, fieldNumber);
+        PutFields(buffer);
     }
 
     void ProtoFormatter::PutFixed64Field(uint64_t value, uint32_t fieldNumber)
     {
-        PutVarInt((fieldNumber << 3) | 1);
-        PutFixed64(value);
+        ProtoFieldBuffer::WithMaxSize<maxVarIntSize + sizeof(uint64_t)> buffer;
+        buffer.PutFixed64Field(value, fieldNumber);
+        PutFields(buffer);
     }
 
     void ProtoFormatter::PutLengthDelimitedField(infra::ConstByteRange range, uint32_t fieldNumber)
@@ -132,8 +134,15 @@ namespace infra
 
     void ProtoFormatter::PutLengthDelimitedSize(std::size_t size, uint32_t fieldNumber)
     {
-        PutVarInt((fieldNumber << 3) | 2);
-        PutVarInt(size);
+        ProtoFieldBuffer::WithMaxSize<2 * maxVarIntSize> buffer;
+        buffer.PutVarInt((fieldNumber << 3) | 2);
+        buffer.PutVarInt(size);
+        PutFields(buffer);
+    }
+
+    void ProtoFormatter::PutFields(const ProtoFieldBuffer& fields)
+    {
+        output << fields.Range();
     }
 
     ProtoLengthDelimitedFormatter ProtoFormatter::LengthDelimitedFormatter(uint32_t fieldNumber)
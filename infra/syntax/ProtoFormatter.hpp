@@ -3,6 +3,9 @@
 
 #include "infra/stream/OutputStream.hpp"
 #include "infra/util/BoundedVector.hpp"
+#include "infra/util/WithStorage.hpp"
+#include <array>
+#include <cstring>
 
 namespace infra
 {
@@ -25,6 +28,34 @@ namespace infra
         std::size_t marker;
     };
 
+    // Collects a run of fixed-size fields, so that they are written to the output in one go with a single
+    // bounds check. The storage must be large enough to hold the maximum encoded size of all fields put into it.
+    class ProtoFieldBuffer
+    {
+    public:
+        template<std::size_t Max>
+        using WithMaxSize = infra::WithStorage<ProtoFieldBuffer, std::array<uint8_t, Max>>;
+
+        explicit ProtoFieldBuffer(ByteRange storage);
+        ProtoFieldBuffer(const ProtoFieldBuffer& other) = delete;
+        ProtoFieldBuffer& operator=(const ProtoFieldBuffer& other) = delete;
+        ~ProtoFieldBuffer() = default;
+
+        void PutVarInt(uint64_t value);
+        void PutFixed32(uint32_t value);
+        void PutFixed64(uint64_t value);
+
+        void PutVarIntField(uint64_t value, uint32_t fieldNumber);
+        void PutFixed32Field(uint32_t value, uint32_t fieldNumber);
+        void PutFixed64Field(uint64_t value, uint32_t fieldNumber);
+
+        ConstByteRange Range() const;
+
+    private:
+        ByteRange storage;
+        std::size_t size = 0;
+    };
+
     class ProtoFormatter
     {
     public:
@@ -45,12 +76,69 @@ namespace infra
         void PutStringField(infra::BoundedConstString string, uint32_t fieldNumber);
         void PutBytesField(infra::ConstByteRange bytes, uint32_t fieldNumber);
         void PutLengthDelimitedSize(std::size_t size, uint32_t fieldNumber);
+        void PutFields(const ProtoFieldBuffer& fields);
         ProtoLengthDelimitedFormatter LengthDelimitedFormatter(uint32_t fieldNumber);
 
     private:
         friend class ProtoLengthDelimitedFormatter;
         infra::DataOutputStream output;
     };
+
+    ////    Implementation    ////
+
+    inline ProtoFieldBuffer::ProtoFieldBuffer(ByteRange storage)
+        : storage(storage)
+    {}
+
+    inline void ProtoFieldBuffer::PutVarInt(uint64_t value)
+    {
+        while (value > 127)
+        {
+            assert(size < storage.size());
+            storage[size++] = static_cast<uint8_t>((value & 0x7f) | 0x80);
+            value >>= 7;
+        }
+
+        assert(size < storage.size());
+        storage[size++] = static_cast<uint8_t>(value);
+    }
+
+    inline void ProtoFieldBuffer::PutFixed32(uint32_t value)
+    {
+        assert(size + sizeof(value) <= storage.size());
+        std::memcpy(storage.begin() + size, &value, sizeof(value));
+        size += sizeof(value);
+    }
+
+    inline void ProtoFieldBuffer::PutFixed64(uint64_t value)
+    {
+        assert(size + sizeof(value) <= storage.size());
+        std::memcpy(storage.begin() + size, &value, sizeof(value));
+        size += sizeof(value);
+    }
+
+    inline void ProtoFieldBuffer::PutVarIntField(uint64_t value, uint32_t fieldNumber)
+    {
+        PutVarInt((fieldNumber << 3) | 0);
+        PutVarInt(value);
+    }
+
+    inline void ProtoFieldBuffer::PutFixed32Field(uint32_t value, uint32_t fieldNumber)
+    {
+        PutVarInt((fieldNumber << 3) | 5);
+        PutFixed32(value);
+    }
+
+    inline void ProtoFieldBuffer::PutFixed64Field(uint64_t value, uint32_t fieldNumber)
+    {
+        PutVarInt((fieldNumber << 3) | 1);
+        PutFixed64(value);
+    }
+
+    inline ConstByteRange ProtoFieldBuffer::Range() const
+    {
+        return infra::Head(storage, size);
+    }
 }
 
 #endif
@@ -1,5 +1,6 @@
 #include "infra/syntax/ProtoParser.hpp"
 #include "infra/util/Overloaded.hpp"
+#include <algorithm>
 
 namespace infra
 {
@@ -88,6 +89,19 @@ namespace infra
 
     uint64_t ProtoParser::GetVarInt()
     {
+        // When the complete varint is available in contiguous memory, decode it in place instead of extracting it byte by byte
+        auto contiguous = infra::Head(input.PeekContiguousRange(), std::min<std::size_t>(input.Available(), 10));
+        for (std::size_t size = 0; size != contiguous.size(); ++size)
+            if ((contiguous[size] & 0x80) == 0)
+            {
+                uint64_t result = 0;
+                for (std::size_t i = 0; i <= size; ++i)
+                    result |= static_cast<uint64_t>(contiguous[i] & 0x7f) << (7 * i);
+
+                input.Consume(size + 1);
+                return result;
+            }
+
         uint64_t result = 0;
         uint8_t byte = 0;
         uint8_t shift = 0;
@@ -0,0 +1,77 @@
+#include "infra/syntax/Json.hpp"
+#include <benchmark/benchmark.h>
+#include <string>
+#include <vector>
+
+namespace
+{
+    constexpr std::size_t numberOfFields = 60;
+
+    std::string Key(std::size_t index)
+    {
+        return "field" + std::to_string(index);
+    }
+
+    std::string MakeObject()
+    {
+        std::string result = "{ ";
+
+        for (std::size_t i = 0; i != numberOfFields; ++i)
+        {
+            if (i != 0)
+                result += ", ";
+
+            result += "\"" + Key(i) + "\" : ";
+
+            if (i % 3 == 0)
+                result += std::to_string(i);
+            else if (i % 3 == 1)
+                result += "\"value" + std::to_string(i) + "\"";
+            else
+                result += "{ \"nested\" : [ 1, 2, 3 ], \"flag\" : true }";
+        }
+
+        return result + " }";
+    }
+
+    template<class Lookup>
+    void ReadAllFields(benchmark::State& state, Lookup lookup)
+    {
+        auto objectString = MakeObject();
+        std::vector<std::string> keys;
+
+        for (std::size_t i = 0; i != numberOfFields; ++i)
+            keys.push_back(Key(i));
+
+        for (auto _ : state)
+            lookup(infra::BoundedConstString(objectString.data(), objectString.size()), keys);
+
+        state.SetItemsProcessed(state.iterations() * numberOfFields);
+    }
+
+    void JsonObjectGetAllFields(benchmark::State& state)
+    {
+        ReadAllFields(state, [](infra::BoundedConstString objectString, const std::vector<std::string>& keys)
+            {
+                infra::JsonObject object(objectString);
+
+                for (auto& key : keys)
+                    benchmark::DoNotOptimize(object.GetValue(key));
+            });
+    }
+
+    void JsonObjectIndexedGetAllFields(benchmark::State& state)
+    {
+        ReadAllFields(state, [](infra::BoundedConstString objectString, const std::vector<std::string>& keys)
+            {
+                infra::JsonObjectIndex::WithMaxMembers<numberOfFields> index;
+                infra::JsonObject object(objectString, index);
+
+                for (auto& key : keys)
+                    benchmark::DoNotOptimize(object.GetValue(key));
+            });
+    }
+}
+
+BENCHMARK(JsonObjectGetAllFields);
+BENCHMARK(JsonObjectIndexedGetAllFields);
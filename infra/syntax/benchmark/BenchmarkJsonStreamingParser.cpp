@@ -0,0 +1,62 @@
+#include "infra/syntax/JsonStreamingParser.hpp"
+#include <benchmark/benchmark.h>
+#include <string>
+
+namespace
+{
+    class CountingObjectVisitor
+        : public infra::JsonObjectVisitor
+    {
+    public:
+        void VisitString(infra::BoundedConstString tag, infra::BoundedConstString value) override
+        {
+            size += value.size();
+        }
+
+        void VisitNumber(infra::BoundedConstString tag, int64_t value) override
+        {
+            size += static_cast<std::size_t>(value);
+        }
+
+        infra::JsonObjectVisitor* VisitObject(infra::BoundedConstString tag, infra::JsonSubObjectParser& parser) override
+        {
+            return this;
+        }
+
+        std::size_t size = 0;
+    };
+
+    std::string MakeDocument(std::size_t numberOfEntries, std::size_t descriptionSize)
+    {
+        std::string result = "{\n";
+
+        for (std::size_t i = 0; i != numberOfEntries; ++i)
+        {
+            result += "    \"entry" + std::to_string(i) + "\" : {\n";
+            result += "        \"name\" : \"component-" + std::to_string(i) + ".bin\",\n";
+            result += "        \"size\" : " + std::to_string(i * 4096) + ",\n";
+            result += "        \"description\" : \"" + std::string(descriptionSize / 2, 'x') + "\\n" + std::string(descriptionSize / 2, 'y') + "\"\n";
+            result += "    }";
+            result += i + 1 != numberOfEntries ? ",\n" : "\n";
+        }
+
+        return result + "}";
+    }
+
+    void JsonStreamingParserFeedDocument(benchmark::State& state)
+    {
+        auto document = MakeDocument(static_cast<std::size_t>(state.range(0)), static_cast<std::size_t>(state.range(1)));
+        CountingObjectVisitor visitor;
+
+        for (auto _ : state)
+        {
+            infra::JsonStreamingObjectParser::WithBuffers<32, 2048, 4> parser(visitor);
+            parser.Feed(infra::BoundedConstString(document.data(), document.size()));
+            benchmark::DoNotOptimize(visitor.size);
+        }
+
+        state.SetBytesProcessed(state.iterations() * document.size());
+    }
+}
+
+BENCHMARK(JsonStreamingParserFeedDocument)->Args({ 10, 200 })->Args({ 200, 200 })->Args({ 200, 2000 });
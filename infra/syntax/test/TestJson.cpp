@@ -884,6 +884,185 @@ TEST(JsonObjectTest, integer_conversion_signed_overflow)
     EXPECT_THAT(jsonObjectMax.Error(), testing::IsTrue());
 }
 
+TEST(JsonObjectIndexTest, build_indexes_members_sorted_on_key)
+{
+    infra::JsonObjectIndex::WithMaxMembers<4> index;
+
+    EXPECT_TRUE(index.Build(R"({ "b" : 1, "c" : { "x" : [ 1, { "y" : 2 } ] }, "a" : "value" })"));
+    EXPECT_EQ(3, index.Size());
+
+    auto member = index.Find("c");
+    ASSERT_EQ(1, member.size());
+    EXPECT_EQ(R"({ "x" : [ 1, { "y" : 2 } ] })", member.front().value);
+    EXPECT_TRUE(index.Find("x").empty());
+}
+
+TEST(JsonObjectIndexTest, build_fails_when_storage_is_exhausted)
+{
+    infra::JsonObjectIndex::WithMaxMembers<1> index;
+
+    EXPECT_FALSE(index.Build(R"({ "a" : 1, "b" : 2 })"));
+}
+
+TEST(JsonObjectIndexTest, build_fails_on_malformed_object)
+{
+    infra::JsonObjectIndex::WithMaxMembers<4> index;
+
+    EXPECT_FALSE(index.Build(R"({ "a" : 1 "b" : 2 })"));
+    EXPECT_FALSE(index.Build(R"({ "a" : { "b" : 2 ] })"));
+    EXPECT_FALSE(index.Build(R"({ "a" : [ 1, 2 })"));
+    EXPECT_FALSE(index.Build(R"({ "a" : })"));
+    EXPECT_FALSE(index.Build(R"([ 1 ])"));
+}
+
+TEST(JsonObjectIndexTest, build_fails_on_escaped_key)
+{
+    infra::JsonObjectIndex::WithMaxMembers<4> index;
+
+    EXPECT_FALSE(index.Build(R"({ "a\"b" : 1 })"));
+}
+
+TEST(JsonObjectIndexTest, duplicate_keys_are_found_in_order_of_appearance)
+{
+    infra::JsonObjectIndex::WithMaxMembers<4> index;
+
+    EXPECT_TRUE(index.Build(R"({ "a" : 1, "b" : 2, "a" : 3 })"));
+
+    auto members = index.Find("a");
+    ASSERT_EQ(2, members.size());
+    EXPECT_EQ(" 1", members[0].value);
+    EXPECT_EQ(" 3", members[1].value);
+}
+
+TEST(JsonObjectIndexTest, indexed_object_gets_values)
+{
+    infra::JsonObjectIndex::WithMaxMembers<8> index;
+    infra::JsonObject object(R"({ "string" : "value", "boolean" : true, "integer" : -5, "big" : 5000000000, "float" : 1.5, "object" : { "nested" : true }, "array" : [ 1 ], "null" : null })", index);
+
+    EXPECT_EQ("value", object.GetString("string"));
+    EXPECT_EQ(true, object.GetBoolean("boolean"));
+    EXPECT_EQ(-5, object.GetInteger("integer"));
+    EXPECT_EQ(5000000000, object.GetIntegerAs<int64_t>("big"));
+    EXPECT_EQ(infra::JsonFloat(1, 500000000, false), object.GetFloat("float"));
+    EXPECT_EQ(true, object.GetObject("object").GetBoolean("nested"));
+    EXPECT_EQ(R"([ 1 ])", object.GetArray("array").ObjectString());
+    EXPECT_EQ(infra::BoundedConstString(), object.GetObject("null").ObjectString());
+    EXPECT_TRUE(object.HasKey("null"));
+    EXPECT_FALSE(object.HasKey("absent"));
+    EXPECT_FALSE(object.Error());
+}
+
+TEST(JsonObjectIndexTest, indexed_object_gets_first_value_of_requested_type)
+{
+    infra::JsonObjectIndex::WithMaxMembers<4> index;
+    infra::JsonObject object(R"({ "key" : "value", "key" : 5 })", index);
+
+    EXPECT_EQ(5, object.GetInteger("key"));
+    EXPECT_EQ(infra::JsonValue(infra::JsonString("value")), object.GetValue("key"));
+    EXPECT_EQ(std::nullopt, object.GetOptionalBoolean("key"));
+    EXPECT_FALSE(object.Error());
+}
+
+TEST(JsonObjectIndexTest, indexed_object_sets_error_on_absent_key)
+{
+    infra::JsonObjectIndex::WithMaxMembers<4> index;
+    infra::JsonObject object(R"({ "key" : "value" })", index);
+
+    EXPECT_EQ(std::nullopt, object.GetOptionalString("absent"));
+    EXPECT_FALSE(object.Error());
+
+    object.GetString("absent");
+    EXPECT_TRUE(object.Error());
+}
+
+TEST(JsonObjectIndexTest, object_falls_back_to_search_when_index_cannot_be_built)
+{
+    infra::JsonObjectIndex::WithMaxMembers<1> index;
+    infra::JsonObject object(R"({ "a" : 1, "b" : 2 })", index);
+
+    EXPECT_EQ(2, object.GetInteger("b"));
+    EXPECT_FALSE(object.Error());
+}
+
+TEST(JsonArrayIndexTest, build_indexes_elements_in_order)
+{
+    infra::JsonArrayIndex::WithMaxElements<4> index;
+
+    EXPECT_TRUE(index.Build(R"([ 1, { "x" : [ 1, { "y" : 2 } ] }, "value" ])"));
+    ASSERT_EQ(3, index.Size());
+    EXPECT_EQ(" 1", index[0]);
+    EXPECT_EQ(R"({ "x" : [ 1, { "y" : 2 } ] })", index[1]);
+    EXPECT_EQ(R"( "value")", index[2]);
+}
+
+TEST(JsonArrayIndexTest, build_indexes_empty_array)
+{
+    infra::JsonArrayIndex::WithMaxElements<1> index;
+
+    EXPECT_TRUE(index.Build(R"([ ])"));
+    EXPECT_EQ(0, index.Size());
+}
+
+TEST(JsonArrayIndexTest, build_fails_when_storage_is_exhausted)
+{
+    infra::JsonArrayIndex::WithMaxElements<1> index;
+
+    EXPECT_FALSE(index.Build(R"([ 1, 2 ])"));
+}
+
+TEST(JsonArrayIndexTest, build_fails_on_malformed_array)
+{
+    infra::JsonArrayIndex::WithMaxElements<4> index;
+
+    EXPECT_FALSE(index.Build(R"([ 1 2 ])"));
+    EXPECT_FALSE(index.Build(R"([ { "b" : 2 ] ])"));
+    EXPECT_FALSE(index.Build(R"([ 1, ])"));
+    EXPECT_FALSE(index.Build(R"([ 1)"));
+    EXPECT_FALSE(index.Build(R"({ "a" : 1 })"));
+}
+
+TEST(JsonArrayIndexTest, indexed_array_gets_values)
+{
+    infra::JsonArrayIndex::WithMaxElements<8> index;
+    infra::JsonArray array(R"([ "value", true, -5, 1.5, { "nested" : true }, [ 1 ], null ])", index);
+
+    EXPECT_EQ(7, array.Size());
+    EXPECT_EQ("value", array.GetString(0));
+    EXPECT_EQ(true, array.GetBoolean(1));
+    EXPECT_EQ(-5, array.GetInteger(2));
+    EXPECT_EQ(infra::JsonFloat(1, 500000000, false), array.GetFloat(3));
+    EXPECT_EQ(true, array.GetObject(4).GetBoolean("nested"));
+    EXPECT_EQ(R"([ 1 ])", array.GetArray(5).ObjectString());
+    EXPECT_EQ(infra::BoundedConstString(), array.GetObject(6).ObjectString());
+    EXPECT_FALSE(array.Error());
+}
+
+TEST(JsonArrayIndexTest, indexed_array_sets_error_on_absent_position_or_other_type)
+{
+    infra::JsonArrayIndex::WithMaxElements<4> index;
+    infra::JsonArray array(R"([ "value" ])", index);
+
+    array.GetString(1);
+    EXPECT_TRUE(array.Error());
+
+    infra::JsonArray otherArray(R"([ "value" ])", index);
+    otherArray.GetInteger(0);
+    EXPECT_TRUE(otherArray.Error());
+}
+
+TEST(JsonArrayIndexTest, array_falls_back_to_iteration_when_index_cannot_be_built)
+{
+    infra::JsonArrayIndex::WithMaxElements<1> index;
+    infra::JsonArray array(R"([ 1, 2 ])", index);
+
+    EXPECT_EQ(2, array.Size());
+    EXPECT_EQ(2, array.GetInteger(1));
+    EXPECT_FALSE(array.Error());
+
+    array.GetInteger(2);
+    EXPECT_TRUE(array.Error());
+}
+
 TEST(JsonArrayIteratorTest, empty_array_iterator_compares_equal_to_end)
 {
     infra::JsonArray jsonArray(R"([ ])");
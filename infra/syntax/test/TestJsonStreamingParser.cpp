@@ -288,6 +288,38 @@ TEST_F(JsonStreamingObjectParserTest, overflow_in_value_results_in_StringOverflo
     parser.Feed(R"({ "a" : "1234567890123" )");
 }
 
+TEST_F(JsonStreamingObjectParserTest, long_overflow_in_value_results_in_StringOverflow)
+{
+    EXPECT_CALL(visitor, StringOverflow());
+    EXPECT_CALL(visitor, VisitString("b", "c"));
+    parser.Feed(R"({ "a" : "1234567890123456789012345678901234567890\"1234567890123456789012345678901234567890", "b" : "c" )");
+}
+
+TEST_F(JsonStreamingObjectParserTest, value_exactly_filling_buffer_does_not_overflow)
+{
+    EXPECT_CALL(visitor, VisitString("a", "123456789012"));
+    parser.Feed(R"({ "a" : "123456789012" )");
+}
+
+TEST_F(JsonStreamingObjectParserTest, long_whitespace_runs_are_skipped)
+{
+    EXPECT_CALL(visitor, VisitString("a", "b"));
+    EXPECT_CALL(visitor, Close());
+    parser.Feed("{\n\t\t\t\t\t\t\t\t\t\t\t\t\t\t\t\t\t\t\"a\"\r\n                                :\v\f                    \"b\"\n\n\n\n\n\n\n\n\n\n\n\n\n\n\n\n\n}");
+}
+
+TEST_F(JsonStreamingObjectParserTest, string_fed_in_parts_is_reassembled)
+{
+    infra::BoundedConstString data(R"({ "tag" : "va\"l\\ue", "skipped" : { "nested" : "12345678901234567890123456789012" } })");
+
+    EXPECT_CALL(visitor, VisitString("tag", "va\"l\\ue"));
+    EXPECT_CALL(visitor, VisitObject("skipped", testing::_)).WillOnce(testing::Return(nullptr));
+    EXPECT_CALL(visitor, Close());
+
+    for (std::size_t index = 0; index != data.size(); ++index)
+        parser.Feed(data.substr(index, 1));
+}
+
 TEST_F(JsonStreamingObjectParserTest, overflow_in_tag_is_truncated)
 {
     EXPECT_CALL(visitor, VisitString("12345678", "a"));
@@ -99,3 +99,38 @@ TEST(ProtoFormatterTest, PutSubObject)
 
     EXPECT_EQ((std::array<uint8_t, 4>{ 4 << 3 | 2, 2, 4 << 3, 2 }), stream.Writer().Processed());
 }
+
+TEST(ProtoFormatterTest, PutFields_writes_all_buffered_fields)
+{
+    infra::ByteOutputStream::WithStorage<30> stream;
+    infra::ProtoFormatter formatter(stream);
+
+    infra::ProtoFieldBuffer::WithMaxSize<27> buffer;
+    buffer.PutVarIntField(389, 4);
+    buffer.PutFixed32Field(2, 4);
+    buffer.PutFixed64Field(3, 4);
+    formatter.PutFields(buffer);
+
+    EXPECT_EQ((std::array<uint8_t, 17>{ 4 << 3, 0x85, 3, 4 << 3 | 5, 2, 0, 0, 0, 4 << 3 | 1, 3, 0, 0, 0, 0, 0, 0, 0 }), stream.Writer().Processed());
+}
+
+TEST(ProtoFormatterTest, PutFields_reports_failure_when_output_is_too_small)
+{
+    infra::ByteOutputStream::WithStorage<2> stream(infra::softFail);
+    infra::ProtoFormatter formatter(stream);
+
+    infra::ProtoFieldBuffer::WithMaxSize<20> buffer;
+    buffer.PutVarIntField(389, 4);
+    formatter.PutFields(buffer);
+
+    EXPECT_TRUE(stream.Failed());
+}
+
+#ifndef EMIL_MUTATION_TESTING
+TEST(ProtoFormatterTest, PutVarInt_beyond_buffer_storage_asserts)
+{
+    infra::ProtoFieldBuffer::WithMaxSize<2> buffer;
+
+    EXPECT_DEATH(buffer.PutVarInt(1 << 14), ".*");
+}
+#endif
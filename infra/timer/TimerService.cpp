@@ -1,6 +1,7 @@
 #include "infra/timer/TimerService.hpp"
 #include "infra/util/LogAndAbort.hpp"
 #include "infra/util/ReallyAssert.hpp"
+#include <algorithm>
 #include <cinttypes>
 
 namespace infra
@@ -26,9 +27,28 @@ namespace infra
         return id;
     }
 
+    void TimerService::UseTimerWheel(infra::MemoryRange<infra::IntrusiveForwardList<Timer>> slots, Duration slotDuration)
+    {
+        really_assert(!slots.empty() && slotDuration > Duration::zero());
+
+        infra::IntrusiveForwardList<Timer> timers;
+        MoveAllTimers(timers);
+
+        this->slots = slots;
+        this->slotDuration = slotDuration;
+
+        while (!timers.empty())
+        {
+            auto& timer = timers.front();
+            timers.pop_front();
+            Slot(timer.NextTrigger()).push_front(timer);
+        }
+    }
+
     void TimerService::RegisterTimer(Timer& timer)
     {
-        scheduledTimers.push_front(timer);
+        Slot(timer.NextTrigger()).push_front(timer);
+        lowerBound = std::min(lowerBound, timer.NextTrigger());
 
         if (timer.NextTrigger() < nextTrigger)
         {
@@ -39,10 +59,10 @@ namespace infra
 
     void TimerService::UnregisterTimer(Timer& timer, TimePoint oldTriggerTime)
     {
-        if (&*timerIterator == &timer)
-            ++timerIterator;
-
-        scheduledTimers.erase_slow(timer);
+        if (!jumpingTimers.empty() && jumpingTimers.has_element(timer))
+            jumpingTimers.erase_slow(timer);
+        else
+            Slot(oldTriggerTime).erase_slow(timer);
 
         if (oldTriggerTime == nextTrigger)
             ComputeNextTrigger();
@@ -50,6 +70,18 @@ namespace infra
 
     void TimerService::UpdateTriggerTime(Timer& timer, TimePoint oldTriggerTime)
     {
+        auto& oldSlot = Slot(oldTriggerTime);
+        auto& newSlot = Slot(timer.NextTrigger());
+
+        // Timers that still have to be notified of a jump stay in jumpingTimers until Jumped reaches them
+        if (&oldSlot != &newSlot && (jumpingTimers.empty() || !jumpingTimers.has_element(timer)))
+        {
+            oldSlot.erase_slow(timer);
+            newSlot.push_front(timer);
+        }
+
+        lowerBound = std::min(lowerBound, timer.NextTrigger());
+
         if (nextTrigger == oldTriggerTime || timer.NextTrigger() < nextTrigger)
             ComputeNextTrigger();
     }
@@ -58,37 +90,11 @@ namespace infra
     {
         holdUpdate = true;
 
-        bool more = true;
-        while (more)
+        for (auto earliest = EarliestTimer(); earliest != nullptr && earliest->NextTrigger() <= time; earliest = EarliestTimer())
         {
-            more = false;
-
-            infra::Timer* earliest = nullptr;
-
-            for (timerIterator = scheduledTimers.begin(); timerIterator != scheduledTimers.end();)
-            {
-                infra::IntrusiveForwardList<Timer>::iterator currentIterator = timerIterator;
-                ++timerIterator;
-
-                if (currentIterator->NextTrigger() <= time)
-                {
-                    if (earliest == nullptr)
-                        earliest = &*currentIterator;
-                    else
-                    {
-                        more = true;
-                        if (earliest->NextTrigger() > currentIterator->NextTrigger())
-                            earliest = &*currentIterator;
-                    }
-                }
-            }
-
-            if (earliest != nullptr)
-            {
-                infra::Function<void()> action = earliest->Action();
-                earliest->ComputeNextTriggerTime();
-                action();
-            }
+            infra::Function<void()> action = earliest->Action();
+            earliest->ComputeNextTriggerTime();
+            action();
         }
 
         holdUpdate = false;
@@ -100,8 +106,23 @@ namespace infra
     {
         holdUpdate = true;
 
-        for (timerIterator = scheduledTimers.begin(); timerIterator != scheduledTimers.end();)
-            timerIterator++->Jumped(from, to);
+        infra::IntrusiveForwardList<Timer> timers;
+        MoveAllTimers(timers);
+
+        while (!timers.empty())
+        {
+            auto& timer = timers.front();
+            timers.pop_front();
+            jumpingTimers.push_front(timer);
+        }
+
+        while (!jumpingTimers.empty())
+        {
+            auto& timer = jumpingTimers.front();
+            jumpingTimers.pop_front();
+            Slot(timer.NextTrigger()).push_front(timer);
+            timer.Jumped(from, to);
+        }
 
         holdUpdate = false;
         if (updateNeeded)
@@ -132,9 +153,8 @@ namespace infra
             updateNeeded = false;
             TimePoint oldTrigger = nextTrigger;
 
-            nextTrigger = TimePoint::max();
-            for (auto& timer : scheduledTimers)
-                nextTrigger = std::min(nextTrigger, timer.NextTrigger());
+            auto earliest = EarliestTimer();
+            nextTrigger = earliest != nullptr ? earliest->NextTrigger() : TimePoint::max();
 
             if (nextTrigger != oldTrigger)
                 NextTriggerChanged();
@@ -142,4 +162,80 @@ namespace infra
         else
             updateNeeded = true;
     }
+
+    Timer* TimerService::EarliestTimer()
+    {
+        // All armed timers trigger at or after lowerBound, so when using a timer wheel, walking one revolution
+        // from the slot of lowerBound finds the earliest timer, unless it triggers more than a revolution later
+        Timer* earliest = nullptr;
+
+        if (slots.size() > 1 && lowerBound <= TimePoint::max() - slotDuration * static_cast<Duration::rep>(slots.size()))
+        {
+            auto slotStart = SlotStart(lowerBound);
+            for (std::size_t i = 0; i != slots.size() && earliest == nullptr; ++i, slotStart += slotDuration)
+                earliest = EarliestTimerInSlot(slotStart);
+        }
+
+        if (earliest == nullptr)
+            earliest = EarliestTimerInAllSlots();
+
+        lowerBound = earliest != nullptr ? earliest->NextTrigger() : TimePoint::max();
+        return earliest;
+    }
+
+    Timer* TimerService::EarliestTimerInSlot(TimePoint slotStart) const
+    {
+        Timer* earliest = nullptr;
+
+        for (auto& timer : Slot(slotStart))
+            if (timer.NextTrigger() < slotStart + slotDuration && (earliest == nullptr || timer.NextTrigger() < earliest->NextTrigger()))
+                earliest = &timer;
+
+        return earliest;
+    }
+
+    Timer* TimerService::EarliestTimerInAllSlots() const
+    {
+        Timer* earliest = nullptr;
+
+        for (auto& slot : slots)
+            for (auto& timer : slot)
+                if (earliest == nullptr || timer.NextTrigger() < earliest->NextTrigger())
+                    earliest = &timer;
+
+        return earliest;
+    }
+
+    infra::IntrusiveForwardList<Timer>& TimerService::Slot(TimePoint time) const
+    {
+        if (slots.size() == 1)
+            return slots.front();
+
+        auto size = static_cast<Duration::rep>(slots.size());
+        auto index = (SlotStart(time).time_since_epoch() / slotDuration) % size;
+        if (index < 0)
+            index += size;
+
+        return slots[index];
+    }
+
+    TimePoint TimerService::SlotStart(TimePoint time) const
+    {
+        auto remainder = time.time_since_epoch() % slotDuration;
+        if (remainder < Duration::zero())
+            remainder += slotDuration;
+
+        return time - remainder;
+    }
+
+    void TimerService::MoveAllTimers(infra::IntrusiveForwardList<Timer>& to)
+    {
+        for (auto& slot : slots)
+            while (!slot.empty())
+            {
+                auto& timer = slot.front();
+                slot.pop_front();
+                to.push_front(timer);
+            }
+    }
 }
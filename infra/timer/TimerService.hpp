@@ -3,6 +3,7 @@
 
 #include "infra/timer/Timer.hpp"
 #include "infra/util/IntrusiveForwardList.hpp"
+#include "infra/util/MemoryRange.hpp"
 
 namespace infra
 {
@@ -18,6 +19,14 @@ namespace infra
     public:
         uint32_t Id() const;
 
+        // By default, all timers are kept in a single unsorted list, so that arming, cancelling and finding the next
+        // trigger take time linear in the number of armed timers. With UseTimerWheel, timers are instead hashed on
+        // their trigger time into slots of slotDuration, so that arming and cancelling only touch a single slot,
+        // and finding the next trigger starts scanning at the slot of the previous trigger.
+        // Choose slotDuration and the number of slots so that one revolution covers the common timeouts.
+        // The slots must outlive all timers of this timer service.
+        void UseTimerWheel(infra::MemoryRange<infra::IntrusiveForwardList<Timer>> slots, Duration slotDuration);
+
         void RegisterTimer(Timer& timer);
         void UnregisterTimer(Timer& timer, TimePoint oldTriggerTime);
         void UpdateTriggerTime(Timer& timer, TimePoint oldTriggerTime);
@@ -34,13 +43,22 @@ namespace infra
 
     private:
         void ComputeNextTrigger();
+        Timer* EarliestTimer();
+        Timer* EarliestTimerInSlot(TimePoint slotStart) const;
+        Timer* EarliestTimerInAllSlots() const;
+        infra::IntrusiveForwardList<Timer>& Slot(TimePoint time) const;
+        TimePoint SlotStart(TimePoint time) const;
+        void MoveAllTimers(infra::IntrusiveForwardList<Timer>& to);
 
     private:
         uint32_t id;
         infra::IntrusiveForwardList<Timer> scheduledTimers;
-        infra::IntrusiveForwardList<Timer>::iterator timerIterator;
+        infra::MemoryRange<infra::IntrusiveForwardList<Timer>> slots{ &scheduledTimers, &scheduledTimers + 1 };
+        Duration slotDuration = Duration::max();
+        infra::IntrusiveForwardList<Timer> jumpingTimers;
 
         TimePoint nextTrigger = TimePoint::max();
+        TimePoint lowerBound = TimePoint::max();
         bool holdUpdate = false;
         bool updateNeeded = false;
 
@@ -0,0 +1,87 @@
+#include "infra/timer/Timer.hpp"
+#include "infra/timer/TimerService.hpp"
+#include <array>
+#include <benchmark/benchmark.h>
+#include <list>
+#include <random>
+
+namespace
+{
+    class BenchmarkTimerService
+        : public infra::TimerService
+    {
+    public:
+        explicit BenchmarkTimerService(bool useTimerWheel)
+            : infra::TimerService(infra::systemTimerServiceId)
+        {
+            if (useTimerWheel)
+                UseTimerWheel(slots, std::chrono::milliseconds(10));
+        }
+
+        infra::TimePoint Now() const override
+        {
+            return now;
+        }
+
+        infra::Duration Resolution() const override
+        {
+            return {};
+        }
+
+        void TimeProgressed(infra::Duration amount)
+        {
+            now += amount;
+            Progressed(now);
+        }
+
+    private:
+        std::array<infra::IntrusiveForwardList<infra::Timer>, 1024> slots;
+        infra::TimePoint now;
+    };
+
+    infra::Duration RandomTimeout(std::mt19937& random)
+    {
+        return std::chrono::milliseconds(std::uniform_int_distribution<int>(100, 30000)(random));
+    }
+
+    void CancelAndRearm(benchmark::State& state)
+    {
+        BenchmarkTimerService timerService(state.range(1) != 0);
+        std::mt19937 random(1);
+        std::list<infra::TimerSingleShot> timers;
+        std::vector<infra::TimerSingleShot*> timerPointers;
+
+        for (int64_t i = 0; i != state.range(0); ++i)
+        {
+            timers.emplace_back(RandomTimeout(random), [] {});
+            timerPointers.push_back(&timers.back());
+        }
+
+        std::uniform_int_distribution<std::size_t> pick(0, timerPointers.size() - 1);
+
+        for (auto _ : state)
+        {
+            auto& timer = *timerPointers[pick(random)];
+            timer.Cancel();
+            timer.Start(RandomTimeout(random), [] {});
+        }
+
+        state.SetItemsProcessed(state.iterations());
+    }
+
+    void ProgressWithRepeatingTimers(benchmark::State& state)
+    {
+        BenchmarkTimerService timerService(state.range(1) != 0);
+        std::mt19937 random(1);
+        std::list<infra::TimerRepeating> timers;
+
+        for (int64_t i = 0; i != state.range(0); ++i)
+            timers.emplace_back(RandomTimeout(random), [] {});
+
+        for (auto _ : state)
+            timerService.TimeProgressed(std::chrono::milliseconds(10));
+    }
+}
+
+BENCHMARK(CancelAndRearm)->ArgsProduct({ { 16, 256, 4096 }, { 0, 1 } })->ArgNames({ "timers", "wheel" });
+BENCHMARK(ProgressWithRepeatingTimers)->ArgsProduct({ { 16, 256, 4096 }, { 0, 1 } })->ArgNames({ "timers", "wheel" });
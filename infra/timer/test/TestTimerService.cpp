@@ -1,5 +1,8 @@
 #include "infra/timer/TimerService.hpp"
+#include "infra/timer/test_helper/ClockFixture.hpp"
+#include "infra/util/test_helper/MockCallback.hpp"
 #include "gtest/gtest.h"
+#include <array>
 
 namespace
 {
@@ -37,3 +40,141 @@ TEST(TimerServiceDeathTest, get_timer_service_with_unknown_id_aborts)
 }
 
 #endif
+
+class TimerWheelTest
+    : public testing::Test
+    , public infra::ClockFixture
+{
+public:
+    TimerWheelTest()
+    {
+        systemTimerService.UseTimerWheel(slots, std::chrono::seconds(1));
+    }
+
+    std::array<infra::IntrusiveForwardList<infra::Timer>, 4> slots;
+};
+
+TEST_F(TimerWheelTest, timers_in_different_slots_trigger_in_order)
+{
+    infra::MockCallback<void(int)> callback;
+    testing::InSequence s;
+    EXPECT_CALL(callback, callback(1)).With(After(std::chrono::milliseconds(1500)));
+    EXPECT_CALL(callback, callback(2)).With(After(std::chrono::milliseconds(2500)));
+
+    infra::TimerSingleShot timer2(std::chrono::milliseconds(2500), [&callback]()
+        {
+            callback.callback(2);
+        });
+    infra::TimerSingleShot timer1(std::chrono::milliseconds(1500), [&callback]()
+        {
+            callback.callback(1);
+        });
+
+    ForwardTime(std::chrono::seconds(5));
+}
+
+TEST_F(TimerWheelTest, timer_beyond_one_revolution_triggers_after_earlier_timer_in_same_slot)
+{
+    infra::MockCallback<void(int)> callback;
+    testing::InSequence s;
+    EXPECT_CALL(callback, callback(1)).With(After(std::chrono::seconds(1)));
+    EXPECT_CALL(callback, callback(2)).With(After(std::chrono::seconds(5)));
+    EXPECT_CALL(callback, callback(3)).With(After(std::chrono::seconds(13)));
+
+    infra::TimerSingleShot timer3(std::chrono::seconds(13), [&callback]()
+        {
+            callback.callback(3);
+        });
+    infra::TimerSingleShot timer2(std::chrono::seconds(5), [&callback]()
+        {
+            callback.callback(2);
+        });
+    infra::TimerSingleShot timer1(std::chrono::seconds(1), [&callback]()
+        {
+            callback.callback(1);
+        });
+
+    EXPECT_EQ(infra::TimePoint() + std::chrono::seconds(1), systemTimerService.NextTrigger());
+    ForwardTime(std::chrono::seconds(20));
+}
+
+TEST_F(TimerWheelTest, cancelled_timer_does_not_trigger)
+{
+    infra::MockCallback<void()> callback;
+    EXPECT_CALL(callback, callback()).With(After(std::chrono::seconds(3)));
+
+    infra::TimerSingleShot timer1(std::chrono::seconds(1), []()
+        {
+            FAIL();
+        });
+    infra::TimerSingleShot timer2(std::chrono::seconds(3), [&callback]()
+        {
+            callback.callback();
+        });
+
+    timer1.Cancel();
+    EXPECT_EQ(infra::TimePoint() + std::chrono::seconds(3), systemTimerService.NextTrigger());
+    ForwardTime(std::chrono::seconds(5));
+}
+
+TEST_F(TimerWheelTest, timer_moved_to_other_slot_triggers_at_updated_time)
+{
+    infra::MockCallback<void()> callback;
+    EXPECT_CALL(callback, callback()).With(After(std::chrono::seconds(2)));
+
+    infra::TimerSingleShot timer(std::chrono::seconds(7), []()
+        {
+            FAIL();
+        });
+    timer.Start(std::chrono::seconds(2), [&callback]()
+        {
+            callback.callback();
+        });
+
+    ForwardTime(std::chrono::seconds(10));
+}
+
+TEST_F(TimerWheelTest, repeating_timer_triggers_repeatedly)
+{
+    infra::MockCallback<void()> callback;
+    EXPECT_CALL(callback, callback()).With(After(std::chrono::seconds(3)));
+    EXPECT_CALL(callback, callback()).With(After(std::chrono::seconds(6)));
+    EXPECT_CALL(callback, callback()).With(After(std::chrono::seconds(9)));
+
+    infra::TimerRepeating timer(std::chrono::seconds(3), [&callback]()
+        {
+            callback.callback();
+        });
+
+    ForwardTime(std::chrono::seconds(9));
+}
+
+TEST_F(TimerWheelTest, timers_are_moved_after_jump)
+{
+    infra::MockCallback<void()> callback;
+    EXPECT_CALL(callback, callback()).With(After(std::chrono::seconds(5)));
+
+    infra::TimerSingleShot timer(std::chrono::seconds(2), [&callback]()
+        {
+            callback.callback();
+        });
+
+    JumpForwardTime(std::chrono::seconds(3));
+    ForwardTime(std::chrono::seconds(5));
+}
+
+TEST_F(TimerWheelTest, timers_armed_before_using_wheel_are_kept)
+{
+    std::array<infra::IntrusiveForwardList<infra::Timer>, 8> otherSlots;
+
+    infra::MockCallback<void()> callback;
+    EXPECT_CALL(callback, callback()).With(After(std::chrono::seconds(3)));
+
+    infra::TimerSingleShot timer(std::chrono::seconds(3), [&callback]()
+        {
+            callback.callback();
+        });
+
+    systemTimerService.UseTimerWheel(otherSlots, std::chrono::milliseconds(100));
+    ForwardTime(std::chrono::seconds(5));
+}
@@ -1,15 +1,206 @@
 #include "infra/util/Base64.hpp"
+#include "infra/util/ReallyAssert.hpp"
 #include <algorithm>
+#include <array>
+
+// The vector implementation is compiled on every x86 build with GCC or Clang, and selected at runtime when the
+// processor supports SSSE3, so that it is built and tested on hosts regardless of the -m flags of the build
+#if (defined(__x86_64__) || defined(__i386__)) && (defined(__GNUC__) || defined(__clang__))
+#define INFRA_BASE64_SSSE3
+#define INFRA_BASE64_TARGET_SSSE3 __attribute__((target("ssse3")))
+#include <tmmintrin.h>
+#endif
 
 namespace infra
 {
+    namespace
+    {
+        constexpr const char alphabet[] = "ABCDEFGHIJKLMNOPQRSTUVWXYZabcdefghijklmnopqrstuvwxyz0123456789+/";
+
+        constexpr std::array<uint8_t, 256> MakeDecodeTable()
+        {
+            std::array<uint8_t, 256> table{};
+
+            for (std::size_t i = 0; i != table.size(); ++i)
+                table[i] = 64;
+
+            for (uint8_t i = 0; i != 64; ++i)
+                table[static_cast<uint8_t>(alphabet[i])] = i;
+
+            return table;
+        }
+
+        constexpr std::array<uint8_t, 256> decodeTable = MakeDecodeTable();
+
+#if defined(INFRA_BASE64_SSSE3)
+        bool HasSsse3()
+        {
+#if defined(__SSSE3__)
+            return true;
+#else
+            static const bool hasSsse3 = []()
+            {
+                __builtin_cpu_init();
+                return __builtin_cpu_supports("ssse3") != 0;
+            }();
+
+            return hasSsse3;
+#endif
+        }
+
+        // Vectorized encoding and decoding as described by Wojciech Muła and Daniel Lemire in
+        // "Faster Base64 Encoding and Decoding using AVX2 Instructions"
+        INFRA_BASE64_TARGET_SSSE3 __m128i EncodeBlock(__m128i input)
+        {
+            input = _mm_shuffle_epi8(input, _mm_set_epi8(10, 11, 9, 10, 7, 8, 6, 7, 4, 5, 3, 4, 1, 2, 0, 1));
+
+            auto indicesAc = _mm_mulhi_epu16(_mm_and_si128(input, _mm_set1_epi32(0x0fc0fc00)), _mm_set1_epi32(0x04000040));
+            auto indicesBd = _mm_mullo_epi16(_mm_and_si128(input, _mm_set1_epi32(0x003f03f0)), _mm_set1_epi32(0x01000010));
+            auto indices = _mm_or_si128(indicesAc, indicesBd);
+
+            auto range = _mm_subs_epu8(indices, _mm_set1_epi8(51));
+            auto upperCase = _mm_cmpgt_epi8(_mm_set1_epi8(26), indices);
+            range = _mm_or_si128(range, _mm_and_si128(upperCase, _mm_set1_epi8(13)));
+
+            auto offsets = _mm_setr_epi8('a' - 26, '0' - 52, '0' - 52, '0' - 52, '0' - 52, '0' - 52, '0' - 52, '0' - 52, '0' - 52, '0' - 52, '0' - 52, '+' - 62, '/' - 63, 'A', 0, 0);
+            return _mm_add_epi8(indices, _mm_shuffle_epi8(offsets, range));
+        }
+
+        INFRA_BASE64_TARGET_SSSE3 bool DecodeBlock(__m128i input, __m128i& output)
+        {
+            auto higherNibble = _mm_and_si128(_mm_srli_epi32(input, 4), _mm_set1_epi8(0x0f));
+            auto lowerNibble = _mm_and_si128(input, _mm_set1_epi8(0x0f));
+
+            auto validLowerNibbles = _mm_setr_epi8(
+                static_cast<char>(0xa8), static_cast<char>(0xf8), static_cast<char>(0xf8), static_cast<char>(0xf8),
+                static_cast<char>(0xf8), static_cast<char>(0xf8), static_cast<char>(0xf8), static_cast<char>(0xf8),
+                static_cast<char>(0xf8), static_cast<char>(0xf8), static_cast<char>(0xf0), 0x54, 0x50, 0x50, 0x50, 0x54);
+            auto higherNibbleBit = _mm_setr_epi8(0x01, 0x02, 0x04, 0x08, 0x10, 0x20, 0x40, static_cast<char>(0x80), 0, 0, 0, 0, 0, 0, 0, 0);
+            auto valid = _mm_and_si128(_mm_shuffle_epi8(validLowerNibbles, lowerNibble), _mm_shuffle_epi8(higherNibbleBit, higherNibble));
+
+            if (_mm_movemask_epi8(_mm_cmpeq_epi8(valid, _mm_setzero_si128())) != 0)
+                return false;
+
+            auto isSlash = _mm_cmpeq_epi8(input, _mm_set1_epi8('/'));
+            auto offsets = _mm_shuffle_epi8(_mm_setr_epi8(0, 0, 19, 4, -65, -65, -71, -71, 0, 0, 0, 0, 0, 0, 0, 0), higherNibble);
+            offsets = _mm_or_si128(_mm_andnot_si128(isSlash, offsets), _mm_and_si128(isSlash, _mm_set1_epi8(16)));
+            auto values = _mm_add_epi8(input, offsets);
+
+            auto pairs = _mm_maddubs_epi16(values, _mm_set1_epi32(0x01400140));
+            auto words = _mm_madd_epi16(pairs, _mm_set1_epi32(0x00011000));
+            output = _mm_shuffle_epi8(words, _mm_setr_epi8(2, 1, 0, 6, 5, 4, 10, 9, 8, 14, 13, 12, -1, -1, -1, -1));
+            return true;
+        }
+
+        INFRA_BASE64_TARGET_SSSE3 std::size_t EncodeBlocksSsse3(const uint8_t* input, std::size_t groups, char* output)
+        {
+            std::size_t encoded = 0;
+
+            // A block reads 16 bytes of which 12 are encoded, so at least 6 groups must be left to stay inside input
+            for (; groups - encoded >= 6; encoded += 4)
+                _mm_storeu_si128(reinterpret_cast<__m128i*>(output + encoded * 4), EncodeBlock(_mm_loadu_si128(reinterpret_cast<const __m128i*>(input + encoded * 3))));
+
+            return encoded;
+        }
+
+        INFRA_BASE64_TARGET_SSSE3 std::size_t DecodeBlocksSsse3(const char* input, std::size_t groups, uint8_t* output)
+        {
+            std::size_t decoded = 0;
+
+            // A block writes 16 bytes of which 12 are decoded, so at least 6 groups must be left to stay inside output
+            for (; groups - decoded >= 6; decoded += 4)
+            {
+                __m128i block;
+                if (!DecodeBlock(_mm_loadu_si128(reinterpret_cast<const __m128i*>(input + decoded * 4)), block))
+                    break;
+
+                _mm_storeu_si128(reinterpret_cast<__m128i*>(output + decoded * 3), block);
+            }
+
+            return decoded;
+        }
+
+        std::size_t EncodeBlocks(const uint8_t* input, std::size_t groups, char* output)
+        {
+            if (!HasSsse3())
+                return 0;
+
+            return EncodeBlocksSsse3(input, groups, output);
+        }
+
+        std::size_t DecodeBlocks(const char* input, std::size_t groups, uint8_t* output)
+        {
+            if (!HasSsse3())
+                return 0;
+
+            return DecodeBlocksSsse3(input, groups, output);
+        }
+#else
+        std::size_t EncodeBlocks(const uint8_t* input, std::size_t groups, char* output)
+        {
+            return 0;
+        }
+
+        std::size_t DecodeBlocks(const char* input, std::size_t groups, uint8_t* output)
+        {
+            return 0;
+        }
+#endif
+    }
+
     namespace detail
     {
-        const char* base64Table = "ABCDEFGHIJKLMNOPQRSTUVWXYZabcdefghijklmnopqrstuvwxyz0123456789+/";
+        const char* base64Table = alphabet;
     }
 
     uint8_t DecodeBase64Byte(char base64)
     {
-        return static_cast<uint8_t>(std::find(&detail::base64Table[0], &detail::base64Table[64], base64) - &detail::base64Table[0]);
+        return decodeTable[static_cast<uint8_t>(base64)];
+    }
+
+    void EncodeBase64Groups(ConstByteRange input, MemoryRange<char> output)
+    {
+        really_assert(input.size() % 3 == 0);
+        really_assert(output.size() >= input.size() / 3 * 4);
+
+        auto groups = input.size() / 3;
+        auto in = input.begin();
+        auto out = output.begin();
+
+        for (std::size_t group = EncodeBlocks(in, groups, out); group != groups; ++group)
+        {
+            uint32_t word = (in[group * 3] << 16) | (in[group * 3 + 1] << 8) | in[group * 3 + 2];
+
+            out[group * 4] = alphabet[word >> 18];
+            out[group * 4 + 1] = alphabet[(word >> 12) & 0x3f];
+            out[group * 4 + 2] = alphabet[(word >> 6) & 0x3f];
+            out[group * 4 + 3] = alphabet[word & 0x3f];
+        }
+    }
+
+    std::size_t DecodeBase64Groups(MemoryRange<const char> input, ByteRange output)
+    {
+        auto groups = std::min(input.size() / 4, output.size() / 3);
+        auto in = input.begin();
+        auto out = output.begin();
+
+        for (std::size_t group = DecodeBlocks(in, groups, out); group != groups; ++group)
+        {
+            uint8_t a = decodeTable[static_cast<uint8_t>(in[group * 4])];
+            uint8_t b = decodeTable[static_cast<uint8_t>(in[group * 4 + 1])];
+            uint8_t c = decodeTable[static_cast<uint8_t>(in[group * 4 + 2])];
+            uint8_t d = decodeTable[static_cast<uint8_t>(in[group * 4 + 3])];
+
+            if ((a | b | c | d) >= 64)
+                return group;
+
+            uint32_t word = (a << 18) | (b << 12) | (c << 6) | d;
+
+            out[group * 3] = static_cast<uint8_t>(word >> 16);
+            out[group * 3 + 1] = static_cast<uint8_t>(word >> 8);
+            out[group * 3 + 2] = static_cast<uint8_t>(word);
+        }
+
+        return groups;
     }
 }
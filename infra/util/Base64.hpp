@@ -1,6 +1,7 @@
 #ifndef INFRA_BASE64_HPP
 #define INFRA_BASE64_HPP
 
+#include "infra/util/ByteRange.hpp"
 #include <cstdint>
 
 namespace infra
@@ -10,7 +11,18 @@ namespace infra
         extern const char* base64Table;
     }
 
+    // Returns a value >= 64 when base64 is not part of the base64 alphabet
     uint8_t DecodeBase64Byte(char base64);
+
+    // Encodes each group of 3 bytes in input into 4 characters. input.size() must be a multiple of 3, and output
+    // must be able to hold input.size() / 3 * 4 characters.
+    // On x86 processors with SSSE3, blocks of 12 bytes are encoded using vector instructions.
+    void EncodeBase64Groups(ConstByteRange input, MemoryRange<char> output);
+
+    // Decodes each group of 4 characters in input into 3 bytes, until input or output is exhausted, or until a group is
+    // encountered that contains a character outside of the base64 alphabet, including padding. Returns the number of groups decoded.
+    // On x86 processors with SSSE3, blocks of 16 characters are decoded using vector instructions.
+    std::size_t DecodeBase64Groups(MemoryRange<const char> input, ByteRange output);
 }
 
 #endif
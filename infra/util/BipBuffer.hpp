@@ -0,0 +1,164 @@
+#ifndef INFRA_BIP_BUFFER_HPP
+#define INFRA_BIP_BUFFER_HPP
+
+//  BipBuffer is a cyclic buffer that hands out contiguous blocks of storage for writing, so that data can be produced
+//  in place instead of being copied into the buffer. Data is kept in at most two contiguous segments: when a
+//  reservation does not fit after the data, it is placed at the start of the storage if there is room before the
+//  data. Both segments can be passed at once to scatter/gather I/O such as writev.
+//  Only one reservation can be outstanding at a time; data may be popped while a reservation is outstanding.
+
+#include "infra/util/MemoryRange.hpp"
+#include "infra/util/WithStorage.hpp"
+#include <algorithm>
+#include <array>
+#include <cassert>
+#include <cstddef>
+#include <cstdint>
+
+namespace infra
+{
+    template<class T>
+    class BipBuffer
+    {
+    public:
+        template<std::size_t StorageSize>
+        using WithStorage = infra::WithStorage<BipBuffer<T>, std::array<T, StorageSize>>;
+
+        explicit BipBuffer(MemoryRange<T> storage);
+        BipBuffer(const BipBuffer& other) = delete;
+        BipBuffer& operator=(const BipBuffer& other) = delete;
+
+        bool Empty() const;
+        std::size_t Size() const;
+        std::size_t MaxSize() const;
+
+        // Returns false while a reservation is outstanding
+        bool CanReserve(std::size_t size) const;
+        MemoryRange<T> Reserve(std::size_t size);
+        void Commit(std::size_t size);
+
+        // The first segment holds the oldest data; the second segment is empty when the data does not wrap
+        std::array<MemoryRange<const T>, 2> Segments() const;
+        void Pop(std::size_t numToPop);
+
+    private:
+        MemoryRange<T> storage;
+        T* front;
+        T* back;
+        T* wrappedBack = nullptr;
+        std::size_t reserved = 0;
+    };
+
+    using BipByteBuffer = BipBuffer<uint8_t>;
+
+    ////    Implementation    ////
+
+    template<class T>
+    BipBuffer<T>::BipBuffer(MemoryRange<T> storage)
+        : storage(storage)
+        , front(storage.begin())
+        , back(storage.begin())
+    {}
+
+    template<class T>
+    bool BipBuffer<T>::Empty() const
+    {
+        return Size() == 0;
+    }
+
+    template<class T>
+    std::size_t BipBuffer<T>::Size() const
+    {
+        return (back - front) + (wrappedBack != nullptr ? wrappedBack - storage.begin() : 0);
+    }
+
+    template<class T>
+    std::size_t BipBuffer<T>::MaxSize() const
+    {
+        return storage.size();
+    }
+
+    template<class T>
+    bool BipBuffer<T>::CanReserve(std::size_t size) const
+    {
+        if (reserved != 0)
+            return false;
+        else if (wrappedBack != nullptr)
+            return static_cast<std::size_t>(front - wrappedBack) >= size;
+        else if (front == back)
+            return storage.size() >= size;
+        else
+            return static_cast<std::size_t>(storage.end() - back) >= size || static_cast<std::size_t>(front - storage.begin()) >= size;
+    }
+
+    template<class T>
+    MemoryRange<T> BipBuffer<T>::Reserve(std::size_t size)
+    {
+        assert(size != 0 && CanReserve(size));
+
+        if (wrappedBack == nullptr)
+        {
+            if (front == back)
+            {
+                front = storage.begin();
+                back = storage.begin();
+            }
+
+            if (static_cast<std::size_t>(storage.end() - back) < size)
+                wrappedBack = storage.begin();
+        }
+
+        reserved = size;
+        auto start = wrappedBack != nullptr ? wrappedBack : back;
+        return MemoryRange<T>(start, start + size);
+    }
+
+    template<class T>
+    void BipBuffer<T>::Commit(std::size_t size)
+    {
+        assert(size <= reserved);
+        reserved = 0;
+
+        if (wrappedBack != nullptr)
+            wrappedBack += size;
+        else
+            back += size;
+    }
+
+    template<class T>
+    std::array<MemoryRange<const T>, 2> BipBuffer<T>::Segments() const
+    {
+        if (wrappedBack != nullptr)
+            return { { MemoryRange<const T>(front, back), MemoryRange<const T>(storage.begin(), wrappedBack) } };
+        else
+            return { { MemoryRange<const T>(front, back), MemoryRange<const T>() } };
+    }
+
+    template<class T>
+    void BipBuffer<T>::Pop(std::size_t numToPop)
+    {
+        assert(numToPop <= Size());
+
+        while (numToPop != 0 || (front == back && wrappedBack != nullptr))
+        {
+            std::size_t popped = std::min<std::size_t>(numToPop, back - front);
+            front += popped;
+            numToPop -= popped;
+
+            if (front == back && wrappedBack != nullptr)
+            {
+                front = storage.begin();
+                back = wrappedBack;
+                wrappedBack = nullptr;
+            }
+        }
+
+        if (front == back && reserved == 0)
+        {
+            front = storage.begin();
+            back = storage.begin();
+        }
+    }
+}
+
+#endif
@@ -885,8 +885,8 @@ namespace infra
     BoundedStringBase<T>& BoundedStringBase<T>::append(const char* s, size_type count)
     {
         really_assert(length + count <= max_size());
-        for (const char* i = s; i != s + count; ++i, ++length)
-            range[length] = *i;
+        std::copy(s, s + count, range.begin() + length);
+        length += count;
 
         return *this;
     }
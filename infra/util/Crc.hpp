@@ -11,12 +11,19 @@ namespace infra
     template<typename CRC_TYPE>
     constexpr CRC_TYPE PolyReverse(CRC_TYPE Polynomial);
 
-    template<typename CRC_TYPE, CRC_TYPE Polynomial, CRC_TYPE InitValue = 0, CRC_TYPE FinalXor = 0, bool ReflectInput = false, bool ReflectOutput = false>
+    // Slices is the number of lookup tables used. With 8 slices, Update(ConstByteRange) processes 8 bytes per step
+    // (slice-by-8), which is several times faster on large inputs at the cost of 8 times the table size in flash.
+    // Select it where it pays off, e.g. infra::Crc32::WithSlices<8> in a bootloader checking a flash image.
+    template<typename CRC_TYPE, CRC_TYPE Polynomial, CRC_TYPE InitValue = 0, CRC_TYPE FinalXor = 0, bool ReflectInput = false, bool ReflectOutput = false, std::size_t Slices = 1>
     class Crc
     {
         static_assert(ReflectInput == ReflectOutput, "Currently, non-matching ReflectInput and ReflectOutput is not supported");
+        static_assert(Slices == 1 || Slices == 8, "Only 1 or 8 slices are supported");
 
     public:
+        template<std::size_t OtherSlices>
+        using WithSlices = Crc<CRC_TYPE, Polynomial, InitValue, FinalXor, ReflectInput, ReflectOutput, OtherSlices>;
+
         constexpr void Update(uint8_t input);
         constexpr void Update(ConstByteRange bytes);
         constexpr CRC_TYPE Result() const;
@@ -28,11 +35,14 @@ namespace infra
         public:
             constexpr Table();
             constexpr CRC_TYPE operator[](int i) const;
+            constexpr CRC_TYPE Slice(std::size_t slice, uint64_t value) const;
 
         private:
-            CRC_TYPE table[256];
+            CRC_TYPE table[Slices][256];
         };
 
+        constexpr void UpdateSlices(const uint8_t* bytes);
+
         template<typename TYPE>
         static constexpr TYPE Reflect(TYPE value);
 
@@ -68,8 +78,8 @@ namespace infra
         return ret;
     }
 
-    template<typename CRC_TYPE, CRC_TYPE Polynomial, CRC_TYPE InitValue, CRC_TYPE FinalXor, bool ReflectInput, bool ReflectOutput>
-    constexpr void Crc<CRC_TYPE, Polynomial, InitValue, FinalXor, ReflectInput, ReflectOutput>::Update(uint8_t input)
+    template<typename CRC_TYPE, CRC_TYPE Polynomial, CRC_TYPE InitValue, CRC_TYPE FinalXor, bool ReflectInput, bool ReflectOutput, std::size_t Slices>
+    constexpr void Crc<CRC_TYPE, Polynomial, InitValue, FinalXor, ReflectInput, ReflectOutput, Slices>::Update(uint8_t input)
     {
         if constexpr (ReflectInput)
         {
@@ -93,28 +103,55 @@ namespace infra
         }
     }
 
-    template<typename CRC_TYPE, CRC_TYPE Polynomial, CRC_TYPE InitValue, CRC_TYPE FinalXor, bool ReflectInput, bool ReflectOutput>
-    constexpr void Crc<CRC_TYPE, Polynomial, InitValue, FinalXor, ReflectInput, ReflectOutput>::Update(ConstByteRange bytes)
+    template<typename CRC_TYPE, CRC_TYPE Polynomial, CRC_TYPE InitValue, CRC_TYPE FinalXor, bool ReflectInput, bool ReflectOutput, std::size_t Slices>
+    constexpr void Crc<CRC_TYPE, Polynomial, InitValue, FinalXor, ReflectInput, ReflectOutput, Slices>::Update(ConstByteRange bytes)
     {
-        for (auto byte : bytes)
-            Update(byte);
+        auto byte = bytes.begin();
+
+        if constexpr (Slices == 8)
+            for (; bytes.end() - byte >= 8; byte += 8)
+                UpdateSlices(byte);
+
+        for (; byte != bytes.end(); ++byte)
+            Update(*byte);
     }
 
-    template<typename CRC_TYPE, CRC_TYPE Polynomial, CRC_TYPE InitValue, CRC_TYPE FinalXor, bool ReflectInput, bool ReflectOutput>
-    constexpr CRC_TYPE Crc<CRC_TYPE, Polynomial, InitValue, FinalXor, ReflectInput, ReflectOutput>::Result() const
+    template<typename CRC_TYPE, CRC_TYPE Polynomial, CRC_TYPE InitValue, CRC_TYPE FinalXor, bool ReflectInput, bool ReflectOutput, std::size_t Slices>
+    constexpr void Crc<CRC_TYPE, Polynomial, InitValue, FinalXor, ReflectInput, ReflectOutput, Slices>::UpdateSlices(const uint8_t* bytes)
+    {
+        // The CRC register is combined with the first bytes of the block, after which byte i of the block
+        // contributes the table entry for the CRC of that byte followed by 7 - i zero bytes
+        if constexpr (ReflectInput)
+        {
+            uint64_t block = uint64_t(bytes[0]) | uint64_t(bytes[1]) << 8 | uint64_t(bytes[2]) << 16 | uint64_t(bytes[3]) << 24 | uint64_t(bytes[4]) << 32 | uint64_t(bytes[5]) << 40 | uint64_t(bytes[6]) << 48 | uint64_t(bytes[7]) << 56;
+            block ^= crc;
+
+            crc = table.Slice(7, block) ^ table.Slice(6, block >> 8) ^ table.Slice(5, block >> 16) ^ table.Slice(4, block >> 24) ^ table.Slice(3, block >> 32) ^ table.Slice(2, block >> 40) ^ table.Slice(1, block >> 48) ^ table.Slice(0, block >> 56);
+        }
+        else
+        {
+            uint64_t block = uint64_t(bytes[0]) << 56 | uint64_t(bytes[1]) << 48 | uint64_t(bytes[2]) << 40 | uint64_t(bytes[3]) << 32 | uint64_t(bytes[4]) << 24 | uint64_t(bytes[5]) << 16 | uint64_t(bytes[6]) << 8 | uint64_t(bytes[7]);
+            block ^= uint64_t(crc) << (64 - bitWidth);
+
+            crc = table.Slice(7, block >> 56) ^ table.Slice(6, block >> 48) ^ table.Slice(5, block >> 40) ^ table.Slice(4, block >> 32) ^ table.Slice(3, block >> 24) ^ table.Slice(2, block >> 16) ^ table.Slice(1, block >> 8) ^ table.Slice(0, block);
+        }
+    }
+
+    template<typename CRC_TYPE, CRC_TYPE Polynomial, CRC_TYPE InitValue, CRC_TYPE FinalXor, bool ReflectInput, bool ReflectOutput, std::size_t Slices>
+    constexpr CRC_TYPE Crc<CRC_TYPE, Polynomial, InitValue, FinalXor, ReflectInput, ReflectOutput, Slices>::Result() const
     {
         return crc ^ FinalXor;
     }
 
-    template<typename CRC_TYPE, CRC_TYPE Polynomial, CRC_TYPE InitValue, CRC_TYPE FinalXor, bool ReflectInput, bool ReflectOutput>
-    constexpr void Crc<CRC_TYPE, Polynomial, InitValue, FinalXor, ReflectInput, ReflectOutput>::Reset()
+    template<typename CRC_TYPE, CRC_TYPE Polynomial, CRC_TYPE InitValue, CRC_TYPE FinalXor, bool ReflectInput, bool ReflectOutput, std::size_t Slices>
+    constexpr void Crc<CRC_TYPE, Polynomial, InitValue, FinalXor, ReflectInput, ReflectOutput, Slices>::Reset()
     {
         crc = InitValue;
     }
 
-    template<typename CRC_TYPE, CRC_TYPE Polynomial, CRC_TYPE InitValue, CRC_TYPE FinalXor, bool ReflectInput, bool ReflectOutput>
+    template<typename CRC_TYPE, CRC_TYPE Polynomial, CRC_TYPE InitValue, CRC_TYPE FinalXor, bool ReflectInput, bool ReflectOutput, std::size_t Slices>
     template<typename TYPE>
-    constexpr TYPE Crc<CRC_TYPE, Polynomial, InitValue, FinalXor, ReflectInput, ReflectOutput>::Reflect(TYPE value)
+    constexpr TYPE Crc<CRC_TYPE, Polynomial, InitValue, FinalXor, ReflectInput, ReflectOutput, Slices>::Reflect(TYPE value)
     {
         TYPE result = 0;
         constexpr size_t bitsToReflect = sizeof(TYPE) * CHAR_BIT;
@@ -125,8 +162,8 @@ namespace infra
         return result;
     }
 
-    template<typename CRC_TYPE, CRC_TYPE Polynomial, CRC_TYPE InitValue, CRC_TYPE FinalXor, bool ReflectInput, bool ReflectOutput>
-    constexpr Crc<CRC_TYPE, Polynomial, InitValue, FinalXor, ReflectInput, ReflectOutput>::Table::Table()
+    template<typename CRC_TYPE, CRC_TYPE Polynomial, CRC_TYPE InitValue, CRC_TYPE FinalXor, bool ReflectInput, bool ReflectOutput, std::size_t Slices>
+    constexpr Crc<CRC_TYPE, Polynomial, InitValue, FinalXor, ReflectInput, ReflectOutput, Slices>::Table::Table()
         : table()
     {
         for (unsigned int i = 0; i < 256; ++i)
@@ -152,16 +189,34 @@ namespace infra
             }
 
             if constexpr (ReflectOutput)
-                table[i] = Reflect(crcEntry);
+                table[0][i] = Reflect(crcEntry);
             else
-                table[i] = crcEntry;
+                table[0][i] = crcEntry;
         }
+
+        // Entry i of slice k is the CRC of byte i followed by k zero bytes
+        for (std::size_t slice = 1; slice != Slices; ++slice)
+            for (unsigned int i = 0; i < 256; ++i)
+            {
+                auto previous = table[slice - 1][i];
+
+                if constexpr (ReflectInput)
+                    table[slice][i] = static_cast<CRC_TYPE>(previous >> 8) ^ table[0][static_cast<uint8_t>(previous)];
+                else
+                    table[slice][i] = static_cast<CRC_TYPE>(previous << 8) ^ table[0][static_cast<uint8_t>(previous >> shift)];
+            }
+    }
+
+    template<typename CRC_TYPE, CRC_TYPE Polynomial, CRC_TYPE InitValue, CRC_TYPE FinalXor, bool ReflectInput, bool ReflectOutput, std::size_t Slices>
+    constexpr CRC_TYPE Crc<CRC_TYPE, Polynomial, InitValue, FinalXor, ReflectInput, ReflectOutput, Slices>::Table::operator[](int i) const
+    {
+        return table[0][i];
     }
 
-    template<typename CRC_TYPE, CRC_TYPE Polynomial, CRC_TYPE InitValue, CRC_TYPE FinalXor, bool ReflectInput, bool ReflectOutput>
-    constexpr CRC_TYPE Crc<CRC_TYPE, Polynomial, InitValue, FinalXor, ReflectInput, ReflectOutput>::Table::operator[](int i) const
+    template<typename CRC_TYPE, CRC_TYPE Polynomial, CRC_TYPE InitValue, CRC_TYPE FinalXor, bool ReflectInput, bool ReflectOutput, std::size_t Slices>
+    constexpr CRC_TYPE Crc<CRC_TYPE, Polynomial, InitValue, FinalXor, ReflectInput, ReflectOutput, Slices>::Table::Slice(std::size_t slice, uint64_t value) const
     {
-        return table[i];
+        return table[slice][static_cast<uint8_t>(value)];
     }
 }
 
@@ -0,0 +1,177 @@
+#include "infra/util/BoundedDeque.hpp"
+#include "infra/util/BoundedList.hpp"
+#include "infra/util/BoundedVector.hpp"
+#include "infra/util/CyclicBuffer.hpp"
+#include "infra/util/IntrusiveSet.hpp"
+#include <algorithm>
+#include <array>
+#include <benchmark/benchmark.h>
+#include <numeric>
+#include <random>
+
+namespace
+{
+    constexpr std::size_t maxElements = 4096;
+
+    class SetNode
+        : public infra::IntrusiveSet<SetNode>::NodeType
+    {
+    public:
+        bool operator<(const SetNode& other) const
+        {
+            return value < other.value;
+        }
+
+        int value = 0;
+    };
+
+    void BoundedVectorPushBackAndClear(benchmark::State& state)
+    {
+        infra::BoundedVector<int>::WithMaxSize<maxElements> vector;
+
+        for (auto _ : state)
+        {
+            for (int64_t i = 0; i != state.range(0); ++i)
+                vector.push_back(static_cast<int>(i));
+
+            benchmark::DoNotOptimize(vector.data());
+            vector.clear();
+        }
+
+        state.SetItemsProcessed(state.iterations() * state.range(0));
+    }
+
+    void BoundedVectorInsertAtFront(benchmark::State& state)
+    {
+        infra::BoundedVector<int>::WithMaxSize<maxElements> vector;
+
+        for (auto _ : state)
+        {
+            for (int64_t i = 0; i != state.range(0); ++i)
+                vector.insert(vector.begin(), static_cast<int>(i));
+
+            benchmark::DoNotOptimize(vector.data());
+            vector.clear();
+        }
+
+        state.SetItemsProcessed(state.iterations() * state.range(0));
+    }
+
+    void BoundedDequePushBackPopFront(benchmark::State& state)
+    {
+        infra::BoundedDeque<int>::WithMaxSize<maxElements> deque;
+
+        for (int64_t i = 0; i != state.range(0); ++i)
+            deque.push_back(static_cast<int>(i));
+
+        for (auto _ : state)
+        {
+            auto value = deque.front();
+            deque.pop_front();
+            deque.push_back(value);
+        }
+
+        state.SetItemsProcessed(state.iterations());
+    }
+
+    void BoundedListPushBackPopFront(benchmark::State& state)
+    {
+        infra::BoundedList<int>::WithMaxSize<maxElements> list;
+
+        for (int64_t i = 0; i != state.range(0); ++i)
+            list.push_back(static_cast<int>(i));
+
+        for (auto _ : state)
+        {
+            auto value = list.front();
+            list.pop_front();
+            list.push_back(value);
+        }
+
+        state.SetItemsProcessed(state.iterations());
+    }
+
+    void BoundedListIterate(benchmark::State& state)
+    {
+        infra::BoundedList<int>::WithMaxSize<maxElements> list;
+
+        for (int64_t i = 0; i != state.range(0); ++i)
+            list.push_back(static_cast<int>(i));
+
+        for (auto _ : state)
+            benchmark::DoNotOptimize(std::accumulate(list.begin(), list.end(), 0));
+
+        state.SetItemsProcessed(state.iterations() * state.range(0));
+    }
+
+    void IntrusiveSetInsertAndErase(benchmark::State& state)
+    {
+        std::array<SetNode, maxElements> nodes;
+        std::mt19937 random(1);
+        infra::IntrusiveSet<SetNode> set;
+
+        for (auto& node : nodes)
+            node.value = static_cast<int>(random());
+
+        for (int64_t i = 0; i != state.range(0) - 1; ++i)
+            set.insert(nodes[i]);
+
+        std::size_t index = static_cast<std::size_t>(state.range(0)) - 1;
+        for (auto _ : state)
+        {
+            set.insert(nodes[index]);
+            index = (index + 1) % state.range(0);
+            set.erase(nodes[index]);
+        }
+
+        state.SetItemsProcessed(state.iterations());
+    }
+
+    void IntrusiveSetFind(benchmark::State& state)
+    {
+        std::array<SetNode, maxElements> nodes;
+        std::mt19937 random(1);
+        infra::IntrusiveSet<SetNode> set;
+
+        for (int64_t i = 0; i != state.range(0); ++i)
+        {
+            nodes[i].value = static_cast<int>(random());
+            set.insert(nodes[i]);
+        }
+
+        std::uniform_int_distribution<std::size_t> pick(0, static_cast<std::size_t>(state.range(0)) - 1);
+        for (auto _ : state)
+            benchmark::DoNotOptimize(set.find(nodes[pick(random)]));
+
+        state.SetItemsProcessed(state.iterations());
+    }
+
+    void CyclicBufferPushAndPop(benchmark::State& state)
+    {
+        infra::CyclicBuffer<uint8_t>::WithStorage<maxElements> buffer;
+        std::array<uint8_t, maxElements> data{};
+        std::array<uint8_t, maxElements> destination{};
+        auto chunk = static_cast<std::size_t>(state.range(0));
+
+        buffer.Push(infra::MakeRange(data.data(), data.data() + maxElements / 2 + 1));
+        buffer.Pop(maxElements / 2 + 1);
+
+        for (auto _ : state)
+        {
+            buffer.Push(infra::MakeRange(data.data(), data.data() + chunk));
+            buffer.PopInto(infra::MakeRange(destination.data(), destination.data() + chunk));
+            benchmark::DoNotOptimize(destination.data());
+        }
+
+        state.SetBytesProcessed(state.iterations() * state.range(0));
+    }
+}
+
+BENCHMARK(BoundedVectorPushBackAndClear)->Arg(16)->Arg(256)->Arg(4096);
+BENCHMARK(BoundedVectorInsertAtFront)->Arg(16)->Arg(256);
+BENCHMARK(BoundedDequePushBackPopFront)->Arg(16)->Arg(4096);
+BENCHMARK(BoundedListPushBackPopFront)->Arg(16)->Arg(4096);
+BENCHMARK(BoundedListIterate)->Arg(16)->Arg(4096);
+BENCHMARK(IntrusiveSetInsertAndErase)->Arg(16)->Arg(256)->Arg(4096);
+BENCHMARK(IntrusiveSetFind)->Arg(16)->Arg(256)->Arg(4096);
+BENCHMARK(CyclicBufferPushAndPop)->Arg(1)->Arg(64)->Arg(1024);
@@ -0,0 +1,32 @@
+#include "infra/util/Crc.hpp"
+#include <benchmark/benchmark.h>
+#include <numeric>
+#include <vector>
+
+namespace
+{
+    template<class Crc>
+    void CrcUpdate(benchmark::State& state)
+    {
+        std::vector<uint8_t> data(static_cast<std::size_t>(state.range(0)));
+        std::iota(data.begin(), data.end(), 0);
+
+        for (auto _ : state)
+        {
+            Crc crc;
+            crc.Update(infra::MakeRange(data));
+            benchmark::DoNotOptimize(crc.Result());
+        }
+
+        state.SetBytesProcessed(state.iterations() * state.range(0));
+    }
+}
+
+BENCHMARK_TEMPLATE(CrcUpdate, infra::Crc8Maxim)->Arg(64)->Arg(4096);
+BENCHMARK_TEMPLATE(CrcUpdate, infra::Crc8Maxim::WithSlices<8>)->Arg(64)->Arg(4096);
+BENCHMARK_TEMPLATE(CrcUpdate, infra::Crc16CcittFalse)->Arg(64)->Arg(4096);
+BENCHMARK_TEMPLATE(CrcUpdate, infra::Crc16CcittFalse::WithSlices<8>)->Arg(64)->Arg(4096);
+BENCHMARK_TEMPLATE(CrcUpdate, infra::Crc32)->Arg(64)->Arg(4096);
+BENCHMARK_TEMPLATE(CrcUpdate, infra::Crc32::WithSlices<8>)->Arg(64)->Arg(4096);
+BENCHMARK_TEMPLATE(CrcUpdate, infra::Crc64Ecma)->Arg(64)->Arg(4096);
+BENCHMARK_TEMPLATE(CrcUpdate, infra::Crc64Ecma::WithSlices<8>)->Arg(64)->Arg(4096);
@@ -0,0 +1,80 @@
+#include "infra/util/Function.hpp"
+#include <benchmark/benchmark.h>
+
+namespace
+{
+    void FunctionInvoke(benchmark::State& state)
+    {
+        int counter = 0;
+        infra::Function<void()> f = [&counter]()
+        {
+            ++counter;
+        };
+
+        for (auto _ : state)
+        {
+            f();
+            benchmark::DoNotOptimize(counter);
+        }
+
+        state.SetItemsProcessed(state.iterations());
+    }
+
+    void FunctionInvokeWithArguments(benchmark::State& state)
+    {
+        infra::Function<int(int, int)> f = [](int x, int y)
+        {
+            return x + y;
+        };
+
+        int result = 0;
+        for (auto _ : state)
+        {
+            result = f(result, 1);
+            benchmark::DoNotOptimize(result);
+        }
+
+        state.SetItemsProcessed(state.iterations());
+    }
+
+    void FunctionCopy(benchmark::State& state)
+    {
+        int a = 0;
+        int b = 0;
+        infra::Function<void()> f = [&a, &b]()
+        {
+            ++a;
+            ++b;
+        };
+
+        for (auto _ : state)
+        {
+            infra::Function<void()> copy = f;
+            benchmark::DoNotOptimize(copy);
+        }
+
+        state.SetItemsProcessed(state.iterations());
+    }
+
+    void FunctionAssignLambda(benchmark::State& state)
+    {
+        int a = 0;
+        infra::Function<void()> f;
+
+        for (auto _ : state)
+        {
+            f = [&a]()
+            {
+                ++a;
+            };
+            benchmark::DoNotOptimize(f);
+        }
+
+        state.SetItemsProcessed(state.iterations());
+    }
+}
+
+BENCHMARK(FunctionInvoke);
+BENCHMARK(FunctionInvokeWithArguments);
+BENCHMARK(FunctionCopy);
+BENCHMARK(FunctionAssignLambda);
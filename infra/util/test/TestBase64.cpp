@@ -0,0 +1,152 @@
+#include "infra/util/Base64.hpp"
+#include "gtest/gtest.h"
+#include <array>
+#include <cstdint>
+#include <string>
+#include <vector>
+
+namespace
+{
+    const std::string alphabet = "ABCDEFGHIJKLMNOPQRSTUVWXYZabcdefghijklmnopqrstuvwxyz0123456789+/";
+
+    std::vector<uint8_t> MakeData(std::size_t size)
+    {
+        std::vector<uint8_t> data;
+
+        for (std::size_t i = 0; i != size; ++i)
+            data.push_back(static_cast<uint8_t>(i * 167 + 13));
+
+        return data;
+    }
+
+    std::string ReferenceEncode(const std::vector<uint8_t>& data)
+    {
+        std::string result;
+
+        for (std::size_t i = 0; i + 2 < data.size(); i += 3)
+        {
+            result += alphabet[data[i] >> 2];
+            result += alphabet[((data[i] & 0x03) << 4) | (data[i + 1] >> 4)];
+            result += alphabet[((data[i + 1] & 0x0f) << 2) | (data[i + 2] >> 6)];
+            result += alphabet[data[i + 2] & 0x3f];
+        }
+
+        return result;
+    }
+}
+
+TEST(Base64Test, DecodeBase64Byte_decodes_alphabet)
+{
+    for (std::size_t i = 0; i != 256; ++i)
+    {
+        auto index = alphabet.find(static_cast<char>(i));
+
+        if (index != std::string::npos)
+            EXPECT_EQ(index, infra::DecodeBase64Byte(static_cast<char>(i)));
+        else
+            EXPECT_LE(64, infra::DecodeBase64Byte(static_cast<char>(i)));
+    }
+}
+
+TEST(Base64Test, EncodeBase64Groups_encodes_groups)
+{
+    std::array<uint8_t, 6> data{ 'a', 'b', 'c', 'd', 'e', 'f' };
+    std::array<char, 8> encoded;
+
+    infra::EncodeBase64Groups(data, encoded);
+
+    EXPECT_EQ("YWJjZGVm", std::string(encoded.begin(), encoded.end()));
+}
+
+TEST(Base64Test, EncodeBase64Groups_encodes_all_sizes)
+{
+    for (std::size_t groups = 0; groups != 40; ++groups)
+    {
+        auto data = MakeData(groups * 3);
+        std::string encoded(groups * 4, ' ');
+
+        infra::EncodeBase64Groups(infra::MakeRange(data), infra::MakeRange(&encoded[0], &encoded[0] + encoded.size()));
+
+        EXPECT_EQ(ReferenceEncode(data), encoded) << groups;
+    }
+}
+
+TEST(Base64Test, DecodeBase64Groups_decodes_all_sizes)
+{
+    for (std::size_t groups = 0; groups != 40; ++groups)
+    {
+        auto data = MakeData(groups * 3);
+        auto encoded = ReferenceEncode(data);
+        std::vector<uint8_t> decoded(data.size(), 0);
+
+        EXPECT_EQ(groups, infra::DecodeBase64Groups(infra::MakeRange(encoded.data(), encoded.data() + encoded.size()), infra::MakeRange(decoded)));
+        EXPECT_EQ(data, decoded) << groups;
+    }
+}
+
+TEST(Base64Test, DecodeBase64Groups_is_limited_by_output)
+{
+    std::string encoded = "YWJjZGVm";
+    std::array<uint8_t, 5> decoded{};
+
+    EXPECT_EQ(1, infra::DecodeBase64Groups(infra::MakeRange(encoded.data(), encoded.data() + encoded.size()), decoded));
+    EXPECT_EQ((std::array<uint8_t, 5>{ 'a', 'b', 'c', 0, 0 }), decoded);
+}
+
+TEST(Base64Test, DecodeBase64Groups_stops_at_padding)
+{
+    std::string encoded = "YWJjZA==";
+    std::array<uint8_t, 6> decoded{};
+
+    EXPECT_EQ(1, infra::DecodeBase64Groups(infra::MakeRange(encoded.data(), encoded.data() + encoded.size()), decoded));
+}
+
+TEST(Base64Test, DecodeBase64Groups_stops_at_group_with_invalid_character)
+{
+    auto data = MakeData(96);
+    auto encoded = ReferenceEncode(data);
+    std::vector<uint8_t> decoded(data.size());
+
+    for (std::size_t position = 0; position != encoded.size(); ++position)
+        for (std::size_t character = 0; character != 256; ++character)
+        {
+            auto invalid = encoded;
+            invalid[position] = static_cast<char>(character);
+            auto expected = alphabet.find(static_cast<char>(character)) != std::string::npos ? encoded.size() / 4 : position / 4;
+
+            ASSERT_EQ(expected, infra::DecodeBase64Groups(infra::MakeRange(invalid.data(), invalid.data() + invalid.size()), infra::MakeRange(decoded))) << position << " " << character;
+        }
+}
+
+TEST(Base64Test, EncodeBase64Groups_encodes_tails_after_blocks_without_overrun)
+{
+    for (std::size_t tail = 0; tail != 16; ++tail)
+    {
+        auto data = MakeData(48 + tail);
+        data.resize(data.size() / 3 * 3);
+        auto expected = ReferenceEncode(data);
+        std::string encoded(expected.size() + 16, '!');
+
+        infra::EncodeBase64Groups(infra::MakeRange(data), infra::MakeRange(&encoded[0], &encoded[0] + expected.size()));
+
+        EXPECT_EQ(expected, encoded.substr(0, expected.size())) << tail;
+        EXPECT_EQ(std::string(16, '!'), encoded.substr(expected.size())) << tail;
+    }
+}
+
+TEST(Base64Test, DecodeBase64Groups_decodes_tails_after_blocks_without_overrun)
+{
+    auto data = MakeData(64);
+    auto encoded = ReferenceEncode(data);
+
+    for (std::size_t tail = 0; tail != 16; ++tail)
+    {
+        auto input = encoded.substr(0, 64 + tail);
+        auto groups = input.size() / 4;
+        std::vector<uint8_t> decoded(groups * 3 + 16, 0xaa);
+
+        EXPECT_EQ(groups, infra::DecodeBase64Groups(infra::MakeRange(input.data(), input.data() + input.size()), infra::Head(infra::MakeRange(decoded), groups * 3))) << tail;
+        EXPECT_EQ(std::vector<uint8_t>(data.begin(), data.begin() + groups * 3), std::vector<uint8_t>(decoded.begin(), decoded.begin() + groups * 3)) << tail;
+        EXPECT_EQ(std::vector<uint8_t>(16, 0xaa), std::vector<uint8_t>(decoded.begin() + groups * 3, decoded.end())) << tail;
+    }
+}
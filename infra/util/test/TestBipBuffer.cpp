@@ -0,0 +1,145 @@
+#include "infra/util/BipBuffer.hpp"
+#include "gmock/gmock.h"
+#include "gtest/gtest.h"
+#include <cstdint>
+#include <vector>
+
+class BipBufferTest
+    : public testing::Test
+{
+public:
+    void Push(std::vector<uint8_t> data)
+    {
+        infra::Copy(infra::MakeRange(data), buffer.Reserve(data.size()));
+        buffer.Commit(data.size());
+    }
+
+    std::vector<uint8_t> Segment(std::size_t index) const
+    {
+        auto segment = buffer.Segments()[index];
+        return std::vector<uint8_t>(segment.begin(), segment.end());
+    }
+
+    infra::BipBuffer<uint8_t>::WithStorage<8> buffer;
+};
+
+TEST_F(BipBufferTest, CreateEmpty)
+{
+    EXPECT_TRUE(buffer.Empty());
+    EXPECT_EQ(0, buffer.Size());
+    EXPECT_EQ(8, buffer.MaxSize());
+    EXPECT_TRUE(buffer.CanReserve(8));
+    EXPECT_FALSE(buffer.CanReserve(9));
+}
+
+TEST_F(BipBufferTest, committed_data_is_in_first_segment)
+{
+    Push({ 1, 2, 3 });
+
+    EXPECT_FALSE(buffer.Empty());
+    EXPECT_EQ(3, buffer.Size());
+    EXPECT_EQ((std::vector<uint8_t>{ 1, 2, 3 }), Segment(0));
+    EXPECT_TRUE(Segment(1).empty());
+}
+
+TEST_F(BipBufferTest, only_committed_part_of_reservation_is_added)
+{
+    auto range = buffer.Reserve(4);
+    range[0] = 5;
+    buffer.Commit(1);
+
+    EXPECT_EQ((std::vector<uint8_t>{ 5 }), Segment(0));
+}
+
+TEST_F(BipBufferTest, no_reservation_while_reservation_is_outstanding)
+{
+    buffer.Reserve(2);
+
+    EXPECT_FALSE(buffer.CanReserve(1));
+
+    buffer.Commit(2);
+    EXPECT_TRUE(buffer.CanReserve(1));
+}
+
+TEST_F(BipBufferTest, Pop_removes_oldest_data)
+{
+    Push({ 1, 2, 3 });
+    buffer.Pop(2);
+
+    EXPECT_EQ((std::vector<uint8_t>{ 3 }), Segment(0));
+}
+
+TEST_F(BipBufferTest, empty_buffer_restarts_at_begin_of_storage)
+{
+    Push({ 1, 2, 3, 4, 5, 6 });
+    buffer.Pop(6);
+
+    EXPECT_TRUE(buffer.CanReserve(8));
+}
+
+TEST_F(BipBufferTest, reservation_that_does_not_fit_at_end_wraps_to_begin)
+{
+    Push({ 1, 2, 3, 4, 5, 6 });
+    buffer.Pop(4);
+
+    EXPECT_FALSE(buffer.CanReserve(5));
+    EXPECT_TRUE(buffer.CanReserve(4));
+
+    Push({ 7, 8, 9 });
+
+    EXPECT_EQ(5, buffer.Size());
+    EXPECT_EQ((std::vector<uint8_t>{ 5, 6 }), Segment(0));
+    EXPECT_EQ((std::vector<uint8_t>{ 7, 8, 9 }), Segment(1));
+}
+
+TEST_F(BipBufferTest, wrapped_reservation_is_limited_by_oldest_data)
+{
+    Push({ 1, 2, 3, 4, 5, 6 });
+    buffer.Pop(4);
+    Push({ 7, 8, 9 });
+
+    EXPECT_TRUE(buffer.CanReserve(1));
+    EXPECT_FALSE(buffer.CanReserve(2));
+}
+
+TEST_F(BipBufferTest, popping_first_segment_makes_second_segment_first)
+{
+    Push({ 1, 2, 3, 4, 5, 6 });
+    buffer.Pop(4);
+    Push({ 7, 8, 9 });
+
+    buffer.Pop(3);
+
+    EXPECT_EQ((std::vector<uint8_t>{ 8, 9 }), Segment(0));
+    EXPECT_TRUE(Segment(1).empty());
+    EXPECT_TRUE(buffer.CanReserve(5));
+}
+
+TEST_F(BipBufferTest, outstanding_reservation_is_kept_while_popping)
+{
+    Push({ 1, 2, 3, 4, 5, 6 });
+    buffer.Pop(4);
+    auto range = buffer.Reserve(2);
+
+    buffer.Pop(2);
+
+    range[0] = 7;
+    range[1] = 8;
+    buffer.Commit(2);
+
+    EXPECT_EQ((std::vector<uint8_t>{ 7, 8 }), Segment(0));
+}
+
+TEST_F(BipBufferTest, outstanding_reservation_at_end_is_kept_when_buffer_becomes_empty)
+{
+    Push({ 1, 2 });
+    auto range = buffer.Reserve(2);
+
+    buffer.Pop(2);
+
+    range[0] = 3;
+    range[1] = 4;
+    buffer.Commit(2);
+
+    EXPECT_EQ((std::vector<uint8_t>{ 3, 4 }), Segment(0));
+}
@@ -2,6 +2,7 @@
 #include "infra/util/Crc.hpp"
 #include "gtest/gtest.h"
 #include <array>
+#include <type_traits>
 
 /// Standard input sequence used to calculate the "check value"
 static constexpr std::array<uint8_t, 9> checkInput = { 0x31, 0x32, 0x33, 0x34, 0x35, 0x36, 0x37, 0x38, 0x39 };
@@ -92,3 +93,63 @@ TEST(TestCrc, Reset)
     };
     static_assert(0xffff == Reset(), "Reset failed");
 }
+
+namespace
+{
+    template<class Crc>
+    constexpr auto CheckValue()
+    {
+        Crc crc;
+        crc.Update(checkInput);
+        return crc.Result();
+    }
+
+    template<class Crc, class CrcSliceBy8>
+    void ExpectSliceBy8EqualsBytewise()
+    {
+        std::array<uint8_t, 41> data{};
+        for (std::size_t i = 0; i != data.size(); ++i)
+            data[i] = static_cast<uint8_t>(i * 37 + 11);
+
+        for (std::size_t size = 0; size != data.size(); ++size)
+        {
+            Crc crc;
+            crc.Update(infra::Head(infra::ConstByteRange(data), size));
+            CrcSliceBy8 crcSliceBy8;
+            crcSliceBy8.Update(infra::Head(infra::ConstByteRange(data), size));
+
+            EXPECT_EQ(crc.Result(), crcSliceBy8.Result()) << "size " << size;
+        }
+    }
+}
+
+TEST(TestCrc, slice_by_8_check_values)
+{
+    static_assert(0xa1 == CheckValue<infra::Crc<uint8_t, 0x31, 0, 0, true, true, 8>>());
+    static_assert(0xf7 == CheckValue<infra::Crc<uint8_t, 0x31, 0xff, 0, false, false, 8>>());
+    static_assert(0x4b37 == CheckValue<infra::Crc<uint16_t, 0x8005, 0xffff, 0, true, true, 8>>());
+    static_assert(0x31c3 == CheckValue<infra::Crc<uint16_t, 0x1021, 0, 0, false, false, 8>>());
+    static_assert(0x29B1 == CheckValue<infra::Crc<uint16_t, 0x1021, 0xffff, 0, false, false, 8>>());
+    static_assert(0xCBF43926 == CheckValue<infra::Crc<uint32_t, 0x04C11DB7, 0xffffffff, 0xffffffff, true, true, 8>>());
+    static_assert(0x995DC9BBDF1939FA == CheckValue<infra::Crc<uint64_t, 0x42F0E1EBA9EA3693, 0xFFFFFFFFFFFFFFFF, 0xFFFFFFFFFFFFFFFF, true, true, 8>>());
+    static_assert(0x6C40DF5F0B497347 == CheckValue<infra::Crc<uint64_t, 0x42F0E1EBA9EA3693, 0, 0, false, false, 8>>());
+}
+
+TEST(TestCrc, WithSlices_selects_number_of_slices_of_same_crc)
+{
+    static_assert(std::is_same_v<infra::Crc<uint32_t, 0x04C11DB7, 0xffffffff, 0xffffffff, true, true, 8>, infra::Crc32::WithSlices<8>>);
+    static_assert(std::is_same_v<infra::Crc32, infra::Crc32::WithSlices<8>::WithSlices<1>>);
+    static_assert(0xCBF43926 == CheckValue<infra::Crc32::WithSlices<8>>());
+}
+
+TEST(TestCrc, slice_by_8_equals_bytewise_for_all_sizes)
+{
+    ExpectSliceBy8EqualsBytewise<infra::Crc<uint8_t, 0x31, 0, 0, true, true, 1>, infra::Crc<uint8_t, 0x31, 0, 0, true, true, 8>>();
+    ExpectSliceBy8EqualsBytewise<infra::Crc<uint8_t, 0x31, 0xff, 0, false, false, 1>, infra::Crc<uint8_t, 0x31, 0xff, 0, false, false, 8>>();
+    ExpectSliceBy8EqualsBytewise<infra::Crc<uint16_t, 0x8005, 0xffff, 0, true, true, 1>, infra::Crc<uint16_t, 0x8005, 0xffff, 0, true, true, 8>>();
+    ExpectSliceBy8EqualsBytewise<infra::Crc<uint16_t, 0x1021, 0xffff, 0, false, false, 1>, infra::Crc<uint16_t, 0x1021, 0xffff, 0, false, false, 8>>();
+    ExpectSliceBy8EqualsBytewise<infra::Crc<uint32_t, 0x04C11DB7, 0xffffffff, 0xffffffff, true, true, 1>, infra::Crc<uint32_t, 0x04C11DB7, 0xffffffff, 0xffffffff, true, true, 8>>();
+    ExpectSliceBy8EqualsBytewise<infra::Crc<uint32_t, 0x04C11DB7, 0xffffffff, 0, false, false, 1>, infra::Crc<uint32_t, 0x04C11DB7, 0xffffffff, 0, false, false, 8>>();
+    ExpectSliceBy8EqualsBytewise<infra::Crc<uint64_t, 0x42F0E1EBA9EA3693, 0xFFFFFFFFFFFFFFFF, 0xFFFFFFFFFFFFFFFF, true, true, 1>, infra::Crc<uint64_t, 0x42F0E1EBA9EA3693, 0xFFFFFFFFFFFFFFFF, 0xFFFFFFFFFFFFFFFF, true, true, 8>>();
+    ExpectSliceBy8EqualsBytewise<infra::Crc<uint64_t, 0x42F0E1EBA9EA3693, 0, 0, false, false, 1>, infra::Crc<uint64_t, 0x42F0E1EBA9EA3693, 0, 0, false, false, 8>>();
+}
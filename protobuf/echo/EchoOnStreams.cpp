@@ -31,6 +31,22 @@ namespace services
         Reset();
     }
 
+    void EchoOnStreams::RegisterObserver(infra::Observer<Service, Echo>* observer)
+    {
+        Echo::RegisterObserver(observer);
+
+        if (serviceIndex != nullptr)
+            serviceIndex->Clear();
+    }
+
+    void EchoOnStreams::UnregisterObserver(infra::Observer<Service, Echo>* observer)
+    {
+        Echo::UnregisterObserver(observer);
+
+        if (serviceIndex != nullptr)
+            serviceIndex->Clear();
+    }
+
     void EchoOnStreams::Reset()
     {
         countingSentWriter.OnAllocatable(infra::emptyFunction);
@@ -60,6 +76,12 @@ namespace services
         this->policy = &policy;
     }
 
+    void EchoOnStreams::SetServiceIndex(ServiceIndex& index)
+    {
+        serviceIndex = &index;
+        serviceIndex->Clear();
+    }
+
     void EchoOnStreams::RequestSend(ServiceProxy& serviceProxy)
     {
         policy->RequestSend(serviceProxy, [this](services::ServiceProxy& proxy)
@@ -213,7 +235,7 @@ namespace services
                 ContinueReceiveMessage();
         }
 
-        if (readerPtr != nullptr && readerPtr->Empty() && !limitedReaderAccess.Referenced())
+        if (readerPtr != nullptr && readerPtr->Empty() && !limitedReaderAccess.Referenced() && !ExecutingMethod())
         {
             bufferedReader.reset();
             readerPtr = nullptr;
@@ -274,27 +296,45 @@ namespace services
 
     void EchoOnStreams::StartMethod(uint32_t serviceId, uint32_t methodId, uint32_t size)
     {
-        if (!NotifyObservers([this, serviceId, methodId, size](auto& service)
-                {
-                    if (service.AcceptsService(serviceId))
-                    {
-                        methodDeserializer = StartingMethod(serviceId, methodId, service.StartMethod(serviceId, methodId, size, errorPolicy));
-                        return true;
-                    }
-
-                    return false;
-                }))
+        auto service = FindService(serviceId);
+
+        if (service != nullptr)
+            methodDeserializer = StartingMethod(serviceId, methodId, service->StartMethod(serviceId, methodId, size, errorPolicy));
+        else
         {
             errorPolicy.ServiceNotFound(serviceId);
             methodDeserializer = StartingMethod(serviceId, methodId, deserializerDummy.Emplace(*this));
         }
     }
 
+    Service* EchoOnStreams::FindService(uint32_t serviceId)
+    {
+        if (serviceIndex != nullptr)
+            if (auto service = serviceIndex->Find(serviceId))
+                return service;
+
+        Service* result = nullptr;
+        NotifyObservers([serviceId, &result](auto& service)
+            {
+                if (service.AcceptsService(serviceId))
+                {
+                    result = &service;
+                    return true;
+                }
+
+                return false;
+            });
+
+        if (result != nullptr && serviceIndex != nullptr)
+            serviceIndex->Add(serviceId, *result);
+
+        return result;
+    }
+
     void EchoOnStreams::LimitedReaderDone()
     {
         delayDataReceived = true;
-        if (bufferedReader->Empty())
-            ReleaseReader();
+        auto releaseReader = bufferedReader->Empty();
 
         if (limitedReader->LimitReached())
         {
@@ -308,6 +348,14 @@ namespace services
                 methodDeserializer->ExecuteMethod();
         }
 
+        // View fields of the message refer into the received data, so while the method is being executed the reader is
+        // only released when the method is done. When more contents must be received, the deserializer copies the views first.
+        if (releaseReader && limitedReader != std::nullopt)
+            methodDeserializer->ReleasingMethodContents();
+
+        if (releaseReader && !ExecutingMethod())
+            ReleaseReader();
+
         delayDataReceived = false;
         if (delayedDataReceived)
         {
@@ -315,4 +363,9 @@ namespace services
             DataReceivedInReader();
         }
     }
+
+    bool EchoOnStreams::ExecutingMethod() const
+    {
+        return methodDeserializer != nullptr && limitedReader == std::nullopt;
+    }
 }
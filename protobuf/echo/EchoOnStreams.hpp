@@ -12,6 +12,7 @@
 #include "protobuf/echo/Echo.hpp"
 #include "protobuf/echo/EchoErrorPolicy.hpp"
 #include "protobuf/echo/Serialization.hpp"
+#include "protobuf/echo/ServiceIndex.hpp"
 #include <cstddef>
 #include <cstdint>
 #include <optional>
@@ -32,7 +33,14 @@ namespace services
         void CancelRequestSend(ServiceProxy& serviceProxy) override;
         services::MethodSerializerFactory& SerializerFactory() override;
 
+        // Incoming messages are dispatched via the index instead of by asking each service whether it accepts the service id.
+        // Services must answer AcceptsService consistently for as long as they are registered.
+        void SetServiceIndex(ServiceIndex& index);
+
     protected:
+        void RegisterObserver(infra::Observer<Service, Echo>* observer) override;
+        void UnregisterObserver(infra::Observer<Service, Echo>* observer) override;
+
         void Reset();
         virtual infra::SharedPtr<MethodSerializer> GrantSend(ServiceProxy& proxy);
         virtual infra::SharedPtr<MethodDeserializer> StartingMethod(uint32_t serviceId, uint32_t methodId, infra::SharedPtr<MethodDeserializer>&& deserializer);
@@ -54,7 +62,9 @@ namespace services
         void StartReceiveMessage();
         void ContinueReceiveMessage();
         void StartMethod(uint32_t serviceId, uint32_t methodId, uint32_t size);
+        Service* FindService(uint32_t serviceId);
         void LimitedReaderDone();
+        bool ExecutingMethod() const;
 
     private:
         struct CountingSentWriter
@@ -84,6 +94,7 @@ namespace services
         services::MethodSerializerFactory& serializerFactory;
         const EchoErrorPolicy& errorPolicy;
         EchoPolicy* policy = &defaultPolicy;
+        ServiceIndex* serviceIndex = nullptr;
 
         infra::IntrusiveList<ServiceProxy> sendRequesters;
         ServiceProxy* sendingProxy = nullptr;
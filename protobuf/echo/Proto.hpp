@@ -3,6 +3,8 @@
 
 #include "infra/syntax/ProtoFormatter.hpp"
 #include "infra/syntax/ProtoParser.hpp"
+#include "infra/util/Function.hpp"
+#include "infra/util/StaticStorage.hpp"
 #include <cstdint>
 
 namespace services
@@ -77,6 +79,36 @@ namespace services
     struct ProtoUnboundedRepeated
     {};
 
+    // Storage of a bytes field with the (streamed) option. When sending, contents refers to the bytes to be sent.
+    // When receiving, the bytes are not stored; each chunk is passed to onChunk as soon as it has been received.
+    struct StreamedBytes
+    {
+        StreamedBytes() = default;
+        StreamedBytes(const uint8_t* begin, const uint8_t* end);
+
+        bool operator==(const StreamedBytes& other) const;
+        bool operator!=(const StreamedBytes& other) const;
+
+        infra::ConstByteRange contents;
+        infra::Function<void(infra::ConstByteRange chunk)> onChunk;
+    };
+
+    // Storage of a repeated field with the (streamed) option. When sending, elements refers to the elements to be sent.
+    // When receiving, only the element being received is stored; it is passed to onElement as soon as it is complete.
+    template<class T>
+    struct StreamedRepeated
+    {
+        StreamedRepeated() = default;
+        StreamedRepeated(const T* begin, const T* end);
+
+        bool operator==(const StreamedRepeated& other) const;
+        bool operator!=(const StreamedRepeated& other) const;
+
+        infra::MemoryRange<const T> elements;
+        infra::Function<void(const T& element)> onElement;
+        T element{};
+    };
+
     void SerializeField(ProtoBool, infra::ProtoFormatter& formatter, bool value, uint32_t fieldNumber);
     void SerializeField(ProtoUInt32, infra::ProtoFormatter& formatter, uint32_t value, uint32_t fieldNumber);
     void SerializeField(ProtoInt32, infra::ProtoFormatter& formatter, int32_t value, uint32_t fieldNumber);
@@ -102,7 +134,29 @@ namespace services
     template<std::size_t Max>
     void SerializeField(ProtoBytes<Max>, infra::ProtoFormatter& formatter, const infra::BoundedVector<uint8_t>& value, uint32_t fieldNumber);
     template<std::size_t Max>
+    void SerializeField(ProtoBytes<Max>, infra::ProtoFormatter& formatter, infra::ConstByteRange value, uint32_t fieldNumber);
+    template<std::size_t Max>
     void SerializeField(ProtoString<Max>, infra::ProtoFormatter& formatter, infra::BoundedConstString value, uint32_t fieldNumber);
+    void SerializeField(ProtoUnboundedBytes, infra::ProtoFormatter& formatter, const StreamedBytes& value, uint32_t fieldNumber);
+    template<std::size_t Max>
+    void SerializeField(ProtoBytes<Max>, infra::ProtoFormatter& formatter, const StreamedBytes& value, uint32_t fieldNumber);
+    template<std::size_t Max, class T, class U>
+    void SerializeField(ProtoRepeated<Max, T>, infra::ProtoFormatter& formatter, const StreamedRepeated<U>& value, uint32_t fieldNumber);
+    template<class T, class U>
+    void SerializeField(ProtoUnboundedRepeated<T>, infra::ProtoFormatter& formatter, const StreamedRepeated<U>& value, uint32_t fieldNumber);
+
+    // Fixed-size fields are collected in a ProtoFieldBuffer by generated code, so that a run of them is written with one bounds check
+    void SerializeField(ProtoBool, infra::ProtoFieldBuffer& buffer, bool value, uint32_t fieldNumber);
+    void SerializeField(ProtoUInt32, infra::ProtoFieldBuffer& buffer, uint32_t value, uint32_t fieldNumber);
+    void SerializeField(ProtoInt32, infra::ProtoFieldBuffer& buffer, int32_t value, uint32_t fieldNumber);
+    void SerializeField(ProtoUInt64, infra::ProtoFieldBuffer& buffer, uint64_t value, uint32_t fieldNumber);
+    void SerializeField(ProtoInt64, infra::ProtoFieldBuffer& buffer, int64_t value, uint32_t fieldNumber);
+    void SerializeField(ProtoFixed32, infra::ProtoFieldBuffer& buffer, uint32_t value, uint32_t fieldNumber);
+    void SerializeField(ProtoFixed64, infra::ProtoFieldBuffer& buffer, uint64_t value, uint32_t fieldNumber);
+    void SerializeField(ProtoSFixed32, infra::ProtoFieldBuffer& buffer, int32_t value, uint32_t fieldNumber);
+    void SerializeField(ProtoSFixed64, infra::ProtoFieldBuffer& buffer, int64_t value, uint32_t fieldNumber);
+    template<class T>
+    void SerializeField(ProtoEnum<T>, infra::ProtoFieldBuffer& buffer, T value, uint32_t fieldNumber);
 
     void DeserializeField(ProtoBool, infra::ProtoParser& parser, infra::ProtoParser::FieldVariant& field, bool& value);
     void DeserializeField(ProtoUInt32, infra::ProtoParser& parser, infra::ProtoParser::FieldVariant& field, uint32_t& value);
@@ -134,6 +188,13 @@ namespace services
     void DeserializeField(ProtoString<Max>, infra::ProtoParser& parser, infra::ProtoParser::FieldVariant& field, infra::BoundedString& value);
     template<std::size_t Max>
     void DeserializeField(ProtoString<Max>, infra::ProtoParser& parser, infra::ProtoParser::FieldVariant& field, infra::BoundedConstString& value);
+    void DeserializeField(ProtoUnboundedBytes, infra::ProtoParser& parser, infra::ProtoParser::FieldVariant& field, StreamedBytes& value);
+    template<std::size_t Max>
+    void DeserializeField(ProtoBytes<Max>, infra::ProtoParser& parser, infra::ProtoParser::FieldVariant& field, StreamedBytes& value);
+    template<std::size_t Max, class T, class U>
+    void DeserializeField(ProtoRepeated<Max, T>, infra::ProtoParser& parser, infra::ProtoParser::FieldVariant& field, StreamedRepeated<U>& value);
+    template<class T, class U>
+    void DeserializeField(ProtoUnboundedRepeated<T>, infra::ProtoParser& parser, infra::ProtoParser::FieldVariant& field, StreamedRepeated<U>& value);
 
     void DeserializeField(ProtoBool, infra::ProtoParser& parser, infra::ProtoParser::PartialFieldVariant& field, bool& value);
     void DeserializeField(ProtoUInt32, infra::ProtoParser& parser, infra::ProtoParser::PartialFieldVariant& field, uint32_t& value);
@@ -226,8 +287,99 @@ namespace services
         static constexpr uint32_t value = MaxFieldsDepth<T, std::make_index_sequence<T::numberOfFields>>::value + 1;
     };
 
+    // Number of bytes needed to hold copies of all view fields of a message
+    template<class Proto, class Type>
+    struct ViewStorageSize
+    {
+        static constexpr uint32_t value = 0;
+    };
+
+    template<std::size_t Max>
+    struct ViewStorageSize<ProtoString<Max>, infra::BoundedConstString>
+    {
+        static constexpr uint32_t value = Max;
+    };
+
+    template<std::size_t Max>
+    struct ViewStorageSize<ProtoBytes<Max>, infra::ConstByteRange>
+    {
+        static constexpr uint32_t value = Max;
+    };
+
+    template<std::size_t Max, class T, class Type>
+    struct ViewStorageSize<ProtoRepeated<Max, T>, Type>
+    {
+        static constexpr uint32_t value = Max * ViewStorageSize<T, typename Type::value_type>::value;
+    };
+
+    template<class T, class Type>
+    struct ViewStorageSize<ProtoUnboundedRepeated<T>, Type>
+    {
+        static_assert(ViewStorageSize<T, typename Type::value_type>::value == 0, "Elements of an unbounded repeated field cannot hold views");
+        static constexpr uint32_t value = 0;
+    };
+
+    // Only the element being received is stored
+    template<std::size_t Max, class T, class U>
+    struct ViewStorageSize<ProtoRepeated<Max, T>, StreamedRepeated<U>>
+    {
+        static constexpr uint32_t value = ViewStorageSize<T, U>::value;
+    };
+
+    template<class T, class U>
+    struct ViewStorageSize<ProtoUnboundedRepeated<T>, StreamedRepeated<U>>
+    {
+        static constexpr uint32_t value = ViewStorageSize<T, U>::value;
+    };
+
+    template<class T, class I>
+    struct FieldsViewStorageSize;
+
+    template<class T, std::size_t... I>
+    struct FieldsViewStorageSize<T, std::integer_sequence<std::size_t, I...>>
+    {
+        static constexpr uint32_t value = (0 + ... + ViewStorageSize<typename T::template ProtoType<I>, typename T::template Type<I>>::value);
+    };
+
+    template<class T>
+    struct ViewStorageSize<ProtoMessage<T>, T>
+    {
+        static constexpr uint32_t value = FieldsViewStorageSize<T, std::make_index_sequence<T::numberOfFields>>::value;
+    };
+
     ////    Implementation    ////
 
+    inline StreamedBytes::StreamedBytes(const uint8_t* begin, const uint8_t* end)
+        : contents(begin, end)
+    {}
+
+    inline bool StreamedBytes::operator==(const StreamedBytes& other) const
+    {
+        return contents == other.contents;
+    }
+
+    inline bool StreamedBytes::operator!=(const StreamedBytes& other) const
+    {
+        return !(*this == other);
+    }
+
+    template<class T>
+    StreamedRepeated<T>::StreamedRepeated(const T* begin, const T* end)
+        : elements(begin, end)
+    {}
+
+    template<class T>
+    bool StreamedRepeated<T>::operator==(const StreamedRepeated& other) const
+    {
+        return elements == other.elements;
+    }
+
+    template<class T>
+    bool StreamedRepeated<T>::operator!=(const StreamedRepeated& other) const
+    {
+        return !(*this == other);
+    }
+
     inline void SerializeField(ProtoBool, infra::ProtoFormatter& formatter, bool value, uint32_t fieldNumber)
     {
         formatter.PutVarIntField(value, fieldNumber);
@@ -273,6 +425,51 @@ namespace services
         formatter.PutFixed64Field(static_cast<uint64_t>(value), fieldNumber);
     }
 
+    inline void SerializeField(ProtoBool, infra::ProtoFieldBuffer& buffer, bool value, uint32_t fieldNumber)
+    {
+        buffer.PutVarIntField(value, fieldNumber);
+    }
+
+    inline void SerializeField(ProtoUInt32, infra::ProtoFieldBuffer& buffer, uint32_t value, uint32_t fieldNumber)
+    {
+        buffer.PutVarIntField(value, fieldNumber);
+    }
+
+    inline void SerializeField(ProtoInt32, infra::ProtoFieldBuffer& buffer, int32_t value, uint32_t fieldNumber)
+    {
+        buffer.PutVarIntField(value, fieldNumber);
+    }
+
+    inline void SerializeField(ProtoUInt64, infra::ProtoFieldBuffer& buffer, uint64_t value, uint32_t fieldNumber)
+    {
+        buffer.PutVarIntField(value, fieldNumber);
+    }
+
+    inline void SerializeField(ProtoInt64, infra::ProtoFieldBuffer& buffer, int64_t value, uint32_t fieldNumber)
+    {
+        buffer.PutVarIntField(value, fieldNumber);
+    }
+
+    inline void SerializeField(ProtoFixed32, infra::ProtoFieldBuffer& buffer, uint32_t value, uint32_t fieldNumber)
+    {
+        buffer.PutFixed32Field(value, fieldNumber);
+    }
+
+    inline void SerializeField(ProtoFixed64, infra::ProtoFieldBuffer& buffer, uint64_t value, uint32_t fieldNumber)
+    {
+        buffer.PutFixed64Field(value, fieldNumber);
+    }
+
+    inline void SerializeField(ProtoSFixed32, infra::ProtoFieldBuffer& buffer, int32_t value, uint32_t fieldNumber)
+    {
+        buffer.PutFixed32Field(static_cast<uint32_t>(value), fieldNumber);
+    }
+
+    inline void SerializeField(ProtoSFixed64, infra::ProtoFieldBuffer& buffer, int64_t value, uint32_t fieldNumber)
+    {
+        buffer.PutFixed64Field(static_cast<uint64_t>(value), fieldNumber);
+    }
+
     inline void SerializeField(ProtoUnboundedString, infra::ProtoFormatter& formatter, const std::string& value, uint32_t fieldNumber)
     {
         formatter.PutStringField(value, fieldNumber);
@@ -317,18 +514,55 @@ namespace services
         formatter.PutVarIntField(static_cast<uint64_t>(value), fieldNumber);
     }
 
+    template<class T>
+    void SerializeField(ProtoEnum<T>, infra::ProtoFieldBuffer& buffer, T value, uint32_t fieldNumber)
+    {
+        buffer.PutVarIntField(static_cast<uint64_t>(value), fieldNumber);
+    }
+
     template<std::size_t Max>
     void SerializeField(ProtoBytes<Max>, infra::ProtoFormatter& formatter, const infra::BoundedVector<uint8_t>& value, uint32_t fieldNumber)
     {
         formatter.PutBytesField(infra::MakeRange(value), fieldNumber);
     }
 
+    template<std::size_t Max>
+    void SerializeField(ProtoBytes<Max>, infra::ProtoFormatter& formatter, infra::ConstByteRange value, uint32_t fieldNumber)
+    {
+        formatter.PutBytesField(value, fieldNumber);
+    }
+
     template<std::size_t Max>
     void SerializeField(ProtoString<Max>, infra::ProtoFormatter& formatter, infra::BoundedConstString value, uint32_t fieldNumber)
     {
         formatter.PutStringField(value, fieldNumber);
     }
 
+    inline void SerializeField(ProtoUnboundedBytes, infra::ProtoFormatter& formatter, const StreamedBytes& value, uint32_t fieldNumber)
+    {
+        formatter.PutBytesField(value.contents, fieldNumber);
+    }
+
+    template<std::size_t Max>
+    void SerializeField(ProtoBytes<Max>, infra::ProtoFormatter& formatter, const StreamedBytes& value, uint32_t fieldNumber)
+    {
+        formatter.PutBytesField(value.contents, fieldNumber);
+    }
+
+    template<std::size_t Max, class T, class U>
+    void SerializeField(ProtoRepeated<Max, T>, infra::ProtoFormatter& formatter, const StreamedRepeated<U>& value, uint32_t fieldNumber)
+    {
+        for (auto& v : value.elements)
+            SerializeField(T(), formatter, v, fieldNumber);
+    }
+
+    template<class T, class U>
+    void SerializeField(ProtoUnboundedRepeated<T>, infra::ProtoFormatter& formatter, const StreamedRepeated<U>& value, uint32_t fieldNumber)
+    {
+        for (auto& v : value.elements)
+            SerializeField(T(), formatter, v, fieldNumber);
+    }
+
     inline void DeserializeField(ProtoBool, infra::ProtoParser& parser, infra::ProtoParser::FieldVariant& field, bool& value)
     {
         parser.ReportFormatResult(std::holds_alternative<uint64_t>(field));
@@ -483,6 +717,38 @@ namespace services
             std::get<infra::ProtoLengthDelimited>(field).GetStringReference(value);
     }
 
+    inline void DeserializeField(ProtoUnboundedBytes, infra::ProtoParser& parser, infra::ProtoParser::FieldVariant& field, StreamedBytes& value)
+    {
+        parser.ReportFormatResult(std::holds_alternative<infra::ProtoLengthDelimited>(field));
+        if (std::holds_alternative<infra::ProtoLengthDelimited>(field))
+        {
+            std::get<infra::ProtoLengthDelimited>(field).GetBytesReference(value.contents);
+            if (value.onChunk)
+                value.onChunk(value.contents);
+        }
+    }
+
+    template<std::size_t Max>
+    void DeserializeField(ProtoBytes<Max>, infra::ProtoParser& parser, infra::ProtoParser::FieldVariant& field, StreamedBytes& value)
+    {
+        DeserializeField(ProtoUnboundedBytes(), parser, field, value);
+    }
+
+    template<std::size_t Max, class T, class U>
+    void DeserializeField(ProtoRepeated<Max, T>, infra::ProtoParser& parser, infra::ProtoParser::FieldVariant& field, StreamedRepeated<U>& value)
+    {
+        DeserializeField(ProtoUnboundedRepeated<T>(), parser, field, value);
+    }
+
+    template<class T, class U>
+    void DeserializeField(ProtoUnboundedRepeated<T>, infra::ProtoParser& parser, infra::ProtoParser::FieldVariant& field, StreamedRepeated<U>& value)
+    {
+        infra::ReConstruct(value.element);
+        DeserializeField(T(), parser, field, value.element);
+        if (!parser.FormatFailed() && value.onElement)
+            value.onElement(value.element);
+    }
+
     inline void DeserializeField(ProtoBool, infra::ProtoParser& parser, infra::ProtoParser::PartialFieldVariant& field, bool& value)
     {
         parser.ReportFormatResult(std::holds_alternative<uint64_t>(field));
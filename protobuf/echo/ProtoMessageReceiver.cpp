@@ -1,25 +1,36 @@
 #include "protobuf/echo/ProtoMessageReceiver.hpp"
-#include "infra/stream/BufferingStreamReader.hpp"
+#include <limits>
 
 namespace services
 {
-    ProtoMessageReceiverBase::ProtoMessageReceiverBase(infra::BoundedVector<std::pair<uint32_t, infra::Function<void(const infra::DataInputStream& stream)>>>& stack)
+    ProtoMessageReceiverBase::ProtoMessageReceiverBase(infra::BoundedVector<StackEntry>& stack, infra::BoundedVector<uint8_t>& viewStorage)
         : stack(stack)
+        , viewStorage(viewStorage)
     {}
 
     void ProtoMessageReceiverBase::Feed(infra::StreamReaderWithRewinding& data)
     {
+        // Data fed earlier is not guaranteed to be valid anymore, so views taken from it would dangle unless they have been kept
+        if (viewsFed)
+        {
+            failed = true;
+            while (!data.Empty())
+                data.ExtractContiguousRange(std::numeric_limits<std::size_t>::max());
+            return;
+        }
+
         infra::BufferingStreamReader reader{ buffer, data };
+        feedingReader = &reader;
 
         while (true)
         {
-            infra::LimitedStreamReaderWithRewinding limitedReader(reader, stack.back().first);
+            infra::LimitedStreamReaderWithRewinding limitedReader(reader, stack.back().size);
             infra::DataInputStream::WithErrorPolicy stream{ limitedReader, infra::softFail };
 
             auto available = limitedReader.Available();
 
             const auto& current = stack.back();
-            current.second(stream);
+            current.feed(stream);
 
             ConsumeStack(current, available - limitedReader.Available());
 
@@ -29,6 +40,8 @@ namespace services
                 break;
             }
         }
+
+        feedingReader = nullptr;
     }
 
     bool ProtoMessageReceiverBase::Failed() const
@@ -36,20 +49,28 @@ namespace services
         return failed;
     }
 
-    void ProtoMessageReceiverBase::ConsumeStack(const std::pair<uint32_t, infra::Function<void(const infra::DataInputStream& stream)>>& current, std::size_t amount)
+    void ProtoMessageReceiverBase::ConsumeStack(const StackEntry& current, std::size_t amount)
     {
-        if (&current != &stack.front())
-        {
+        auto outermost = &current == &stack.front();
+
+        if (!outermost)
             for (auto& i : stack)
             {
-                i.first -= amount;
+                i.size -= amount;
 
                 if (&i == &current)
                     break;
             }
 
-            while (stack.size() > 1 && stack.back().first == 0)
-                stack.pop_back();
+        // Empty entries pushed by the outermost message are popped when they are fed next, except for streamed elements,
+        // which are reported right away so that an empty element at the end of the data is not held back
+        while (stack.size() > 1 && stack.back().size == 0 && (!outermost || stack.back().onDone))
+        {
+            auto onDone = stack.back().onDone;
+            stack.pop_back();
+
+            if (onDone)
+                onDone();
         }
     }
 
@@ -101,13 +122,13 @@ namespace services
     namespace
     {
         template<class C>
-        void DeserializeContainer(infra::BoundedVector<std::pair<uint32_t, infra::Function<void(const infra::DataInputStream& stream)>>>& stack, infra::ProtoParser& parser, infra::ProtoParser::PartialFieldVariant& field, C& value)
+        void DeserializeContainer(infra::BoundedVector<ProtoMessageReceiverBase::StackEntry>& stack, infra::ProtoParser& parser, infra::ProtoParser::PartialFieldVariant& field, C& value)
         {
             parser.ReportFormatResult(std::holds_alternative<infra::PartialProtoLengthDelimited>(field));
             if (std::holds_alternative<infra::PartialProtoLengthDelimited>(field))
             {
                 auto bytesSize = std::get<infra::PartialProtoLengthDelimited>(field).length;
-                stack.emplace_back(bytesSize, [&value](const infra::DataInputStream& stream)
+                stack.push_back(ProtoMessageReceiverBase::StackEntry{ bytesSize, [&value](const infra::DataInputStream& stream)
                     {
                         while (!stream.Empty())
                         {
@@ -116,10 +137,131 @@ namespace services
                             range.shrink_from_back_to(value.max_size() - value.size());
                             value.insert(value.end(), range.begin(), range.end());
                         }
-                    });
+                    } });
                 value.clear();
             }
         }
+
+        void AssignView(infra::BoundedConstString& value, infra::ConstByteRange range)
+        {
+            value = infra::BoundedConstString(reinterpret_cast<const char*>(range.begin()), range.size());
+        }
+
+        void AssignView(infra::ConstByteRange& value, infra::ConstByteRange range)
+        {
+            value = range;
+        }
+
+        infra::ConstByteRange ViewBytes(infra::BoundedConstString value)
+        {
+            return infra::StringAsByteRange(value);
+        }
+
+        infra::ConstByteRange ViewBytes(infra::ConstByteRange value)
+        {
+            return value;
+        }
+
+        void DeserializeStreamed(infra::BoundedVector<ProtoMessageReceiverBase::StackEntry>& stack, infra::ProtoParser& parser, infra::ProtoParser::PartialFieldVariant& field, StreamedBytes& value)
+        {
+            parser.ReportFormatResult(std::holds_alternative<infra::PartialProtoLengthDelimited>(field));
+            if (std::holds_alternative<infra::PartialProtoLengthDelimited>(field))
+            {
+                auto bytesSize = std::get<infra::PartialProtoLengthDelimited>(field).length;
+                stack.push_back(ProtoMessageReceiverBase::StackEntry{ bytesSize, [&value](const infra::DataInputStream& stream)
+                    {
+                        while (!stream.Empty())
+                        {
+                            auto range = stream.ContiguousRange();
+                            if (value.onChunk)
+                                value.onChunk(range);
+                        }
+                    } });
+                value.contents = infra::ConstByteRange();
+            }
+        }
+    }
+
+    template<class View>
+    void ProtoMessageReceiverBase::DeserializeView(infra::ProtoParser& parser, infra::ProtoParser::PartialFieldVariant& field, View& value)
+    {
+        parser.ReportFormatResult(std::holds_alternative<infra::PartialProtoLengthDelimited>(field));
+        if (std::holds_alternative<infra::PartialProtoLengthDelimited>(field))
+        {
+            stack.push_back(StackEntry{ std::get<infra::PartialProtoLengthDelimited>(field).length, [this, &value](const infra::DataInputStream& stream)
+                {
+                    auto bytesSize = stack.back().size;
+                    auto fromInput = FeedingFromInput();
+                    auto range = stream.ContiguousRange();
+                    auto copied = ViewBytes(value);
+
+                    if (copied.empty() && fromInput && range.size() == bytesSize)
+                    {
+                        AssignView(value, range);
+                        viewsFed = true;
+                    }
+                    else
+                    {
+                        auto view = CopyView(copied, range, stream);
+                        partialViewSize = view.size() - copied.size() == bytesSize ? 0 : view.size();
+                        AssignView(value, view);
+                    }
+                } });
+            value = View();
+        }
+    }
+
+    bool ProtoMessageReceiverBase::FeedingFromInput() const
+    {
+        // buffer holds data left over from an earlier call to Feed, and is reused once the current call ends
+        return feedingReader->ConstructSaveMarker() >= buffer.size();
+    }
+
+    infra::ConstByteRange ProtoMessageReceiverBase::CopyView(infra::ConstByteRange copied, infra::ConstByteRange range, const infra::DataInputStream& stream)
+    {
+        // Parts of a field fed earlier have been copied to the end of viewStorage, so the next parts are appended to them
+        const uint8_t* begin = viewStorage.end() - copied.size();
+
+        while (true)
+        {
+            stream.ErrorPolicy().ReportResult(range.size() <= viewStorage.max_size() - viewStorage.size());
+            range.shrink_from_back_to(viewStorage.max_size() - viewStorage.size());
+            viewStorage.insert(viewStorage.end(), range.begin(), range.end());
+
+            if (stream.Empty())
+                break;
+
+            range = stream.ContiguousRange();
+        }
+
+        return infra::ConstByteRange(begin, viewStorage.end());
+    }
+
+    void ProtoMessageReceiverBase::KeepViews(ProtoStringBase, infra::BoundedConstString& value)
+    {
+        AssignView(value, KeepView(ViewBytes(value)));
+    }
+
+    void ProtoMessageReceiverBase::KeepViews(ProtoBytesBase, infra::ConstByteRange& value)
+    {
+        AssignView(value, KeepView(value));
+    }
+
+    infra::ConstByteRange ProtoMessageReceiverBase::KeepView(infra::ConstByteRange view)
+    {
+        if (view.empty() || (view.begin() >= viewStorage.begin() && view.end() <= viewStorage.end()))
+            return view;
+
+        if (view.size() > viewStorage.max_size() - viewStorage.size())
+        {
+            failed = true;
+            return infra::ConstByteRange();
+        }
+
+        // A field of which only a part has been copied must remain at the end of viewStorage
+        auto begin = viewStorage.end() - partialViewSize;
+        viewStorage.insert(begin, view.begin(), view.end());
+        return infra::ConstByteRange(begin, begin + view.size());
     }
 
     void ProtoMessageReceiverBase::DeserializeField(ProtoStringBase, infra::ProtoParser& parser, infra::ProtoParser::PartialFieldVariant& field, infra::BoundedString& value)
@@ -142,16 +284,36 @@ namespace services
         DeserializeContainer(stack, parser, field, value);
     }
 
+    void ProtoMessageReceiverBase::DeserializeField(ProtoStringBase, infra::ProtoParser& parser, infra::ProtoParser::PartialFieldVariant& field, infra::BoundedConstString& value)
+    {
+        DeserializeView(parser, field, value);
+    }
+
+    void ProtoMessageReceiverBase::DeserializeField(ProtoBytesBase, infra::ProtoParser& parser, infra::ProtoParser::PartialFieldVariant& field, infra::ConstByteRange& value)
+    {
+        DeserializeView(parser, field, value);
+    }
+
+    void ProtoMessageReceiverBase::DeserializeField(ProtoBytesBase, infra::ProtoParser& parser, infra::ProtoParser::PartialFieldVariant& field, StreamedBytes& value)
+    {
+        DeserializeStreamed(stack, parser, field, value);
+    }
+
+    void ProtoMessageReceiverBase::DeserializeField(ProtoUnboundedBytes, infra::ProtoParser& parser, infra::ProtoParser::PartialFieldVariant& field, StreamedBytes& value)
+    {
+        DeserializeStreamed(stack, parser, field, value);
+    }
+
     void ProtoMessageReceiverBase::ConsumeUnknownField(infra::ProtoParser::PartialField& field)
     {
         if (std::holds_alternative<infra::PartialProtoLengthDelimited>(field.first))
         {
             auto size = std::get<infra::PartialProtoLengthDelimited>(field.first).length;
-            stack.emplace_back(size, [](const infra::DataInputStream& stream)
+            stack.push_back(StackEntry{ size, [](const infra::DataInputStream& stream)
                 {
                     while (!stream.Empty())
                         stream.ContiguousRange();
-                });
+                } });
         }
     }
 }
@@ -1,6 +1,7 @@
 #ifndef PROTOBUF_PROTO_MESSAGE_RECEIVER_HPP
 #define PROTOBUF_PROTO_MESSAGE_RECEIVER_HPP
 
+#include "infra/stream/BufferingStreamReader.hpp"
 #include "infra/syntax/ProtoParser.hpp"
 #include "infra/util/BoundedDeque.hpp"
 #include "infra/util/BoundedVector.hpp"
@@ -11,7 +12,14 @@ namespace services
     class ProtoMessageReceiverBase
     {
     public:
-        explicit ProtoMessageReceiverBase(infra::BoundedVector<std::pair<uint32_t, infra::Function<void(const infra::DataInputStream& stream)>>>& stack);
+        struct StackEntry
+        {
+            uint32_t size;
+            infra::Function<void(const infra::DataInputStream& stream)> feed;
+            infra::Function<void()> onDone; // Invoked when all size bytes have been fed
+        };
+
+        ProtoMessageReceiverBase(infra::BoundedVector<StackEntry>& stack, infra::BoundedVector<uint8_t>& viewStorage);
 
         void Feed(infra::StreamReaderWithRewinding& data);
         bool Failed() const;
@@ -19,9 +27,11 @@ namespace services
     protected:
         template<class Message>
         void FeedForMessage(const infra::DataInputStream& stream, Message& message);
+        template<class Message>
+        void KeepMessageViews(Message& message);
 
     private:
-        void ConsumeStack(const std::pair<uint32_t, infra::Function<void(const infra::DataInputStream& stream)>>& current, std::size_t amount);
+        void ConsumeStack(const StackEntry& current, std::size_t amount);
 
         template<class Message, std::size_t... I>
         bool DeserializeFields(infra::ProtoParser::PartialField& field, infra::ProtoParser& parser, Message& message, std::index_sequence<I...>);
@@ -43,6 +53,12 @@ namespace services
         void DeserializeField(ProtoUnboundedString, infra::ProtoParser& parser, infra::ProtoParser::PartialFieldVariant& field, std::string& value);
         void DeserializeField(ProtoBytesBase, infra::ProtoParser& parser, infra::ProtoParser::PartialFieldVariant& field, infra::BoundedVector<uint8_t>& value);
         void DeserializeField(ProtoUnboundedBytes, infra::ProtoParser& parser, infra::ProtoParser::PartialFieldVariant& field, std::vector<uint8_t>& value);
+        // Views refer into the fed data when the field is fed contiguously, otherwise they refer to a copy in viewStorage
+        void DeserializeField(ProtoStringBase, infra::ProtoParser& parser, infra::ProtoParser::PartialFieldVariant& field, infra::BoundedConstString& value);
+        void DeserializeField(ProtoBytesBase, infra::ProtoParser& parser, infra::ProtoParser::PartialFieldVariant& field, infra::ConstByteRange& value);
+        // Streamed fields are passed on while they are being received, instead of being stored in the message
+        void DeserializeField(ProtoBytesBase, infra::ProtoParser& parser, infra::ProtoParser::PartialFieldVariant& field, StreamedBytes& value);
+        void DeserializeField(ProtoUnboundedBytes, infra::ProtoParser& parser, infra::ProtoParser::PartialFieldVariant& field, StreamedBytes& value);
 
         template<class Enum>
         void DeserializeField(ProtoEnum<Enum>, infra::ProtoParser& parser, infra::ProtoParser::PartialFieldVariant& field, Enum& value) const;
@@ -54,12 +70,44 @@ namespace services
         void DeserializeField(ProtoUnboundedRepeated<ProtoType>, infra::ProtoParser& parser, infra::ProtoParser::PartialFieldVariant& field, Type& value);
         template<class Type>
         void DeserializeField(ProtoUnboundedRepeated<ProtoBool>, infra::ProtoParser& parser, infra::ProtoParser::PartialFieldVariant& field, Type& value);
+        template<class ProtoType, class T>
+        void DeserializeField(ProtoRepeatedBase<ProtoType>, infra::ProtoParser& parser, infra::ProtoParser::PartialFieldVariant& field, StreamedRepeated<T>& value);
+        template<class ProtoType, class T>
+        void DeserializeField(ProtoUnboundedRepeated<ProtoType>, infra::ProtoParser& parser, infra::ProtoParser::PartialFieldVariant& field, StreamedRepeated<T>& value);
+        template<class ProtoType, class T>
+        void DeserializeStreamedElement(infra::ProtoParser& parser, infra::ProtoParser::PartialFieldVariant& field, StreamedRepeated<T>& value);
+
+        template<class View>
+        void DeserializeView(infra::ProtoParser& parser, infra::ProtoParser::PartialFieldVariant& field, View& value);
+        bool FeedingFromInput() const;
+        infra::ConstByteRange CopyView(infra::ConstByteRange copied, infra::ConstByteRange range, const infra::DataInputStream& stream);
+
+        template<class Message, std::size_t... I>
+        void KeepFieldsViews(Message& message, std::index_sequence<I...>);
+        template<std::size_t I, class Message>
+        void KeepFieldViews(Message& message);
+        void KeepViews(ProtoStringBase, infra::BoundedConstString& value);
+        void KeepViews(ProtoBytesBase, infra::ConstByteRange& value);
+        template<class Message>
+        void KeepViews(ProtoMessage<Message>, Message& value);
+        template<class ProtoType, class Type>
+        void KeepViews(ProtoRepeatedBase<ProtoType>, Type& value);
+        template<class ProtoType, class T>
+        void KeepViews(ProtoRepeatedBase<ProtoType>, StreamedRepeated<T>& value);
+        template<class ProtoType, class T>
+        void KeepViews(ProtoUnboundedRepeated<ProtoType>, StreamedRepeated<T>& value);
+        infra::ConstByteRange KeepView(infra::ConstByteRange view);
 
         void ConsumeUnknownField(infra::ProtoParser::PartialField& field);
 
     private:
         infra::BoundedDeque<uint8_t>::WithMaxSize<32> buffer;
-        infra::BoundedVector<std::pair<uint32_t, infra::Function<void(const infra::DataInputStream& stream)>>>& stack;
+        infra::BoundedVector<StackEntry>& stack;
+        infra::BoundedVector<uint8_t>& viewStorage;
+        infra::BufferingStreamReader* feedingReader = nullptr;
+        std::size_t partialViewSize = 0;
+        std::size_t streamedElementViewStorageStart = 0;
+        bool viewsFed = false;
         bool failed = false;
     };
 
@@ -70,13 +118,17 @@ namespace services
     public:
         ProtoMessageReceiver();
 
+        // Copies the views that refer into the data fed so far, so that they stay valid when that data is released
+        void KeepViews();
+
         Message message;
 
     private:
-        infra::BoundedVector<std::pair<uint32_t, infra::Function<void(const infra::DataInputStream& stream)>>>::WithMaxSize<MessageDepth<services::ProtoMessage<Message>>::value + 1> stack{ { std::pair<uint32_t, infra::Function<void(const infra::DataInputStream& stream)>>{ std::numeric_limits<uint32_t>::max(), [this](const infra::DataInputStream& stream)
+        infra::BoundedVector<StackEntry>::WithMaxSize<MessageDepth<services::ProtoMessage<Message>>::value + 1> stack{ { StackEntry{ std::numeric_limits<uint32_t>::max(), [this](const infra::DataInputStream& stream)
             {
                 FeedForMessage(stream, message);
             } } } };
+        infra::BoundedVector<uint8_t>::WithMaxSize<ViewStorageSize<services::ProtoMessage<Message>, Message>::value> viewStorage;
     };
 }
 
@@ -112,6 +164,13 @@ namespace services
         }
     }
 
+    template<class Message>
+    void ProtoMessageReceiverBase::KeepMessageViews(Message& message)
+    {
+        KeepViews(ProtoMessage<Message>(), message);
+        viewsFed = false;
+    }
+
     template<class Message, std::size_t... I>
     bool ProtoMessageReceiverBase::DeserializeFields(infra::ProtoParser::PartialField& field, infra::ProtoParser& parser, Message& message, std::index_sequence<I...>)
     {
@@ -145,10 +204,10 @@ namespace services
         if (std::holds_alternative<infra::PartialProtoLengthDelimited>(field))
         {
             auto messageSize = std::get<infra::PartialProtoLengthDelimited>(field).length;
-            stack.emplace_back(messageSize, [this, &value](const infra::DataInputStream& stream)
+            stack.push_back(StackEntry{ messageSize, [this, &value](const infra::DataInputStream& stream)
                 {
                     FeedForMessage(stream, value);
-                });
+                } });
             infra::ReConstruct(value);
         }
     }
@@ -180,10 +239,95 @@ namespace services
         value.back() = result;
     }
 
+    template<class ProtoType, class T>
+    void ProtoMessageReceiverBase::DeserializeField(ProtoRepeatedBase<ProtoType>, infra::ProtoParser& parser, infra::ProtoParser::PartialFieldVariant& field, StreamedRepeated<T>& value)
+    {
+        DeserializeStreamedElement<ProtoType>(parser, field, value);
+    }
+
+    template<class ProtoType, class T>
+    void ProtoMessageReceiverBase::DeserializeField(ProtoUnboundedRepeated<ProtoType>, infra::ProtoParser& parser, infra::ProtoParser::PartialFieldVariant& field, StreamedRepeated<T>& value)
+    {
+        DeserializeStreamedElement<ProtoType>(parser, field, value);
+    }
+
+    template<class ProtoType, class T>
+    void ProtoMessageReceiverBase::DeserializeStreamedElement(infra::ProtoParser& parser, infra::ProtoParser::PartialFieldVariant& field, StreamedRepeated<T>& value)
+    {
+        infra::ReConstruct(value.element);
+        streamedElementViewStorageStart = viewStorage.size();
+
+        auto stackSize = stack.size();
+        DeserializeField(ProtoType(), parser, field, value.element);
+
+        auto onDone = [this, &value]()
+        {
+            if (value.onElement)
+                value.onElement(value.element);
+
+            // Copies of views in the element are only needed until the element has been passed on
+            if constexpr (ViewStorageSize<ProtoType, T>::value != 0)
+            {
+                viewStorage.resize(streamedElementViewStorageStart);
+                infra::ReConstruct(value.element);
+            }
+        };
+
+        // Length delimited elements are complete when their stack entry is consumed, other elements are complete immediately
+        if (stackSize != stack.size())
+            stack.back().onDone = onDone;
+        else if (!parser.FormatFailed())
+            onDone();
+    }
+
+    template<class Message, std::size_t... I>
+    void ProtoMessageReceiverBase::KeepFieldsViews(Message& message, std::index_sequence<I...>)
+    {
+        (KeepFieldViews<I>(message), ...);
+    }
+
+    template<std::size_t I, class Message>
+    void ProtoMessageReceiverBase::KeepFieldViews(Message& message)
+    {
+        if constexpr (ViewStorageSize<typename Message::template ProtoType<I>, typename Message::template Type<I>>::value != 0)
+            KeepViews(typename Message::template ProtoType<I>(), message.Get(std::integral_constant<uint32_t, I>()));
+    }
+
+    template<class Message>
+    void ProtoMessageReceiverBase::KeepViews(ProtoMessage<Message>, Message& value)
+    {
+        KeepFieldsViews(value, std::make_index_sequence<Message::numberOfFields>{});
+    }
+
+    template<class ProtoType, class Type>
+    void ProtoMessageReceiverBase::KeepViews(ProtoRepeatedBase<ProtoType>, Type& value)
+    {
+        for (auto& element : value)
+            KeepViews(ProtoType(), element);
+    }
+
+    template<class ProtoType, class T>
+    void ProtoMessageReceiverBase::KeepViews(ProtoRepeatedBase<ProtoType>, StreamedRepeated<T>& value)
+    {
+        KeepViews(ProtoType(), value.element);
+    }
+
+    template<class ProtoType, class T>
+    void ProtoMessageReceiverBase::KeepViews(ProtoUnboundedRepeated<ProtoType>, StreamedRepeated<T>& value)
+    {
+        KeepViews(ProtoType(), value.element);
+    }
+
     template<class Message>
     ProtoMessageReceiver<Message>::ProtoMessageReceiver()
-        : ProtoMessageReceiverBase(stack)
+        : ProtoMessageReceiverBase(stack, viewStorage)
     {}
+
+    template<class Message>
+    void ProtoMessageReceiver<Message>::KeepViews()
+    {
+        KeepMessageViews(message);
+    }
 }
 
 #endif
@@ -128,4 +128,28 @@ namespace services
         SerializeRange(stack, formatter, infra::MakeRange(value), fieldNumber, retry);
         return true;
     }
+
+    bool ProtoMessageSenderBase::SerializeField(ProtoStringBase, infra::ProtoFormatter& formatter, infra::BoundedConstString value, uint32_t fieldNumber, bool& retry) const
+    {
+        SerializeRange(stack, formatter, infra::StringAsByteRange(value), fieldNumber, retry);
+        return true;
+    }
+
+    bool ProtoMessageSenderBase::SerializeField(ProtoBytesBase, infra::ProtoFormatter& formatter, infra::ConstByteRange value, uint32_t fieldNumber, bool& retry) const
+    {
+        SerializeRange(stack, formatter, value, fieldNumber, retry);
+        return true;
+    }
+
+    bool ProtoMessageSenderBase::SerializeField(ProtoBytesBase, infra::ProtoFormatter& formatter, const StreamedBytes& value, uint32_t fieldNumber, bool& retry) const
+    {
+        SerializeRange(stack, formatter, value.contents, fieldNumber, retry);
+        return true;
+    }
+
+    bool ProtoMessageSenderBase::SerializeField(ProtoUnboundedBytes, infra::ProtoFormatter& formatter, const StreamedBytes& value, uint32_t fieldNumber, bool& retry) const
+    {
+        SerializeRange(stack, formatter, value.contents, fieldNumber, retry);
+        return true;
+    }
 }
@@ -45,6 +45,10 @@ namespace services
         bool SerializeField(ProtoUnboundedString, infra::ProtoFormatter& formatter, const std::string& value, uint32_t fieldNumber, bool& retry) const;
         bool SerializeField(ProtoBytesBase, infra::ProtoFormatter& formatter, const infra::BoundedVector<uint8_t>& value, uint32_t fieldNumber, bool& retry) const;
         bool SerializeField(ProtoUnboundedBytes, infra::ProtoFormatter& formatter, const std::vector<uint8_t>& value, uint32_t fieldNumber, bool& retry) const;
+        bool SerializeField(ProtoStringBase, infra::ProtoFormatter& formatter, infra::BoundedConstString value, uint32_t fieldNumber, bool& retry) const;
+        bool SerializeField(ProtoBytesBase, infra::ProtoFormatter& formatter, infra::ConstByteRange value, uint32_t fieldNumber, bool& retry) const;
+        bool SerializeField(ProtoBytesBase, infra::ProtoFormatter& formatter, const StreamedBytes& value, uint32_t fieldNumber, bool& retry) const;
+        bool SerializeField(ProtoUnboundedBytes, infra::ProtoFormatter& formatter, const StreamedBytes& value, uint32_t fieldNumber, bool& retry) const;
 
         template<class Enum>
         bool SerializeField(ProtoEnum<Enum>, infra::ProtoFormatter& formatter, const Enum& value, uint32_t fieldNumber, const bool& retry) const;
@@ -54,6 +58,10 @@ namespace services
         bool SerializeField(ProtoRepeatedBase<ProtoType>, const infra::ProtoFormatter& formatter, const infra::BoundedVector<Type>& value, uint32_t fieldNumber, bool& retry) const;
         template<class ProtoType, class Type>
         bool SerializeField(ProtoUnboundedRepeated<ProtoType>, const infra::ProtoFormatter& formatter, const std::vector<Type>& value, uint32_t fieldNumber, bool& retry) const;
+        template<class ProtoType, class Type>
+        bool SerializeField(ProtoRepeatedBase<ProtoType>, const infra::ProtoFormatter& formatter, const StreamedRepeated<Type>& value, uint32_t fieldNumber, bool& retry) const;
+        template<class ProtoType, class Type>
+        bool SerializeField(ProtoUnboundedRepeated<ProtoType>, const infra::ProtoFormatter& formatter, const StreamedRepeated<Type>& value, uint32_t fieldNumber, bool& retry) const;
 
     private:
         infra::BoundedDeque<uint8_t>::WithMaxSize<32> buffer;
@@ -203,6 +211,45 @@ namespace services
         return true;
     }
 
+    template<class ProtoType, class Type>
+    bool ProtoMessageSenderBase::SerializeField(ProtoRepeatedBase<ProtoType>, const infra::ProtoFormatter&, const StreamedRepeated<Type>& value, uint32_t fieldNumber, bool& retry) const
+    {
+        stack.emplace_back(0, [this, &value, fieldNumber, &retry](infra::DataOutputStream& stream, uint32_t& index, const bool&, const infra::StreamWriter& finalWriter, infra::StreamErrorPolicy& errorPolicy)
+            {
+                infra::ProtoFormatter formatter{ stream };
+
+                for (; index != value.elements.size(); ++index)
+                {
+                    if (finalWriter.Available() == 0)
+                    {
+                        errorPolicy.ReportResult(false);
+                        return false;
+                    }
+
+                    auto size = stack.size();
+                    auto result = SerializeField(ProtoType(), formatter, value.elements[index], fieldNumber, retry);
+                    if (size != stack.size())
+                    {
+                        // A nested message was added to the stack, so we need to stop processing the current message until it has been fully sent
+                        ++index;
+                        retry = retry && result;
+                        return false;
+                    }
+                }
+
+                return true;
+            });
+
+        retry = true;
+        return true;
+    }
+
+    template<class ProtoType, class Type>
+    bool ProtoMessageSenderBase::SerializeField(ProtoUnboundedRepeated<ProtoType>, const infra::ProtoFormatter& formatter, const StreamedRepeated<Type>& value, uint32_t fieldNumber, bool& retry) const
+    {
+        return SerializeField(ProtoRepeatedBase<ProtoType>(), formatter, value, fieldNumber, retry);
+    }
+
     template<class Message>
     ProtoMessageSender<Message>::ProtoMessageSender(const Message& message)
         : ProtoMessageSenderBase(stack)
@@ -1,5 +1,7 @@
 #include "protobuf/echo/Serialization.hpp"
 #include "protobuf/echo/Echo.hpp"
+#include <algorithm>
+#include <cstdint>
 
 namespace services
 {
@@ -59,4 +61,144 @@ namespace services
         delete[] deserializerMemory.begin();
         deserializerMemory = {};
     }
+
+    MethodSerializerFactory::Pooled::Pooled(infra::ByteRange arena)
+        : arena(arena)
+        , blocksEnd(reinterpret_cast<Block*>(reinterpret_cast<uintptr_t>(arena.end()) / alignof(Block) * alignof(Block)))
+    {
+        really_assert(reinterpret_cast<uintptr_t>(arena.begin()) % alignof(std::max_align_t) == 0);
+
+        for (std::size_t sizeClass = 0; sizeClass != numberOfSizeClasses; ++sizeClass)
+            statistics[sizeClass].blockSize = BlockSize(sizeClass);
+    }
+
+    MethodSerializerFactory::Pooled::~Pooled()
+    {
+        for (auto block = blocksEnd - numberOfBlocks; block != blocksEnd; ++block)
+        {
+            assert(block->UnReferenced());
+            block->~Block();
+        }
+    }
+
+    infra::SharedPtr<infra::ByteRange> MethodSerializerFactory::Pooled::SerializerMemory(uint32_t size)
+    {
+        return Allocate(size);
+    }
+
+    infra::SharedPtr<infra::ByteRange> MethodSerializerFactory::Pooled::DeserializerMemory(uint32_t size)
+    {
+        return Allocate(size);
+    }
+
+    infra::MemoryRange<const MethodSerializerFactory::Pooled::SizeClassStatistics> MethodSerializerFactory::Pooled::Statistics() const
+    {
+        return infra::MakeRange(statistics);
+    }
+
+    std::size_t MethodSerializerFactory::Pooled::ArenaHighWaterMark() const
+    {
+        return carved + numberOfBlocks * sizeof(Block);
+    }
+
+    std::size_t MethodSerializerFactory::Pooled::HeapFallbacks() const
+    {
+        return heapFallbacks;
+    }
+
+    void MethodSerializerFactory::Pooled::Destruct(const void* object)
+    {}
+
+    void MethodSerializerFactory::Pooled::Deallocate(void* control)
+    {
+        auto& block = *static_cast<Block*>(control);
+
+        --statistics[block.sizeClass].inUse;
+        block.next = freeLists[block.sizeClass];
+        freeLists[block.sizeClass] = &block;
+    }
+
+    MethodSerializerFactory::Pooled::Block::Block(infra::SharedObjectDeleter* pool, std::size_t sizeClass, uint8_t* data)
+        : infra::detail::SharedPtrControl(&memory, pool)
+        , sizeClass(sizeClass)
+        , memory(data, data + BlockSize(sizeClass))
+    {}
+
+    MethodSerializerFactory::Pooled::HeapBlock::HeapBlock(uint32_t size)
+        : storage(new uint8_t[size])
+        , memory(storage.get(), storage.get() + size)
+    {}
+
+    infra::SharedPtr<infra::ByteRange> MethodSerializerFactory::Pooled::Allocate(uint32_t size)
+    {
+        auto sizeClass = SizeClass(size);
+
+        Block* block = nullptr;
+        if (sizeClass != numberOfSizeClasses)
+        {
+            block = TakeFree(sizeClass);
+            if (block == nullptr)
+                block = Carve(sizeClass);
+            for (auto largerClass = sizeClass + 1; block == nullptr && largerClass != numberOfSizeClasses; ++largerClass)
+                block = TakeFree(largerClass);
+        }
+
+        if (block == nullptr)
+        {
+            ++heapFallbacks;
+            auto heapBlock = infra::MakeSharedOnHeap<HeapBlock>(size);
+            return infra::MakeContainedSharedObject(heapBlock->memory, heapBlock);
+        }
+
+        block->memory = infra::ByteRange(block->memory.begin(), block->memory.begin() + size);
+
+        auto& classStatistics = statistics[block->sizeClass];
+        ++classStatistics.inUse;
+        classStatistics.highWaterMark = std::max(classStatistics.highWaterMark, classStatistics.inUse);
+
+        return infra::SharedPtr<infra::ByteRange>(block, &block->memory);
+    }
+
+    MethodSerializerFactory::Pooled::Block* MethodSerializerFactory::Pooled::Carve(std::size_t sizeClass)
+    {
+        auto blockSize = BlockSize(sizeClass);
+        auto freeBegin = arena.begin() + carved;
+        auto freeEnd = reinterpret_cast<uint8_t*>(blocksEnd - numberOfBlocks);
+        if (freeEnd < freeBegin || static_cast<std::size_t>(freeEnd - freeBegin) < blockSize + sizeof(Block))
+            return nullptr;
+
+        carved += blockSize;
+        ++numberOfBlocks;
+        ++statistics[sizeClass].blocks;
+
+        return new (blocksEnd - numberOfBlocks) Block(this, sizeClass, freeBegin);
+    }
+
+    MethodSerializerFactory::Pooled::Block* MethodSerializerFactory::Pooled::TakeFree(std::size_t sizeClass)
+    {
+        auto block = freeLists[sizeClass];
+
+        if (block != nullptr)
+        {
+            freeLists[sizeClass] = block->next;
+            block->next = nullptr;
+        }
+
+        return block;
+    }
+
+    std::size_t MethodSerializerFactory::Pooled::SizeClass(uint32_t size)
+    {
+        std::size_t sizeClass = 0;
+
+        while (sizeClass != numberOfSizeClasses && BlockSize(sizeClass) < size)
+            ++sizeClass;
+
+        return sizeClass;
+    }
+
+    std::size_t MethodSerializerFactory::Pooled::BlockSize(std::size_t sizeClass)
+    {
+        return smallestBlockSize << sizeClass;
+    }
 }
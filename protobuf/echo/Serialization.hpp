@@ -2,9 +2,12 @@
 #define PROTOBUF_SERIALIZATION_HPP
 
 #include "infra/util/ReallyAssert.hpp"
+#include "infra/util/SharedPtr.hpp"
 #include "infra/util/SharedOptional.hpp"
+#include "infra/util/WithStorage.hpp"
 #include "protobuf/echo/ProtoMessageReceiver.hpp"
 #include "protobuf/echo/ProtoMessageSender.hpp"
+#include <memory>
 
 namespace services
 {
@@ -19,6 +22,10 @@ namespace services
         virtual ~MethodDeserializer() = default;
 
         virtual void MethodContents(infra::SharedPtr<infra::StreamReaderWithRewinding>&& reader) = 0;
+        // Invoked when the contents received so far are released before the rest of the contents has been received
+        virtual void ReleasingMethodContents()
+        {}
+
         virtual void ExecuteMethod() = 0;
         virtual bool Failed() const = 0;
     };
@@ -54,8 +61,10 @@ namespace services
     {
     public:
         explicit MethodDeserializerImpl(const infra::Function<void(Args...)>& method);
+        MethodDeserializerImpl(const infra::Function<void(Args...)>& method, const infra::Function<void(Message& message)>& prepare);
 
         void MethodContents(infra::SharedPtr<infra::StreamReaderWithRewinding>&& reader) override;
+        void ReleasingMethodContents() override;
         void ExecuteMethod() override;
         bool Failed() const override;
 
@@ -92,6 +101,7 @@ namespace services
         class ForServices;
 
         class OnHeap;
+        class Pooled;
 
         MethodSerializerFactory() = default;
         MethodSerializerFactory(const MethodSerializerFactory& other) = delete;
@@ -106,6 +116,9 @@ namespace services
 
         template<class Message, class... Args>
         infra::SharedPtr<MethodDeserializer> MakeDeserializer(const infra::Function<void(Args...)>& method);
+        // prepare is invoked on the message before it is received, e.g. to set the callbacks of streamed fields
+        template<class Message, class... Args>
+        infra::SharedPtr<MethodDeserializer> MakeDeserializer(const infra::Function<void(Args...)>& method, const infra::Function<void(Message& message)>& prepare);
 
         infra::SharedPtr<MethodDeserializer> MakeDummyDeserializer(Echo& echo);
     };
@@ -242,6 +255,99 @@ namespace services
         infra::ByteRange deserializerMemory;
     };
 
+    // Hands out blocks from a fixed arena in power-of-two size classes, starting at smallestBlockSize.
+    // Blocks are carved from the arena on first use of their size class, and are kept on a per-class
+    // free list after being released, so that a small message only takes a small block and no memory
+    // is allocated from the heap after the arena is warmed up. When the arena has no room for a new
+    // block, a free block of a larger class is used. Statistics report the high-water mark per class,
+    // which helps to size the arena.
+    // The bookkeeping of each block is kept in a table at the end of the arena, so that blocks are packed
+    // without headers; smallestBlockSize is chosen such that a block is always larger than its bookkeeping.
+    // Requests larger than the largest class, or for which the arena has no block left, are served from
+    // the heap and counted in HeapFallbacks().
+    class MethodSerializerFactory::Pooled
+        : public MethodSerializerFactory
+        , private infra::SharedObjectDeleter
+    {
+    private:
+        struct Block
+            : infra::detail::SharedPtrControl
+        {
+            Block(infra::SharedObjectDeleter* pool, std::size_t sizeClass, uint8_t* data);
+
+            Block* next = nullptr;
+            std::size_t sizeClass;
+            infra::ByteRange memory;
+        };
+
+        struct HeapBlock
+        {
+            explicit HeapBlock(uint32_t size);
+
+            std::unique_ptr<uint8_t[]> storage;
+            infra::ByteRange memory;
+        };
+
+    public:
+        static constexpr std::size_t numberOfSizeClasses = 14;
+        static constexpr std::size_t smallestBlockSize = 64;
+
+        static_assert(sizeof(Block) <= smallestBlockSize);
+
+        template<std::size_t Size>
+        struct Arena
+        {
+            operator infra::ByteRange();
+
+            alignas(std::max_align_t) std::array<uint8_t, Size> storage;
+        };
+
+        template<std::size_t Size>
+        using WithArena = infra::WithStorage<Pooled, Arena<Size>>;
+
+        struct SizeClassStatistics
+        {
+            std::size_t blockSize;
+            std::size_t blocks = 0;
+            std::size_t inUse = 0;
+            std::size_t highWaterMark = 0;
+        };
+
+        // The arena must be aligned on std::max_align_t
+        explicit Pooled(infra::ByteRange arena);
+        ~Pooled();
+
+        infra::SharedPtr<infra::ByteRange> SerializerMemory(uint32_t size) override;
+        infra::SharedPtr<infra::ByteRange> DeserializerMemory(uint32_t size) override;
+
+        // Indexed by size class; class i holds blocks of smallestBlockSize << i bytes
+        infra::MemoryRange<const SizeClassStatistics> Statistics() const;
+        // Bytes of the arena taken by blocks and their bookkeeping
+        std::size_t ArenaHighWaterMark() const;
+        std::size_t HeapFallbacks() const;
+
+    private:
+        // Implementation of SharedObjectDeleter
+        void Destruct(const void* object) override;
+        void Deallocate(void* control) override;
+
+    private:
+        infra::SharedPtr<infra::ByteRange> Allocate(uint32_t size);
+        Block* Carve(std::size_t sizeClass);
+        Block* TakeFree(std::size_t sizeClass);
+        static std::size_t SizeClass(uint32_t size);
+        static std::size_t BlockSize(std::size_t sizeClass);
+
+    private:
+        infra::ByteRange arena;
+        Block* blocksEnd;
+        std::size_t numberOfBlocks = 0;
+        std::size_t carved = 0;
+        std::size_t heapFallbacks = 0;
+        std::array<Block*, numberOfSizeClasses> freeLists{};
+        std::array<SizeClassStatistics, numberOfSizeClasses> statistics;
+    };
+
     ////    Implementation    ////
 
     template<class Message, class... Args>
@@ -249,12 +355,25 @@ namespace services
         : method(method)
     {}
 
+    template<class Message, class... Args>
+    MethodDeserializerImpl<Message, Args...>::MethodDeserializerImpl(const infra::Function<void(Args...)>& method, const infra::Function<void(Message& message)>& prepare)
+        : method(method)
+    {
+        prepare(receiver.message);
+    }
+
     template<class Message, class... Args>
     void MethodDeserializerImpl<Message, Args...>::MethodContents(infra::SharedPtr<infra::StreamReaderWithRewinding>&& reader)
     {
         receiver.Feed(*reader);
     }
 
+    template<class Message, class... Args>
+    void MethodDeserializerImpl<Message, Args...>::ReleasingMethodContents()
+    {
+        receiver.KeepViews();
+    }
+
     template<class Message, class... Args>
     void MethodDeserializerImpl<Message, Args...>::ExecuteMethod()
     {
@@ -326,6 +445,16 @@ namespace services
         return infra::MakeContainedSharedObject(*deserializer, memory);
     }
 
+    template<class Message, class... Args>
+    infra::SharedPtr<MethodDeserializer> MethodSerializerFactory::MakeDeserializer(const infra::Function<void(Args...)>& method, const infra::Function<void(Message& message)>& prepare)
+    {
+        using Deserializer = MethodDeserializerImpl<Message, Args...>;
+
+        auto memory = DeserializerMemory(sizeof(Deserializer));
+        auto deserializer = new (memory->begin()) Deserializer(method, prepare);
+        return infra::MakeContainedSharedObject(*deserializer, memory);
+    }
+
     template<class... Services>
     template<class... ServiceProxies>
     infra::SharedPtr<infra::ByteRange> MethodSerializerFactory::ForServices<Services...>::AndProxies<ServiceProxies...>::SerializerMemory(uint32_t size)
@@ -343,6 +472,12 @@ namespace services
         deserializerMemory = infra::Head(infra::MakeRange(deserializerStorage), size);
         return deserializerAccess.MakeShared(deserializerMemory);
     }
+
+    template<std::size_t Size>
+    MethodSerializerFactory::Pooled::Arena<Size>::operator infra::ByteRange()
+    {
+        return infra::MakeRange(storage);
+    }
 }
 
 #endif
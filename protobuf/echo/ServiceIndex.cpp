@@ -0,0 +1,61 @@
+#include "protobuf/echo/ServiceIndex.hpp"
+#include "infra/util/ReallyAssert.hpp"
+
+namespace services
+{
+    ServiceIndex::ServiceIndex(infra::MemoryRange<Entry> entries)
+        : entries(entries)
+    {
+        really_assert(!entries.empty() && (entries.size() & (entries.size() - 1)) == 0);
+        Clear();
+    }
+
+    Service* ServiceIndex::Find(uint32_t id) const
+    {
+        for (auto slot = Slot(id); entries[slot].service != nullptr; slot = (slot + 1) & (entries.size() - 1))
+            if (entries[slot].id == id)
+                return entries[slot].service;
+
+        return nullptr;
+    }
+
+    void ServiceIndex::Add(uint32_t id, Service& service)
+    {
+        if (size == MaxSize())
+            return;
+
+        auto slot = Slot(id);
+        while (entries[slot].service != nullptr && entries[slot].id != id)
+            slot = (slot + 1) & (entries.size() - 1);
+
+        if (entries[slot].service == nullptr)
+            ++size;
+
+        entries[slot] = Entry{ id, &service };
+    }
+
+    void ServiceIndex::Clear()
+    {
+        for (auto& entry : entries)
+            entry = Entry{};
+
+        size = 0;
+    }
+
+    std::size_t ServiceIndex::Size() const
+    {
+        return size;
+    }
+
+    std::size_t ServiceIndex::MaxSize() const
+    {
+        return entries.size() * 3 / 4;
+    }
+
+    std::size_t ServiceIndex::Slot(uint32_t id) const
+    {
+        uint32_t hash = id * 0x9e3779b1u;
+        hash ^= hash >> 16;
+        return hash & (entries.size() - 1);
+    }
+}
@@ -0,0 +1,50 @@
+#ifndef PROTOBUF_ECHO_SERVICE_INDEX_HPP
+#define PROTOBUF_ECHO_SERVICE_INDEX_HPP
+
+#include "infra/util/MemoryRange.hpp"
+#include "infra/util/WithStorage.hpp"
+#include <array>
+#include <cstdint>
+
+namespace services
+{
+    class Service;
+
+    // Open-addressing table from service id to service. EchoOnStreams uses it as a cache in front of
+    // walking all registered services, so that dispatching an incoming message does not grow with
+    // the number of services. The number of entries must be a power of two; when the table is three
+    // quarters full, further ids are not added and are found by walking the services instead.
+    class ServiceIndex
+    {
+    public:
+        struct Entry
+        {
+            uint32_t id = 0;
+            Service* service = nullptr;
+        };
+
+        template<std::size_t Size>
+        using WithSize = infra::WithStorage<ServiceIndex, std::array<Entry, Size>>;
+
+        explicit ServiceIndex(infra::MemoryRange<Entry> entries);
+        ServiceIndex(const ServiceIndex& other) = delete;
+        ServiceIndex& operator=(const ServiceIndex& other) = delete;
+        ~ServiceIndex() = default;
+
+        Service* Find(uint32_t id) const;
+        void Add(uint32_t id, Service& service);
+        void Clear();
+
+        std::size_t Size() const;
+        std::size_t MaxSize() const;
+
+    private:
+        std::size_t Slot(uint32_t id) const;
+
+    private:
+        infra::MemoryRange<Entry> entries;
+        std::size_t size = 0;
+    };
+}
+
+#endif
@@ -60,6 +60,11 @@ namespace services
     }
 
     void PrintField(const infra::BoundedVector<uint8_t>& value, services::Tracer& tracer)
+    {
+        PrintField(infra::MakeRange(value), tracer);
+    }
+
+    void PrintField(infra::ConstByteRange value, services::Tracer& tracer)
     {
         tracer.Continue() << "[";
         for (auto v : value)
@@ -67,6 +72,11 @@ namespace services
         tracer.Continue() << "]";
     }
 
+    void PrintField(const StreamedBytes& value, services::Tracer& tracer)
+    {
+        PrintField(value.contents, tracer);
+    }
+
     namespace detail
     {
         TracingEchoOnStreamsDescendantHelper::TracingEchoOnStreamsDescendantHelper(services::Tracer& tracer)
@@ -132,6 +142,11 @@ namespace services
             deserializer->MethodContents(std::move(reader));
         }
 
+        void TracingEchoOnStreamsDescendantHelper::ReleasingMethodContents()
+        {
+            deserializer->ReleasingMethodContents();
+        }
+
         void TracingEchoOnStreamsDescendantHelper::ExecuteMethod()
         {
             infra::BoundedVectorInputStream stream(readerBuffer, infra::noFail);
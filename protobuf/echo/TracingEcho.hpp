@@ -42,6 +42,8 @@ namespace services
     void PrintField(int64_t value, services::Tracer& tracer);
     void PrintField(const infra::BoundedConstString& value, services::Tracer& tracer);
     void PrintField(const infra::BoundedVector<uint8_t>& value, services::Tracer& tracer);
+    void PrintField(infra::ConstByteRange value, services::Tracer& tracer);
+    void PrintField(const StreamedBytes& value, services::Tracer& tracer);
 
     template<class T>
     void PrintField(T value, services::Tracer& tracer, typename std::enable_if<std::is_enum<T>::value>::type* = 0)
@@ -76,6 +78,19 @@ namespace services
         tracer.Continue() << "]";
     }
 
+    template<class T>
+    void PrintField(const StreamedRepeated<T>& value, services::Tracer& tracer)
+    {
+        tracer.Continue() << "[";
+        for (auto& v : value.elements)
+        {
+            if (&v != &value.elements.front())
+                tracer.Continue() << ", ";
+            PrintField(v, tracer);
+        }
+        tracer.Continue() << "]";
+    }
+
     namespace detail
     {
         class TracingEchoOnStreamsDescendantHelper
@@ -98,6 +113,7 @@ namespace services
 
             // Implementation of MethodDeserializer
             void MethodContents(infra::SharedPtr<infra::StreamReaderWithRewinding>&& reader) override;
+            void ReleasingMethodContents() override;
             void ExecuteMethod() override;
             bool Failed() const override;
 
@@ -0,0 +1,116 @@
+#include "generated/echo/BenchmarkMessages.pb.hpp"
+#include "infra/stream/ByteInputStream.hpp"
+#include "infra/stream/ByteOutputStream.hpp"
+#include "infra/stream/StdVectorOutputStream.hpp"
+#include "protobuf/echo/ProtoMessageSender.hpp"
+#include <array>
+#include <benchmark/benchmark.h>
+#include <vector>
+
+namespace
+{
+    benchmark_messages::Measurement MakeMeasurement()
+    {
+        return benchmark_messages::Measurement(1234, 0x5a5a5a5a, -40, true, benchmark_messages::Unit::kelvin);
+    }
+
+    benchmark_messages::Report MakeReport()
+    {
+        std::array<uint8_t, 32> payload{};
+        return benchmark_messages::Report(77, 0x123456789a, MakeMeasurement(), "sensor-front", infra::MakeRange(payload));
+    }
+
+    template<class Message>
+    std::vector<uint8_t> Serialized(const Message& message)
+    {
+        infra::StdVectorOutputStream::WithStorage stream;
+        infra::ProtoFormatter formatter(stream);
+        message.Serialize(formatter);
+        return stream.Storage();
+    }
+
+    template<class Message>
+    void Serialize(benchmark::State& state, const Message& message)
+    {
+        infra::ByteOutputStream::WithStorage<Message::maxMessageSize> stream;
+
+        for (auto _ : state)
+        {
+            infra::ProtoFormatter formatter(stream);
+            message.Serialize(formatter);
+            benchmark::DoNotOptimize(stream.Storage().data());
+            stream.Writer().Reset();
+        }
+
+        state.SetItemsProcessed(state.iterations());
+    }
+
+    template<class Message>
+    void Deserialize(benchmark::State& state, const Message& message)
+    {
+        auto data = Serialized(message);
+
+        for (auto _ : state)
+        {
+            infra::ByteInputStream stream(infra::MakeRange(data));
+            infra::ProtoParser parser(stream);
+            Message result(parser);
+            benchmark::DoNotOptimize(result);
+        }
+
+        state.SetItemsProcessed(state.iterations());
+    }
+
+    template<class Message>
+    void Send(benchmark::State& state, const Message& message)
+    {
+        infra::ByteOutputStream::WithStorage<Message::maxMessageSize> stream;
+
+        for (auto _ : state)
+        {
+            services::ProtoMessageSender<Message> sender(message);
+            sender.Fill(stream);
+            benchmark::DoNotOptimize(stream.Storage().data());
+            stream.Writer().Reset();
+        }
+
+        state.SetItemsProcessed(state.iterations());
+    }
+
+    void SerializeMeasurement(benchmark::State& state)
+    {
+        Serialize(state, MakeMeasurement());
+    }
+
+    void SerializeReport(benchmark::State& state)
+    {
+        Serialize(state, MakeReport());
+    }
+
+    void DeserializeMeasurement(benchmark::State& state)
+    {
+        Deserialize(state, MakeMeasurement());
+    }
+
+    void DeserializeReport(benchmark::State& state)
+    {
+        Deserialize(state, MakeReport());
+    }
+
+    void SendMeasurement(benchmark::State& state)
+    {
+        Send(state, MakeMeasurement());
+    }
+
+    void SendReport(benchmark::State& state)
+    {
+        Send(state, MakeReport());
+    }
+}
+
+BENCHMARK(SerializeMeasurement);
+BENCHMARK(SerializeReport);
+BENCHMARK(DeserializeMeasurement);
+BENCHMARK(DeserializeReport);
+BENCHMARK(SendMeasurement);
+BENCHMARK(SendReport);
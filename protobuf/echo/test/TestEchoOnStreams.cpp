@@ -32,6 +32,16 @@ namespace services
         {
             return EchoOnStreams::GrantSend(proxy);
         }
+
+        void InheritedMethodContents(infra::SharedPtr<infra::StreamReaderWithRewinding>&& reader)
+        {
+            EchoOnStreams::MethodContents(std::move(reader));
+        }
+
+        void InheritedReleaseDeserializer()
+        {
+            EchoOnStreams::ReleaseDeserializer();
+        }
     };
 }
 
@@ -42,6 +52,7 @@ public:
     infra::SharedOptional<infra::ByteInputStreamReader> reader;
     testing::StrictMock<services::EchoErrorPolicyMock> errorPolicy;
     services::MethodSerializerFactory::ForServices<services::ServiceStub>::AndProxies<services::ServiceStubProxy> serializerFactory;
+    services::ServiceIndex::WithSize<4> index;
     testing::StrictMock<services::EchoOnStreamsMock> echo{ serializerFactory, errorPolicy };
     testing::StrictMock<services::ServiceStub> service{ echo };
     services::ServiceStubProxy serviceProxy{ echo };
@@ -79,6 +90,81 @@ TEST_F(EchoOnStreamsTest, ReleaseReader_with_data_in_buffer)
     echo.ReleaseReader();
 }
 
+TEST_F(EchoOnStreamsTest, reader_is_held_until_method_is_done)
+{
+    std::array<uint8_t, 5> data{ 1, (1 << 3) | 2, 2, 1 << 3, 5 };
+    EXPECT_CALL(echo, StartingMethod(1, 1, testing::_)).WillOnce(testing::Invoke([](uint32_t serviceId, uint32_t methodId, infra::SharedPtr<services::MethodDeserializer>&& deserializer)
+        {
+            return std::move(deserializer);
+        }));
+    EXPECT_CALL(echo, MethodContents(testing::_)).WillOnce(testing::Invoke([this](infra::SharedPtr<infra::StreamReaderWithRewinding>&& reader)
+        {
+            echo.InheritedMethodContents(std::move(reader));
+        }));
+    EXPECT_CALL(service, Method(5)).WillOnce(testing::Invoke([this](uint32_t value)
+        {
+            EXPECT_FALSE(reader.Allocatable());
+        }));
+    echo.DataReceived(reader.Emplace(infra::MakeRange(data)));
+    EXPECT_FALSE(reader.Allocatable());
+
+    EXPECT_CALL(echo, ReleaseDeserializer()).WillOnce(testing::Invoke([this]()
+        {
+            echo.InheritedReleaseDeserializer();
+        }));
+    service.MethodDone();
+    EXPECT_TRUE(reader.Allocatable());
+}
+
+TEST_F(EchoOnStreamsTest, view_received_before_the_read_that_ends_the_message_is_copied)
+{
+    testing::StrictMock<testing::MockFunction<void(infra::ConstByteRange)>> method;
+    EXPECT_CALL(echo, StartingMethod(1, 1, testing::_)).WillOnce(testing::Invoke([&method](uint32_t serviceId, uint32_t methodId, infra::SharedPtr<services::MethodDeserializer>&& deserializer)
+        {
+            return infra::MakeSharedOnHeap<services::MethodDeserializerImpl<test_messages::TestBytesView, infra::ConstByteRange>>([&method](infra::ConstByteRange value)
+                {
+                    method.Call(value);
+                });
+        }));
+    EXPECT_CALL(echo, MethodContents(testing::_)).Times(2).WillRepeatedly(testing::Invoke([this](infra::SharedPtr<infra::StreamReaderWithRewinding>&& reader)
+        {
+            echo.InheritedMethodContents(std::move(reader));
+        }));
+
+    std::array<uint8_t, 7> view{ 1, (1 << 3) | 2, 6, 10, 2, 5, 6 };
+    echo.DataReceived(reader.Emplace(infra::MakeRange(view)));
+    EXPECT_TRUE(reader.Allocatable());
+    view.fill(0);
+
+    std::array<uint8_t, 2> endOfMessage{ 2 << 3, 1 };
+    EXPECT_CALL(method, Call(testing::Eq(std::array<uint8_t, 2>{ 5, 6 })));
+    echo.DataReceived(reader.Emplace(infra::MakeRange(endOfMessage)));
+}
+
+TEST_F(EchoOnStreamsTest, view_split_over_reads_is_copied)
+{
+    testing::StrictMock<testing::MockFunction<void(infra::ConstByteRange)>> method;
+    EXPECT_CALL(echo, StartingMethod(1, 1, testing::_)).WillOnce(testing::Invoke([&method](uint32_t serviceId, uint32_t methodId, infra::SharedPtr<services::MethodDeserializer>&& deserializer)
+        {
+            return infra::MakeSharedOnHeap<services::MethodDeserializerImpl<test_messages::TestBytesView, infra::ConstByteRange>>([&method](infra::ConstByteRange value)
+                {
+                    method.Call(value);
+                });
+        }));
+    EXPECT_CALL(echo, MethodContents(testing::_)).Times(2).WillRepeatedly(testing::Invoke([this](infra::SharedPtr<infra::StreamReaderWithRewinding>&& reader)
+        {
+            echo.InheritedMethodContents(std::move(reader));
+        }));
+
+    std::array<uint8_t, 6> start{ 1, (1 << 3) | 2, 5, 10, 3, 5 };
+    echo.DataReceived(reader.Emplace(infra::MakeRange(start)));
+    EXPECT_TRUE(reader.Allocatable());
+
+    std::array<uint8_t, 2> end{ 6, 7 };
+    EXPECT_CALL(method, Call(testing::Eq(std::array<uint8_t, 3>{ 5, 6, 7 })));
+    echo.DataReceived(reader.Emplace(infra::MakeRange(end)));
+}
+
 TEST_F(EchoOnStreamsTest, reset_after_grant_with_partly_sent_does_not_crash)
 {
     // A MethodSerializer whose Serialize always returns true (partlySent), simulating a
@@ -140,3 +226,34 @@ TEST_F(EchoOnStreamsTest, send_is_operational_after_reset)
     echo.SendStreamAvailable(writer.Emplace(data));
     EXPECT_EQ((std::vector<uint8_t>{ 1, 26, 0 }), data);
 }
+
+TEST_F(EchoOnStreamsTest, service_is_dispatched_via_index)
+{
+    echo.SetServiceIndex(index);
+
+    std::array<uint8_t, 64> data{ 1, (1 << 3) | 2, 64 };
+    EXPECT_CALL(echo, StartingMethod(1, 1, testing::_)).WillOnce(testing::Invoke([](uint32_t serviceId, uint32_t methodId, infra::SharedPtr<services::MethodDeserializer>&& deserializer)
+        {
+            return std::move(deserializer);
+        }));
+    EXPECT_CALL(echo, MethodContents(testing::_));
+    echo.DataReceived(reader.Emplace(infra::MakeRange(data)));
+    echo.ReleaseReader();
+
+    EXPECT_EQ(&service, index.Find(1));
+}
+
+TEST_F(EchoOnStreamsTest, index_is_cleared_when_services_change)
+{
+    echo.SetServiceIndex(index);
+    index.Add(1, service);
+
+    {
+        services::ServiceStub otherService{ echo };
+        EXPECT_EQ(nullptr, index.Find(1));
+
+        index.Add(1, otherService);
+    }
+
+    EXPECT_EQ(nullptr, index.Find(1));
+}
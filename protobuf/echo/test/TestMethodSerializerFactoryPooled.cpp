@@ -0,0 +1,119 @@
+#include "protobuf/echo/Serialization.hpp"
+#include "gmock/gmock.h"
+#include <algorithm>
+#include <vector>
+
+class MethodSerializerFactoryPooledTest
+    : public testing::Test
+{
+public:
+    static constexpr std::size_t arenaSize = 1024;
+
+    services::MethodSerializerFactory::Pooled::WithArena<arenaSize> factory;
+};
+
+TEST_F(MethodSerializerFactoryPooledTest, memory_has_requested_size)
+{
+    auto memory = factory.SerializerMemory(10);
+
+    EXPECT_EQ(10, memory->size());
+    EXPECT_EQ(0, reinterpret_cast<uintptr_t>(memory->begin()) % alignof(std::max_align_t));
+}
+
+TEST_F(MethodSerializerFactoryPooledTest, small_request_takes_block_of_smallest_fitting_size_class)
+{
+    auto small = factory.SerializerMemory(10);
+    auto large = factory.DeserializerMemory(200);
+
+    EXPECT_EQ(64, factory.Statistics()[0].blockSize);
+    EXPECT_EQ(1, factory.Statistics()[0].inUse);
+    EXPECT_EQ(256, factory.Statistics()[2].blockSize);
+    EXPECT_EQ(1, factory.Statistics()[2].inUse);
+    EXPECT_EQ(0, factory.Statistics()[1].blocks);
+}
+
+TEST_F(MethodSerializerFactoryPooledTest, released_block_is_reused)
+{
+    auto first = factory.SerializerMemory(10);
+    auto firstBegin = first->begin();
+    first = nullptr;
+
+    auto highWaterMark = factory.ArenaHighWaterMark();
+    auto second = factory.SerializerMemory(12);
+
+    EXPECT_EQ(firstBegin, second->begin());
+    EXPECT_EQ(highWaterMark, factory.ArenaHighWaterMark());
+    EXPECT_EQ(1, factory.Statistics()[0].blocks);
+}
+
+TEST_F(MethodSerializerFactoryPooledTest, high_water_mark_counts_simultaneous_blocks)
+{
+    {
+        auto first = factory.SerializerMemory(10);
+        auto second = factory.DeserializerMemory(10);
+    }
+
+    auto third = factory.SerializerMemory(10);
+
+    EXPECT_EQ(2, factory.Statistics()[0].blocks);
+    EXPECT_EQ(1, factory.Statistics()[0].inUse);
+    EXPECT_EQ(2, factory.Statistics()[0].highWaterMark);
+}
+
+TEST_F(MethodSerializerFactoryPooledTest, larger_free_block_is_used_when_arena_is_exhausted)
+{
+    auto largeBegin = factory.SerializerMemory(512)->begin();
+
+    std::vector<infra::SharedPtr<infra::ByteRange>> small;
+    while (factory.Statistics()[3].inUse == 0)
+        small.push_back(factory.SerializerMemory(16));
+
+    EXPECT_EQ(largeBegin, small.back()->begin());
+    EXPECT_EQ(small.size() - 1, factory.Statistics()[0].blocks);
+}
+
+TEST_F(MethodSerializerFactoryPooledTest, blocks_are_packed_without_headers)
+{
+    auto first = factory.SerializerMemory(64);
+    auto second = factory.SerializerMemory(64);
+
+    EXPECT_EQ(first->begin() + 64, second->begin());
+}
+
+TEST_F(MethodSerializerFactoryPooledTest, request_larger_than_largest_size_class_is_served_from_heap)
+{
+    auto size = static_cast<uint32_t>(services::MethodSerializerFactory::Pooled::smallestBlockSize << services::MethodSerializerFactory::Pooled::numberOfSizeClasses);
+    auto memory = factory.SerializerMemory(size);
+
+    EXPECT_EQ(size, memory->size());
+    EXPECT_EQ(1, factory.HeapFallbacks());
+    EXPECT_EQ(0, factory.ArenaHighWaterMark());
+}
+
+TEST_F(MethodSerializerFactoryPooledTest, request_is_served_from_heap_when_arena_is_exhausted)
+{
+    std::vector<infra::SharedPtr<infra::ByteRange>> blocks;
+    while (factory.HeapFallbacks() == 0)
+        blocks.push_back(factory.SerializerMemory(64));
+
+    EXPECT_EQ(64, blocks.back()->size());
+    EXPECT_EQ(blocks.size() - 1, factory.Statistics()[0].blocks);
+    EXPECT_GE(arenaSize, factory.ArenaHighWaterMark());
+}
+
+TEST_F(MethodSerializerFactoryPooledTest, deserializer_is_constructed_in_pooled_memory)
+{
+    infra::SharedPtr<services::MethodDeserializer> deserializer = factory.MakeDeserializer<services::EmptyMessage>(infra::Function<void()>([]() {}));
+
+    EXPECT_EQ(1, std::count_if(factory.Statistics().begin(), factory.Statistics().end(), [](auto& statistics)
+                     {
+                         return statistics.inUse == 1;
+                     }));
+
+    deserializer = nullptr;
+
+    EXPECT_EQ(0, std::count_if(factory.Statistics().begin(), factory.Statistics().end(), [](auto& statistics)
+                     {
+                         return statistics.inUse != 0;
+                     }));
+}
@@ -225,6 +225,204 @@ TEST(ProtoMessageReceiverTest, parse_bytes_too_long)
     EXPECT_EQ((infra::BoundedVector<uint8_t>::WithMaxSize<50>{ { 1, 2, 3, 4, 5, 6, 7, 8, 9, 10, 1, 2, 3, 4, 5, 6, 7, 8, 9, 10, 1, 2, 3, 4, 5, 6, 7, 8, 9, 10, 1, 2, 3, 4, 5, 6, 7, 8, 9, 10, 1, 2, 3, 4, 5, 6, 7, 8, 9, 10 } }), receiver.message.value);
 }
 
+TEST(ProtoMessageReceiverTest, parse_bytes_view)
+{
+    services::ProtoMessageReceiver<test_messages::TestBytesView> receiver;
+
+    std::vector<uint8_t> data{ 10, 2, 5, 6 };
+    infra::StdVectorInputStreamReader reader(data);
+    receiver.Feed(reader);
+
+    EXPECT_FALSE(receiver.Failed());
+    EXPECT_EQ((std::array<uint8_t, 2>{ 5, 6 }), receiver.message.value);
+    EXPECT_EQ(data.data() + 2, receiver.message.value.begin());
+}
+
+TEST(ProtoMessageReceiverTest, parse_string_view)
+{
+    services::ProtoMessageReceiver<test_messages::TestStringView> receiver;
+
+    std::vector<uint8_t> data{ 10, 4, 'a', 'b', 'c', 'd' };
+    infra::StdVectorInputStreamReader reader(data);
+    receiver.Feed(reader);
+
+    EXPECT_FALSE(receiver.Failed());
+    EXPECT_EQ("abcd", receiver.message.value);
+    EXPECT_EQ(reinterpret_cast<const char*>(data.data() + 2), receiver.message.value.begin());
+}
+
+TEST(ProtoMessageReceiverTest, parse_bytes_view_fed_in_parts_is_copied)
+{
+    services::ProtoMessageReceiver<test_messages::TestBytesView> receiver;
+
+    std::vector<uint8_t> data{ 10, 2, 5 };
+    infra::StdVectorInputStreamReader reader(data);
+    receiver.Feed(reader);
+
+    std::vector<uint8_t> remainder{ 6 };
+    infra::StdVectorInputStreamReader remainderReader(remainder);
+    receiver.Feed(remainderReader);
+    data.assign(data.size(), 0);
+    remainder.assign(remainder.size(), 0);
+
+    EXPECT_FALSE(receiver.Failed());
+    EXPECT_EQ((std::array<uint8_t, 2>{ 5, 6 }), receiver.message.value);
+}
+
+TEST(ProtoMessageReceiverTest, parse_string_view_fed_in_parts_is_copied)
+{
+    services::ProtoMessageReceiver<test_messages::TestStringView> receiver;
+
+    infra::StdVectorInputStreamReader::WithStorage data(std::in_place, std::initializer_list<uint8_t>{ 10, 4, 'a', 'b' });
+    receiver.Feed(data);
+
+    infra::StdVectorInputStreamReader::WithStorage remainder(std::in_place, std::initializer_list<uint8_t>{ 'c', 'd' });
+    receiver.Feed(remainder);
+
+    EXPECT_FALSE(receiver.Failed());
+    EXPECT_EQ("abcd", receiver.message.value);
+}
+
+TEST(ProtoMessageReceiverTest, parse_bytes_view_fed_in_parts_exceeding_view_storage_fails)
+{
+    services::ProtoMessageReceiver<test_messages::TestTwoBytesViews> receiver;
+
+    infra::StdVectorInputStreamReader::WithStorage data(std::in_place, std::initializer_list<uint8_t>{ 10, 21, 1, 2, 3 });
+    receiver.Feed(data);
+
+    infra::StdVectorInputStreamReader::WithStorage remainder(std::in_place, std::initializer_list<uint8_t>{ 4, 5, 6, 7, 8, 9, 10, 11, 12, 13, 14, 15, 16, 17, 18, 19, 20, 21 });
+    receiver.Feed(remainder);
+
+    EXPECT_TRUE(receiver.Failed());
+}
+
+TEST(ProtoMessageReceiverTest, parse_bytes_view_with_header_fed_separately)
+{
+    services::ProtoMessageReceiver<test_messages::TestBytesView> receiver;
+
+    infra::StdVectorInputStreamReader::WithStorage header(std::in_place, std::initializer_list<uint8_t>{ 10 });
+    receiver.Feed(header);
+
+    std::vector<uint8_t> data{ 2, 5, 6 };
+    infra::StdVectorInputStreamReader reader(data);
+    receiver.Feed(reader);
+
+    EXPECT_FALSE(receiver.Failed());
+    EXPECT_EQ((std::array<uint8_t, 2>{ 5, 6 }), receiver.message.value);
+    EXPECT_EQ(data.data() + 1, receiver.message.value.begin());
+}
+
+TEST(ProtoMessageReceiverTest, parse_bytes_view_fails_when_message_continues_in_next_feed)
+{
+    services::ProtoMessageReceiver<test_messages::TestBytesView> receiver;
+
+    infra::StdVectorInputStreamReader::WithStorage data(std::in_place, std::initializer_list<uint8_t>{ 10, 2, 5, 6 });
+    receiver.Feed(data);
+    EXPECT_FALSE(receiver.Failed());
+
+    infra::StdVectorInputStreamReader::WithStorage remainder(std::in_place, std::initializer_list<uint8_t>{ 2 << 3, 1 });
+    receiver.Feed(remainder);
+
+    EXPECT_TRUE(receiver.Failed());
+    EXPECT_TRUE(remainder.Empty());
+}
+
+TEST(ProtoMessageReceiverTest, parse_bytes_view_kept_when_message_continues_in_next_feed)
+{
+    services::ProtoMessageReceiver<test_messages::TestBytesView> receiver;
+
+    std::vector<uint8_t> data{ 10, 2, 5, 6 };
+    infra::StdVectorInputStreamReader reader(data);
+    receiver.Feed(reader);
+    receiver.KeepViews();
+    data.assign(data.size(), 0);
+
+    infra::StdVectorInputStreamReader::WithStorage remainder(std::in_place, std::initializer_list<uint8_t>{ 2 << 3, 1 });
+    receiver.Feed(remainder);
+
+    EXPECT_FALSE(receiver.Failed());
+    EXPECT_EQ((std::array<uint8_t, 2>{ 5, 6 }), receiver.message.value);
+}
+
+TEST(ProtoMessageReceiverTest, kept_view_does_not_interrupt_view_fed_in_parts)
+{
+    services::ProtoMessageReceiver<test_messages::TestTwoBytesViews> receiver;
+
+    std::vector<uint8_t> data{ 10, 2, 5, 6, 18, 3, 7 };
+    infra::StdVectorInputStreamReader reader(data);
+    receiver.Feed(reader);
+    receiver.KeepViews();
+    data.assign(data.size(), 0);
+
+    infra::StdVectorInputStreamReader::WithStorage remainder(std::in_place, std::initializer_list<uint8_t>{ 8, 9 });
+    receiver.Feed(remainder);
+
+    EXPECT_FALSE(receiver.Failed());
+    EXPECT_EQ((std::array<uint8_t, 2>{ 5, 6 }), receiver.message.first);
+    EXPECT_EQ((std::array<uint8_t, 3>{ 7, 8, 9 }), receiver.message.second);
+}
+
+TEST(ProtoMessageReceiverTest, parse_streamed_bytes_per_chunk)
+{
+    services::ProtoMessageReceiver<test_messages::TestStreamedBytes> receiver;
+    std::vector<std::vector<uint8_t>> chunks;
+    receiver.message.data.onChunk = [&chunks](infra::ConstByteRange chunk)
+    {
+        chunks.emplace_back(chunk.begin(), chunk.end());
+    };
+
+    infra::StdVectorInputStreamReader::WithStorage data(std::in_place, std::initializer_list<uint8_t>{ 1 << 3, 7, (2 << 3) | 2, 4, 1, 2 });
+    receiver.Feed(data);
+    infra::StdVectorInputStreamReader::WithStorage data2(std::in_place, std::initializer_list<uint8_t>{ 3, 4 });
+    receiver.Feed(data2);
+
+    EXPECT_FALSE(receiver.Failed());
+    EXPECT_EQ(7, receiver.message.offset);
+    EXPECT_EQ((std::vector<std::vector<uint8_t>>{ { 1, 2 }, { 3, 4 } }), chunks);
+    EXPECT_TRUE(receiver.message.data.contents.empty());
+}
+
+TEST(ProtoMessageReceiverTest, parse_streamed_repeated_per_element)
+{
+    services::ProtoMessageReceiver<test_messages::TestStreamedRepeated> receiver;
+    std::vector<uint32_t> messages;
+    std::vector<uint32_t> values;
+    receiver.message.messages.onElement = [&messages](const test_messages::TestUInt32& element)
+    {
+        messages.push_back(element.value);
+    };
+    receiver.message.values.onElement = [&values](const uint32_t& element)
+    {
+        values.push_back(element);
+    };
+
+    infra::StdVectorInputStreamReader::WithStorage data(std::in_place, std::initializer_list<uint8_t>{ (1 << 3) | 2, 2, 1 << 3, 5, 2 << 3, 7, (1 << 3) | 2, 2, 1 << 3 });
+    receiver.Feed(data);
+
+    EXPECT_EQ((std::vector<uint32_t>{ 5 }), messages);
+    EXPECT_EQ((std::vector<uint32_t>{ 7 }), values);
+
+    infra::StdVectorInputStreamReader::WithStorage data2(std::in_place, std::initializer_list<uint8_t>{ 6, (1 << 3) | 2, 0 });
+    receiver.Feed(data2);
+
+    EXPECT_FALSE(receiver.Failed());
+    EXPECT_EQ((std::vector<uint32_t>{ 5, 6, 0 }), messages);
+    EXPECT_TRUE(receiver.message.messages.elements.empty());
+}
+
+TEST(ProtoMessageReceiverTest, parse_empty_message_at_end_of_data)
+{
+    services::ProtoMessageReceiver<test_messages::TestMessageWithMessageField> receiver;
+
+    infra::StdVectorInputStreamReader::WithStorage data(std::in_place, std::initializer_list<uint8_t>{ (1 << 3) | 2, 0 });
+    receiver.Feed(data);
+    infra::StdVectorInputStreamReader::WithStorage data2(std::in_place, std::initializer_list<uint8_t>{ (1 << 3) | 2, 2, 1 << 3, 5 });
+    receiver.Feed(data2);
+
+    EXPECT_FALSE(receiver.Failed());
+    EXPECT_EQ(5, receiver.message.message.value);
+}
+
 TEST(ProtoMessageReceiverTest, parse_message)
 {
     services::ProtoMessageReceiver<test_messages::TestMessageWithMessageField> receiver;
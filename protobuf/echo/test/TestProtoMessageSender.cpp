@@ -160,6 +160,42 @@ TEST_F(ProtoMessageSenderTest, format_bytes)
     ExpectFill({ 10, 2, 5, 6 }, sender);
 }
 
+TEST_F(ProtoMessageSenderTest, format_bytes_view)
+{
+    std::array<uint8_t, 2> data{ 5, 6 };
+    test_messages::TestBytesView message{ infra::MakeRange(data) };
+    services::ProtoMessageSender sender{ message };
+
+    ExpectFill({ 10, 2, 5, 6 }, sender);
+}
+
+TEST_F(ProtoMessageSenderTest, format_string_view)
+{
+    test_messages::TestStringView message{ "abcd" };
+    services::ProtoMessageSender sender{ message };
+
+    ExpectFill({ 10, 4, 'a', 'b', 'c', 'd' }, sender);
+}
+
+TEST_F(ProtoMessageSenderTest, format_streamed_bytes)
+{
+    std::array<uint8_t, 2> data{ 5, 6 };
+    test_messages::TestStreamedBytes message{ 7, infra::MakeRange(data) };
+    services::ProtoMessageSender sender{ message };
+
+    ExpectFill({ 1 << 3, 7, (2 << 3) | 2, 2, 5, 6 }, sender);
+}
+
+TEST_F(ProtoMessageSenderTest, format_streamed_repeated)
+{
+    std::array<test_messages::TestUInt32, 2> messages{ test_messages::TestUInt32{ 5 }, test_messages::TestUInt32{ 6 } };
+    std::array<uint32_t, 1> values{ 7 };
+    test_messages::TestStreamedRepeated message{ infra::MakeRange(messages), infra::MakeRange(values) };
+    services::ProtoMessageSender sender{ message };
+
+    ExpectFill({ (1 << 3) | 2, 2, 1 << 3, 5, (1 << 3) | 2, 2, 1 << 3, 6, 2 << 3, 7 }, sender);
+}
+
 TEST_F(ProtoMessageSenderTest, format_message)
 {
     test_messages::TestMessageWithMessageField message{ 5 };
@@ -0,0 +1,70 @@
+#include "protobuf/echo/ServiceIndex.hpp"
+#include "protobuf/echo/test_doubles/EchoMock.hpp"
+#include "protobuf/echo/test_doubles/ServiceStub.hpp"
+#include "gmock/gmock.h"
+
+class ServiceIndexTest
+    : public testing::Test
+{
+public:
+    testing::StrictMock<services::EchoMock> echo;
+    services::ServiceStub service1{ echo };
+    services::ServiceStub service2{ echo };
+    services::ServiceIndex::WithSize<8> index;
+};
+
+TEST_F(ServiceIndexTest, unknown_id_is_not_found)
+{
+    EXPECT_EQ(nullptr, index.Find(1));
+}
+
+TEST_F(ServiceIndexTest, added_ids_are_found)
+{
+    index.Add(1, service1);
+    index.Add(2, service2);
+
+    EXPECT_EQ(&service1, index.Find(1));
+    EXPECT_EQ(&service2, index.Find(2));
+    EXPECT_EQ(nullptr, index.Find(3));
+    EXPECT_EQ(2, index.Size());
+}
+
+TEST_F(ServiceIndexTest, adding_existing_id_replaces_service)
+{
+    index.Add(1, service1);
+    index.Add(1, service2);
+
+    EXPECT_EQ(&service2, index.Find(1));
+    EXPECT_EQ(1, index.Size());
+}
+
+TEST_F(ServiceIndexTest, ids_up_to_max_size_are_found)
+{
+    for (uint32_t id = 0; id != index.MaxSize(); ++id)
+        index.Add(id * 8, id % 2 == 0 ? service1 : service2);
+
+    for (uint32_t id = 0; id != index.MaxSize(); ++id)
+        EXPECT_EQ(id % 2 == 0 ? &service1 : &service2, index.Find(id * 8));
+
+    EXPECT_EQ(nullptr, index.Find(8 * 8));
+}
+
+TEST_F(ServiceIndexTest, ids_beyond_max_size_are_not_added)
+{
+    EXPECT_EQ(6, index.MaxSize());
+
+    for (uint32_t id = 0; id != 8; ++id)
+        index.Add(id, service1);
+
+    EXPECT_EQ(6, index.Size());
+    EXPECT_EQ(nullptr, index.Find(7));
+}
+
+TEST_F(ServiceIndexTest, Clear_removes_all_ids)
+{
+    index.Add(1, service1);
+    index.Clear();
+
+    EXPECT_EQ(nullptr, index.Find(1));
+    EXPECT_EQ(0, index.Size());
+}
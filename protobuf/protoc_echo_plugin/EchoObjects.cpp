@@ -285,7 +285,8 @@ namespace application
 
             void VisitInt32(const EchoFieldInt32& field) override
             {
-                maxMessageSize += infra::MaxVarIntSize(std::numeric_limits<uint32_t>::max()) + infra::MaxVarIntSize((field.number << 3) | 2);
+                // Negative values are sign extended to 64 bits
+                maxMessageSize += infra::MaxVarIntSize(std::numeric_limits<uint64_t>::max()) + infra::MaxVarIntSize((field.number << 3) | 2);
             }
 
             void VisitFixed64(const EchoFieldFixed64& field) override
@@ -340,7 +341,8 @@ namespace application
 
             void VisitEnum(const EchoFieldEnum& field) override
             {
-                maxMessageSize += infra::MaxVarIntSize(std::numeric_limits<uint32_t>::max()) + infra::MaxVarIntSize((field.number << 3) | 2);
+                // Negative values are sign extended to 64 bits
+                maxMessageSize += infra::MaxVarIntSize(std::numeric_limits<uint64_t>::max()) + infra::MaxVarIntSize((field.number << 3) | 2);
             }
 
             void VisitSFixed64(const EchoFieldSFixed64& field) override
@@ -431,6 +433,7 @@ namespace application
     EchoFieldString::EchoFieldString(const google::protobuf::FieldDescriptor& descriptor)
         : EchoField(descriptor)
         , maxStringSize(descriptor.options().GetExtension(string_size))
+        , view(descriptor.options().GetExtension(::view))
     {
         assert(maxStringSize != 0);
         protoReferenceType = protoType = "services::ProtoString<" + absl::StrCat(maxStringSize) + ">";
@@ -467,11 +470,13 @@ namespace application
     EchoFieldBytes::EchoFieldBytes(const google::protobuf::FieldDescriptor& descriptor)
         : EchoField(descriptor)
         , maxBytesSize(descriptor.options().GetExtension(bytes_size))
+        , view(descriptor.options().GetExtension(::view))
     {
         if (maxBytesSize == 0)
             throw UnspecifiedBytesSize{ name };
 
         protoReferenceType = protoType = "services::ProtoBytes<" + absl::StrCat(maxBytesSize) + ">";
+        streamed = !descriptor.is_repeated() && descriptor.options().GetExtension(::streamed);
     }
 
     void EchoFieldBytes::Accept(EchoFieldVisitor& visitor) const
@@ -483,6 +488,7 @@ namespace application
         : EchoField(descriptor)
     {
         protoReferenceType = protoType = "services::ProtoUnboundedBytes";
+        streamed = !descriptor.is_repeated() && descriptor.options().GetExtension(::streamed);
     }
 
     void EchoFieldUnboundedBytes::Accept(EchoFieldVisitor& visitor) const
@@ -548,6 +554,7 @@ namespace application
 
         protoType = "services::ProtoRepeated<" + absl::StrCat(maxArraySize) + ", " + type->protoType + ">";
         protoReferenceType = "services::ProtoRepeated<" + absl::StrCat(maxArraySize) + ", " + type->protoReferenceType + ">";
+        streamed = descriptor.options().GetExtension(::streamed);
     }
 
     void EchoFieldRepeated::Accept(EchoFieldVisitor& visitor) const
@@ -561,6 +568,8 @@ namespace application
     {
         protoType = "services::ProtoUnboundedRepeated<" + type->protoType + ">";
         protoReferenceType = "services::ProtoUnboundedRepeated<" + type->protoReferenceType + ">";
+        // std::vector<bool> does not provide a contiguous range of elements to send
+        streamed = descriptor.options().GetExtension(::streamed) && type->protoType != "services::ProtoBool";
     }
 
     void EchoFieldUnboundedRepeated::Accept(EchoFieldVisitor& visitor) const
@@ -620,6 +629,7 @@ namespace application
     EchoRoot::EchoRoot(const google::protobuf::FileDescriptor& rootFile)
     {
         GetFile(rootFile);
+        CheckStreamedFields();
     }
 
     void EchoRoot::AddDescriptorSet(const google::protobuf::FileDescriptorSet& descriptorSet)
@@ -697,4 +707,33 @@ namespace application
         services.push_back(result);
         return result;
     }
+
+    void EchoRoot::CheckStreamedFields() const
+    {
+        // Streamed fields are handed out through callbacks that are only installed on the parameter of a received method
+        for (auto& message : messages)
+            for (auto& field : message->fields)
+                if (field->streamed && (!IsParameter(*message) || IsNested(*message)))
+                    throw StreamedFieldNotInParameter{ message->name, field->name };
+    }
+
+    bool EchoRoot::IsParameter(const EchoMessage& message) const
+    {
+        for (auto& service : services)
+            for (auto& method : service->methods)
+                if (method.parameter.get() == &message)
+                    return true;
+
+        return false;
+    }
+
+    bool EchoRoot::IsNested(const EchoMessage& message) const
+    {
+        for (auto& other : messages)
+            for (int i = 0; i != other->descriptor.field_count(); ++i)
+                if (other->descriptor.field(i)->message_type() == &message.descriptor)
+                    return true;
+
+        return false;
+    }
 }
@@ -28,6 +28,7 @@ namespace application
         std::string name;
         int number;
         std::string constantName;
+        bool streamed = false;
 
         static std::shared_ptr<EchoField> GenerateField(const google::protobuf::FieldDescriptor& fieldDescriptor, EchoRoot& root);
     };
@@ -141,6 +142,7 @@ namespace application
         void Accept(EchoFieldVisitor& visitor) const override;
 
         uint32_t maxStringSize;
+        bool view;
     };
 
     class EchoFieldUnboundedString
@@ -173,6 +175,7 @@ namespace application
         void Accept(EchoFieldVisitor& visitor) const override;
 
         uint32_t maxBytesSize;
+        bool view;
     };
 
     class EchoFieldUnboundedBytes
@@ -291,6 +294,11 @@ namespace application
         std::vector<std::shared_ptr<EchoService>> services;
 
         google::protobuf::DescriptorPool pool;
+
+    private:
+        void CheckStreamedFields() const;
+        bool IsParameter(const EchoMessage& message) const;
+        bool IsNested(const EchoMessage& message) const;
     };
 
     class EchoFieldVisitor
@@ -352,6 +360,12 @@ namespace application
         std::string method;
     };
 
+    struct StreamedFieldNotInParameter
+    {
+        std::string message;
+        std::string fieldName;
+    };
+
     struct MessageNotFound
     {
         std::string name;
@@ -4,6 +4,9 @@
 #include "google/protobuf/compiler/plugin.h"
 #include "google/protobuf/io/zero_copy_stream_impl.h"
 #include "infra/syntax/ProtoFormatter.hpp"
+#include <algorithm>
+#include <limits>
+#include <optional>
 #include <sstream>
 
 namespace application
@@ -50,7 +53,10 @@ namespace application
 
             void VisitString(const EchoFieldString& field) override
             {
-                result = "infra::BoundedString::WithStorage<" + absl::StrCat(field.maxStringSize) + ">";
+                if (field.view)
+                    result = "infra::BoundedConstString";
+                else
+                    result = "infra::BoundedString::WithStorage<" + absl::StrCat(field.maxStringSize) + ">";
             }
 
             void VisitUnboundedString(const EchoFieldUnboundedString& field) override
@@ -80,12 +86,20 @@ namespace application
 
             void VisitBytes(const EchoFieldBytes& field) override
             {
-                result = "infra::BoundedVector<uint8_t>::WithMaxSize<" + absl::StrCat(field.maxBytesSize) + ">";
+                if (field.streamed)
+                    result = "services::StreamedBytes";
+                else if (field.view)
+                    result = "infra::ConstByteRange";
+                else
+                    result = "infra::BoundedVector<uint8_t>::WithMaxSize<" + absl::StrCat(field.maxBytesSize) + ">";
             }
 
             void VisitUnboundedBytes(const EchoFieldUnboundedBytes& field) override
             {
-                result = "std::vector<uint8_t>";
+                if (field.streamed)
+                    result = "services::StreamedBytes";
+                else
+                    result = "std::vector<uint8_t>";
             }
 
             void VisitUint32(const EchoFieldUint32& field) override
@@ -98,7 +112,10 @@ namespace application
                 std::string r;
                 StorageTypeVisitor visitor(r);
                 field.type->Accept(visitor);
-                result = "infra::BoundedVector<" + r + ">::WithMaxSize<" + absl::StrCat(field.maxArraySize) + ">";
+                if (field.streamed)
+                    result = "services::StreamedRepeated<" + r + ">";
+                else
+                    result = "infra::BoundedVector<" + r + ">::WithMaxSize<" + absl::StrCat(field.maxArraySize) + ">";
             }
 
             void VisitUnboundedRepeated(const EchoFieldUnboundedRepeated& field) override
@@ -106,7 +123,10 @@ namespace application
                 std::string r;
                 StorageTypeVisitor visitor(r);
                 field.type->Accept(visitor);
-                result = "std::vector<" + r + ">";
+                if (field.streamed)
+                    result = "services::StreamedRepeated<" + r + ">";
+                else
+                    result = "std::vector<" + r + ">";
             }
 
         protected:
@@ -134,11 +154,24 @@ namespace application
                 result = "infra::ConstByteRange";
             }
 
+            void VisitUnboundedBytes(const EchoFieldUnboundedBytes& field) override
+            {
+                result = "std::vector<uint8_t>";
+            }
+
             void VisitEnum(const EchoFieldEnum& field) override
             {
                 result = field.type->name;
             }
 
+            void VisitUnboundedRepeated(const EchoFieldUnboundedRepeated& field) override
+            {
+                std::string r;
+                StorageTypeVisitor visitor(r);
+                field.type->Accept(visitor);
+                result = "std::vector<" + r + ">";
+            }
+
             void VisitRepeated(const EchoFieldRepeated& field) override
             {
                 std::string r;
@@ -383,12 +416,36 @@ namespace application
 
             void VisitBytes(const EchoFieldBytes& field) override
             {
-                result = "infra::MakeRange(" + field.name + ")";
+                if (field.streamed)
+                    result = field.name + ".contents";
+                else if (field.view)
+                    result = field.name;
+                else
+                    result = "infra::MakeRange(" + field.name + ")";
             }
 
             void VisitUnboundedBytes(const EchoFieldUnboundedBytes& field) override
             {
-                result = "infra::MakeRange(" + field.name + ")";
+                if (field.streamed)
+                    result = field.name + ".contents";
+                else
+                    result = "infra::MakeRange(" + field.name + ")";
+            }
+
+            void VisitRepeated(const EchoFieldRepeated& field) override
+            {
+                if (field.streamed)
+                    result = field.name + ".elements";
+                else
+                    DecayedReferenceVisitor::VisitRepeated(field);
+            }
+
+            void VisitUnboundedRepeated(const EchoFieldUnboundedRepeated& field) override
+            {
+                if (field.streamed)
+                    result = field.name + ".elements";
+                else
+                    DecayedReferenceVisitor::VisitUnboundedRepeated(field);
             }
         };
 
@@ -418,6 +475,195 @@ namespace application
                 result = field.name + ".begin(), " + field.name + ".end()";
             }
         };
+
+        // The type of the parameter of the method that receives a streamed field, per chunk or per element
+        class StreamedParameterTypeVisitor
+            : public ParameterTypeVisitor
+        {
+        public:
+            using ParameterTypeVisitor::ParameterTypeVisitor;
+
+            void VisitRepeated(const EchoFieldRepeated& field) override
+            {
+                ParameterTypeVisitor visitor(result);
+                field.type->Accept(visitor);
+            }
+
+            void VisitUnboundedRepeated(const EchoFieldUnboundedRepeated& field) override
+            {
+                ParameterTypeVisitor visitor(result);
+                field.type->Accept(visitor);
+            }
+        };
+
+        // Sets the callback of a streamed field of the received message to the method that receives the field
+        class StreamedCallbackVisitor
+            : public FieldNameVisitor
+        {
+        public:
+            StreamedCallbackVisitor(std::string& result, const std::string& methodName)
+                : FieldNameVisitor(result)
+                , methodName(methodName)
+            {}
+
+            void VisitBytes(const EchoFieldBytes& field) override
+            {
+                result = "message." + field.name + ".onChunk = [this](infra::ConstByteRange " + field.name + ") { " + methodName + "(" + field.name + "); };";
+            }
+
+            void VisitUnboundedBytes(const EchoFieldUnboundedBytes& field) override
+            {
+                result = "message." + field.name + ".onChunk = [this](infra::ConstByteRange " + field.name + ") { " + methodName + "(" + field.name + "); };";
+            }
+
+            void VisitRepeated(const EchoFieldRepeated& field) override
+            {
+                result = "message." + field.name + ".onElement = [this](" + ElementParameter(*field.type) + ") { " + methodName + "(" + DecayedElement(*field.type) + "); };";
+            }
+
+            void VisitUnboundedRepeated(const EchoFieldUnboundedRepeated& field) override
+            {
+                result = "message." + field.name + ".onElement = [this](" + ElementParameter(*field.type) + ") { " + methodName + "(" + DecayedElement(*field.type) + "); };";
+            }
+
+        private:
+            std::string ElementParameter(const EchoField& element) const
+            {
+                std::string type;
+                StorageTypeVisitor visitor(type);
+                element.Accept(visitor);
+                return "const " + type + "& " + element.name;
+            }
+
+            std::string DecayedElement(const EchoField& element) const
+            {
+                std::string decayed;
+                DecayedVisitor visitor(decayed);
+                element.Accept(visitor);
+                return decayed;
+            }
+
+        private:
+            std::string methodName;
+        };
+
+        // The maximum encoded size of a field including its tag, for fields that are not length delimited
+        class FixedFieldSizeVisitor
+            : public EchoFieldVisitor
+        {
+        public:
+            explicit FixedFieldSizeVisitor(std::optional<uint32_t>& result)
+                : result(result)
+            {}
+
+            void VisitInt64(const EchoFieldInt64& field) override
+            {
+                result = Tag(field) + infra::MaxVarIntSize(std::numeric_limits<uint64_t>::max());
+            }
+
+            void VisitUint64(const EchoFieldUint64& field) override
+            {
+                result = Tag(field) + infra::MaxVarIntSize(std::numeric_limits<uint64_t>::max());
+            }
+
+            void VisitInt32(const EchoFieldInt32& field) override
+            {
+                // Negative values are sign extended to 64 bits
+                result = Tag(field) + infra::MaxVarIntSize(std::numeric_limits<uint64_t>::max());
+            }
+
+            void VisitFixed64(const EchoFieldFixed64& field) override
+            {
+                result = Tag(field) + 8;
+            }
+
+            void VisitFixed32(const EchoFieldFixed32& field) override
+            {
+                result = Tag(field) + 4;
+            }
+
+            void VisitBool(const EchoFieldBool& field) override
+            {
+                result = Tag(field) + 1;
+            }
+
+            void VisitString(const EchoFieldString& field) override
+            {
+                result = std::nullopt;
+            }
+
+            void VisitUnboundedString(const EchoFieldUnboundedString& field) override
+            {
+                result = std::nullopt;
+            }
+
+            void VisitMessage(const EchoFieldMessage& field) override
+            {
+                result = std::nullopt;
+            }
+
+            void VisitBytes(const EchoFieldBytes& field) override
+            {
+                result = std::nullopt;
+            }
+
+            void VisitUnboundedBytes(const EchoFieldUnboundedBytes& field) override
+            {
+                result = std::nullopt;
+            }
+
+            void VisitUint32(const EchoFieldUint32& field) override
+            {
+                result = Tag(field) + infra::MaxVarIntSize(std::numeric_limits<uint32_t>::max());
+            }
+
+            void VisitEnum(const EchoFieldEnum& field) override
+            {
+                result = Tag(field) + infra::MaxVarIntSize(std::numeric_limits<uint64_t>::max());
+            }
+
+            void VisitSFixed64(const EchoFieldSFixed64& field) override
+            {
+                result = Tag(field) + 8;
+            }
+
+            void VisitSFixed32(const EchoFieldSFixed32& field) override
+            {
+                result = Tag(field) + 4;
+            }
+
+            void VisitRepeated(const EchoFieldRepeated& field) override
+            {
+                result = std::nullopt;
+            }
+
+            void VisitUnboundedRepeated(const EchoFieldUnboundedRepeated& field) override
+            {
+                result = std::nullopt;
+            }
+
+        private:
+            uint32_t Tag(const EchoField& field) const
+            {
+                return infra::MaxVarIntSize(field.number << 3);
+            }
+
+        private:
+            std::optional<uint32_t>& result;
+        };
+
+        std::string StreamedMethodName(const EchoMethod& method, const EchoField& field)
+        {
+            return method.name + google::protobuf::compiler::cpp::UnderscoresToCamelCase(field.name, true);
+        }
+
+        bool HasStreamedFields(const EchoMessage& message)
+        {
+            return std::any_of(message.fields.begin(), message.fields.end(), [](const std::shared_ptr<EchoField>& field)
+                {
+                    return field->streamed;
+                });
+        }
     }
 
     bool CppInfraCodeGenerator::Generate(const google::protobuf::FileDescriptor* file, const std::string& parameter,
@@ -468,6 +714,11 @@ namespace application
             *error = "Field " + exception.service + "." + exception.method + " needs a method_id specifying its id";
             return false;
         }
+        catch (StreamedFieldNotInParameter& exception)
+        {
+            *error = "Field " + exception.message + "." + exception.fieldName + " is streamed, which requires " + exception.message + " to be the parameter of a method and not to be used as a field of another message";
+            return false;
+        }
         catch (MessageNotFound& exception)
         {
             *error = "Message " + exception.name + " was used before having been fully defined";
@@ -895,7 +1146,7 @@ namespace application
         if (message->MaxMessageSize() != std::nullopt)
         {
             auto fields = std::make_shared<Access>("public");
-            fields->Add(std::make_shared<DataMember>("maxMessageSize", "static const uint32_t", absl::StrCat(*message->MaxMessageSize())));
+            fields->Add(std::make_shared<DataMember>("maxMessageSize", "static constexpr uint32_t", absl::StrCat(*message->MaxMessageSize())));
             classFormatter->Add(fields);
         }
     }
@@ -907,8 +1158,49 @@ namespace application
             google::protobuf::io::OstreamOutputStream stream(&result);
             google::protobuf::io::Printer printer(&stream, '$', nullptr);
 
+            // Runs of consecutive fixed-size fields are collected in a buffer sized at compile time, and written with a single bounds check
+            std::vector<std::shared_ptr<EchoField>> run;
+            uint32_t runSize = 0;
+
+            auto flushRun = [&printer, &run, &runSize]()
+            {
+                if (run.size() == 1)
+                    printer.Print("SerializeField($type$(), formatter, $name$, $constant$);\n", "type", run.front()->protoType, "name", run.front()->name, "constant", run.front()->constantName);
+                else if (run.size() > 1)
+                {
+                    printer.Print("{\n");
+                    printer.Indent();
+                    printer.Print("infra::ProtoFieldBuffer::WithMaxSize<$size$> buffer;\n", "size", absl::StrCat(runSize));
+                    for (auto& field : run)
+                        printer.Print("SerializeField($type$(), buffer, $name$, $constant$);\n", "type", field->protoType, "name", field->name, "constant", field->constantName);
+                    printer.Print("formatter.PutFields(buffer);\n");
+                    printer.Outdent();
+                    printer.Print("}\n");
+                }
+
+                run.clear();
+                runSize = 0;
+            };
+
             for (auto& field : message->fields)
-                printer.Print("SerializeField($type$(), formatter, $name$, $constant$);\n", "type", field->protoType, "name", field->name, "constant", field->constantName);
+            {
+                std::optional<uint32_t> fixedSize;
+                FixedFieldSizeVisitor visitor(fixedSize);
+                field->Accept(visitor);
+
+                if (fixedSize != std::nullopt)
+                {
+                    run.push_back(field);
+                    runSize += *fixedSize;
+                }
+                else
+                {
+                    flushRun();
+                    printer.Print("SerializeField($type$(), formatter, $name$, $constant$);\n", "type", field->protoType, "name", field->name, "constant", field->constantName);
+                }
+            }
+
+            flushRun();
         }
 
         return result.str();
@@ -1187,6 +1479,9 @@ namespace application
             {
                 for (auto field : method.parameter->fields)
                 {
+                    if (field->streamed)
+                        continue;
+
                     std::string typeName;
                     ParameterTypeVisitor visitor(typeName);
                     field->Accept(visitor);
@@ -1194,6 +1489,18 @@ namespace application
                 }
             }
             functions->Add(serviceMethod);
+
+            if (method.parameter)
+                for (auto field : method.parameter->fields)
+                    if (field->streamed)
+                    {
+                        auto streamedMethod = std::make_shared<Function>(StreamedMethodName(method, *field), "", "void", Function::fVirtual | Function::fAbstract);
+                        std::string typeName;
+                        StreamedParameterTypeVisitor visitor(typeName);
+                        field->Accept(visitor);
+                        streamedMethod->Parameter(typeName + " " + field->name);
+                        functions->Add(streamedMethod);
+                    }
         }
 
         auto acceptsService = std::make_shared<Function>("AcceptsService", AcceptsServiceBody(), "bool", Function::fConst | Function::fOverride);
@@ -1373,22 +1680,51 @@ namespace application
             ParameterTypeVisitor visitor(typeName);
             field->Accept(visitor);
 
-            printer.Print("$type$ v$index$", "type", typeName, "index", absl::StrCat(index));
+            if (field->streamed)
+                printer.Print("$type$", "type", typeName);
+            else
+                printer.Print("$type$ v$index$", "type", typeName, "index", absl::StrCat(index));
         }
 
         printer.Print(R"() { $name$()",
             "name", method.name);
 
+        bool first = true;
         for (auto& field : method.parameter->fields)
         {
-            auto index = std::distance(&method.parameter->fields.front(), &field);
-            if (index != 0)
+            if (field->streamed)
+                continue;
+
+            if (!first)
                 printer.Print(", ");
+            first = false;
 
+            auto index = std::distance(&method.parameter->fields.front(), &field);
             printer.Print("v$index$", "index", absl::StrCat(index));
         }
 
-        printer.Print(R"(); }));
+        printer.Print("); })");
+
+        if (HasStreamedFields(*method.parameter))
+        {
+            printer.Print(R"(, infra::Function<void($argument$&)>([this]($argument$& message)
+            {
+)",
+                "argument", method.parameter->qualifiedName);
+
+            for (auto& field : method.parameter->fields)
+                if (field->streamed)
+                {
+                    std::string callback;
+                    StreamedCallbackVisitor visitor(callback, StreamedMethodName(method, *field));
+                    field->Accept(visitor);
+                    printer.Print("                $callback$\n", "callback", callback);
+                }
+
+            printer.Print("            })");
+        }
+
+        printer.Print(R"();
 )");
     }
 
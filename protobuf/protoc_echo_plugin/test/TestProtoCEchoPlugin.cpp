@@ -500,3 +500,46 @@ TEST(ProtoCEchoPluginTest, deserialize_nested_repeated_message)
     EXPECT_EQ(5, message.message[0].value);
     EXPECT_EQ(6, message.message[1].value);
 }
+
+TEST(ProtoCEchoPluginTest, max_message_size_is_a_compile_time_constant)
+{
+    static_assert(test_messages::TestFixedSizeFields::maxMessageSize == 45);
+
+    std::array<uint8_t, test_messages::TestFixedSizeFields::maxMessageSize> storage;
+    EXPECT_EQ(45, storage.size());
+}
+
+TEST(ProtoCEchoPluginTest, serialize_fixed_size_fields_around_length_delimited_field)
+{
+    test_messages::TestFixedSizeFields message;
+    message.a = 5;
+    message.b = 2;
+    message.c = -1;
+    message.d = true;
+    message.e = "ab";
+    message.f = 3;
+
+    infra::ByteOutputStream::WithStorage<100> stream;
+    infra::ProtoFormatter formatter(stream);
+    message.Serialize(formatter);
+
+    EXPECT_EQ((std::array<uint8_t, 33>{ 1 << 3, 5, (2 << 3) | 5, 2, 0, 0, 0, 3 << 3, 0xff, 0xff, 0xff, 0xff, 0xff, 0xff, 0xff, 0xff, 0xff, 1, 4 << 3, 1,
+                  (5 << 3) | 2, 2, 'a', 'b', (6 << 3) | 1, 3, 0, 0, 0, 0, 0, 0, 0 }),
+        stream.Writer().Processed());
+}
+
+TEST(ProtoCEchoPluginTest, deserialize_fixed_size_fields_around_length_delimited_field)
+{
+    std::array<uint8_t, 33> data{ 1 << 3, 5, (2 << 3) | 5, 2, 0, 0, 0, 3 << 3, 0xff, 0xff, 0xff, 0xff, 0xff, 0xff, 0xff, 0xff, 0xff, 1, 4 << 3, 1,
+        (5 << 3) | 2, 2, 'a', 'b', (6 << 3) | 1, 3, 0, 0, 0, 0, 0, 0, 0 };
+    infra::ByteInputStream stream(data);
+    infra::ProtoParser parser(stream);
+
+    test_messages::TestFixedSizeFields message(parser);
+    EXPECT_EQ(5, message.a);
+    EXPECT_EQ(2, message.b);
+    EXPECT_EQ(-1, message.c);
+    EXPECT_TRUE(message.d);
+    EXPECT_EQ("ab", message.e);
+    EXPECT_EQ(3, message.f);
+}
@@ -37,6 +37,9 @@ namespace services
                   keepAliveForReader = nullptr;
               })
     {
+        if (clientSession != nullptr)
+            clientSession->Acquire();
+
         mbedtls_ssl_init(&sslContext);
         mbedtls_ssl_config_init(&sslConfig);
         mbedtls_ctr_drbg_init(&ctr_drbg);
@@ -55,7 +58,7 @@ namespace services
         certificates.Config(sslConfig);
 
         if (server)
-            mbedtls_ssl_conf_session_cache(&sslConfig, &std::get<ServerParameters>(parameters.parameters).serverCache, mbedtls_ssl_cache_get, mbedtls_ssl_cache_set);
+            std::get<ServerParameters>(parameters.parameters).serverCache.Configure(sslConfig);
 
         if (!server)
         {
@@ -122,6 +125,9 @@ namespace services
             mbedtls_ssl_free(&sslContext);
             mbedtls_ssl_config_free(&sslConfig);
         }
+
+        if (clientSession != nullptr)
+            clientSession->Release();
     }
 
     void ConnectionMbedTls::CreatedObserver(infra::SharedPtr<services::ConnectionObserver> connectionObserver)
@@ -481,7 +487,7 @@ namespace services
         Rewind(0);
     }
 
-    ConnectionMbedTlsListener::ConnectionMbedTlsListener(AllocatorConnectionMbedTls& allocator, ServerConnectionObserverFactory& factory, CertificatesMbedTls& certificates, hal::SynchronousRandomDataGenerator& randomDataGenerator, mbedtls_ssl_cache_context& serverCache, ConnectionMbedTls::CertificateValidation certificateValidation)
+    ConnectionMbedTlsListener::ConnectionMbedTlsListener(AllocatorConnectionMbedTls& allocator, ServerConnectionObserverFactory& factory, CertificatesMbedTls& certificates, hal::SynchronousRandomDataGenerator& randomDataGenerator, MbedTlsServerSessionCache& serverCache, ConnectionMbedTls::CertificateValidation certificateValidation)
         : allocator(allocator)
         , factory(factory)
         , certificates(certificates)
@@ -612,7 +618,8 @@ namespace services
 
     ConnectionFactoryMbedTls::ConnectionFactoryMbedTls(AllocatorConnectionMbedTls& connectionAllocator,
         AllocatorConnectionMbedTlsListener& listenerAllocator, infra::BoundedList<ConnectionMbedTlsConnector>& connectors, MbedTlsSessionStorage& sessionStorage,
-        ConnectionFactory& factory, CertificatesMbedTls& certificates, hal::SynchronousRandomDataGenerator& randomDataGenerator, ConnectionMbedTls::CertificateValidation certificateValidation)
+        ConnectionFactory& factory, CertificatesMbedTls& certificates, hal::SynchronousRandomDataGenerator& randomDataGenerator, ConnectionMbedTls::CertificateValidation certificateValidation,
+        const MbedTlsServerSessionCache::Config& serverSessionConfig)
         : connectionAllocator(connectionAllocator)
         , listenerAllocator(listenerAllocator)
         , sessionStorage(sessionStorage)
@@ -620,15 +627,9 @@ namespace services
         , factory(factory)
         , certificates(certificates)
         , randomDataGenerator(randomDataGenerator)
+        , serverCache(randomDataGenerator, serverSessionConfig)
         , certificateValidation(certificateValidation)
-    {
-        mbedtls_ssl_cache_init(&serverCache);
-    }
-
-    ConnectionFactoryMbedTls::~ConnectionFactoryMbedTls()
-    {
-        mbedtls_ssl_cache_free(&serverCache);
-    }
+    {}
 
     infra::SharedPtr<void> ConnectionFactoryMbedTls::Listen(uint16_t port, ServerConnectionObserverFactory& connectionObserverFactory, IPVersions versions)
     {
@@ -680,6 +681,9 @@ namespace services
         {
             if (sessionStorage.Full())
                 session != nullptr ? sessionStorage.Invalidate(session) : sessionStorage.Clear();
+            // A storage that keeps the sessions of open connections remains full while all of them are in use
+            if (sessionStorage.Full())
+                return nullptr;
             savedSession = sessionStorage.NewSession(address);
         }
         session = savedSession;
@@ -757,6 +761,9 @@ namespace services
         {
             if (sessionStorage.Full())
                 session != nullptr ? sessionStorage.Invalidate(session) : sessionStorage.Clear();
+            // A storage that keeps the sessions of open connections remains full while all of them are in use
+            if (sessionStorage.Full())
+                return nullptr;
             savedSession = sessionStorage.NewSession(hostname);
         }
 
@@ -35,7 +35,7 @@ namespace services
 
         struct ServerParameters
         {
-            mbedtls_ssl_cache_context& serverCache;
+            MbedTlsServerSessionCache& serverCache;
             CertificateValidation certificateValidation;
         };
 
@@ -158,7 +158,7 @@ namespace services
     {
     public:
         ConnectionMbedTlsListener(AllocatorConnectionMbedTls& allocator, ServerConnectionObserverFactory& factory,
-            CertificatesMbedTls& certificates, hal::SynchronousRandomDataGenerator& randomDataGenerator, mbedtls_ssl_cache_context& serverCache, ConnectionMbedTls::CertificateValidation certificateValidation);
+            CertificatesMbedTls& certificates, hal::SynchronousRandomDataGenerator& randomDataGenerator, MbedTlsServerSessionCache& serverCache, ConnectionMbedTls::CertificateValidation certificateValidation);
 
         void ConnectionAccepted(infra::AutoResetFunction<void(infra::SharedPtr<services::ConnectionObserver> connectionObserver)>&& createdObserver, services::IPAddress address) override;
 
@@ -169,13 +169,13 @@ namespace services
         ServerConnectionObserverFactory& factory;
         CertificatesMbedTls& certificates;
         hal::SynchronousRandomDataGenerator& randomDataGenerator;
-        mbedtls_ssl_cache_context& serverCache;
+        MbedTlsServerSessionCache& serverCache;
         ConnectionMbedTls::CertificateValidation certificateValidation;
         infra::SharedPtr<void> listener;
     };
 
     using AllocatorConnectionMbedTlsListener = infra::SharedObjectAllocator<ConnectionMbedTlsListener,
-        void(AllocatorConnectionMbedTls& allocator, ServerConnectionObserverFactory& factory, CertificatesMbedTls& certificates, hal::SynchronousRandomDataGenerator& randomDataGenerator, mbedtls_ssl_cache_context& serverCache, ConnectionMbedTls::CertificateValidation certificateValidation)>;
+        void(AllocatorConnectionMbedTls& allocator, ServerConnectionObserverFactory& factory, CertificatesMbedTls& certificates, hal::SynchronousRandomDataGenerator& randomDataGenerator, MbedTlsServerSessionCache& serverCache, ConnectionMbedTls::CertificateValidation certificateValidation)>;
 
     class ConnectionFactoryMbedTls;
 
@@ -240,8 +240,8 @@ namespace services
         using CustomSessionStorageWithMaxConnectionsListenersAndConnectors = infra::WithStorage<infra::WithStorage<infra::WithStorage<ConnectionFactoryMbedTls, AllocatorConnectionMbedTls::UsingAllocator<infra::SharedObjectAllocatorFixedSize>::WithStorage<MaxConnections>>, AllocatorConnectionMbedTlsListener::UsingAllocator<infra::SharedObjectAllocatorFixedSize>::WithStorage<MaxListeners>>, infra::BoundedList<ConnectionMbedTlsConnector>::WithMaxSize<MaxConnectors>>;
 
         ConnectionFactoryMbedTls(AllocatorConnectionMbedTls& connectionAllocator, AllocatorConnectionMbedTlsListener& listenerAllocator, infra::BoundedList<ConnectionMbedTlsConnector>& connectors, MbedTlsSessionStorage& sessionStorage,
-            ConnectionFactory& factory, CertificatesMbedTls& certificates, hal::SynchronousRandomDataGenerator& randomDataGenerator, ConnectionMbedTls::CertificateValidation certificateValidation = ConnectionMbedTls::CertificateValidation::Default);
-        ~ConnectionFactoryMbedTls();
+            ConnectionFactory& factory, CertificatesMbedTls& certificates, hal::SynchronousRandomDataGenerator& randomDataGenerator, ConnectionMbedTls::CertificateValidation certificateValidation = ConnectionMbedTls::CertificateValidation::Default,
+            const MbedTlsServerSessionCache::Config& serverSessionConfig = MbedTlsServerSessionCache::Config());
 
         infra::SharedPtr<void> Listen(uint16_t port, ServerConnectionObserverFactory& connectionObserverFactory, IPVersions versions = IPVersions::both) override;
         void Connect(ClientConnectionObserverFactory& connectionObserverFactory) override;
@@ -262,7 +262,7 @@ namespace services
         ConnectionFactory& factory;
         CertificatesMbedTls& certificates;
         hal::SynchronousRandomDataGenerator& randomDataGenerator;
-        mbedtls_ssl_cache_context serverCache;
+        MbedTlsServerSessionCache serverCache;
         MbedTlsSession* session = nullptr;
         IPAddress previousAddress;
         ConnectionMbedTls::CertificateValidation certificateValidation;
@@ -275,7 +275,7 @@ namespace services
         if (client != std::nullopt && client->HttpClientObserver::IsAttached())
             client->HttpClientObserver::Subject().CloseConnection();
 
-        hostAndPortHash = GenerateHostAndPortHash(*clientObserverFactory);
+        hostAndPortHash = GenerateHostAndPortHash(hasher, *clientObserverFactory);
         delegate.Connect(*this);
     }
 
@@ -333,10 +333,10 @@ namespace services
 
     bool HttpClientCachedConnectionConnector::SameHost() const
     {
-        return GenerateHostAndPortHash(*clientObserverFactory) == hostAndPortHash;
+        return GenerateHostAndPortHash(hasher, *clientObserverFactory) == hostAndPortHash;
     }
 
-    Sha256::Digest HttpClientCachedConnectionConnector::GenerateHostAndPortHash(const HttpClientObserverFactory& factory) const
+    Sha256::Digest HttpClientCachedConnectionConnector::GenerateHostAndPortHash(const Sha256& hasher, const HttpClientObserverFactory& factory)
     {
         Sha256::Digest hostHash = hasher.Calculate(infra::StringAsByteRange(factory.Hostname()));
         auto port = factory.Port();
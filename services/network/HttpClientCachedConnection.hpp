@@ -79,6 +79,8 @@ namespace services
 
         void Stop(const infra::Function<void()>& onDone);
 
+        static Sha256::Digest GenerateHostAndPortHash(const Sha256& hasher, const HttpClientObserverFactory& factory);
+
     private:
         // Implementation of HttpClientObserverFactory
         infra::BoundedConstString Hostname() const override;
@@ -99,7 +101,6 @@ namespace services
         void TryRetargetConnection();
         void ClientPtrExpired();
         bool SameHost() const;
-        Sha256::Digest GenerateHostAndPortHash(const HttpClientObserverFactory& factory) const;
 
     private:
         HttpClientConnector& delegate;
@@ -0,0 +1,242 @@
+#include "services/network/HttpClientConnectionPool.hpp"
+#include "infra/event/EventDispatcher.hpp"
+#include "infra/util/ReallyAssert.hpp"
+
+namespace services
+{
+    HttpClientConnectionPool::Slot::Slot(HttpClientConnectionPool& pool, HttpClientConnector& delegate)
+        : HttpClientCachedConnectionConnector(delegate, pool.hasher, pool.config.idleTimeout)
+        , pool(pool)
+    {}
+
+    bool HttpClientConnectionPool::Slot::Busy() const
+    {
+        return factory != nullptr;
+    }
+
+    void HttpClientConnectionPool::Slot::RetargetConnection()
+    {
+        ++pool.statistics.hits;
+        HttpClientCachedConnectionConnector::RetargetConnection();
+    }
+
+    void HttpClientConnectionPool::Slot::Connect()
+    {
+        ++pool.statistics.misses;
+        HttpClientCachedConnectionConnector::Connect();
+    }
+
+    void HttpClientConnectionPool::Slot::DetachingObserver()
+    {
+        HttpClientCachedConnectionConnector::DetachingObserver();
+        Released();
+    }
+
+    void HttpClientConnectionPool::Slot::DisconnectTimeout()
+    {
+        ++pool.statistics.idleTimeouts;
+        host = std::nullopt;
+        HttpClientCachedConnectionConnector::DisconnectTimeout();
+    }
+
+    HttpClientConnectionPool::Slot::Request::Request(Slot& slot)
+        : slot(slot)
+    {}
+
+    infra::BoundedConstString HttpClientConnectionPool::Slot::Request::Hostname() const
+    {
+        return slot.factory->Hostname();
+    }
+
+    uint16_t HttpClientConnectionPool::Slot::Request::Port() const
+    {
+        return slot.factory->Port();
+    }
+
+    void HttpClientConnectionPool::Slot::Request::ConnectionEstablished(infra::AutoResetFunction<void(infra::SharedPtr<HttpClientObserver> client)>&& createdObserver)
+    {
+        really_assert(slot.factory != nullptr);
+        // The slot stays busy until either the observer created by the factory detaches, or the factory discards the lambda without creating an observer
+        slot.createdObserver = std::move(createdObserver);
+
+        slot.factory->ConnectionEstablished([slotPtr = slot.requestPtr.MakeShared(slot)](infra::SharedPtr<HttpClientObserver> observer)
+            {
+                if (observer != nullptr)
+                {
+                    slotPtr->attached = true;
+                    slotPtr->createdObserver(observer);
+                }
+            });
+    }
+
+    void HttpClientConnectionPool::Slot::Request::ConnectionFailed(ConnectFailReason reason)
+    {
+        really_assert(slot.factory != nullptr);
+        auto& factory = *slot.factory;
+
+        slot.host = std::nullopt;
+        slot.Released();
+        factory.ConnectionFailed(reason);
+    }
+
+    void HttpClientConnectionPool::Slot::Serve(services::HttpClientObserverFactory& factory, const Sha256::Digest& host)
+    {
+        this->factory = &factory;
+        this->host = host;
+        attached = false;
+
+        HttpClientCachedConnectionConnector::Connect(request);
+    }
+
+    void HttpClientConnectionPool::Slot::Cancel()
+    {
+        HttpClientCachedConnectionConnector::CancelConnect(request);
+        host = std::nullopt;
+        Released();
+    }
+
+    void HttpClientConnectionPool::Slot::RequestExpired()
+    {
+        if (!attached)
+        {
+            createdObserver = nullptr;
+            Released();
+        }
+    }
+
+    void HttpClientConnectionPool::Slot::Released()
+    {
+        if (factory == nullptr)
+            return;
+
+        factory = nullptr;
+        lastUse = ++pool.useCounter;
+
+        infra::EventDispatcher::Instance().Schedule([this]()
+            {
+                pool.ServeWaiting();
+            });
+    }
+
+    HttpClientConnectionPool::HttpClientConnectionPool(infra::BoundedVector<Slot>& slots, infra::MemoryRange<HttpClientConnector*> delegates, const Sha256& hasher, const Config& config)
+        : slots(slots)
+        , hasher(hasher)
+        , config(config)
+    {
+        really_assert(delegates.size() <= slots.max_size());
+        really_assert(config.maxConnectionsPerHost != 0);
+
+        for (auto delegate : delegates)
+            slots.emplace_back(*this, *delegate);
+    }
+
+    void HttpClientConnectionPool::Connect(HttpClientObserverFactory& factory)
+    {
+        waitingClientObserverFactories.push_back(factory);
+
+        infra::EventDispatcher::Instance().Schedule([this]()
+            {
+                ServeWaiting();
+            });
+    }
+
+    void HttpClientConnectionPool::CancelConnect(HttpClientObserverFactory& factory)
+    {
+        for (auto& slot : slots)
+            if (slot.factory == &factory)
+            {
+                slot.Cancel();
+                return;
+            }
+
+        waitingClientObserverFactories.erase(factory);
+    }
+
+    void HttpClientConnectionPool::Stop(const infra::Function<void()>& onDone)
+    {
+        if (slots.empty())
+        {
+            onDone();
+            return;
+        }
+
+        onStopped = onDone;
+        slotsStopping = slots.size();
+
+        for (auto& slot : slots)
+            slot.Stop([this]()
+                {
+                    if (--slotsStopping == 0)
+                        onStopped();
+                });
+    }
+
+    HttpClientConnectionPool::Statistics HttpClientConnectionPool::GetStatistics() const
+    {
+        return statistics;
+    }
+
+    void HttpClientConnectionPool::ResetStatistics()
+    {
+        statistics = Statistics{};
+    }
+
+    void HttpClientConnectionPool::ServeWaiting()
+    {
+        // Waiting factories are served in order of arrival, but a factory that cannot be served yet, because its host has
+        // reached maxConnectionsPerHost, does not prevent factories behind it from being served
+        for (auto factory = waitingClientObserverFactories.begin(); factory != waitingClientObserverFactories.end();)
+        {
+            auto& current = *factory;
+            ++factory;
+
+            auto host = HttpClientCachedConnectionConnector::GenerateHostAndPortHash(hasher, current);
+            auto slot = SelectSlot(host);
+            if (slot != nullptr)
+            {
+                waitingClientObserverFactories.erase(current);
+                slot->Serve(current, host);
+            }
+        }
+    }
+
+    HttpClientConnectionPool::Slot* HttpClientConnectionPool::SelectSlot(const Sha256::Digest& host)
+    {
+        std::size_t connectionsToHost = 0;
+        Slot* unused = nullptr;
+        Slot* leastRecentlyUsed = nullptr;
+
+        for (auto& slot : slots)
+        {
+            if (slot.host == host)
+            {
+                if (!slot.Busy())
+                    return &slot;
+
+                ++connectionsToHost;
+            }
+            else if (!slot.Busy())
+            {
+                if (slot.host == std::nullopt)
+                {
+                    if (unused == nullptr)
+                        unused = &slot;
+                }
+                else if (leastRecentlyUsed == nullptr || slot.lastUse < leastRecentlyUsed->lastUse)
+                    leastRecentlyUsed = &slot;
+            }
+        }
+
+        if (connectionsToHost >= config.maxConnectionsPerHost)
+            return nullptr;
+        else if (unused != nullptr)
+            return unused;
+        else if (leastRecentlyUsed != nullptr)
+        {
+            ++statistics.evictions;
+            return leastRecentlyUsed;
+        }
+        else
+            return nullptr;
+    }
+}
@@ -0,0 +1,127 @@
+#ifndef SERVICES_HTTP_CLIENT_CONNECTION_POOL_HPP
+#define SERVICES_HTTP_CLIENT_CONNECTION_POOL_HPP
+
+#include "infra/util/AutoResetFunction.hpp"
+#include "infra/util/BoundedVector.hpp"
+#include "infra/util/IntrusiveList.hpp"
+#include "infra/util/MemoryRange.hpp"
+#include "infra/util/WithStorage.hpp"
+#include "services/network/HttpClientCachedConnection.hpp"
+#include <optional>
+
+namespace services
+{
+    // HttpClientConnectionPool keeps connections to several hosts open at the same time. Each slot caches one connection
+    // through its own delegate connector, e.g. an HttpClientConnectorWithNameResolverImpl, which has at most one connection
+    // open at a time.
+    //
+    // A request is served by an idle slot connected to the same host and port when there is one, so that its connection is
+    // reused. Otherwise it is served by an unused slot, or by the least recently used idle slot, of which the connection is
+    // then closed. At most maxConnectionsPerHost slots are connected to the same host and port. Requests that cannot be
+    // served yet wait in order of arrival, where a request for a host that has reached its limit does not hold up requests
+    // for other hosts. Idle connections are closed after idleTimeout.
+    class HttpClientConnectionPool
+        : public HttpClientConnector
+    {
+    public:
+        struct Config
+        {
+            Config()
+            {}
+
+            std::size_t maxConnectionsPerHost = 2;
+            infra::Duration idleTimeout = std::chrono::minutes(1);
+        };
+
+        struct Statistics
+        {
+            uint32_t hits;         // Requests served on a connection that was already open
+            uint32_t misses;       // Requests for which a new connection was opened
+            uint32_t evictions;    // Idle connections closed to make room for another host
+            uint32_t idleTimeouts; // Idle connections closed because of idleTimeout
+        };
+
+        class Slot
+            : public HttpClientCachedConnectionConnector
+        {
+        public:
+            Slot(HttpClientConnectionPool& pool, HttpClientConnector& delegate);
+
+            bool Busy() const;
+
+        protected:
+            // Implementation of HttpClientCachedConnectionConnector
+            void RetargetConnection() override;
+            void Connect() override;
+            void DetachingObserver() override;
+            void DisconnectTimeout() override;
+
+        private:
+            class Request
+                : public services::HttpClientObserverFactory
+            {
+            public:
+                explicit Request(Slot& slot);
+
+                // Implementation of HttpClientObserverFactory
+                infra::BoundedConstString Hostname() const override;
+                uint16_t Port() const override;
+                void ConnectionEstablished(infra::AutoResetFunction<void(infra::SharedPtr<HttpClientObserver> client)>&& createdObserver) override;
+                void ConnectionFailed(ConnectFailReason reason) override;
+
+            private:
+                Slot& slot;
+            };
+
+            void Serve(services::HttpClientObserverFactory& factory, const Sha256::Digest& host);
+            void Cancel();
+            void RequestExpired();
+            void Released();
+
+        private:
+            friend class HttpClientConnectionPool;
+
+            HttpClientConnectionPool& pool;
+            Request request{ *this };
+            services::HttpClientObserverFactory* factory = nullptr;
+            std::optional<Sha256::Digest> host;
+            uint32_t lastUse = 0;
+            bool attached = false;
+            infra::AutoResetFunction<void(infra::SharedPtr<HttpClientObserver> client)> createdObserver;
+            infra::AccessedBySharedPtr requestPtr{ [this]()
+                {
+                    RequestExpired();
+                } };
+        };
+
+        template<std::size_t NumberOfSlots>
+        using WithSlots = infra::WithStorage<HttpClientConnectionPool, infra::BoundedVector<Slot>::WithMaxSize<NumberOfSlots>>;
+
+        HttpClientConnectionPool(infra::BoundedVector<Slot>& slots, infra::MemoryRange<HttpClientConnector*> delegates, const Sha256& hasher, const Config& config = Config());
+
+        // Implementation of HttpClientConnector
+        void Connect(HttpClientObserverFactory& factory) override;
+        void CancelConnect(HttpClientObserverFactory& factory) override;
+
+        void Stop(const infra::Function<void()>& onDone);
+
+        Statistics GetStatistics() const;
+        void ResetStatistics();
+
+    private:
+        void ServeWaiting();
+        Slot* SelectSlot(const Sha256::Digest& host);
+
+    private:
+        infra::BoundedVector<Slot>& slots;
+        const Sha256& hasher;
+        Config config;
+        infra::IntrusiveList<HttpClientObserverFactory> waitingClientObserverFactories;
+        Statistics statistics{};
+        uint32_t useCounter = 0;
+        std::size_t slotsStopping = 0;
+        infra::AutoResetFunction<void()> onStopped;
+    };
+}
+
+#endif
@@ -0,0 +1,210 @@
+#include "services/network/HttpRouter.hpp"
+#include "infra/util/ReallyAssert.hpp"
+#include <algorithm>
+#include <limits>
+
+namespace services
+{
+    HttpRouter::HttpRouter(infra::BoundedVector<Node>& nodes, infra::BoundedVector<Literal>& literals, infra::BoundedVector<MatchedParameter>& parameters)
+        : nodes(nodes)
+        , literals(literals)
+        , parameters(parameters)
+    {
+        really_assert(nodes.max_size() != 0 && nodes.max_size() <= std::numeric_limits<uint16_t>::max());
+
+        nodes.clear();
+        literals.clear();
+        nodes.push_back(Node{ infra::BoundedConstString(), nullptr, none, none, SegmentKind::literal, HttpVerb::get });
+    }
+
+    void HttpRouter::AddRoute(HttpVerb verb, infra::BoundedConstString pattern, HttpPage& page)
+    {
+        uint16_t node = 0;
+        std::size_t numberOfParameters = 0;
+
+        for (auto segment = NextSegment(pattern); !segment.empty(); segment = NextSegment(pattern))
+        {
+            really_assert(nodes[node].kind != SegmentKind::wildcard);
+
+            auto kind = KindOf(segment);
+            if (kind == SegmentKind::parameter)
+                segment = segment.substr(1, segment.size() - 2);
+            if (kind != SegmentKind::literal)
+                ++numberOfParameters;
+
+            node = Child(node, kind, segment);
+        }
+
+        really_assert(numberOfParameters <= parameters.max_size());
+        really_assert(Route(node, verb) == none);
+
+        auto& route = nodes[Insert(node, SegmentKind::route, infra::BoundedConstString())];
+        route.verb = verb;
+        route.page = &page;
+    }
+
+    std::optional<infra::BoundedConstString> HttpRouter::Parameter(infra::BoundedConstString name) const
+    {
+        for (auto& parameter : parameters)
+            if (parameter.name == name)
+                return parameter.value;
+
+        return std::nullopt;
+    }
+
+    infra::BoundedConstString HttpRouter::Parameter(std::size_t index) const
+    {
+        really_assert(index < parameters.size());
+        return parameters[index].value;
+    }
+
+    std::size_t HttpRouter::NumberOfParameters() const
+    {
+        return parameters.size();
+    }
+
+    HttpPage* HttpRouter::PageForRequest(const HttpRequestParser& request)
+    {
+        parameters.clear();
+
+        auto page = Match(0, request.PathTokens().TokenAndRest(0), request.Verb());
+        if (page != nullptr)
+            return page;
+        else
+            return HttpPageServer::PageForRequest(request);
+    }
+
+    infra::BoundedConstString HttpRouter::NextSegment(infra::BoundedConstString& path)
+    {
+        auto start = path.find_first_not_of('/');
+        if (start == infra::BoundedConstString::npos)
+        {
+            path = infra::BoundedConstString();
+            return infra::BoundedConstString();
+        }
+
+        auto end = path.find('/', start);
+        auto segment = path.substr(start, end - start);
+        path = end != infra::BoundedConstString::npos ? path.substr(end) : infra::BoundedConstString();
+        return segment;
+    }
+
+    HttpRouter::SegmentKind HttpRouter::KindOf(infra::BoundedConstString segment)
+    {
+        if (segment == "*")
+            return SegmentKind::wildcard;
+        else if (segment.size() >= 2 && segment.front() == '{' && segment.back() == '}')
+            return SegmentKind::parameter;
+        else
+            return SegmentKind::literal;
+    }
+
+    infra::BoundedVector<HttpRouter::Literal>::iterator HttpRouter::LowerBound(uint16_t parent, infra::BoundedConstString segment)
+    {
+        return std::lower_bound(literals.begin(), literals.end(), segment, [this, parent](const Literal& literal, infra::BoundedConstString segment)
+            {
+                return literal.parent < parent || (literal.parent == parent && nodes[literal.node].segment < segment);
+            });
+    }
+
+    uint16_t HttpRouter::FindLiteral(uint16_t parent, infra::BoundedConstString segment)
+    {
+        auto literal = LowerBound(parent, segment);
+
+        if (literal != literals.end() && literal->parent == parent && nodes[literal->node].segment == segment)
+            return literal->node;
+        else
+            return none;
+    }
+
+    uint16_t HttpRouter::Child(uint16_t parent, SegmentKind kind, infra::BoundedConstString segment)
+    {
+        if (kind == SegmentKind::literal)
+        {
+            auto literal = FindLiteral(parent, segment);
+            if (literal != none)
+                return literal;
+        }
+        else
+            for (auto child = nodes[parent].firstChild; child != none; child = nodes[child].nextSibling)
+                if (nodes[child].kind == kind && nodes[child].segment == segment)
+                    return child;
+
+        return Insert(parent, kind, segment);
+    }
+
+    uint16_t HttpRouter::Insert(uint16_t parent, SegmentKind kind, infra::BoundedConstString segment)
+    {
+        really_assert(!nodes.full());
+
+        auto index = static_cast<uint16_t>(nodes.size());
+
+        if (kind == SegmentKind::literal)
+        {
+            literals.insert(LowerBound(parent, segment), Literal{ parent, index });
+            nodes.push_back(Node{ segment, nullptr, none, none, kind, HttpVerb::get });
+        }
+        else
+        {
+            // Siblings are kept ordered on kind, so that Match tries parameters before wildcards, and finds routes last
+            auto link = &nodes[parent].firstChild;
+            while (*link != none && nodes[*link].kind <= kind)
+                link = &nodes[*link].nextSibling;
+
+            nodes.push_back(Node{ segment, nullptr, none, *link, kind, HttpVerb::get });
+            *link = index;
+        }
+
+        return index;
+    }
+
+    uint16_t HttpRouter::Route(uint16_t node, HttpVerb verb) const
+    {
+        for (auto child = nodes[node].firstChild; child != none; child = nodes[child].nextSibling)
+            if (nodes[child].kind == SegmentKind::route && nodes[child].verb == verb)
+                return child;
+
+        return none;
+    }
+
+    HttpPage* HttpRouter::Match(uint16_t node, infra::BoundedConstString path, HttpVerb verb)
+    {
+        auto rest = path;
+        auto segment = NextSegment(rest);
+
+        if (segment.empty())
+        {
+            auto route = Route(node, verb);
+            return route != none ? nodes[route].page : nullptr;
+        }
+
+        auto literal = FindLiteral(node, segment);
+        if (literal != none)
+            if (auto page = Match(literal, rest, verb))
+                return page;
+
+        for (auto child = nodes[node].firstChild; child != none; child = nodes[child].nextSibling)
+        {
+            auto& candidate = nodes[child];
+
+            if (candidate.kind == SegmentKind::parameter)
+            {
+                parameters.push_back(MatchedParameter{ candidate.segment, segment });
+                if (auto page = Match(child, rest, verb))
+                    return page;
+                parameters.pop_back();
+            }
+            else if (candidate.kind == SegmentKind::wildcard)
+            {
+                auto route = Route(child, verb);
+                if (route != none)
+                {
+                    parameters.push_back(MatchedParameter{ candidate.segment, infra::BoundedConstString(segment.begin(), path.end() - segment.begin()) });
+                    return nodes[route].page;
+                }
+            }
+        }
+
+        return nullptr;
+    }
+}
@@ -0,0 +1,97 @@
+#ifndef SERVICES_HTTP_ROUTER_HPP
+#define SERVICES_HTTP_ROUTER_HPP
+
+#include "infra/util/BoundedString.hpp"
+#include "infra/util/BoundedVector.hpp"
+#include "infra/util/WithStorage.hpp"
+#include "services/network/Http.hpp"
+#include "services/network/HttpServer.hpp"
+#include <optional>
+
+namespace services
+{
+    // HttpRouter compiles routes into a trie of path segments, so that finding the page for a request takes time
+    // proportional to the number of segments in the path, instead of to the total number of pages. The literal children
+    // of all nodes are kept in one vector sorted on parent and segment, so that a literal is found by binary search;
+    // the other children of a node are linked as siblings. A pattern consists of segments separated by '/', where each
+    // segment is one of:
+    // - a literal, which matches a path segment that is equal to it;
+    // - "{name}", a parameter, which matches any single path segment;
+    // - "*", a wildcard, which may only be the last segment, and which matches the non-empty remainder of the path.
+    // Literals take precedence over parameters, and parameters over wildcards. Each pattern may have a page per verb.
+    //
+    // The values matched by parameters and by a wildcard are views into the request path. They are available through
+    // Parameter, where a wildcard is named "*", until the next invocation of PageForRequest. Requests that do not match
+    // any route are served by the pages added with AddPage.
+    class HttpRouter
+        : public HttpPageServer
+    {
+    public:
+        enum class SegmentKind : uint8_t
+        {
+            literal,
+            parameter,
+            wildcard,
+            route
+        };
+
+        struct Node
+        {
+            infra::BoundedConstString segment;
+            HttpPage* page;
+            uint16_t firstChild;
+            uint16_t nextSibling;
+            SegmentKind kind;
+            HttpVerb verb;
+        };
+
+        struct Literal
+        {
+            uint16_t parent;
+            uint16_t node;
+        };
+
+        struct MatchedParameter
+        {
+            infra::BoundedConstString name;
+            infra::BoundedConstString value;
+        };
+
+        template<std::size_t MaxNodes, std::size_t MaxParameters = 4>
+        using WithMaxNodes = infra::WithStorage<infra::WithStorage<infra::WithStorage<HttpRouter,
+                                                                       infra::BoundedVector<Node>::WithMaxSize<MaxNodes>>,
+                                                    infra::BoundedVector<Literal>::WithMaxSize<MaxNodes>>,
+            infra::BoundedVector<MatchedParameter>::WithMaxSize<MaxParameters>>;
+
+        HttpRouter(infra::BoundedVector<Node>& nodes, infra::BoundedVector<Literal>& literals, infra::BoundedVector<MatchedParameter>& parameters);
+
+        void AddRoute(HttpVerb verb, infra::BoundedConstString pattern, HttpPage& page);
+
+        std::optional<infra::BoundedConstString> Parameter(infra::BoundedConstString name) const;
+        infra::BoundedConstString Parameter(std::size_t index) const;
+        std::size_t NumberOfParameters() const;
+
+        // Implementation of HttpPageServer
+        HttpPage* PageForRequest(const HttpRequestParser& request) override;
+
+    private:
+        static infra::BoundedConstString NextSegment(infra::BoundedConstString& path);
+        static SegmentKind KindOf(infra::BoundedConstString segment);
+
+        infra::BoundedVector<Literal>::iterator LowerBound(uint16_t parent, infra::BoundedConstString segment);
+        uint16_t FindLiteral(uint16_t parent, infra::BoundedConstString segment);
+        uint16_t Child(uint16_t parent, SegmentKind kind, infra::BoundedConstString segment);
+        uint16_t Insert(uint16_t parent, SegmentKind kind, infra::BoundedConstString segment);
+        uint16_t Route(uint16_t node, HttpVerb verb) const;
+        HttpPage* Match(uint16_t node, infra::BoundedConstString path, HttpVerb verb);
+
+    private:
+        static const uint16_t none = 0;
+
+        infra::BoundedVector<Node>& nodes;
+        infra::BoundedVector<Literal>& literals;
+        infra::BoundedVector<MatchedParameter>& parameters;
+    };
+}
+
+#endif
@@ -8,6 +8,42 @@
 
 namespace services
 {
+    namespace
+    {
+        class HttpResponseWithConnectionClose
+            : public HttpResponse
+        {
+        public:
+            explicit HttpResponseWithConnectionClose(const HttpResponse& response)
+                : response(response)
+            {}
+
+            infra::BoundedConstString Status() const override
+            {
+                return response.Status();
+            }
+
+            void WriteBody(infra::TextOutputStream& stream) const override
+            {
+                response.WriteBody(stream);
+            }
+
+            infra::BoundedConstString ContentType() const override
+            {
+                return response.ContentType();
+            }
+
+            void AddHeaders(HttpResponseHeaderBuilder& builder) const override
+            {
+                response.AddHeaders(builder);
+                builder.AddHeader("Connection", "close");
+            }
+
+        private:
+            const HttpResponse& response;
+        };
+    }
+
     SimpleHttpResponse httpResponseNoContent{ services::http_responses::noContent };
 
     void HttpPageServer::AddPage(services::HttpPage& page)
@@ -124,7 +160,7 @@ namespace services
             return infra::BoundedConstString();
     }
 
-    HttpServerConnectionObserver::HttpServerConnectionObserver(infra::BoundedString& buffer, HttpPageServer& httpServer)
+    HttpServerConnectionObserver::HttpServerConnectionObserver(infra::BoundedString& buffer, HttpPageServer& httpServer, const Config& config)
         : buffer(buffer)
         , httpServer(httpServer)
         , pageLimitedReader([this]()
@@ -136,12 +172,14 @@ namespace services
                   idle = true;
                   CheckIdleClose();
               })
+        , config(config)
     {}
 
     void HttpServerConnectionObserver::Attached()
     {
         this->connection = &Subject();
         RequestSendStream();
+        StartIdleTimeout();
     }
 
     void HttpServerConnectionObserver::SendStreamAvailable(infra::SharedPtr<infra::StreamWriter>&& writer)
@@ -172,7 +210,11 @@ namespace services
             if (pageServer != nullptr)
                 DataReceivedForPage(std::move(reader));
             else if (parser != std::nullopt) // Received data after contents for the page, but before closing the page request
-                Abort();
+            {
+                // With keepAlive, this is the next request, which is left in the connection until the response has been sent
+                if (!config.keepAlive)
+                    Abort();
+            }
             else
                 ReceivedRequest(std::move(reader));
         }
@@ -221,7 +263,11 @@ namespace services
 
     void HttpServerConnectionObserver::SendResponse(const HttpResponse& response)
     {
-        SendResponseWithoutNextRequest(response);
+        if (lastRequest)
+            SendResponseWithoutNextRequest(HttpResponseWithConnectionClose(response));
+        else
+            SendResponseWithoutNextRequest(response);
+
         PrepareForNextRequest();
     }
 
@@ -328,6 +374,10 @@ namespace services
 
     void HttpServerConnectionObserver::HandleRequest(infra::SharedPtr<infra::StreamReaderWithRewinding>&& reader)
     {
+        idleTimeout.Cancel();
+        ++requestsReceived;
+        lastRequest = (config.keepAlive && ConnectionCloseRequested()) || requestsReceived == config.maxRequestsPerConnection;
+
         RequestIsNowInProgress();
 
         send100Response = send100Response || Expect100();
@@ -354,7 +404,7 @@ namespace services
 
     void HttpServerConnectionObserver::DataReceivedForPage(infra::SharedPtr<infra::StreamReaderWithRewinding>&& reader)
     {
-        if (contentLength != std::nullopt && reader->Available() > *contentLength)
+        if (contentLength != std::nullopt && reader->Available() > *contentLength && !config.keepAlive)
             Abort();
         else
         {
@@ -403,6 +453,12 @@ namespace services
             lengthRead = 0;
             send100Response = false;
             buffer.clear();
+
+            if (lastRequest)
+                closeWhenIdle = true;
+            else
+                StartIdleTimeout();
+
             SetIdle();
         }
     }
@@ -412,6 +468,11 @@ namespace services
         return parser->Header("Expect") == "100-continue";
     }
 
+    bool HttpServerConnectionObserver::ConnectionCloseRequested() const
+    {
+        return infra::CaseInsensitiveCompare(parser->Header("Connection"), "close");
+    }
+
     void HttpServerConnectionObserver::SendBuffer()
     {
         infra::TextOutputStream::WithErrorPolicy stream(*streamWriter);
@@ -428,6 +489,16 @@ namespace services
             ConnectionObserver::Close();
     }
 
+    void HttpServerConnectionObserver::StartIdleTimeout()
+    {
+        if (config.idleTimeout != std::nullopt)
+            idleTimeout.Start(*config.idleTimeout, [this]()
+                {
+                    closeWhenIdle = true;
+                    SetIdle();
+                });
+    }
+
     void SimpleHttpPage::RequestReceived(HttpRequestParser& parser, HttpServerConnection& connection)
     {
         this->connection = &connection;
@@ -486,12 +557,13 @@ namespace services
         return contentType;
     }
 
-    DefaultHttpServer::DefaultHttpServer(infra::BoundedString& buffer, ConnectionFactory& connectionFactory, uint16_t port)
+    DefaultHttpServer::DefaultHttpServer(infra::BoundedString& buffer, ConnectionFactory& connectionFactory, uint16_t port, const HttpServerConnectionObserver::Config& config)
         : SingleConnectionListener(connectionFactory, port, { connectionCreator })
         , buffer(buffer)
+        , config(config)
         , connectionCreator([this](std::optional<HttpServerConnectionObserver>& value, IPAddress address)
               {
-                  value.emplace(this->buffer, *this);
+                  value.emplace(this->buffer, *this, this->config);
               })
     {}
 }
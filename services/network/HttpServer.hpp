@@ -157,7 +157,24 @@ namespace services
         template<::size_t BufferSize>
         using WithBuffer = infra::WithStorage<HttpServerConnectionObserver, infra::BoundedString::WithStorage<BufferSize>>;
 
-        HttpServerConnectionObserver(infra::BoundedString& buffer, HttpPageServer& httpServer);
+        struct Config
+        {
+            Config()
+            {}
+
+            // The connection is always kept open after a response. When keepAlive is enabled, requests that arrive
+            // before the response to the previous request has been sent are kept in the connection's receive buffer,
+            // and are parsed as soon as that response has been written to the connection; without it, such requests
+            // abort the connection. Also, the connection is then closed after responding to a request with
+            // "Connection: close".
+            bool keepAlive = false;
+            // When set, the connection is closed after waiting this long for a request
+            std::optional<infra::Duration> idleTimeout;
+            // When non-zero, the connection is closed after responding to this many requests
+            uint32_t maxRequestsPerConnection = 0;
+        };
+
+        HttpServerConnectionObserver(infra::BoundedString& buffer, HttpPageServer& httpServer, const Config& config = Config());
 
         // Implementation of ConnectionObserver
         void Attached() override;
@@ -196,8 +213,10 @@ namespace services
         void RequestSendStream();
         void PrepareForNextRequest();
         bool Expect100() const;
+        bool ConnectionCloseRequested() const;
         void SendBuffer();
         void CheckIdleClose();
+        void StartIdleTimeout();
 
     protected:
         infra::SharedPtr<infra::StreamWriter> streamWriter;
@@ -220,6 +239,10 @@ namespace services
         std::optional<HttpRequestParserImpl> parser;
         infra::TimerSingleShot initialIdle;
         bool sendingResponse = false;
+        Config config;
+        infra::TimerSingleShot idleTimeout;
+        uint32_t requestsReceived = 0;
+        bool lastRequest = false;
 
         friend class SimpleHttpPage;
     };
@@ -232,10 +255,11 @@ namespace services
         template<::size_t BufferSize>
         using WithBuffer = infra::WithStorage<DefaultHttpServer, infra::BoundedString::WithStorage<BufferSize>>;
 
-        DefaultHttpServer(infra::BoundedString& buffer, ConnectionFactory& connectionFactory, uint16_t port);
+        DefaultHttpServer(infra::BoundedString& buffer, ConnectionFactory& connectionFactory, uint16_t port, const HttpServerConnectionObserver::Config& config = HttpServerConnectionObserver::Config());
 
     private:
         infra::BoundedString& buffer;
+        HttpServerConnectionObserver::Config config;
         infra::Creator<services::ConnectionObserver, HttpServerConnectionObserver, void(IPAddress address)> connectionCreator;
     };
 }
@@ -3,8 +3,10 @@
 #include "infra/util/BoundedString.hpp"
 #include "infra/util/BoundedVector.hpp"
 #include "infra/util/ByteRange.hpp"
+#include "infra/util/ReallyAssert.hpp"
 #include "services/network/Address.hpp"
 #include "services/util/Sha256.hpp"
+#include <algorithm>
 
 namespace services
 {
@@ -77,6 +79,22 @@ namespace services
         return identifier;
     }
 
+    void MbedTlsSession::Acquire()
+    {
+        ++users;
+    }
+
+    void MbedTlsSession::Release()
+    {
+        really_assert(users != 0);
+        --users;
+    }
+
+    bool MbedTlsSession::InUse() const
+    {
+        return users != 0;
+    }
+
     MbedTlsSessionHasher::MbedTlsSessionHasher(Sha256& hasher)
         : hasher(hasher)
     {}
@@ -287,4 +305,262 @@ namespace services
         nvm->emplace_back();
         return nvm->back();
     }
+
+    MbedTlsSessionStorageLru::Session::Session(Sha256::Digest identifier, MbedTlsSessionStorageLru& storage)
+        : MbedTlsSession(identifier)
+        , storage(storage)
+    {}
+
+    MbedTlsSessionStorageLru::Session::Session(network::MbedTlsPersistedSession& reference, MbedTlsSessionStorageLru& storage)
+        : MbedTlsSession(reference)
+        , storage(storage)
+    {}
+
+    void MbedTlsSessionStorageLru::Session::Obtained()
+    {
+        MbedTlsSession::Obtained();
+        storage.SessionObtained(*this);
+    }
+
+    MbedTlsSessionStorageLru::MbedTlsSessionStorageLru(infra::BoundedList<Session>& storage, TlsSessionHasher& hasher, const Config& config)
+        : storage(storage)
+        , hasher(hasher)
+        , config(config)
+    {}
+
+    MbedTlsSessionStorageLru::MbedTlsSessionStorageLru(infra::BoundedList<Session>& storage, services::ConfigurationStoreAccess<infra::BoundedVector<network::MbedTlsPersistedSession>>& nvm, TlsSessionHasher& hasher, const Config& config)
+        : storage(storage)
+        , nvm(&nvm)
+        , hasher(hasher)
+        , config(config)
+    {
+        LoadSessions();
+    }
+
+    MbedTlsSession* MbedTlsSessionStorageLru::NewSession(infra::BoundedConstString hostname)
+    {
+        return Emplace(hasher.HashHostname(hostname));
+    }
+
+    MbedTlsSession* MbedTlsSessionStorageLru::NewSession(IPAddress address)
+    {
+        return Emplace(hasher.HashIP(address));
+    }
+
+    MbedTlsSession* MbedTlsSessionStorageLru::GetSession(infra::BoundedConstString hostname)
+    {
+        return Find(hasher.HashHostname(hostname));
+    }
+
+    MbedTlsSession* MbedTlsSessionStorageLru::GetSession(IPAddress address)
+    {
+        return Find(hasher.HashIP(address));
+    }
+
+    void MbedTlsSessionStorageLru::Invalidate(MbedTlsSession* sessionToInvalidate)
+    {
+        for (auto& session : storage)
+            if (sessionToInvalidate == &session)
+            {
+                Remove(session);
+                return;
+            }
+    }
+
+    bool MbedTlsSessionStorageLru::Full() const
+    {
+        return storage.full() && std::all_of(storage.begin(), storage.end(), [](const Session& session)
+                                     {
+                                         return session.InUse();
+                                     });
+    }
+
+    void MbedTlsSessionStorageLru::Clear()
+    {
+        for (auto session = storage.begin(); session != storage.end();)
+        {
+            auto& current = *session++;
+
+            if (current.InUse())
+                current.invalidated = true;
+            else
+                storage.remove(current);
+        }
+
+        if (nvm != nullptr)
+        {
+            (*nvm)->clear();
+            nvm->Write();
+        }
+    }
+
+    MbedTlsSession* MbedTlsSessionStorageLru::Emplace(const Sha256::Digest& identifier)
+    {
+        if (storage.full())
+            Remove(Victim());
+
+        storage.emplace_back(identifier, *this);
+        Touch(storage.back());
+        return &storage.back();
+    }
+
+    MbedTlsSession* MbedTlsSessionStorageLru::Find(const Sha256::Digest& identifier)
+    {
+        for (auto& session : storage)
+            if (!session.invalidated && session.Identifier().range() == identifier)
+            {
+                if (session.expiry <= infra::Now() && !session.InUse())
+                {
+                    Remove(session);
+                    return nullptr;
+                }
+
+                session.lastUse = ++useCounter;
+                return &session;
+            }
+
+        return nullptr;
+    }
+
+    MbedTlsSessionStorageLru::Session& MbedTlsSessionStorageLru::Victim()
+    {
+        auto now = infra::Now();
+        Session* victim = nullptr;
+
+        for (auto& session : storage)
+        {
+            if (session.InUse())
+                continue;
+
+            if (session.invalidated || session.expiry <= now)
+                return session;
+
+            if (victim == nullptr || session.lastUse < victim->lastUse)
+                victim = &session;
+        }
+
+        really_assert(victim != nullptr);
+        return *victim;
+    }
+
+    void MbedTlsSessionStorageLru::Touch(Session& session)
+    {
+        session.lastUse = ++useCounter;
+        session.expiry = infra::Now() + config.lifetime;
+    }
+
+    void MbedTlsSessionStorageLru::Remove(Session& session)
+    {
+        // The persisted session is erased without writing, the next write of an obtained session persists its removal
+        if (nvm != nullptr)
+        {
+            auto persistedSession = FindPersistedSession(session.Identifier());
+            if (persistedSession != nullptr)
+                (*nvm)->erase(persistedSession);
+        }
+
+        if (session.InUse())
+            session.invalidated = true;
+        else
+            storage.remove(session);
+    }
+
+    void MbedTlsSessionStorageLru::SessionObtained(Session& session)
+    {
+        Touch(session);
+
+        if (nvm != nullptr && !session.invalidated)
+            SerializeSessionToFlash(session);
+    }
+
+    void MbedTlsSessionStorageLru::SerializeSessionToFlash(Session& session)
+    {
+        // Persisted sessions are kept in order of use, so that the least recently used one is dropped when the store is full
+        auto persistedSession = FindPersistedSession(session.Identifier());
+        if (persistedSession != nullptr)
+            (*nvm)->erase(persistedSession);
+        else if ((*nvm)->full())
+            (*nvm)->erase((*nvm)->begin());
+
+        (*nvm)->emplace_back();
+
+        if (MbedTlsSession::Serialize(session, (*nvm)->back()) != 0)
+            (*nvm)->pop_back();
+
+        nvm->Write();
+    }
+
+    void MbedTlsSessionStorageLru::LoadSessions()
+    {
+        while ((*nvm)->size() > storage.max_size())
+            (*nvm)->erase((*nvm)->begin());
+
+        for (auto persistedSession = (*nvm)->begin(); persistedSession != (*nvm)->end();)
+        {
+            storage.emplace_back(*persistedSession, *this);
+
+            if (storage.back().IsDeserialized())
+            {
+                Touch(storage.back());
+                ++persistedSession;
+            }
+            else
+            {
+                persistedSession = (*nvm)->erase(persistedSession);
+                storage.pop_back();
+            }
+        }
+    }
+
+    network::MbedTlsPersistedSession* MbedTlsSessionStorageLru::FindPersistedSession(const infra::BoundedVector<uint8_t>& identifier)
+    {
+        for (auto& persistedSession : **nvm)
+            if (persistedSession.identifier == identifier)
+                return &persistedSession;
+
+        return nullptr;
+    }
+
+    MbedTlsServerSessionCache::MbedTlsServerSessionCache(hal::SynchronousRandomDataGenerator& randomDataGenerator, const Config& config)
+        : randomDataGenerator(randomDataGenerator)
+        , sessionTickets(config.sessionTickets)
+    {
+        mbedtls_ssl_cache_init(&cache);
+        mbedtls_ssl_cache_set_max_entries(&cache, static_cast<int>(config.maxEntries));
+#if defined(MBEDTLS_HAVE_TIME)
+        mbedtls_ssl_cache_set_timeout(&cache, static_cast<int>(std::chrono::duration_cast<std::chrono::seconds>(config.lifetime).count()));
+#endif
+
+        mbedtls_ssl_ticket_init(&ticket);
+#if defined(MBEDTLS_SSL_SESSION_TICKETS) && defined(MBEDTLS_SSL_TICKET_C)
+        if (sessionTickets)
+        {
+            auto result = mbedtls_ssl_ticket_setup(&ticket, &MbedTlsServerSessionCache::StaticGenerateRandomData, this, MBEDTLS_CIPHER_AES_256_GCM,
+                static_cast<uint32_t>(std::chrono::duration_cast<std::chrono::seconds>(config.lifetime).count()));
+            really_assert(result == 0);
+        }
+#endif
+    }
+
+    MbedTlsServerSessionCache::~MbedTlsServerSessionCache()
+    {
+        mbedtls_ssl_ticket_free(&ticket);
+        mbedtls_ssl_cache_free(&cache);
+    }
+
+    void MbedTlsServerSessionCache::Configure(mbedtls_ssl_config& sslConfig)
+    {
+        mbedtls_ssl_conf_session_cache(&sslConfig, &cache, mbedtls_ssl_cache_get, mbedtls_ssl_cache_set);
+
+#if defined(MBEDTLS_SSL_SESSION_TICKETS) && defined(MBEDTLS_SSL_TICKET_C)
+        if (sessionTickets)
+            mbedtls_ssl_conf_session_tickets_cb(&sslConfig, mbedtls_ssl_ticket_write, mbedtls_ssl_ticket_parse, &ticket);
+#endif
+    }
+
+    int MbedTlsServerSessionCache::StaticGenerateRandomData(void* data, unsigned char* output, std::size_t size)
+    {
+        reinterpret_cast<MbedTlsServerSessionCache*>(data)->randomDataGenerator.GenerateRandomData(infra::ByteRange(output, output + size));
+        return 0;
+    }
 }
@@ -2,11 +2,15 @@
 #define SERVICES_MBED_TLS_SESSION_HPP
 
 #include "generated/echo/Network.pb.hpp"
+#include "hal/synchronous_interfaces/SynchronousRandomDataGenerator.hpp"
+#include "infra/timer/Timer.hpp"
 #include "infra/util/BoundedList.hpp"
 #include "infra/util/BoundedString.hpp"
 #include "infra/util/Function.hpp"
 #include "infra/util/WithStorage.hpp"
 #include "mbedtls/ssl.h"
+#include "mbedtls/ssl_cache.h"
+#include "mbedtls/ssl_ticket.h"
 #include "services/network/Address.hpp"
 #include "services/util/ConfigurationStore.hpp"
 #include "services/util/Sha256.hpp"
@@ -32,10 +36,16 @@ namespace services
         virtual int GetSession(mbedtls_ssl_context* context);
         virtual const infra::BoundedVector<uint8_t>& Identifier() const;
 
+        // A connection uses its session from its construction until its destruction
+        void Acquire();
+        void Release();
+        bool InUse() const;
+
     private:
         mbedtls_ssl_session session;
         bool clientSessionObtained = false;
         bool clientSessionDeserialized = false;
+        uint16_t users = 0;
         infra::BoundedVector<uint8_t>::WithMaxSize<32> identifier;
     };
 
@@ -149,6 +159,115 @@ namespace services
         TlsSessionHasher& hasher;
     };
 
+    // MbedTlsSessionStorageLru keeps client sessions up to the capacity of its storage. When a session for a new host is
+    // needed while the storage is full, the least recently used session that is not in use by a connection is evicted,
+    // so Full only returns true when all sessions are in use. ConnectionFactoryMbedTls then fails a connection to a new
+    // host, and NewSession must not be invoked. A session expires lifetime after it was last obtained from a handshake or
+    // a session ticket, unless it is in use. A session in use that is invalidated or cleared is not found anymore, and is
+    // evicted first once its connection has released it.
+    //
+    // When constructed with a ConfigurationStoreAccess, which may be backed by flash or by a file on a host, obtained
+    // sessions are persisted and loaded again on construction, so that after a reboot sessions are resumed instead of
+    // starting with a full handshake. Because time does not survive a reboot, the lifetime of a loaded session starts
+    // when it is loaded; the server still rejects sessions and tickets that it considers to be expired.
+    class MbedTlsSessionStorageLru
+        : public MbedTlsSessionStorage
+    {
+    public:
+        struct Config
+        {
+            Config()
+            {}
+
+            infra::Duration lifetime = std::chrono::hours(24);
+        };
+
+        class Session
+            : public MbedTlsSession
+        {
+        public:
+            Session(Sha256::Digest identifier, MbedTlsSessionStorageLru& storage);
+            Session(network::MbedTlsPersistedSession& reference, MbedTlsSessionStorageLru& storage);
+
+            // Implementation of MbedTlsSession
+            void Obtained() override;
+
+        private:
+            friend class MbedTlsSessionStorageLru;
+
+            MbedTlsSessionStorageLru& storage;
+            uint32_t lastUse = 0;
+            infra::TimePoint expiry;
+            bool invalidated = false;
+        };
+
+        template<std::size_t MaxSessions>
+        using WithMaxSize = infra::WithStorage<MbedTlsSessionStorageLru, infra::BoundedList<Session>::WithMaxSize<MaxSessions>>;
+
+        MbedTlsSessionStorageLru(infra::BoundedList<Session>& storage, TlsSessionHasher& hasher, const Config& config = Config());
+        MbedTlsSessionStorageLru(infra::BoundedList<Session>& storage, services::ConfigurationStoreAccess<infra::BoundedVector<network::MbedTlsPersistedSession>>& nvm, TlsSessionHasher& hasher, const Config& config = Config());
+
+        MbedTlsSession* NewSession(infra::BoundedConstString hostname) override;
+        MbedTlsSession* NewSession(IPAddress address) override;
+        MbedTlsSession* GetSession(infra::BoundedConstString hostname) override;
+        MbedTlsSession* GetSession(IPAddress address) override;
+        void Invalidate(MbedTlsSession* sessionToInvalidate) override;
+        bool Full() const override;
+        void Clear() override;
+
+    private:
+        MbedTlsSession* Emplace(const Sha256::Digest& identifier);
+        MbedTlsSession* Find(const Sha256::Digest& identifier);
+        Session& Victim();
+        void Touch(Session& session);
+        void Remove(Session& session);
+        void SessionObtained(Session& session);
+        void SerializeSessionToFlash(Session& session);
+        void LoadSessions();
+        network::MbedTlsPersistedSession* FindPersistedSession(const infra::BoundedVector<uint8_t>& identifier);
+
+    private:
+        infra::BoundedList<Session>& storage;
+        services::ConfigurationStoreAccess<infra::BoundedVector<network::MbedTlsPersistedSession>>* nvm = nullptr;
+        TlsSessionHasher& hasher;
+        Config config;
+        uint32_t useCounter = 0;
+    };
+
+    // MbedTlsServerSessionCache lets clients resume their sessions with a server. Sessions are cached by session ID, where
+    // the oldest session is evicted when maxEntries is reached. With sessionTickets enabled, the server also issues
+    // RFC 5077 session tickets, so that clients can resume their sessions without the server having to keep them; this
+    // is the only way of resuming sessions in TLS 1.3. Ticket keys are kept in RAM and are rotated every lifetime, so
+    // tickets do not survive a reboot of the server.
+    class MbedTlsServerSessionCache
+    {
+    public:
+        struct Config
+        {
+            Config()
+            {}
+
+            std::size_t maxEntries = 50;
+            infra::Duration lifetime = std::chrono::hours(24);
+            bool sessionTickets = false;
+        };
+
+        explicit MbedTlsServerSessionCache(hal::SynchronousRandomDataGenerator& randomDataGenerator, const Config& config = Config());
+        MbedTlsServerSessionCache(const MbedTlsServerSessionCache& other) = delete;
+        MbedTlsServerSessionCache& operator=(const MbedTlsServerSessionCache& other) = delete;
+        ~MbedTlsServerSessionCache();
+
+        void Configure(mbedtls_ssl_config& sslConfig);
+
+    private:
+        static int StaticGenerateRandomData(void* data, unsigned char* output, std::size_t size);
+
+    private:
+        hal::SynchronousRandomDataGenerator& randomDataGenerator;
+        bool sessionTickets;
+        mbedtls_ssl_cache_context cache;
+        mbedtls_ssl_ticket_context ticket;
+    };
 }
 
 #endif
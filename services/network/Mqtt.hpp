@@ -14,6 +14,15 @@ namespace services
     public:
         virtual void PublishDone() = 0;
         virtual void SubscribeDone() = 0;
+
+        // Invoked when the message has been sent but not yet acknowledged. From then on, the observer may prepare the next
+        // message and invoke Publish or Subscribe again; it is sent as soon as the client's in-flight window has room.
+        virtual void PublishSent()
+        {}
+
+        virtual void SubscribeSent()
+        {}
+
         virtual infra::SharedPtr<infra::StreamWriter> ReceivedNotification(infra::BoundedConstString topic, uint32_t payloadSize) = 0;
 
         virtual void FillTopic(infra::StreamWriter& writer) const = 0;
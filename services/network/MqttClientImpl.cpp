@@ -1,16 +1,123 @@
 #include "services/network/MqttClientImpl.hpp"
 #include "infra/event/EventDispatcherWithWeakPtr.hpp"
+#include "infra/stream/ByteOutputStream.hpp"
 #include "infra/stream/CountingOutputStream.hpp"
+#include "infra/util/ReallyAssert.hpp"
+#include <algorithm>
+#include <limits>
 
 namespace services
 {
+    MqttClientSession::MqttClientSession(infra::BoundedVector<InFlight>& inFlight, infra::ByteRange packetStorage)
+        : inFlight(inFlight)
+        , packetStorage(packetStorage)
+    {
+        really_assert(inFlight.max_size() != 0 && inFlight.max_size() <= std::numeric_limits<uint8_t>::max());
+    }
+
+    bool MqttClientSession::StoresPackets() const
+    {
+        return !packetStorage.empty();
+    }
+
+    bool MqttClientSession::Empty() const
+    {
+        return inFlight.empty();
+    }
+
+    bool MqttClientSession::Full() const
+    {
+        return inFlight.full();
+    }
+
+    uint16_t MqttClientSession::NewPacketIdentifier()
+    {
+        do
+        {
+            ++packetIdentifier;
+        } while (packetIdentifier == 0 || Find(packetIdentifier) != nullptr);
+
+        return packetIdentifier;
+    }
+
+    MqttClientSession::InFlight& MqttClientSession::Add(uint16_t packetIdentifier, bool subscribe)
+    {
+        uint8_t slot = 0;
+        while (std::any_of(inFlight.begin(), inFlight.end(), [slot](const InFlight& entry)
+            {
+                return entry.slot == slot;
+            }))
+            ++slot;
+
+        inFlight.push_back(InFlight{ packetIdentifier, subscribe, false, false, slot, 0, infra::TimePoint() });
+        return inFlight.back();
+    }
+
+    MqttClientSession::InFlight* MqttClientSession::Find(uint16_t packetIdentifier)
+    {
+        for (auto& entry : inFlight)
+            if (entry.packetIdentifier == packetIdentifier)
+                return &entry;
+
+        return nullptr;
+    }
+
+    void MqttClientSession::Remove(const InFlight& entry)
+    {
+        inFlight.erase(inFlight.begin() + (&entry - inFlight.begin()));
+    }
+
+    infra::ByteRange MqttClientSession::PacketStorage(const InFlight& entry)
+    {
+        auto slotSize = packetStorage.size() / inFlight.max_size();
+        return infra::ByteRange(packetStorage.begin() + entry.slot * slotSize, packetStorage.begin() + (entry.slot + 1) * slotSize);
+    }
+
+    MqttClientSession::InFlight* MqttClientSession::NextRetransmission()
+    {
+        for (auto& entry : inFlight)
+            if (entry.retransmit)
+                return &entry;
+
+        return nullptr;
+    }
+
+    std::optional<infra::TimePoint> MqttClientSession::NextDeadline() const
+    {
+        std::optional<infra::TimePoint> result;
+
+        for (auto& entry : inFlight)
+            if (!entry.retransmit && (result == std::nullopt || entry.deadline < *result))
+                result = entry.deadline;
+
+        return result;
+    }
+
+    void MqttClientSession::Resume()
+    {
+        inFlight.erase(std::remove_if(inFlight.begin(), inFlight.end(), [](const InFlight& entry)
+                           {
+                               return entry.size == 0;
+                           }),
+            inFlight.end());
+
+        for (auto& entry : inFlight)
+        {
+            entry.retransmit = true;
+            entry.fromPreviousConnection = true;
+        }
+    }
+
     MqttClientImpl::MqttFormatter::MqttFormatter(infra::DataOutputStream stream)
         : stream(stream)
     {}
 
-    void MqttClientImpl::MqttFormatter::MessageConnect(infra::BoundedConstString clientId, infra::BoundedConstString username, infra::BoundedConstString password, infra::Duration keepAlive)
+    void MqttClientImpl::MqttFormatter::MessageConnect(infra::BoundedConstString clientId, infra::BoundedConstString username, infra::BoundedConstString password, infra::Duration keepAlive, bool cleanSession)
     {
         PacketConnect packetHeader{};
+
+        if (!cleanSession)
+            packetHeader.connectFlags &= ~0x02;
         std::size_t packetSize = sizeof(packetHeader) + EncodedLength(clientId);
 
         if (!username.empty())
@@ -55,11 +162,10 @@ namespace services
         return 5 + EncodedTopicLength(message) + PayloadLength(message);
     }
 
-    void MqttClientImpl::MqttFormatter::MessageSubscribe(const MqttClientObserver& message)
+    void MqttClientImpl::MqttFormatter::MessageSubscribe(const MqttClientObserver& message, uint16_t packetIdentifier)
     {
         Header(PacketType::packetTypeSubscribe, EncodedTopicLength(message) + 3, 2);
 
-        uint16_t packetIdentifier = 1;
         stream << infra::BigEndian<uint16_t>(packetIdentifier);
 
         AddTopic(message);
@@ -181,10 +287,18 @@ namespace services
 
     MqttClientImpl::MqttClientImpl(MqttClientObserverFactory& factory, infra::BoundedConstString clientId, infra::BoundedConstString username, infra::BoundedConstString password,
         infra::Duration operationTimeout, infra::Duration pingInterval)
-        : operationTimeout(operationTimeout)
+        : MqttClientImpl(factory, defaultSession, clientId, username, password, operationTimeout, pingInterval)
+    {}
+
+    MqttClientImpl::MqttClientImpl(MqttClientObserverFactory& factory, MqttClientSession& session, infra::BoundedConstString clientId, infra::BoundedConstString username, infra::BoundedConstString password,
+        infra::Duration operationTimeout, infra::Duration pingInterval)
+        : session(session)
+        , operationTimeout(operationTimeout)
         , pingInterval(pingInterval)
         , state(std::in_place_type_t<StateConnecting>(), *this, factory, clientId, username, password)
-    {}
+    {
+        session.Resume();
+    }
 
     void MqttClientImpl::Publish()
     {
@@ -235,6 +349,7 @@ namespace services
         : StateBase(clientConnection)
     {
         StartPing();
+        ProcessSendOperations();
     }
 
     infra::SharedPtr<infra::StreamWriter> MqttClientImpl::ReceivedNotification(infra::BoundedConstString topic, uint32_t payloadSize)
@@ -303,7 +418,7 @@ namespace services
     {
         infra::DataOutputStream::WithErrorPolicy stream(*writer);
         MqttFormatter formatter(stream);
-        formatter.MessageConnect(clientId, username, password, clientConnection.pingInterval);
+        formatter.MessageConnect(clientId, username, password, clientConnection.pingInterval, !clientConnection.session.StoresPackets());
     }
 
     void MqttClientImpl::StateConnecting::HandleDataReceived()
@@ -366,11 +481,25 @@ namespace services
 
     void MqttClientImpl::StateConnected::SendStreamAvailable(infra::SharedPtr<infra::StreamWriter>&& writer)
     {
-        sendOperations.front()->SendStreamAvailable(*writer);
+        if (retransmitting != std::nullopt)
+            Retransmit(*writer);
+        else
+            sendOperations[sendingOperation]->SendStreamAvailable(*writer);
+
         if (!waitingForPingReply)
             StartPing();
 
         writer = nullptr;
+
+        if (retransmitting == std::nullopt)
+        {
+            sendOperations[sendingOperation]->Sent();
+            sendOperations.erase(sendOperations.begin() + sendingOperation);
+        }
+
+        retransmitting = std::nullopt;
+        executingSend = false;
+        ProcessSendOperations();
     }
 
     MqttClientImpl& MqttClientImpl::StateConnected::ClientConnection() const
@@ -405,11 +534,18 @@ namespace services
         if (stream.Failed())
             return;
 
-        if (!sendOperations.empty())
-            sendOperations.front()->HandlePubAck();
+        auto& session = clientConnection.session;
+        auto entry = session.Find(infra::FromBigEndian(packetIdentifier));
+        if (entry != nullptr && !entry->subscribe)
+        {
+            auto notify = !entry->fromPreviousConnection;
+            session.Remove(*entry);
+
+            if (notify)
+                clientConnection.Observer().PublishDone();
+        }
 
-        operationTimeout.Cancel();
-        clientConnection.ConnectionObserver::Subject().AckReceived();
+        Acknowledged();
     }
 
     void MqttClientImpl::StateConnected::HandleSubAck(std::size_t packetLength, infra::DataInputStream::WithErrorPolicy stream, infra::SharedPtr<infra::StreamReader>& reader)
@@ -426,18 +562,23 @@ namespace services
         if (stream.Failed())
             return;
 
-        if (infra::FromBigEndian(packetIdentifier) != 1 || returnCode == 0x80)
+        auto& session = clientConnection.session;
+        auto entry = session.Find(infra::FromBigEndian(packetIdentifier));
+
+        if (entry == nullptr || !entry->subscribe || returnCode == 0x80)
         {
             reader = nullptr;
             clientConnection.Abort();
             return;
         }
 
-        if (!sendOperations.empty())
-            sendOperations.front()->HandleSubAck();
+        auto notify = !entry->fromPreviousConnection;
+        session.Remove(*entry);
 
-        operationTimeout.Cancel();
-        clientConnection.ConnectionObserver::Subject().AckReceived();
+        if (notify)
+            clientConnection.Observer().SubscribeDone();
+
+        Acknowledged();
     }
 
     void MqttClientImpl::StateConnected::HandlePublish(std::size_t packetLength, infra::DataInputStream::WithErrorPolicy stream)
@@ -525,20 +666,52 @@ namespace services
             infra::MakeContainedSharedObject(clientConnection, clientConnection.ConnectionObserver::Subject().ObserverPtr()));
     }
 
-    void MqttClientImpl::StateConnected::PopFrontOperation()
+    void MqttClientImpl::StateConnected::Acknowledged()
     {
-        executingSend = false;
-        sendOperations.pop_front();
+        UpdateOperationTimeout();
+
+        clientConnection.ConnectionObserver::Subject().AckReceived();
         ProcessSendOperations();
     }
 
     void MqttClientImpl::StateConnected::ProcessSendOperations()
     {
-        if (!executingSend && !sendOperations.empty())
+        if (executingSend)
+            return;
+
+        if (auto entry = clientConnection.session.NextRetransmission())
         {
             executingSend = true;
-            clientConnection.ConnectionObserver::Subject().RequestSendStream(sendOperations.front()->MessageSize(clientConnection.Observer()));
+            retransmitting = entry->packetIdentifier;
+            clientConnection.ConnectionObserver::Subject().RequestSendStream(entry->size);
+            return;
         }
+
+        // Operations which need a packet identifier wait for room in the in-flight window, without holding up other operations
+        for (sendingOperation = 0; sendingOperation != sendOperations.size(); ++sendingOperation)
+            if (!sendOperations[sendingOperation]->NeedsPacketIdentifier() || !clientConnection.session.Full())
+            {
+                executingSend = true;
+                clientConnection.ConnectionObserver::Subject().RequestSendStream(sendOperations[sendingOperation]->MessageSize(clientConnection.Observer()));
+                return;
+            }
+    }
+
+    void MqttClientImpl::StateConnected::Retransmit(infra::StreamWriter& writer)
+    {
+        auto& session = clientConnection.session;
+        auto entry = session.Find(*retransmitting);
+        if (entry == nullptr)
+            return;
+
+        entry->retransmit = false;
+        auto packet = infra::Head(session.PacketStorage(*entry), entry->size);
+        uint8_t duplicateFlag = entry->subscribe ? 0 : 0x08;
+
+        infra::DataOutputStream::WithErrorPolicy stream(writer);
+        stream << static_cast<uint8_t>(packet.front() | duplicateFlag) << infra::DiscardHead(packet, 1);
+
+        StartOperationTimeout(*entry);
     }
 
     void MqttClientImpl::StateConnected::StartPing()
@@ -577,31 +750,71 @@ namespace services
         clientConnection.Abort();
     }
 
-    uint16_t MqttClientImpl::StateConnected::GeneratePacketIdentifier()
+    void MqttClientImpl::StateConnected::StartOperationTimeout(MqttClientSession::InFlight& entry)
     {
-        ++packetIdentifier;
-        if (packetIdentifier == 0)
-            ++packetIdentifier;
+        entry.deadline = infra::Now() + clientConnection.operationTimeout;
+        UpdateOperationTimeout();
+    }
 
-        return packetIdentifier;
+    void MqttClientImpl::StateConnected::UpdateOperationTimeout()
+    {
+        auto deadline = clientConnection.session.NextDeadline();
+
+        if (deadline == std::nullopt)
+            operationTimeout.Cancel();
+        else
+            operationTimeout.Start(*deadline, [this]()
+                {
+                    clientConnection.Abort();
+                });
     }
 
-    MqttClientImpl::StateConnected::OperationPublish::OperationPublish(StateConnected& connectedState, MqttClientObserver& observer)
+    MqttClientImpl::StateConnected::OperationWithPacketIdentifier::OperationWithPacketIdentifier(StateConnected& connectedState)
         : connectedState(connectedState)
-        , observer(observer)
     {}
 
-    void MqttClientImpl::StateConnected::OperationPublish::SendStreamAvailable(infra::StreamWriter& writer)
+    bool MqttClientImpl::StateConnected::OperationWithPacketIdentifier::NeedsPacketIdentifier() const
+    {
+        return true;
+    }
+
+    template<class Format>
+    void MqttClientImpl::StateConnected::OperationWithPacketIdentifier::SendAndStore(infra::StreamWriter& writer, bool subscribe, std::size_t messageSize, Format format)
     {
+        auto& session = connectedState.ClientConnection().session;
+        auto& entry = session.Add(session.NewPacketIdentifier(), subscribe);
+        auto storage = session.PacketStorage(entry);
         infra::DataOutputStream::WithErrorPolicy stream(writer);
-        MqttFormatter formatter(stream);
 
-        connectedState.operationTimeout.Start(connectedState.ClientConnection().operationTimeout, [this]()
+        if (messageSize > storage.size())
+        {
+            MqttFormatter formatter(stream);
+            format(formatter, entry.packetIdentifier);
+        }
+        else
+        {
+            infra::ByteOutputStream packetStream(storage);
+            MqttFormatter formatter(packetStream);
+            format(formatter, entry.packetIdentifier);
+
+            entry.size = static_cast<uint16_t>(packetStream.Writer().Processed().size());
+            stream << packetStream.Writer().Processed();
+        }
+
+        connectedState.StartOperationTimeout(entry);
+    }
+
+    MqttClientImpl::StateConnected::OperationPublish::OperationPublish(StateConnected& connectedState, MqttClientObserver& observer)
+        : OperationWithPacketIdentifier(connectedState)
+        , observer(observer)
+    {}
+
+    void MqttClientImpl::StateConnected::OperationPublish::SendStreamAvailable(infra::StreamWriter& writer)
+    {
+        SendAndStore(writer, false, MessageSize(observer), [this](MqttFormatter& formatter, uint16_t packetIdentifier)
             {
-                connectedState.ClientConnection().Abort();
+                formatter.MessagePublish(connectedState.ClientConnection().Observer(), packetIdentifier);
             });
-
-        formatter.MessagePublish(connectedState.ClientConnection().Observer(), connectedState.GeneratePacketIdentifier());
     }
 
     std::size_t MqttClientImpl::StateConnected::OperationPublish::MessageSize(const MqttClientObserver& message)
@@ -609,28 +822,22 @@ namespace services
         return MqttFormatter::MessageSizePublish(message);
     }
 
-    void MqttClientImpl::StateConnected::OperationPublish::HandlePubAck()
+    void MqttClientImpl::StateConnected::OperationPublish::Sent()
     {
-        observer.PublishDone();
-        connectedState.PopFrontOperation();
+        observer.PublishSent();
     }
 
     MqttClientImpl::StateConnected::OperationSubscribe::OperationSubscribe(StateConnected& connectedState, MqttClientObserver& observer)
-        : connectedState(connectedState)
+        : OperationWithPacketIdentifier(connectedState)
         , observer(observer)
     {}
 
     void MqttClientImpl::StateConnected::OperationSubscribe::SendStreamAvailable(infra::StreamWriter& writer)
     {
-        infra::DataOutputStream::WithErrorPolicy stream(writer);
-        MqttFormatter formatter(stream);
-
-        connectedState.operationTimeout.Start(connectedState.ClientConnection().operationTimeout, [this]()
+        SendAndStore(writer, true, MessageSize(observer), [this](MqttFormatter& formatter, uint16_t packetIdentifier)
             {
-                connectedState.ClientConnection().Abort();
+                formatter.MessageSubscribe(connectedState.ClientConnection().Observer(), packetIdentifier);
             });
-
-        formatter.MessageSubscribe(connectedState.ClientConnection().Observer());
     }
 
     std::size_t MqttClientImpl::StateConnected::OperationSubscribe::MessageSize(const MqttClientObserver& message)
@@ -638,10 +845,9 @@ namespace services
         return MqttFormatter::MessageSizeSubscribe(message);
     }
 
-    void MqttClientImpl::StateConnected::OperationSubscribe::HandleSubAck()
+    void MqttClientImpl::StateConnected::OperationSubscribe::Sent()
     {
-        observer.SubscribeDone();
-        connectedState.PopFrontOperation();
+        observer.SubscribeSent();
     }
 
     MqttClientImpl::StateConnected::OperationPubAck::OperationPubAck(StateConnected& connectedState)
@@ -654,7 +860,6 @@ namespace services
         MqttFormatter formatter(stream);
 
         formatter.MessagePubAck(connectedState.ClientConnection().Observer(), connectedState.receivedPacketIdentifier);
-        connectedState.PopFrontOperation();
     }
 
     std::size_t MqttClientImpl::StateConnected::OperationPubAck::MessageSize(const MqttClientObserver& message)
@@ -674,7 +879,6 @@ namespace services
         formatter.MessagePing(connectedState.ClientConnection().Observer());
 
         connectedState.StartWaitForPingReply();
-        connectedState.PopFrontOperation();
     }
 
     std::size_t MqttClientImpl::StateConnected::OperationPing::MessageSize(const MqttClientObserver& message)
@@ -692,6 +896,13 @@ namespace services
         , password(password)
     {}
 
+    MqttClientConnectorImpl::MqttClientConnectorImpl(infra::BoundedConstString clientId, infra::BoundedConstString username, infra::BoundedConstString password,
+        infra::BoundedConstString hostname, uint16_t port, services::ConnectionFactoryWithNameResolver& connectionFactory, MqttClientSession& session)
+        : MqttClientConnectorImpl(clientId, username, password, hostname, port, connectionFactory)
+    {
+        this->session = &session;
+    }
+
     void MqttClientConnectorImpl::SetHostname(infra::BoundedConstString newHostname)
     {
         hostname = newHostname;
@@ -744,7 +955,11 @@ namespace services
     void MqttClientConnectorImpl::ConnectionEstablished(infra::AutoResetFunction<void(infra::SharedPtr<services::ConnectionObserver> connectionObserver)>&& createdObserver)
     {
         connecting = false;
-        createdObserver(client.Emplace(*clientObserverFactory, clientId, username, password));
+
+        if (session != nullptr)
+            createdObserver(client.Emplace(*clientObserverFactory, *session, clientId, username, password));
+        else
+            createdObserver(client.Emplace(*clientObserverFactory, clientId, username, password));
     }
 
     void MqttClientConnectorImpl::ConnectionFailed(ConnectFailReason reason)
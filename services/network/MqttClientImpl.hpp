@@ -3,14 +3,71 @@
 
 #include "infra/timer/Timer.hpp"
 #include "infra/util/BoundedDeque.hpp"
+#include "infra/util/BoundedVector.hpp"
 #include "infra/util/Endian.hpp"
 #include "infra/util/PolymorphicVariant.hpp"
 #include "infra/util/SharedOptional.hpp"
+#include "infra/util/WithStorage.hpp"
 #include "services/network/ConnectionFactoryWithNameResolver.hpp"
 #include "services/network/Mqtt.hpp"
+#include <optional>
 
 namespace services
 {
+    // MqttClientSession keeps track of the QoS 1 publishes and the subscribes that have been sent, but that have not yet
+    // been acknowledged. The number of entries bounds how many of those are in flight at the same time on one connection.
+    // Acknowledgements are matched on packet identifier, so they may arrive in any order. Each entry has its own deadline,
+    // after which the connection is aborted.
+    //
+    // When packet storage is available, each packet is stored until it is acknowledged. A session which outlives its
+    // connection then retransmits the unacknowledged packets on the next connection, with the DUP flag set for publishes.
+    // In that case a persistent session is requested from the broker by clearing the clean session flag on connect.
+    // Packets which may not fit in a slot of the packet storage are sent without being stored, and are not retransmitted.
+    class MqttClientSession
+    {
+    public:
+        struct InFlight
+        {
+            uint16_t packetIdentifier;
+            bool subscribe;
+            bool retransmit;
+            bool fromPreviousConnection;
+            uint8_t slot;
+            uint16_t size;
+            infra::TimePoint deadline;
+        };
+
+        template<std::size_t WindowSize, std::size_t MaxPacketSize = 0>
+        using WithWindow = infra::WithStorage<infra::WithStorage<MqttClientSession,
+                                                  infra::BoundedVector<InFlight>::WithMaxSize<WindowSize>>,
+            std::array<uint8_t, WindowSize * MaxPacketSize>>;
+
+        MqttClientSession(infra::BoundedVector<InFlight>& inFlight, infra::ByteRange packetStorage);
+        MqttClientSession(const MqttClientSession& other) = delete;
+        MqttClientSession& operator=(const MqttClientSession& other) = delete;
+
+        bool StoresPackets() const;
+        bool Empty() const;
+        bool Full() const;
+
+        uint16_t NewPacketIdentifier();
+        InFlight& Add(uint16_t packetIdentifier, bool subscribe);
+        InFlight* Find(uint16_t packetIdentifier);
+        void Remove(const InFlight& entry);
+        infra::ByteRange PacketStorage(const InFlight& entry);
+        InFlight* NextRetransmission();
+        // Earliest deadline of the entries that have been sent on the current connection
+        std::optional<infra::TimePoint> NextDeadline() const;
+
+        // Invoked when a new connection starts: entries of which the packet is stored are marked for retransmission, other entries are dropped
+        void Resume();
+
+    private:
+        infra::BoundedVector<InFlight>& inFlight;
+        infra::ByteRange packetStorage;
+        uint16_t packetIdentifier = 0;
+    };
+
     class MqttClientImpl
         : public ConnectionObserver
         , public MqttClient
@@ -18,6 +75,8 @@ namespace services
     public:
         MqttClientImpl(MqttClientObserverFactory& factory, infra::BoundedConstString clientId, infra::BoundedConstString username, infra::BoundedConstString password,
             infra::Duration operationTimeout = std::chrono::seconds(30), infra::Duration pingInterval = std::chrono::seconds(35));
+        MqttClientImpl(MqttClientObserverFactory& factory, MqttClientSession& session, infra::BoundedConstString clientId, infra::BoundedConstString username, infra::BoundedConstString password,
+            infra::Duration operationTimeout = std::chrono::seconds(30), infra::Duration pingInterval = std::chrono::seconds(35));
 
         // Implementation of MqttClient
         void Publish() override;
@@ -60,11 +119,11 @@ namespace services
         public:
             explicit MqttFormatter(infra::DataOutputStream stream);
 
-            void MessageConnect(infra::BoundedConstString clientId, infra::BoundedConstString username, infra::BoundedConstString password, infra::Duration keepAlive);
+            void MessageConnect(infra::BoundedConstString clientId, infra::BoundedConstString username, infra::BoundedConstString password, infra::Duration keepAlive, bool cleanSession);
             static std::size_t MessageSizeConnect(infra::BoundedConstString clientId, infra::BoundedConstString username, infra::BoundedConstString password);
             void MessagePublish(const MqttClientObserver& message, uint16_t packetIdentifier);
             static std::size_t MessageSizePublish(const MqttClientObserver& message);
-            void MessageSubscribe(const MqttClientObserver& message);
+            void MessageSubscribe(const MqttClientObserver& message, uint16_t packetIdentifier);
             static std::size_t MessageSizeSubscribe(const MqttClientObserver& message);
             void MessagePubAck(const MqttClientObserver& message, uint16_t packetIdentifier);
             static std::size_t MessageSizePubAck(const MqttClientObserver& message);
@@ -181,14 +240,16 @@ namespace services
             void HandlePubAck(std::size_t packetLength, infra::DataInputStream::WithErrorPolicy stream);
             void HandleSubAck(std::size_t packetLength, infra::DataInputStream::WithErrorPolicy stream, infra::SharedPtr<infra::StreamReader>& reader);
             void HandlePublish(size_t packetLength, infra::DataInputStream::WithErrorPolicy stream);
-            void PopFrontOperation();
+            void Acknowledged();
             void ProcessSendOperations();
+            void Retransmit(infra::StreamWriter& writer);
             void StartPing();
             void SendPing();
             void HandlePingReply();
             void StartWaitForPingReply();
             void PingReplyTimeout();
-            uint16_t GeneratePacketIdentifier();
+            void StartOperationTimeout(MqttClientSession::InFlight& entry);
+            void UpdateOperationTimeout();
 
         private:
             class OperationBase
@@ -199,40 +260,56 @@ namespace services
                 virtual void SendStreamAvailable(infra::StreamWriter& writer) = 0;
                 virtual std::size_t MessageSize(const MqttClientObserver& message) = 0;
 
-                virtual void HandlePubAck()
-                {}
+                virtual bool NeedsPacketIdentifier() const
+                {
+                    return false;
+                }
 
-                virtual void HandleSubAck()
+                virtual void Sent()
                 {}
             };
 
-            class OperationPublish
+            class OperationWithPacketIdentifier
                 : public OperationBase
             {
+            public:
+                explicit OperationWithPacketIdentifier(StateConnected& connectedState);
+
+                bool NeedsPacketIdentifier() const override;
+
+            protected:
+                template<class Format>
+                void SendAndStore(infra::StreamWriter& writer, bool subscribe, std::size_t messageSize, Format format);
+
+            protected:
+                StateConnected& connectedState;
+            };
+
+            class OperationPublish
+                : public OperationWithPacketIdentifier
+            {
             public:
                 OperationPublish(StateConnected& connectedState, MqttClientObserver& observer);
 
                 void SendStreamAvailable(infra::StreamWriter& writer) override;
                 std::size_t MessageSize(const MqttClientObserver& message) override;
-                void HandlePubAck() override;
+                void Sent() override;
 
             private:
-                StateConnected& connectedState;
                 MqttClientObserver& observer;
             };
 
             class OperationSubscribe
-                : public OperationBase
+                : public OperationWithPacketIdentifier
             {
             public:
                 OperationSubscribe(StateConnected& connectedState, MqttClientObserver& observer);
 
                 void SendStreamAvailable(infra::StreamWriter& writer) override;
                 std::size_t MessageSize(const MqttClientObserver& message) override;
-                void HandleSubAck() override;
+                void Sent() override;
 
             private:
-                StateConnected& connectedState;
                 MqttClientObserver& observer;
             };
 
@@ -267,13 +344,14 @@ namespace services
             uint16_t receivedPacketIdentifier;
 
             using OperationVariant = infra::PolymorphicVariant<OperationBase, OperationPublish, OperationSubscribe, OperationPubAck, OperationPing>;
-            infra::BoundedDeque<OperationVariant>::WithMaxSize<3> sendOperations;
+            infra::BoundedDeque<OperationVariant>::WithMaxSize<4> sendOperations;
+            std::size_t sendingOperation = 0;
+            std::optional<uint16_t> retransmitting;
             bool executingSend = false;
             bool executingNotification = false;
             uint16_t notificationPayloadSize = 0;
             infra::SharedPtr<infra::StreamWriter> notificationWriter;
             infra::TimerSingleShot pingTimer;
-            uint16_t packetIdentifier = 0;
             bool waitingForPingReply = false;
 
         private:
@@ -289,6 +367,8 @@ namespace services
         infra::SharedPtr<infra::StreamReader> ReceiveStream();
 
     private:
+        MqttClientSession::WithWindow<1> defaultSession;
+        MqttClientSession& session;
         infra::Duration operationTimeout;
         infra::Duration pingInterval;
         infra::PolymorphicVariant<StateBase, StateConnecting, StateConnected> state;
@@ -301,6 +381,8 @@ namespace services
     public:
         MqttClientConnectorImpl(infra::BoundedConstString clientId, infra::BoundedConstString username, infra::BoundedConstString password,
             infra::BoundedConstString hostname, uint16_t port, services::ConnectionFactoryWithNameResolver& connectionFactory);
+        MqttClientConnectorImpl(infra::BoundedConstString clientId, infra::BoundedConstString username, infra::BoundedConstString password,
+            infra::BoundedConstString hostname, uint16_t port, services::ConnectionFactoryWithNameResolver& connectionFactory, MqttClientSession& session);
 
         void SetHostname(infra::BoundedConstString newHostname);
         void SetClientId(infra::BoundedConstString newClientId);
@@ -325,6 +407,7 @@ namespace services
         infra::BoundedConstString clientId;
         infra::BoundedConstString username;
         infra::BoundedConstString password;
+        MqttClientSession* session = nullptr;
         infra::NotifyingSharedOptional<MqttClientImpl> client;
         MqttClientObserverFactory* clientObserverFactory = nullptr;
     };
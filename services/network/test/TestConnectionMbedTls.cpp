@@ -288,6 +288,54 @@ TEST_F(ConnectionMbedTlsTest, persistent_session_fails_deserialize)
     }
 }
 
+TEST_F(ConnectionMbedTlsTest, lru_session_storage_keeps_session_ticket_across_restart)
+{
+    infra::BoundedVector<network::MbedTlsPersistedSession>::WithMaxSize<2> stores;
+    testing::NiceMock<services::ConfigurationStoreInterfaceMock> configInterface;
+    services::ConfigurationStoreAccess<infra::BoundedVector<network::MbedTlsPersistedSession>> configStore{ configInterface, stores };
+    services::Sha256MbedTls sha256;
+    services::MbedTlsSessionHasher mbedTlsHasher{ sha256 };
+
+    services::MbedTlsServerSessionCache::Config serverSessionConfig;
+    serverSessionConfig.sessionTickets = true;
+    services::ConnectionFactoryMbedTls::WithMaxConnectionsListenersAndConnectors<2, 1, 0> tlsNetworkServer(loopBackNetwork, serverCertificates, randomDataGenerator,
+        services::ConnectionMbedTls::CertificateValidation::Default, serverSessionConfig);
+    infra::SharedPtr<void> listener = tlsNetworkServer.Listen(1234, serverObserverFactory);
+
+    EXPECT_CALL(clientObserverFactory, Address()).WillRepeatedly(testing::Return(services::IPAddress()));
+
+    for (int restart = 0; restart != 2; ++restart)
+    {
+        services::MbedTlsSessionStorageLru::WithMaxSize<2> lruStorage{ configStore, mbedTlsHasher };
+        EXPECT_EQ(restart != 0, lruStorage.GetSession(services::IPAddress()) != nullptr);
+
+        services::ConnectionFactoryMbedTls::CustomSessionStorageWithMaxConnectionsListenersAndConnectors<2, 0, 1> tlsNetworkClient(lruStorage, loopBackNetwork, clientCertificates, randomDataGenerator);
+
+        EXPECT_CALL(clientObserverFactory, Port()).WillOnce(testing::Return(1234));
+        tlsNetworkClient.Connect(clientObserverFactory);
+
+        infra::SharedOptional<services::ConnectionObserverStub> observer1;
+        infra::SharedOptional<services::ConnectionObserverStub> observer2;
+
+        EXPECT_CALL(serverObserverFactory, ConnectionAccepted(testing::_, testing::_))
+            .WillOnce(testing::Invoke([&](infra::AutoResetFunction<void(infra::SharedPtr<services::ConnectionObserver> connectionObserver)> createdObserver, services::IPAddress address)
+                {
+                    createdObserver(observer1.Emplace());
+                }));
+        EXPECT_CALL(clientObserverFactory, ConnectionEstablished(testing::_))
+            .WillOnce(testing::Invoke([&](infra::AutoResetFunction<void(infra::SharedPtr<services::ConnectionObserver> connectionObserver)> createdObserver)
+                {
+                    createdObserver(observer2.Emplace());
+                }));
+        ExecuteAllActions();
+
+        EXPECT_EQ(1, stores.size());
+
+        observer1->Subject().AbortAndDestroy();
+        ExecuteAllActions();
+    }
+}
+
 TEST_F(ConnectionMbedTlsTest, mbedtls_session_fails_deserialize)
 {
     network::MbedTlsPersistedSession persistedSession;
@@ -135,13 +135,13 @@ TEST_F(EchoOnConnectionTest, DataReceived_while_service_method_is_executing)
     auto readerPtr = infra::UnOwnedSharedPtr(stream.Reader());
     EXPECT_CALL(connection, ReceiveStream()).WillOnce(testing::Return(readerPtr));
     EXPECT_CALL(service, Method(5));
-    EXPECT_CALL(connection, AckReceived());
     connection.Observer().DataReceived();
 
-    EXPECT_CALL(connection, ReceiveStream()).WillOnce(testing::Return(readerPtr));
-    EXPECT_CALL(connection, AckReceived());
+    // The received data is held until the method is done, so that view fields remain valid
     connection.Observer().DataReceived();
 
+    EXPECT_CALL(connection, AckReceived()).Times(2);
+    EXPECT_CALL(connection, ReceiveStream()).WillOnce(testing::Return(readerPtr));
     service.MethodDone();
 }
 
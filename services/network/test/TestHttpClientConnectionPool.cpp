@@ -0,0 +1,351 @@
+#include "infra/timer/test_helper/ClockFixture.hpp"
+#include "infra/util/SharedOptional.hpp"
+#include "infra/util/test_helper/MockCallback.hpp"
+#include "infra/util/test_helper/MockHelpers.hpp"
+#include "services/network/HttpClientConnectionPool.hpp"
+#include "services/network/test_doubles/HttpClientMock.hpp"
+#include "services/util/Sha256MbedTls.hpp"
+#include "gmock/gmock.h"
+#include <array>
+
+namespace
+{
+    class ObserverFactory
+        : public testing::StrictMock<services::HttpClientObserverFactoryMock>
+    {
+    public:
+        explicit ObserverFactory(infra::BoundedConstString hostname, uint16_t port = 80)
+        {
+            EXPECT_CALL(*this, Hostname()).WillRepeatedly(testing::Return(hostname));
+            EXPECT_CALL(*this, Port()).WillRepeatedly(testing::Return(port));
+        }
+    };
+
+    struct PooledConnection
+    {
+        testing::StrictMock<services::HttpClientConnectorMock> delegate;
+        testing::StrictMock<services::HttpClientMock> subject;
+        infra::SharedOptional<testing::StrictMock<services::HttpClientObserverMock>> observer;
+        services::HttpClientObserverFactory* connectingFactory = nullptr;
+    };
+}
+
+class HttpClientConnectionPoolTest
+    : public testing::Test
+    , public infra::ClockFixture
+{
+public:
+    HttpClientConnectionPoolTest()
+    {
+        CreatePool(services::HttpClientConnectionPool::Config());
+    }
+
+    ~HttpClientConnectionPoolTest()
+    {
+        for (auto& connection : connections)
+            if (connection.subject.IsAttached())
+                connection.subject.Detach();
+    }
+
+    void CreatePool(const services::HttpClientConnectionPool::Config& config)
+    {
+        pool.emplace(infra::MakeRange(delegates), hasher, config);
+    }
+
+    void ExpectConnect(PooledConnection& connection)
+    {
+        EXPECT_CALL(connection.delegate, Connect(testing::_)).WillOnce(infra::SaveRef<0>(&connection.connectingFactory));
+    }
+
+    void ExpectObserverCreated(PooledConnection& connection, ObserverFactory& factory)
+    {
+        EXPECT_CALL(factory, ConnectionEstablished(testing::_)).WillOnce(testing::Invoke([&connection](auto&& createdClientObserver)
+            {
+                auto observer = connection.observer.Emplace();
+                EXPECT_CALL(*observer, Attached());
+                createdClientObserver(observer);
+            }));
+    }
+
+    void EstablishConnection(PooledConnection& connection, ObserverFactory& factory)
+    {
+        ExpectObserverCreated(connection, factory);
+        connection.connectingFactory->ConnectionEstablished([&connection](infra::SharedPtr<services::HttpClientObserver> client)
+            {
+                connection.subject.Attach(client);
+            });
+    }
+
+    void FinishRequest(PooledConnection& connection)
+    {
+        EXPECT_CALL(*connection.observer, BodyComplete());
+        connection.subject.Observer().BodyComplete();
+        EXPECT_CALL(*connection.observer, Detaching());
+        connection.observer->Detach();
+    }
+
+    void ExpectConnectionClosed(PooledConnection& connection)
+    {
+        EXPECT_CALL(connection.subject, CloseConnection()).WillOnce([&connection]()
+            {
+                connection.subject.Detach();
+            });
+    }
+
+    std::array<PooledConnection, 2> connections;
+    std::array<services::HttpClientConnector*, 2> delegates{ &connections[0].delegate, &connections[1].delegate };
+    services::Sha256MbedTls hasher;
+    std::optional<services::HttpClientConnectionPool::WithSlots<2>> pool;
+
+    ObserverFactory factoryA1{ "hostA" };
+    ObserverFactory factoryA2{ "hostA" };
+    ObserverFactory factoryB{ "hostB" };
+    ObserverFactory factoryC{ "hostA", 8080 };
+};
+
+TEST_F(HttpClientConnectionPoolTest, request_is_served_on_new_connection)
+{
+    ExpectConnect(connections[0]);
+    pool->Connect(factoryA1);
+    ExecuteAllActions();
+
+    EXPECT_EQ("hostA", connections[0].connectingFactory->Hostname());
+    EXPECT_EQ(80, connections[0].connectingFactory->Port());
+
+    EstablishConnection(connections[0], factoryA1);
+    FinishRequest(connections[0]);
+    ExecuteAllActions();
+
+    EXPECT_EQ(0, pool->GetStatistics().hits);
+    EXPECT_EQ(1, pool->GetStatistics().misses);
+}
+
+TEST_F(HttpClientConnectionPoolTest, request_for_same_host_reuses_idle_connection)
+{
+    ExpectConnect(connections[0]);
+    pool->Connect(factoryA1);
+    ExecuteAllActions();
+    EstablishConnection(connections[0], factoryA1);
+    FinishRequest(connections[0]);
+    ExecuteAllActions();
+
+    ExpectObserverCreated(connections[0], factoryA2);
+    pool->Connect(factoryA2);
+    ExecuteAllActions();
+    FinishRequest(connections[0]);
+    ExecuteAllActions();
+
+    EXPECT_EQ(1, pool->GetStatistics().hits);
+    EXPECT_EQ(1, pool->GetStatistics().misses);
+
+    pool->ResetStatistics();
+    EXPECT_EQ(0, pool->GetStatistics().hits);
+    EXPECT_EQ(0, pool->GetStatistics().misses);
+}
+
+TEST_F(HttpClientConnectionPoolTest, requests_for_different_hosts_are_served_concurrently)
+{
+    ExpectConnect(connections[0]);
+    ExpectConnect(connections[1]);
+    pool->Connect(factoryA1);
+    pool->Connect(factoryB);
+    ExecuteAllActions();
+
+    EXPECT_EQ("hostA", connections[0].connectingFactory->Hostname());
+    EXPECT_EQ("hostB", connections[1].connectingFactory->Hostname());
+
+    EstablishConnection(connections[0], factoryA1);
+    EstablishConnection(connections[1], factoryB);
+    FinishRequest(connections[0]);
+    FinishRequest(connections[1]);
+    ExecuteAllActions();
+}
+
+TEST_F(HttpClientConnectionPoolTest, connections_per_host_are_limited)
+{
+    services::HttpClientConnectionPool::Config config;
+    config.maxConnectionsPerHost = 1;
+    CreatePool(config);
+
+    ExpectConnect(connections[0]);
+    pool->Connect(factoryA1);
+    pool->Connect(factoryA2);
+    ExecuteAllActions();
+    EstablishConnection(connections[0], factoryA1);
+
+    ExpectObserverCreated(connections[0], factoryA2);
+    FinishRequest(connections[0]);
+    ExecuteAllActions();
+    FinishRequest(connections[0]);
+    ExecuteAllActions();
+
+    EXPECT_EQ(1, pool->GetStatistics().hits);
+    EXPECT_EQ(1, pool->GetStatistics().misses);
+}
+
+TEST_F(HttpClientConnectionPoolTest, waiting_request_does_not_block_requests_for_other_hosts)
+{
+    services::HttpClientConnectionPool::Config config;
+    config.maxConnectionsPerHost = 1;
+    CreatePool(config);
+
+    ExpectConnect(connections[0]);
+    ExpectConnect(connections[1]);
+    pool->Connect(factoryA1);
+    pool->Connect(factoryA2);
+    pool->Connect(factoryB);
+    ExecuteAllActions();
+
+    EXPECT_EQ("hostB", connections[1].connectingFactory->Hostname());
+
+    EstablishConnection(connections[0], factoryA1);
+    EstablishConnection(connections[1], factoryB);
+
+    ExpectObserverCreated(connections[0], factoryA2);
+    FinishRequest(connections[0]);
+    ExecuteAllActions();
+
+    FinishRequest(connections[0]);
+    FinishRequest(connections[1]);
+    ExecuteAllActions();
+}
+
+TEST_F(HttpClientConnectionPoolTest, least_recently_used_idle_connection_is_evicted)
+{
+    ExpectConnect(connections[0]);
+    pool->Connect(factoryA1);
+    ExecuteAllActions();
+    EstablishConnection(connections[0], factoryA1);
+    FinishRequest(connections[0]);
+    ExecuteAllActions();
+
+    ExpectConnect(connections[1]);
+    pool->Connect(factoryB);
+    ExecuteAllActions();
+    EstablishConnection(connections[1], factoryB);
+    FinishRequest(connections[1]);
+    ExecuteAllActions();
+
+    ExpectConnectionClosed(connections[0]);
+    ExpectConnect(connections[0]);
+    pool->Connect(factoryC);
+    ExecuteAllActions();
+
+    EXPECT_EQ(8080, connections[0].connectingFactory->Port());
+    EXPECT_EQ(1, pool->GetStatistics().evictions);
+
+    EstablishConnection(connections[0], factoryC);
+    FinishRequest(connections[0]);
+    ExecuteAllActions();
+}
+
+TEST_F(HttpClientConnectionPoolTest, idle_connection_is_closed_after_idle_timeout)
+{
+    ExpectConnect(connections[0]);
+    pool->Connect(factoryA1);
+    ExecuteAllActions();
+    EstablishConnection(connections[0], factoryA1);
+    FinishRequest(connections[0]);
+    ExecuteAllActions();
+
+    ExpectConnectionClosed(connections[0]);
+    ForwardTime(std::chrono::minutes(1));
+
+    EXPECT_EQ(1, pool->GetStatistics().idleTimeouts);
+
+    ExpectConnect(connections[0]);
+    pool->Connect(factoryA2);
+    ExecuteAllActions();
+
+    EXPECT_EQ(2, pool->GetStatistics().misses);
+}
+
+TEST_F(HttpClientConnectionPoolTest, failed_connection_releases_slot)
+{
+    services::HttpClientConnectionPool::Config config;
+    config.maxConnectionsPerHost = 1;
+    CreatePool(config);
+
+    ExpectConnect(connections[0]);
+    pool->Connect(factoryA1);
+    pool->Connect(factoryA2);
+    ExecuteAllActions();
+
+    EXPECT_CALL(factoryA1, ConnectionFailed(services::HttpClientObserverFactory::ConnectFailReason::nameLookupFailed));
+    ExpectConnect(connections[0]);
+    connections[0].connectingFactory->ConnectionFailed(services::HttpClientObserverFactory::ConnectFailReason::nameLookupFailed);
+    ExecuteAllActions();
+
+    EstablishConnection(connections[0], factoryA2);
+    FinishRequest(connections[0]);
+    ExecuteAllActions();
+}
+
+TEST_F(HttpClientConnectionPoolTest, connection_not_used_by_factory_releases_slot)
+{
+    services::HttpClientConnectionPool::Config config;
+    config.maxConnectionsPerHost = 1;
+    CreatePool(config);
+
+    ExpectConnect(connections[0]);
+    pool->Connect(factoryA1);
+    pool->Connect(factoryA2);
+    ExecuteAllActions();
+
+    EXPECT_CALL(factoryA1, ConnectionEstablished(testing::_));
+    ExpectConnect(connections[0]);
+    connections[0].connectingFactory->ConnectionEstablished([this](infra::SharedPtr<services::HttpClientObserver> client)
+        {
+            connections[0].subject.Attach(client);
+        });
+    ExecuteAllActions();
+
+    EstablishConnection(connections[0], factoryA2);
+    FinishRequest(connections[0]);
+    ExecuteAllActions();
+}
+
+TEST_F(HttpClientConnectionPoolTest, cancel_connecting_request)
+{
+    ExpectConnect(connections[0]);
+    pool->Connect(factoryA1);
+    ExecuteAllActions();
+
+    EXPECT_CALL(connections[0].delegate, CancelConnect(testing::Ref(*connections[0].connectingFactory)));
+    pool->CancelConnect(factoryA1);
+    ExecuteAllActions();
+}
+
+TEST_F(HttpClientConnectionPoolTest, cancel_waiting_request)
+{
+    services::HttpClientConnectionPool::Config config;
+    config.maxConnectionsPerHost = 1;
+    CreatePool(config);
+
+    ExpectConnect(connections[0]);
+    pool->Connect(factoryA1);
+    pool->Connect(factoryA2);
+    ExecuteAllActions();
+
+    pool->CancelConnect(factoryA2);
+
+    EstablishConnection(connections[0], factoryA1);
+    FinishRequest(connections[0]);
+    ExecuteAllActions();
+}
+
+TEST_F(HttpClientConnectionPoolTest, Stop_closes_open_connections)
+{
+    ExpectConnect(connections[0]);
+    pool->Connect(factoryA1);
+    ExecuteAllActions();
+    EstablishConnection(connections[0], factoryA1);
+
+    infra::VerifyingFunction<void()> onDone;
+    ExpectConnectionClosed(connections[0]);
+    EXPECT_CALL(*connections[0].observer, Detaching());
+    pool->Stop([&]()
+        {
+            onDone.callback();
+        });
+}
@@ -0,0 +1,134 @@
+#include "services/network/HttpRouter.hpp"
+#include "services/network/test_doubles/HttpRequestParserStub.hpp"
+#include "services/network/test_doubles/HttpServerMock.hpp"
+#include "gmock/gmock.h"
+
+class HttpRouterTest
+    : public testing::Test
+{
+public:
+    services::HttpPage* PageFor(services::HttpVerb verb, infra::BoundedConstString path)
+    {
+        services::HttpRequestParserStub request(verb, path, "");
+        return router.PageForRequest(request);
+    }
+
+    services::HttpPage* PageFor(infra::BoundedConstString path)
+    {
+        return PageFor(services::HttpVerb::get, path);
+    }
+
+    services::HttpRouter::WithMaxNodes<32, 2> router;
+    testing::StrictMock<services::HttpPageMock> page1;
+    testing::StrictMock<services::HttpPageMock> page2;
+    testing::StrictMock<services::HttpPageMock> page3;
+};
+
+TEST_F(HttpRouterTest, literal_route_is_found)
+{
+    router.AddRoute(services::HttpVerb::get, "api/status", page1);
+    router.AddRoute(services::HttpVerb::get, "api/version", page2);
+
+    EXPECT_EQ(&page1, PageFor("api/status"));
+    EXPECT_EQ(&page2, PageFor("/api/version"));
+    EXPECT_EQ(nullptr, PageFor("api/other"));
+    EXPECT_EQ(nullptr, PageFor("api"));
+    EXPECT_EQ(nullptr, PageFor("api/status/more"));
+}
+
+TEST_F(HttpRouterTest, root_route_is_found)
+{
+    router.AddRoute(services::HttpVerb::get, "/", page1);
+
+    EXPECT_EQ(&page1, PageFor("/"));
+    EXPECT_EQ(&page1, PageFor(""));
+}
+
+TEST_F(HttpRouterTest, routes_are_dispatched_per_verb)
+{
+    router.AddRoute(services::HttpVerb::get, "api/devices", page1);
+    router.AddRoute(services::HttpVerb::post, "api/devices", page2);
+
+    EXPECT_EQ(&page1, PageFor(services::HttpVerb::get, "api/devices"));
+    EXPECT_EQ(&page2, PageFor(services::HttpVerb::post, "api/devices"));
+    EXPECT_EQ(nullptr, PageFor(services::HttpVerb::delete_, "api/devices"));
+}
+
+TEST_F(HttpRouterTest, parameters_are_captured)
+{
+    router.AddRoute(services::HttpVerb::get, "api/devices/{device}/sensors/{sensor}", page1);
+
+    EXPECT_EQ(&page1, PageFor("api/devices/12/sensors/temperature"));
+    EXPECT_EQ(2, router.NumberOfParameters());
+    EXPECT_EQ("12", router.Parameter(0));
+    EXPECT_EQ("temperature", router.Parameter(1));
+    EXPECT_EQ(std::make_optional<infra::BoundedConstString>("12"), router.Parameter("device"));
+    EXPECT_EQ(std::make_optional<infra::BoundedConstString>("temperature"), router.Parameter("sensor"));
+    EXPECT_EQ(std::nullopt, router.Parameter("other"));
+}
+
+TEST_F(HttpRouterTest, literal_takes_precedence_over_parameter)
+{
+    router.AddRoute(services::HttpVerb::get, "api/devices/{device}", page1);
+    router.AddRoute(services::HttpVerb::get, "api/devices/all", page2);
+
+    EXPECT_EQ(&page2, PageFor("api/devices/all"));
+    EXPECT_EQ(0, router.NumberOfParameters());
+    EXPECT_EQ(&page1, PageFor("api/devices/12"));
+    EXPECT_EQ(1, router.NumberOfParameters());
+}
+
+TEST_F(HttpRouterTest, parameter_is_tried_when_literal_does_not_lead_to_a_route)
+{
+    router.AddRoute(services::HttpVerb::get, "api/all/list", page1);
+    router.AddRoute(services::HttpVerb::get, "api/{group}/count", page2);
+
+    EXPECT_EQ(&page2, PageFor("api/all/count"));
+    EXPECT_EQ(std::make_optional<infra::BoundedConstString>("all"), router.Parameter("group"));
+}
+
+TEST_F(HttpRouterTest, wildcard_matches_remainder_of_path)
+{
+    router.AddRoute(services::HttpVerb::get, "static/*", page1);
+    router.AddRoute(services::HttpVerb::get, "static/{file}", page2);
+
+    EXPECT_EQ(&page2, PageFor("static/index.html"));
+    EXPECT_EQ(&page1, PageFor("static/css/style.css"));
+    EXPECT_EQ(std::make_optional<infra::BoundedConstString>("css/style.css"), router.Parameter("*"));
+    EXPECT_EQ(nullptr, PageFor("static"));
+}
+
+TEST_F(HttpRouterTest, unrouted_request_is_served_by_added_pages)
+{
+    router.AddRoute(services::HttpVerb::get, "api/status", page1);
+    router.AddPage(page2);
+
+    EXPECT_CALL(page2, ServesRequest(testing::_)).WillOnce(testing::Return(true));
+    EXPECT_EQ(&page2, PageFor("other"));
+}
+
+TEST_F(HttpRouterTest, route_is_found_among_many)
+{
+    infra::BoundedString::WithStorage<16> paths[10];
+    for (int i = 0; i != 10; ++i)
+    {
+        paths[i] = "api/page";
+        paths[i].push_back(static_cast<char>('0' + i));
+        router.AddRoute(services::HttpVerb::get, paths[i], i == 9 ? page3 : page1);
+    }
+
+    EXPECT_EQ(&page3, PageFor("api/page9"));
+}
+
+TEST_F(HttpRouterTest, literals_are_found_regardless_of_order_of_adding)
+{
+    router.AddRoute(services::HttpVerb::get, "c", page1);
+    router.AddRoute(services::HttpVerb::get, "a/c", page3);
+    router.AddRoute(services::HttpVerb::get, "b", page2);
+    router.AddRoute(services::HttpVerb::get, "a", page2);
+
+    EXPECT_EQ(&page1, PageFor("c"));
+    EXPECT_EQ(&page2, PageFor("b"));
+    EXPECT_EQ(&page2, PageFor("a"));
+    EXPECT_EQ(&page3, PageFor("a/c"));
+}
@@ -567,3 +567,174 @@ TEST_F(HttpServerWithSimplePageTest, when_responding_early_to_a_request_next_req
     EXPECT_CALL(connection, AbortAndDestroyMock());
     connection.AbortAndDestroy();
 }
+
+class HttpServerWithKeepAliveTest
+    : public testing::Test
+    , public infra::ClockFixture
+{
+public:
+    HttpServerWithKeepAliveTest()
+    {
+        httpServer.AddPage(page);
+        connectionFactoryMock.NewConnection(*serverConnectionObserverFactory, connection, services::IPv4AddressLocalHost());
+    }
+
+    ~HttpServerWithKeepAliveTest() override
+    {
+        httpServer.Stop(infra::emptyFunction);
+    }
+
+    static services::HttpServerConnectionObserver::Config MakeConfig()
+    {
+        services::HttpServerConnectionObserver::Config config;
+        config.keepAlive = true;
+        config.idleTimeout = std::chrono::seconds(5);
+        config.maxRequestsPerConnection = 3;
+        return config;
+    }
+
+    void ExpectRequest(const std::string& path, bool respond = true)
+    {
+        EXPECT_CALL(page, ServesRequest(testing::_)).WillOnce(testing::Invoke([path](const infra::Tokenizer& pathTokens)
+            {
+                return pathTokens.Token(0) == path;
+            }));
+        EXPECT_CALL(page, RequestReceived(testing::_, testing::_)).WillOnce(testing::Invoke([this, respond](services::HttpRequestParser& parser, services::HttpServerConnection& connection)
+            {
+                httpConnection = &connection;
+                if (respond)
+                    connection.SendResponse(services::httpResponseNoContent);
+            }));
+    }
+
+    void ReceiveData(const std::string& data)
+    {
+        connection.SimulateDataReceived(infra::MakeStringByteRange(data));
+        ExecuteAllActions();
+    }
+
+    std::string SentData()
+    {
+        std::string result(connection.sentData.begin(), connection.sentData.end());
+        connection.sentData.clear();
+        return result;
+    }
+
+    const std::string response = "HTTP/1.1 204 No Content\r\n\r\n";
+    const std::string responseWithClose = "HTTP/1.1 204 No Content\r\nConnection: close\r\n\r\n";
+
+    testing::StrictMock<services::ConnectionStub> connection;
+    infra::SharedPtr<services::ConnectionStub> connectionPtr{ infra::UnOwnedSharedPtr(connection) };
+    testing::StrictMock<services::ConnectionFactoryMock> connectionFactoryMock;
+    services::ServerConnectionObserverFactory* serverConnectionObserverFactory;
+    infra::Execute execute{ [this]()
+        {
+            EXPECT_CALL(connectionFactoryMock, Listen(80, testing::_, services::IPVersions::both)).WillOnce(testing::DoAll(infra::SaveRef<1>(&serverConnectionObserverFactory), testing::Return(nullptr)));
+        } };
+    services::DefaultHttpServer::WithBuffer<256> httpServer{ connectionFactoryMock, 80, MakeConfig() };
+    testing::StrictMock<services::HttpPageMock> page;
+    services::HttpServerConnection* httpConnection = nullptr;
+};
+
+TEST_F(HttpServerWithKeepAliveTest, connection_is_kept_open_after_response)
+{
+    ExpectRequest("a");
+    ReceiveData("GET /a HTTP/1.1\r\n\r\n");
+    EXPECT_EQ(response, SentData());
+
+    ExpectRequest("b");
+    ReceiveData("GET /b HTTP/1.1\r\n\r\n");
+    EXPECT_EQ(response, SentData());
+
+    EXPECT_CALL(connection, AbortAndDestroyMock());
+}
+
+TEST_F(HttpServerWithKeepAliveTest, pipelined_requests_are_served_in_order)
+{
+    testing::InSequence sequence;
+    ExpectRequest("a");
+    ExpectRequest("b");
+    ReceiveData("GET /a HTTP/1.1\r\n\r\nGET /b HTTP/1.1\r\n\r\n");
+
+    EXPECT_EQ(response + response, SentData());
+
+    EXPECT_CALL(connection, AbortAndDestroyMock());
+}
+
+TEST_F(HttpServerWithKeepAliveTest, pipelined_request_after_body_is_served)
+{
+    testing::InSequence sequence;
+    EXPECT_CALL(page, ServesRequest(testing::_)).WillOnce(testing::Return(true));
+    EXPECT_CALL(page, RequestReceived(testing::_, testing::_)).WillOnce(infra::SaveRef<1>(&httpConnection));
+    EXPECT_CALL(page, DataReceived(testing::_)).WillOnce(testing::Invoke([this](infra::SharedPtr<infra::StreamReaderWithRewinding>&& reader)
+        {
+            infra::TextInputStream::WithErrorPolicy stream(*reader);
+            infra::BoundedString::WithStorage<8> body(4, ' ');
+            stream >> body;
+            EXPECT_EQ("data", body);
+            reader = nullptr;
+        }));
+    EXPECT_CALL(page, Close()).WillOnce(testing::Invoke([this]()
+        {
+            httpConnection->SendResponse(services::httpResponseNoContent);
+        }));
+    ExpectRequest("b");
+    ReceiveData("PUT /a HTTP/1.1\r\nContent-Length: 4\r\n\r\ndataGET /b HTTP/1.1\r\n\r\n");
+
+    EXPECT_EQ(response + response, SentData());
+
+    EXPECT_CALL(connection, AbortAndDestroyMock());
+}
+
+TEST_F(HttpServerWithKeepAliveTest, pipelined_request_waits_for_response)
+{
+    ExpectRequest("a", false);
+    EXPECT_CALL(page, DataReceived(testing::_)).WillOnce(testing::Invoke([](infra::SharedPtr<infra::StreamReaderWithRewinding>&& reader)
+        {
+            reader = nullptr;
+        }));
+    EXPECT_CALL(page, Close());
+    ReceiveData("GET /a HTTP/1.1\r\n\r\nGET /b HTTP/1.1\r\n\r\n");
+    EXPECT_EQ("", SentData());
+
+    ExpectRequest("b");
+    httpConnection->SendResponse(services::httpResponseNoContent);
+    ExecuteAllActions();
+    EXPECT_EQ(response + response, SentData());
+
+    EXPECT_CALL(connection, AbortAndDestroyMock());
+}
+
+TEST_F(HttpServerWithKeepAliveTest, connection_close_request_closes_connection_after_response)
+{
+    ExpectRequest("a");
+    EXPECT_CALL(connection, CloseAndDestroyMock());
+    ReceiveData("GET /a HTTP/1.1\r\nConnection: close\r\n\r\n");
+
+    EXPECT_EQ(responseWithClose, SentData());
+}
+
+TEST_F(HttpServerWithKeepAliveTest, connection_is_closed_after_max_requests)
+{
+    ExpectRequest("a");
+    ReceiveData("GET /a HTTP/1.1\r\n\r\n");
+    ExpectRequest("a");
+    ReceiveData("GET /a HTTP/1.1\r\n\r\n");
+    EXPECT_EQ(response + response, SentData());
+
+    ExpectRequest("a");
+    EXPECT_CALL(connection, CloseAndDestroyMock());
+    ReceiveData("GET /a HTTP/1.1\r\n\r\n");
+    EXPECT_EQ(responseWithClose, SentData());
+}
+
+TEST_F(HttpServerWithKeepAliveTest, idle_connection_is_closed_after_idle_timeout)
+{
+    ForwardTime(std::chrono::seconds(4));
+    ExpectRequest("a");
+    ReceiveData("GET /a HTTP/1.1\r\n\r\n");
+
+    ForwardTime(std::chrono::seconds(4));
+    EXPECT_CALL(connection, CloseAndDestroyMock());
+    ForwardTime(std::chrono::seconds(1));
+}
@@ -0,0 +1,245 @@
+#include "infra/timer/test_helper/ClockFixture.hpp"
+#include "services/network/MbedTlsSession.hpp"
+#include "services/util/Sha256MbedTls.hpp"
+#include "services/util/test_doubles/ConfigurationStoreMock.hpp"
+#include "gmock/gmock.h"
+
+class MbedTlsSessionStorageLruTest
+    : public testing::Test
+    , public infra::ClockFixture
+{
+public:
+    services::Sha256MbedTls sha256;
+    services::MbedTlsSessionHasher hasher{ sha256 };
+    services::MbedTlsSessionStorageLru::WithMaxSize<2> storage{ hasher };
+};
+
+TEST_F(MbedTlsSessionStorageLruTest, new_session_is_found)
+{
+    auto session = storage.NewSession("host");
+
+    EXPECT_EQ(session, storage.GetSession("host"));
+    EXPECT_EQ(nullptr, storage.GetSession("other"));
+}
+
+TEST_F(MbedTlsSessionStorageLruTest, session_is_found_by_address)
+{
+    auto session = storage.NewSession(services::IPv4Address{ 1, 2, 3, 4 });
+
+    EXPECT_EQ(session, storage.GetSession(services::IPv4Address{ 1, 2, 3, 4 }));
+    EXPECT_EQ(nullptr, storage.GetSession(services::IPv4Address{ 1, 2, 3, 5 }));
+}
+
+TEST_F(MbedTlsSessionStorageLruTest, storage_is_not_full_while_sessions_are_not_in_use)
+{
+    storage.NewSession("host1");
+    storage.NewSession("host2");
+
+    EXPECT_FALSE(storage.Full());
+}
+
+TEST_F(MbedTlsSessionStorageLruTest, least_recently_used_session_is_evicted)
+{
+    auto session1 = storage.NewSession("host1");
+    storage.NewSession("host2");
+    storage.GetSession("host1");
+
+    auto session3 = storage.NewSession("host3");
+
+    EXPECT_EQ(session1, storage.GetSession("host1"));
+    EXPECT_EQ(nullptr, storage.GetSession("host2"));
+    EXPECT_EQ(session3, storage.GetSession("host3"));
+}
+
+TEST_F(MbedTlsSessionStorageLruTest, session_expires_after_lifetime)
+{
+    storage.NewSession("host");
+
+    ForwardTime(std::chrono::hours(24) - std::chrono::seconds(1));
+    EXPECT_NE(nullptr, storage.GetSession("host"));
+
+    ForwardTime(std::chrono::seconds(1));
+    EXPECT_EQ(nullptr, storage.GetSession("host"));
+}
+
+TEST_F(MbedTlsSessionStorageLruTest, obtaining_session_restarts_lifetime)
+{
+    auto session = storage.NewSession("host");
+
+    ForwardTime(std::chrono::hours(12));
+    session->Obtained();
+
+    ForwardTime(std::chrono::hours(12));
+    EXPECT_EQ(session, storage.GetSession("host"));
+}
+
+TEST_F(MbedTlsSessionStorageLruTest, expired_session_is_evicted_before_least_recently_used_session)
+{
+    services::MbedTlsSessionStorageLru::Config config;
+    config.lifetime = std::chrono::minutes(10);
+    services::MbedTlsSessionStorageLru::WithMaxSize<2> shortLivedStorage{ hasher, config };
+
+    shortLivedStorage.NewSession("host1");
+    ForwardTime(std::chrono::minutes(5));
+    auto session2 = shortLivedStorage.NewSession("host2");
+    shortLivedStorage.GetSession("host1");
+    ForwardTime(std::chrono::minutes(5));
+
+    shortLivedStorage.NewSession("host3");
+
+    EXPECT_EQ(session2, shortLivedStorage.GetSession("host2"));
+    EXPECT_EQ(nullptr, shortLivedStorage.GetSession("host1"));
+}
+
+TEST_F(MbedTlsSessionStorageLruTest, invalidated_session_is_removed)
+{
+    auto session = storage.NewSession("host");
+
+    storage.Invalidate(session);
+
+    EXPECT_EQ(nullptr, storage.GetSession("host"));
+}
+
+TEST_F(MbedTlsSessionStorageLruTest, Clear_removes_all_sessions)
+{
+    storage.NewSession("host1");
+    storage.NewSession("host2");
+
+    storage.Clear();
+
+    EXPECT_EQ(nullptr, storage.GetSession("host1"));
+    EXPECT_EQ(nullptr, storage.GetSession("host2"));
+}
+
+TEST_F(MbedTlsSessionStorageLruTest, storage_is_full_when_all_sessions_are_in_use)
+{
+    storage.NewSession("host1")->Acquire();
+    auto session2 = storage.NewSession("host2");
+    session2->Acquire();
+
+    EXPECT_TRUE(storage.Full());
+
+    session2->Release();
+    EXPECT_FALSE(storage.Full());
+}
+
+TEST_F(MbedTlsSessionStorageLruTest, storage_remains_full_when_sessions_in_use_are_invalidated)
+{
+    auto session1 = storage.NewSession("host1");
+    session1->Acquire();
+    storage.NewSession("host2")->Acquire();
+
+    storage.Invalidate(session1);
+    EXPECT_TRUE(storage.Full());
+
+    storage.Clear();
+    EXPECT_TRUE(storage.Full());
+}
+
+TEST_F(MbedTlsSessionStorageLruTest, session_in_use_is_not_evicted)
+{
+    auto session1 = storage.NewSession("host1");
+    session1->Acquire();
+    storage.NewSession("host2");
+    storage.GetSession("host2");
+
+    auto session3 = storage.NewSession("host3");
+
+    EXPECT_EQ(session1, storage.GetSession("host1"));
+    EXPECT_EQ(nullptr, storage.GetSession("host2"));
+    EXPECT_EQ(session3, storage.GetSession("host3"));
+}
+
+TEST_F(MbedTlsSessionStorageLruTest, session_in_use_does_not_expire)
+{
+    auto session = storage.NewSession("host");
+    session->Acquire();
+
+    ForwardTime(std::chrono::hours(24));
+    EXPECT_EQ(session, storage.GetSession("host"));
+
+    session->Release();
+    EXPECT_EQ(nullptr, storage.GetSession("host"));
+}
+
+TEST_F(MbedTlsSessionStorageLruTest, invalidated_session_in_use_is_not_found_and_evicted_first_after_release)
+{
+    auto session1 = storage.NewSession("host1");
+    session1->Acquire();
+    auto session2 = storage.NewSession("host2");
+    storage.GetSession("host1");
+
+    storage.Invalidate(session1);
+    EXPECT_EQ(nullptr, storage.GetSession("host1"));
+
+    session1->Release();
+    auto session3 = storage.NewSession("host3");
+
+    EXPECT_EQ(session2, storage.GetSession("host2"));
+    EXPECT_EQ(session3, storage.GetSession("host3"));
+}
+
+TEST_F(MbedTlsSessionStorageLruTest, Clear_keeps_sessions_in_use_until_released)
+{
+    auto session1 = storage.NewSession("host1");
+    session1->Acquire();
+    storage.NewSession("host2");
+
+    storage.Clear();
+
+    EXPECT_EQ(nullptr, storage.GetSession("host1"));
+    EXPECT_FALSE(storage.Full());
+
+    session1->Release();
+    storage.NewSession("host3");
+    storage.NewSession("host4");
+    EXPECT_EQ(nullptr, storage.GetSession("host1"));
+}
+
+#ifndef EMIL_MUTATION_TESTING
+TEST_F(MbedTlsSessionStorageLruTest, new_session_while_all_sessions_are_in_use_asserts)
+{
+    storage.NewSession("host1")->Acquire();
+    storage.NewSession("host2")->Acquire();
+
+    EXPECT_DEATH(storage.NewSession("host3"), "");
+}
+#endif
+
+class MbedTlsSessionStorageLruPersistentTest
+    : public MbedTlsSessionStorageLruTest
+{
+public:
+    infra::BoundedVector<network::MbedTlsPersistedSession>::WithMaxSize<3> stores;
+    testing::StrictMock<services::ConfigurationStoreInterfaceMock> configInterface;
+    services::ConfigurationStoreAccess<infra::BoundedVector<network::MbedTlsPersistedSession>> configStore{ configInterface, stores };
+};
+
+TEST_F(MbedTlsSessionStorageLruPersistentTest, obtained_session_is_written)
+{
+    services::MbedTlsSessionStorageLru::WithMaxSize<2> persistentStorage{ configStore, hasher };
+    auto session = persistentStorage.NewSession("host");
+
+    EXPECT_CALL(configInterface, Write());
+    session->Obtained();
+}
+
+TEST_F(MbedTlsSessionStorageLruPersistentTest, Clear_erases_persisted_sessions)
+{
+    stores.emplace_back();
+    services::MbedTlsSessionStorageLru::WithMaxSize<2> persistentStorage{ configStore, hasher };
+
+    EXPECT_CALL(configInterface, Write());
+    persistentStorage.Clear();
+    EXPECT_TRUE(stores.empty());
+}
+
+TEST_F(MbedTlsSessionStorageLruPersistentTest, sessions_that_fail_to_deserialize_are_dropped)
+{
+    stores.emplace_back();
+    stores.emplace_back();
+
+    services::MbedTlsSessionStorageLru::WithMaxSize<2> persistentStorage{ configStore, hasher };
+
+    EXPECT_TRUE(stores.empty());
+}
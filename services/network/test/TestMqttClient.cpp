@@ -417,6 +417,14 @@ TEST_F(MqttClientTest, rejected_subscription_aborts_connection)
     ReceiveSubAck(1, 0x80);
 }
 
+TEST_F(MqttClientTest, suback_without_subscribe_aborts_connection)
+{
+    Connect();
+
+    ExpectClosingConnection();
+    ReceiveSubAck(1, 0x01);
+}
+
 TEST_F(MqttClientTest, subscribe_aborts_connection_with_30_sec_timeout)
 {
     Connect();
@@ -496,11 +504,16 @@ TEST_F(MqttClientTest, additional_received_data_are_processed_after_Notification
 {
     Connect();
 
+    FillTopic("topic");
+    client.Subject().Subscribe();
+    ExecuteAllActions();
+
     ExpectReceivedNotification("topic", "payload");
     ReceivePublish("topic", "payload", 1);
 
     ReceiveSubAck(1, 0x01);
 
+    EXPECT_CALL(client, SubscribeDone());
     client.Subject().NotificationDone();
 
     ExecuteAllActions();
@@ -657,3 +670,267 @@ TEST_F(MqttClientTest, _35_seconds_after_previous_traffic_ping_request_is_sent)
     // Ping reply
     connection.SimulateDataReceived(std::vector<uint8_t>{ 0xd0, 0x00 });
 }
+
+class MqttClientObserverWithSentMock
+    : public services::MqttClientObserverMock
+{
+public:
+    MOCK_METHOD0(PublishSent, void());
+    MOCK_METHOD0(SubscribeSent, void());
+};
+
+class MqttClientWithSessionTest
+    : public testing::Test
+    , public infra::ClockFixture
+{
+public:
+    ~MqttClientWithSessionTest() override
+    {
+        EXPECT_CALL(factory, ConnectionFailed(testing::_)).Times(testing::AnyNumber());
+        EXPECT_CALL(client, Detaching()).Times(testing::AnyNumber());
+    }
+
+    void Connect(ConnectionStubWithSendStreamControl& connection, std::vector<uint8_t> conAck = { 0x20, 0x02, 0x00, 0x00 })
+    {
+        EXPECT_CALL(connectionFactory, Connect(testing::Ref(connector)));
+        connector.Connect(factory);
+
+        connector.ConnectionEstablished([&connection](infra::SharedPtr<services::ConnectionObserver> connectionObserver)
+            {
+                connection.Attach(connectionObserver);
+            });
+
+        ExecuteAllActions();
+        connectMessage = connection.sentData;
+        connection.sentData.clear();
+
+        EXPECT_CALL(factory, ConnectionEstablished(testing::_)).WillOnce(testing::Invoke([this](infra::AutoResetFunction<void(infra::SharedPtr<services::MqttClientObserver> client)>&& createdClient)
+            {
+                EXPECT_CALL(client, Attached());
+                createdClient(clientPtr);
+            }));
+        connection.SimulateDataReceived(conAck);
+        ExecuteAllActions();
+    }
+
+    void Message(infra::BoundedConstString topic, infra::BoundedConstString payload)
+    {
+        EXPECT_CALL(client, FillTopic(testing::_)).WillRepeatedly(testing::Invoke([topic](infra::StreamWriter& writer)
+            {
+                infra::TextOutputStream::WithErrorPolicy stream(writer);
+                stream << topic;
+            }));
+        EXPECT_CALL(client, FillPayload(testing::_)).WillRepeatedly(testing::Invoke([payload](infra::StreamWriter& writer)
+            {
+                infra::TextOutputStream::WithErrorPolicy stream(writer);
+                stream << payload;
+            }));
+    }
+
+    void Publish(infra::BoundedConstString payload)
+    {
+        Message("t", payload);
+        EXPECT_CALL(client, PublishSent());
+        client.Subject().Publish();
+        ExecuteAllActions();
+    }
+
+    std::vector<uint8_t> PublishPacket(uint16_t packetIdentifier, const std::string& payload, uint8_t flags = 0)
+    {
+        std::vector<uint8_t> packet{ static_cast<uint8_t>(0x32 | flags), static_cast<uint8_t>(5 + payload.size()), 0x00, 0x01, 't', static_cast<uint8_t>(packetIdentifier >> 8), static_cast<uint8_t>(packetIdentifier) };
+        packet.insert(packet.end(), payload.begin(), payload.end());
+        return packet;
+    }
+
+    static std::vector<uint8_t> Concatenated(std::initializer_list<std::vector<uint8_t>> packets)
+    {
+        std::vector<uint8_t> result;
+        for (auto& packet : packets)
+            result.insert(result.end(), packet.begin(), packet.end());
+        return result;
+    }
+
+    void ReceiveAck(ConnectionStubWithSendStreamControl& connection, uint8_t packetType, uint16_t packetIdentifier)
+    {
+        connection.SimulateDataReceived(std::vector<uint8_t>{ packetType, 0x03, static_cast<uint8_t>(packetIdentifier >> 8), static_cast<uint8_t>(packetIdentifier), 0x01 });
+    }
+
+    testing::StrictMock<services::ConnectionFactoryWithNameResolverMock> connectionFactory;
+    testing::StrictMock<services::MqttClientObserverFactoryMock> factory;
+    testing::StrictMock<MqttClientObserverWithSentMock> client;
+    services::MqttClientSession::WithWindow<2, 16> session;
+    services::MqttClientConnectorImpl connector{ "clientId", "username", "password", "127.0.0.1", 1234, connectionFactory, session };
+    testing::StrictMock<ConnectionStubWithSendStreamControl> connection;
+    infra::SharedPtr<services::Connection> connectionPtr{ infra::UnOwnedSharedPtr(connection) };
+    infra::SharedPtr<services::MqttClientObserver> clientPtr{ infra::UnOwnedSharedPtr(client) };
+    std::vector<uint8_t> connectMessage;
+};
+
+TEST_F(MqttClientWithSessionTest, session_with_packet_storage_requests_persistent_session)
+{
+    Connect(connection);
+
+    EXPECT_EQ(0xc0, connectMessage[9]);
+}
+
+TEST_F(MqttClientWithSessionTest, publishes_are_pipelined_up_to_window_size)
+{
+    Connect(connection);
+
+    Publish("a");
+    Publish("b");
+    EXPECT_EQ(Concatenated({ PublishPacket(1, "a"), PublishPacket(2, "b") }), connection.sentData);
+    connection.sentData.clear();
+
+    Message("t", "c");
+    client.Subject().Publish();
+    ExecuteAllActions();
+    EXPECT_TRUE(connection.sentData.empty());
+
+    EXPECT_CALL(client, PublishDone());
+    EXPECT_CALL(client, PublishSent());
+    ReceiveAck(connection, 0x40, 1);
+    ExecuteAllActions();
+    EXPECT_EQ(PublishPacket(3, "c"), connection.sentData);
+}
+
+TEST_F(MqttClientWithSessionTest, acknowledgements_are_matched_out_of_order)
+{
+    Connect(connection);
+
+    Publish("a");
+    Publish("b");
+
+    EXPECT_CALL(client, PublishDone());
+    ReceiveAck(connection, 0x40, 2);
+
+    Publish("c");
+    EXPECT_EQ(Concatenated({ PublishPacket(1, "a"), PublishPacket(2, "b"), PublishPacket(3, "c") }), connection.sentData);
+
+    EXPECT_CALL(client, PublishDone()).Times(2);
+    ReceiveAck(connection, 0x40, 1);
+    ReceiveAck(connection, 0x40, 3);
+}
+
+TEST_F(MqttClientWithSessionTest, subscribe_and_publish_are_pipelined)
+{
+    Connect(connection);
+
+    Message("t", "");
+    EXPECT_CALL(client, SubscribeSent());
+    client.Subject().Subscribe();
+    ExecuteAllActions();
+
+    Publish("a");
+    EXPECT_EQ(Concatenated({ { 0x82, 0x06, 0x00, 0x01, 0x00, 0x01, 't', 0x01 }, PublishPacket(2, "a") }), connection.sentData);
+
+    EXPECT_CALL(client, PublishDone());
+    ReceiveAck(connection, 0x40, 2);
+
+    EXPECT_CALL(client, SubscribeDone());
+    ReceiveAck(connection, 0x90, 1);
+}
+
+TEST_F(MqttClientWithSessionTest, operation_times_out_while_later_operations_are_sent)
+{
+    Connect(connection);
+
+    Publish("a");
+    ForwardTime(std::chrono::seconds(20));
+    Publish("b");
+    ForwardTime(std::chrono::seconds(9));
+
+    EXPECT_CALL(connection, AbortAndDestroyMock());
+    EXPECT_CALL(client, Detaching());
+    ForwardTime(std::chrono::seconds(1));
+}
+
+TEST_F(MqttClientWithSessionTest, each_operation_times_out_after_it_was_sent)
+{
+    Connect(connection);
+
+    Publish("a");
+    ForwardTime(std::chrono::seconds(20));
+    Publish("b");
+    ForwardTime(std::chrono::seconds(5));
+
+    EXPECT_CALL(client, PublishDone());
+    ReceiveAck(connection, 0x40, 1);
+    ForwardTime(std::chrono::seconds(24));
+
+    EXPECT_CALL(connection, AbortAndDestroyMock());
+    EXPECT_CALL(client, Detaching());
+    ForwardTime(std::chrono::seconds(1));
+}
+
+TEST_F(MqttClientWithSessionTest, unacknowledged_publishes_are_retransmitted_on_next_connection)
+{
+    Connect(connection);
+
+    Publish("a");
+    Publish("b");
+
+    EXPECT_CALL(client, PublishDone());
+    ReceiveAck(connection, 0x40, 1);
+
+    EXPECT_CALL(connection, AbortAndDestroyMock());
+    EXPECT_CALL(client, Detaching());
+    connection.AbortAndDestroy();
+    ExecuteAllActions();
+
+    testing::StrictMock<ConnectionStubWithSendStreamControl> connection2;
+    infra::SharedPtr<services::Connection> connection2Ptr{ infra::UnOwnedSharedPtr(connection2) };
+    Connect(connection2, { 0x20, 0x02, 0x01, 0x00 });
+    EXPECT_EQ(PublishPacket(2, "b", 0x08), connection2.sentData);
+    connection2.sentData.clear();
+
+    Publish("c");
+    EXPECT_EQ(PublishPacket(3, "c"), connection2.sentData);
+
+    ReceiveAck(connection2, 0x40, 2);
+
+    EXPECT_CALL(client, PublishDone());
+    ReceiveAck(connection2, 0x40, 3);
+
+    EXPECT_CALL(client, Detaching());
+}
+
+TEST_F(MqttClientWithSessionTest, publish_which_does_not_fit_in_packet_storage_is_sent_without_retransmission)
+{
+    Connect(connection);
+
+    Publish("abcdefghijklmnop");
+    EXPECT_EQ(PublishPacket(1, "abcdefghijklmnop"), connection.sentData);
+
+    EXPECT_CALL(connection, AbortAndDestroyMock());
+    EXPECT_CALL(client, Detaching());
+    connection.AbortAndDestroy();
+    ExecuteAllActions();
+
+    testing::StrictMock<ConnectionStubWithSendStreamControl> connection2;
+    infra::SharedPtr<services::Connection> connection2Ptr{ infra::UnOwnedSharedPtr(connection2) };
+    Connect(connection2, { 0x20, 0x02, 0x01, 0x00 });
+    EXPECT_EQ(std::vector<uint8_t>{}, connection2.sentData);
+
+    EXPECT_CALL(client, Detaching());
+}
+
+TEST_F(MqttClientWithSessionTest, session_without_packet_storage_requests_clean_session)
+{
+    services::MqttClientSession::WithWindow<2> sessionWithoutStorage;
+    services::MqttClientConnectorImpl connector{ "clientId", "username", "password", "127.0.0.1", 1234, connectionFactory, sessionWithoutStorage };
+    testing::StrictMock<ConnectionStubWithSendStreamControl> otherConnection;
+    infra::SharedPtr<services::Connection> otherConnectionPtr{ infra::UnOwnedSharedPtr(otherConnection) };
+
+    EXPECT_CALL(connectionFactory, Connect(testing::Ref(connector)));
+    connector.Connect(factory);
+    connector.ConnectionEstablished([&otherConnection](infra::SharedPtr<services::ConnectionObserver> connectionObserver)
+        {
+            otherConnection.Attach(connectionObserver);
+        });
+    ExecuteAllActions();
+
+    EXPECT_EQ(0xc2, otherConnection.sentData[9]);
+
+    EXPECT_CALL(factory, ConnectionFailed(services::MqttClientObserverFactory::ConnectFailReason::initializationFailed));
+}
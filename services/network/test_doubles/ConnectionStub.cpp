@@ -11,7 +11,8 @@ namespace services
         infra::EventDispatcherWithWeakPtr::Instance().Schedule([](const infra::SharedPtr<ConnectionStub>& object)
             {
                 infra::SharedPtr<infra::StreamWriter> stream = std::move(object->streamWriterPtr);
-                object->Observer().SendStreamAvailable(std::move(stream));
+                if (object->IsAttached())
+                    object->Observer().SendStreamAvailable(std::move(stream));
             },
             SharedFromThis());
     }
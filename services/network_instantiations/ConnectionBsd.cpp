@@ -1,6 +1,10 @@
 #include "services/network_instantiations/ConnectionBsd.hpp"
 #include "infra/event/EventDispatcherWithWeakPtr.hpp"
+#ifdef EMIL_NETWORK_EPOLL
+#include "services/network_instantiations/EventDispatcherWithNetworkEpoll.hpp"
+#else
 #include "services/network_instantiations/EventDispatcherWithNetworkBsd.hpp"
+#endif
 #include <arpa/inet.h>
 #include <cstring>
 #include <errno.h>
@@ -9,6 +13,7 @@
 #include <netinet/tcp.h>
 #include <optional>
 #include <sys/socket.h>
+#include <sys/uio.h>
 #include <unistd.h>
 
 namespace
@@ -120,16 +125,18 @@ namespace services
     {
         if (Connected())
         {
+            network.DeregisterConnection(*this);
             int result = close(socket);
             if (result == -1)
                 std::abort();
+            socket = 0;
         }
     }
 
     void ConnectionBsd::RequestSendStream(std::size_t sendSize)
     {
         assert(requestedSendSize == 0);
-        assert(sendSize != 0 && sendSize <= MaxSendStreamSize());
+        assert(sendSize <= MaxSendStreamSize());
 
         requestedSendSize = sendSize;
         TryAllocateSendStream();
@@ -137,7 +144,7 @@ namespace services
 
     std::size_t ConnectionBsd::MaxSendStreamSize() const
     {
-        return sendBuffer.max_size();
+        return sendBuffer.MaxSize();
     }
 
     infra::SharedPtr<infra::StreamReaderWithRewinding> ConnectionBsd::ReceiveStream()
@@ -158,6 +165,7 @@ namespace services
 
     void ConnectionBsd::AbortAndDestroy()
     {
+        network.DeregisterConnection(*this);
         int result = close(socket);
         assert(result != -1);
         socket = 0;
@@ -199,7 +207,7 @@ namespace services
 
     bool ConnectionBsd::SendBufferEmpty() const
     {
-        return sendBuffer.empty();
+        return sendBuffer.Empty();
     }
 
     void ConnectionBsd::Receive()
@@ -234,12 +242,17 @@ namespace services
 
     void ConnectionBsd::Send()
     {
-        long sent = 0;
-
-        do
+        while (!sendBuffer.Empty())
         {
-            std::vector<char> tmpBuffer(sendBuffer.begin(), sendBuffer.end());
-            sent = send(socket, tmpBuffer.data(), tmpBuffer.size(), 0);
+            auto segments = sendBuffer.Segments();
+            std::array<iovec, 2> vectors{ { { const_cast<uint8_t*>(segments[0].begin()), segments[0].size() },
+                { const_cast<uint8_t*>(segments[1].begin()), segments[1].size() } } };
+
+            msghdr message{};
+            message.msg_iov = vectors.data();
+            message.msg_iovlen = segments[1].empty() ? 1 : 2;
+
+            auto sent = sendmsg(socket, &message, 0);
 
             if (sent == -1)
             {
@@ -248,8 +261,11 @@ namespace services
                 return;
             }
 
-            sendBuffer.erase(sendBuffer.begin(), sendBuffer.begin() + sent);
-        } while (sent != 0 && !sendBuffer.empty());
+            if (sent == 0)
+                break;
+
+            sendBuffer.Pop(sent);
+        }
 
         if (requestedSendSize != 0)
             TryAllocateSendStream();
@@ -279,12 +295,13 @@ namespace services
     void ConnectionBsd::TryAllocateSendStream()
     {
         assert(streamWriter.Allocatable());
-        if (sendBuffer.max_size() - sendBuffer.size() >= requestedSendSize)
+        if (sendBuffer.CanReserve(requestedSendSize))
         {
-            auto size = requestedSendSize;
-            infra::EventDispatcherWithWeakPtr::Instance().Schedule([size](const infra::SharedPtr<ConnectionBsd>& object)
+            // An empty send stream does not need a reservation, and BipBuffer does not hand out empty reservations
+            auto reservation = requestedSendSize != 0 ? sendBuffer.Reserve(requestedSendSize) : infra::ByteRange();
+            infra::EventDispatcherWithWeakPtr::Instance().Schedule([reservation](const infra::SharedPtr<ConnectionBsd>& object)
                 {
-                    infra::SharedPtr<infra::StreamWriter> writer = object->streamWriter.Emplace(*object, size);
+                    infra::SharedPtr<infra::StreamWriter> writer = object->streamWriter.Emplace(*object, reservation);
                     object->Observer().SendStreamAvailable(std::move(writer));
                 },
                 SharedFromThis());
@@ -293,16 +310,16 @@ namespace services
         }
     }
 
-    ConnectionBsd::StreamWriterBsd::StreamWriterBsd(ConnectionBsd& connection, std::size_t size)
-        : std::vector<uint8_t>(size, 0)
-        , infra::ByteOutputStreamWriter(infra::MakeRange(*this))
+    ConnectionBsd::StreamWriterBsd::StreamWriterBsd(ConnectionBsd& connection, infra::ByteRange reservation)
+        : infra::ByteOutputStreamWriter(reservation)
         , connection(connection)
     {}
 
     ConnectionBsd::StreamWriterBsd::~StreamWriterBsd()
     {
-        connection.sendBuffer.insert(connection.sendBuffer.end(), Processed().begin(), Processed().end());
+        connection.sendBuffer.Commit(Processed().size());
         connection.trySend = true;
+        connection.network.ConnectionStateChanged(connection);
     }
 
     ConnectionBsd::StreamReaderBsd::StreamReaderBsd(ConnectionBsd& connection)
@@ -314,6 +331,7 @@ namespace services
     {
         connection.receiveBuffer.erase(connection.receiveBuffer.begin(), connection.receiveBuffer.begin() + ConstructSaveMarker());
         Rewind(0);
+        connection.network.ConnectionStateChanged(connection);
     }
 
     ListenerBsd::ListenerBsd(EventDispatcherWithNetwork& network, uint16_t port, services::ServerConnectionObserverFactory& factory, IPVersions versions)
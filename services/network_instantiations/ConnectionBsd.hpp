@@ -3,6 +3,7 @@
 
 #include "infra/stream/BoundedDequeInputStream.hpp"
 #include "infra/stream/ByteOutputStream.hpp"
+#include "infra/util/BipBuffer.hpp"
 #include "infra/util/IntrusiveList.hpp"
 #include "infra/util/SharedObjectAllocator.hpp"
 #include "infra/util/SharedOptional.hpp"
@@ -43,11 +44,10 @@ namespace services
 
     private:
         class StreamWriterBsd
-            : private std::vector<uint8_t>
-            , public infra::ByteOutputStreamWriter
+            : public infra::ByteOutputStreamWriter
         {
         public:
-            StreamWriterBsd(ConnectionBsd& connection, std::size_t size);
+            StreamWriterBsd(ConnectionBsd& connection, infra::ByteRange reservation);
             ~StreamWriterBsd();
 
         private:
@@ -73,7 +73,8 @@ namespace services
         int socket;
 
         infra::BoundedDeque<uint8_t>::WithMaxSize<2048> receiveBuffer;
-        infra::BoundedDeque<uint8_t>::WithMaxSize<2048> sendBuffer;
+        // StreamWriterBsd writes directly into the send buffer, which is sent from without copying
+        infra::BipByteBuffer::WithStorage<2048> sendBuffer;
 
         infra::SharedOptional<StreamWriterBsd> streamWriter;
         std::size_t requestedSendSize = 0;
@@ -1,6 +1,10 @@
 #include "services/network_instantiations/DatagramBsd.hpp"
 #include "infra/stream/StdVectorInputStream.hpp"
+#ifdef EMIL_NETWORK_EPOLL
+#include "services/network_instantiations/EventDispatcherWithNetworkEpoll.hpp"
+#else
 #include "services/network_instantiations/EventDispatcherWithNetworkBsd.hpp"
+#endif
 #include <errno.h>
 #include <fcntl.h>
 #include <sys/socket.h>
@@ -73,6 +77,9 @@ namespace services
         if (HasObserver())
             GetObserver().Detach();
 
+        if (network != nullptr)
+            network->DeregisterDatagram(*this);
+
         int result = close(socket);
         if (result == -1)
             std::abort();
@@ -237,5 +244,8 @@ namespace services
         connection.sendBuffer->resize(Processed().size());
         connection.trySend = true;
         connection.self = connection.SharedFromThis();
+
+        if (connection.network != nullptr)
+            connection.network->DatagramStateChanged(connection);
     }
 }
@@ -14,6 +14,8 @@
 
 namespace services
 {
+    class EventDispatcherWithNetwork;
+
     class DatagramBsd
         : public services::DatagramExchange
         , public infra::EnableSharedFromThis<DatagramBsd>
@@ -62,6 +64,7 @@ namespace services
     private:
         friend class EventDispatcherWithNetwork;
 
+        EventDispatcherWithNetwork* network = nullptr;
         int socket = ::socket(AF_INET, SOCK_DGRAM, IPPROTO_UDP);
         IPv4Address localAddress{};
         std::optional<UdpSocket> connectedTo;
@@ -37,6 +37,16 @@ namespace services
         connections.push_back(connection);
     }
 
+    void EventDispatcherWithNetwork::DeregisterConnection(ConnectionBsd& connection)
+    {
+        // File descriptor sets are rebuilt on every iteration, closed connections are removed in Idle()
+    }
+
+    void EventDispatcherWithNetwork::ConnectionStateChanged(ConnectionBsd& connection)
+    {
+        // File descriptor sets are rebuilt on every iteration, so there is no interest to update
+    }
+
     void EventDispatcherWithNetwork::RegisterListener(ListenerBsd& listener)
     {
         listeners.push_back(listener);
@@ -61,9 +71,20 @@ namespace services
 
     void EventDispatcherWithNetwork::RegisterDatagram(const infra::SharedPtr<DatagramBsd>& datagram)
     {
+        datagram->network = this;
         datagrams.push_back(datagram);
     }
 
+    void EventDispatcherWithNetwork::DeregisterDatagram(DatagramBsd& datagram)
+    {
+        // File descriptor sets are rebuilt on every iteration, destroyed datagrams are removed in Idle()
+    }
+
+    void EventDispatcherWithNetwork::DatagramStateChanged(DatagramBsd& datagram)
+    {
+        // File descriptor sets are rebuilt on every iteration, so there is no interest to update
+    }
+
     bool EventDispatcherWithNetwork::ConnectionsOpen() const
     {
         return !connectors.empty() || !connections.empty();
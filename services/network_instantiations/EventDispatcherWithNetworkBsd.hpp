@@ -19,10 +19,14 @@ namespace services
         ~EventDispatcherWithNetwork() override;
 
         void RegisterConnection(const infra::SharedPtr<ConnectionBsd>& connection);
+        void DeregisterConnection(ConnectionBsd& connection);
+        void ConnectionStateChanged(ConnectionBsd& connection);
         void RegisterListener(ListenerBsd& listener);
         void DeregisterListener(ListenerBsd& listener);
         void DeregisterConnector(ConnectorBsd& connector);
         void RegisterDatagram(const infra::SharedPtr<DatagramBsd>& datagram);
+        void DeregisterDatagram(DatagramBsd& datagram);
+        void DatagramStateChanged(DatagramBsd& datagram);
 
         bool ConnectionsOpen() const;
 
@@ -0,0 +1,416 @@
+#include "services/network_instantiations/EventDispatcherWithNetworkEpoll.hpp"
+#include "infra/util/Overloaded.hpp"
+#include <algorithm>
+#include <errno.h>
+#include <sys/eventfd.h>
+#include <sys/socket.h>
+#include <unistd.h>
+
+namespace services
+{
+    EventDispatcherWithNetwork::EventDispatcherWithNetwork()
+    {
+        epollFileDescriptor = epoll_create1(EPOLL_CLOEXEC);
+        if (epollFileDescriptor == -1)
+            std::abort();
+
+        wakeUpEvent = eventfd(0, EFD_NONBLOCK | EFD_CLOEXEC);
+        if (wakeUpEvent == -1)
+            std::abort();
+
+        auto event = MakeEvent(wakeUpEvent, EPOLLIN, nextGeneration++);
+        if (epoll_ctl(epollFileDescriptor, EPOLL_CTL_ADD, wakeUpEvent, &event) == -1)
+            std::abort();
+    }
+
+    EventDispatcherWithNetwork::~EventDispatcherWithNetwork()
+    {
+        close(wakeUpEvent);
+        close(epollFileDescriptor);
+    }
+
+    void EventDispatcherWithNetwork::RegisterConnection(const infra::SharedPtr<ConnectionBsd>& connection)
+    {
+        Watch(connection->socket, RequiredEvents(*connection), &*connection);
+    }
+
+    void EventDispatcherWithNetwork::DeregisterConnection(ConnectionBsd& connection)
+    {
+        changedConnections.erase(std::remove(changedConnections.begin(), changedConnections.end(), &connection), changedConnections.end());
+
+        auto registration = registrations.find(connection.socket);
+        if (registration != registrations.end() && std::holds_alternative<ConnectionBsd*>(registration->second.owner))
+            Unwatch(connection.socket);
+    }
+
+    void EventDispatcherWithNetwork::ConnectionStateChanged(ConnectionBsd& connection)
+    {
+        if (connection.Connected())
+            changedConnections.push_back(&connection);
+    }
+
+    void EventDispatcherWithNetwork::RegisterListener(ListenerBsd& listener)
+    {
+        Watch(listener.listenSocket, EPOLLIN, &listener);
+    }
+
+    void EventDispatcherWithNetwork::DeregisterListener(ListenerBsd& listener)
+    {
+        Unwatch(listener.listenSocket);
+    }
+
+    void EventDispatcherWithNetwork::DeregisterConnector(ConnectorBsd& connector)
+    {
+        for (auto c = connectors.begin(); c != connectors.end(); ++c)
+            if (&*c == &connector)
+            {
+                if (connector.connectSocket != -1)
+                    Unwatch(connector.connectSocket);
+
+                connectors.erase(c);
+                return;
+            }
+
+        std::abort();
+    }
+
+    void EventDispatcherWithNetwork::RegisterDatagram(const infra::SharedPtr<DatagramBsd>& datagram)
+    {
+        datagram->network = this;
+        Watch(datagram->socket, RequiredEvents(*datagram), &*datagram);
+    }
+
+    void EventDispatcherWithNetwork::DeregisterDatagram(DatagramBsd& datagram)
+    {
+        changedDatagrams.erase(std::remove(changedDatagrams.begin(), changedDatagrams.end(), &datagram), changedDatagrams.end());
+        Unwatch(datagram.socket);
+    }
+
+    void EventDispatcherWithNetwork::DatagramStateChanged(DatagramBsd& datagram)
+    {
+        changedDatagrams.push_back(&datagram);
+    }
+
+    bool EventDispatcherWithNetwork::ConnectionsOpen() const
+    {
+        if (!connectors.empty())
+            return true;
+
+        for (auto& registration : registrations)
+            if (std::holds_alternative<ConnectionBsd*>(registration.second.owner))
+                return true;
+
+        return false;
+    }
+
+    infra::SharedPtr<void> EventDispatcherWithNetwork::Listen(uint16_t port, services::ServerConnectionObserverFactory& factory, IPVersions versions)
+    {
+        return infra::MakeSharedOnHeap<ListenerBsd>(*this, port, factory, versions);
+    }
+
+    void EventDispatcherWithNetwork::Connect(ClientConnectionObserverFactory& factory)
+    {
+        auto& connector = connectors.emplace_back(*this, factory);
+        Watch(connector.connectSocket, EPOLLOUT, &connector);
+    }
+
+    void EventDispatcherWithNetwork::CancelConnect(ClientConnectionObserverFactory& factory)
+    {
+        for (auto c = connectors.begin(); c != connectors.end(); ++c)
+            if (&c->factory == &factory)
+            {
+                Unwatch(c->connectSocket);
+                connectors.erase(c);
+                return;
+            }
+
+        std::abort();
+    }
+
+    infra::SharedPtr<DatagramExchange> EventDispatcherWithNetwork::Listen(DatagramExchangeObserver& observer, uint16_t port, IPVersions versions)
+    {
+        assert(versions != IPVersions::ipv6);
+        auto result = infra::MakeSharedOnHeap<DatagramBsd>(port, observer);
+        RegisterDatagram(result);
+        return result;
+    }
+
+    infra::SharedPtr<DatagramExchange> EventDispatcherWithNetwork::Listen(DatagramExchangeObserver& observer, IPVersions versions)
+    {
+        assert(versions != IPVersions::ipv6);
+        auto result = infra::MakeSharedOnHeap<DatagramBsd>(observer);
+        RegisterDatagram(result);
+        return result;
+    }
+
+    infra::SharedPtr<DatagramExchange> EventDispatcherWithNetwork::Connect(DatagramExchangeObserver& observer, UdpSocket remote)
+    {
+        auto result = infra::MakeSharedOnHeap<DatagramBsd>(remote, observer);
+        RegisterDatagram(result);
+        return result;
+    }
+
+    infra::SharedPtr<DatagramExchange> EventDispatcherWithNetwork::Connect(DatagramExchangeObserver& observer, uint16_t localPort, UdpSocket remote)
+    {
+        auto result = infra::MakeSharedOnHeap<DatagramBsd>(localPort, remote, observer);
+        RegisterDatagram(result);
+        return result;
+    }
+
+    void EventDispatcherWithNetwork::JoinMulticastGroup(infra::SharedPtr<DatagramExchange> datagramExchange, IPv4Address multicastAddress)
+    {
+        if (auto datagram = FindDatagram(datagramExchange); datagram != nullptr)
+            datagram->JoinMulticastGroup(multicastAddress);
+    }
+
+    void EventDispatcherWithNetwork::LeaveMulticastGroup(infra::SharedPtr<DatagramExchange> datagramExchange, IPv4Address multicastAddress)
+    {
+        if (auto datagram = FindDatagram(datagramExchange); datagram != nullptr)
+            datagram->LeaveMulticastGroup(multicastAddress);
+    }
+
+    void EventDispatcherWithNetwork::JoinMulticastGroup(infra::SharedPtr<DatagramExchange> datagramExchange, IPv6Address multicastAddress)
+    {
+        std::abort();
+    }
+
+    void EventDispatcherWithNetwork::LeaveMulticastGroup(infra::SharedPtr<DatagramExchange> datagramExchange, IPv6Address multicastAddress)
+    {
+        std::abort();
+    }
+
+    void EventDispatcherWithNetwork::RequestExecution()
+    {
+        uint64_t increment = 1;
+        if (write(wakeUpEvent, &increment, sizeof(increment)) == -1 && errno != EAGAIN)
+            std::abort();
+    }
+
+    void EventDispatcherWithNetwork::Idle()
+    {
+        ProcessChangedConnections();
+        ProcessChangedDatagrams();
+
+        int result = 0;
+        do
+        {
+            result = epoll_wait(epollFileDescriptor, events.data(), static_cast<int>(events.size()), -1);
+        } while (result == -1 && errno == EINTR);
+
+        if (result == -1)
+            std::abort();
+
+        for (int i = 0; i != result; ++i)
+            HandleEvent(events[i]);
+    }
+
+    epoll_event EventDispatcherWithNetwork::MakeEvent(int fileDescriptor, uint32_t events, uint32_t generation)
+    {
+        epoll_event event{};
+        event.events = events;
+        event.data.u64 = (static_cast<uint64_t>(generation) << 32) | static_cast<uint32_t>(fileDescriptor);
+        return event;
+    }
+
+    void EventDispatcherWithNetwork::Watch(int fileDescriptor, uint32_t events, const Owner& owner)
+    {
+        auto generation = nextGeneration++;
+        auto event = MakeEvent(fileDescriptor, events, generation);
+
+        if (events != 0 && epoll_ctl(epollFileDescriptor, EPOLL_CTL_ADD, fileDescriptor, &event) == -1)
+            std::abort();
+
+        auto inserted = registrations.emplace(fileDescriptor, Registration{ owner, events, generation }).second;
+        if (!inserted)
+            std::abort();
+    }
+
+    void EventDispatcherWithNetwork::Unwatch(int fileDescriptor)
+    {
+        auto registration = registrations.find(fileDescriptor);
+        if (registration == registrations.end())
+            return;
+
+        if (registration->second.events != 0 && epoll_ctl(epollFileDescriptor, EPOLL_CTL_DEL, fileDescriptor, nullptr) == -1)
+            std::abort();
+
+        registrations.erase(registration);
+    }
+
+    void EventDispatcherWithNetwork::UpdateEvents(int fileDescriptor, uint32_t events)
+    {
+        auto registration = registrations.find(fileDescriptor);
+        if (registration == registrations.end() || registration->second.events == events)
+            return;
+
+        auto event = MakeEvent(fileDescriptor, events, registration->second.generation);
+
+        int operation = EPOLL_CTL_MOD;
+        if (registration->second.events == 0)
+            operation = EPOLL_CTL_ADD;
+        else if (events == 0)
+            operation = EPOLL_CTL_DEL;
+
+        if (epoll_ctl(epollFileDescriptor, operation, fileDescriptor, &event) == -1)
+            std::abort();
+
+        registration->second.events = events;
+    }
+
+    uint32_t EventDispatcherWithNetwork::RequiredEvents(const ConnectionBsd& connection) const
+    {
+        uint32_t result = 0;
+
+        if (!connection.receiveBuffer.full())
+            result |= EPOLLIN;
+        if (!connection.SendBufferEmpty())
+            result |= EPOLLOUT;
+
+        return result;
+    }
+
+    uint32_t EventDispatcherWithNetwork::RequiredEvents(const DatagramBsd& datagram) const
+    {
+        if (datagram.SendBufferEmpty())
+            return EPOLLIN;
+        else
+            return EPOLLIN | EPOLLOUT;
+    }
+
+    void EventDispatcherWithNetwork::ProcessChangedConnections()
+    {
+        // Connections remove themselves from changedConnections when they are closed, so the remaining entries are all alive
+        while (!changedConnections.empty())
+        {
+            infra::SharedPtr<ConnectionBsd> connection = changedConnections.back()->SharedFromThis();
+            changedConnections.pop_back();
+
+            connection->TrySend();
+
+            if (connection->Connected())
+                UpdateEvents(connection->socket, RequiredEvents(*connection));
+        }
+    }
+
+    void EventDispatcherWithNetwork::ProcessChangedDatagrams()
+    {
+        while (!changedDatagrams.empty())
+        {
+            infra::SharedPtr<DatagramBsd> datagram = changedDatagrams.back()->SharedFromThis();
+            changedDatagrams.pop_back();
+
+            datagram->TrySend();
+            UpdateEvents(datagram->socket, RequiredEvents(*datagram));
+        }
+    }
+
+    void EventDispatcherWithNetwork::HandleEvent(const epoll_event& event)
+    {
+        auto fileDescriptor = static_cast<int>(static_cast<uint32_t>(event.data.u64));
+        auto generation = static_cast<uint32_t>(event.data.u64 >> 32);
+
+        if (fileDescriptor == wakeUpEvent)
+        {
+            ClearWakeUpEvent();
+            return;
+        }
+
+        // An earlier event in the same batch may have closed the socket, after which a new socket reused its file descriptor
+        auto registration = registrations.find(fileDescriptor);
+        if (registration == registrations.end() || registration->second.generation != generation)
+            return;
+
+        // Handlers may modify registrations, so the owner is copied before it is visited
+        auto owner = registration->second.owner;
+
+        const auto visitor = infra::Overloaded{
+            [](ListenerBsd* listener)
+            {
+                listener->Accept();
+            },
+            [this, fileDescriptor, &event](ConnectorBsd* connector)
+            {
+                // The connected socket is handed over to a ConnectionBsd, which registers it again
+                Unwatch(fileDescriptor);
+
+                if ((event.events & (EPOLLERR | EPOLLHUP)) != 0)
+                    connector->Failed();
+                else
+                    connector->Connected();
+            },
+            [this, &event](ConnectionBsd* connection)
+            {
+                HandleConnectionEvent(*connection->SharedFromThis(), event.events);
+            },
+            [this, &event](DatagramBsd* datagram)
+            {
+                HandleDatagramEvent(*datagram->SharedFromThis(), event.events);
+            },
+        };
+
+        std::visit(visitor, owner);
+    }
+
+    void EventDispatcherWithNetwork::HandleConnectionEvent(ConnectionBsd& connection, uint32_t events)
+    {
+        if ((events & EPOLLERR) != 0)
+        {
+            connection.AbortAndDestroy();
+            return;
+        }
+
+        if ((events & (EPOLLIN | EPOLLHUP)) != 0)
+            connection.Receive();
+
+        if (!connection.Connected())
+            return;
+
+        if ((events & EPOLLHUP) != 0)
+        {
+            // The peer is gone, so only data still held by the kernel remains to be received. While the receive buffer
+            // is full, the socket is taken out of the epoll set, since the hang-up would otherwise be reported continuously
+            UpdateEvents(connection.socket, RequiredEvents(connection) & EPOLLIN);
+            return;
+        }
+
+        if ((events & EPOLLOUT) != 0)
+            connection.Send();
+
+        if (connection.Connected())
+            UpdateEvents(connection.socket, RequiredEvents(connection));
+    }
+
+    void EventDispatcherWithNetwork::HandleDatagramEvent(DatagramBsd& datagram, uint32_t events)
+    {
+        if ((events & EPOLLERR) != 0)
+        {
+            // Errors such as ICMP port unreachable are not fatal for a datagram socket, but are reported until they are read
+            int error = 0;
+            socklen_t errorSize = sizeof(error);
+            getsockopt(datagram.socket, SOL_SOCKET, SO_ERROR, &error, &errorSize);
+        }
+
+        if ((events & EPOLLIN) != 0)
+            datagram.Receive();
+        if ((events & EPOLLOUT) != 0)
+            datagram.TrySend();
+
+        UpdateEvents(datagram.socket, RequiredEvents(datagram));
+    }
+
+    DatagramBsd* EventDispatcherWithNetwork::FindDatagram(const infra::SharedPtr<DatagramExchange>& datagramExchange) const
+    {
+        for (auto& registration : registrations)
+            if (auto datagram = std::get_if<DatagramBsd*>(&registration.second.owner); datagram != nullptr && *datagram == &*datagramExchange)
+                return *datagram;
+
+        return nullptr;
+    }
+
+    void EventDispatcherWithNetwork::ClearWakeUpEvent()
+    {
+        uint64_t count;
+        if (read(wakeUpEvent, &count, sizeof(count)) == -1 && errno != EAGAIN)
+            std::abort();
+    }
+}
@@ -0,0 +1,104 @@
+#ifndef SERVICES_EVENT_DISPATCHER_WITH_NETWORK_EPOLL_HPP
+#define SERVICES_EVENT_DISPATCHER_WITH_NETWORK_EPOLL_HPP
+
+#include "services/network/Multicast.hpp"
+#include "services/network_instantiations/ConnectionBsd.hpp"
+#include "services/network_instantiations/DatagramBsd.hpp"
+#include <array>
+#include <list>
+#include <sys/epoll.h>
+#include <unordered_map>
+#include <variant>
+#include <vector>
+
+namespace services
+{
+    // Drop-in replacement for the select() based EventDispatcherWithNetwork on Linux hosts.
+    // Sockets are registered with epoll once when they are created, and their interest set is
+    // only modified when their send or receive state changes, so that the cost of waiting
+    // does not grow with the number of open sockets. Sockets deregister themselves before they
+    // are closed, so that a reused file descriptor never refers to a stale registration. Each
+    // registration carries a generation in its epoll events, so that events which were reported for
+    // a closed socket in the same epoll_wait batch are not delivered to a socket that reused its file descriptor.
+    class EventDispatcherWithNetwork
+        : public infra::EventDispatcherWithWeakPtr::WithSize<1024>
+        , public ConnectionFactory
+        , public DatagramFactory
+        , public Multicast
+    {
+    public:
+        EventDispatcherWithNetwork();
+        ~EventDispatcherWithNetwork() override;
+
+        void RegisterConnection(const infra::SharedPtr<ConnectionBsd>& connection);
+        void DeregisterConnection(ConnectionBsd& connection);
+        void ConnectionStateChanged(ConnectionBsd& connection);
+        void RegisterListener(ListenerBsd& listener);
+        void DeregisterListener(ListenerBsd& listener);
+        void DeregisterConnector(ConnectorBsd& connector);
+        void RegisterDatagram(const infra::SharedPtr<DatagramBsd>& datagram);
+        void DeregisterDatagram(DatagramBsd& datagram);
+        void DatagramStateChanged(DatagramBsd& datagram);
+
+        bool ConnectionsOpen() const;
+
+    public:
+        // Implementation of ConnectionFactory
+        infra::SharedPtr<void> Listen(uint16_t port, services::ServerConnectionObserverFactory& factory, IPVersions versions) override;
+        void Connect(ClientConnectionObserverFactory& factory) override;
+        void CancelConnect(ClientConnectionObserverFactory& factory) override;
+
+        // Implementation of DatagramFactory
+        infra::SharedPtr<DatagramExchange> Listen(DatagramExchangeObserver& observer, uint16_t port, IPVersions versions = IPVersions::both) override;
+        infra::SharedPtr<DatagramExchange> Listen(DatagramExchangeObserver& observer, IPVersions versions = IPVersions::both) override;
+        infra::SharedPtr<DatagramExchange> Connect(DatagramExchangeObserver& observer, UdpSocket remote) override;
+        infra::SharedPtr<DatagramExchange> Connect(DatagramExchangeObserver& observer, uint16_t localPort, UdpSocket remote) override;
+
+        // Implementation of Multicast
+        void JoinMulticastGroup(infra::SharedPtr<DatagramExchange> datagramExchange, IPv4Address multicastAddress) override;
+        void LeaveMulticastGroup(infra::SharedPtr<DatagramExchange> datagramExchange, IPv4Address multicastAddress) override;
+        void JoinMulticastGroup(infra::SharedPtr<DatagramExchange> datagramExchange, IPv6Address multicastAddress) override;
+        void LeaveMulticastGroup(infra::SharedPtr<DatagramExchange> datagramExchange, IPv6Address multicastAddress) override;
+
+    protected:
+        void RequestExecution() override;
+        void Idle() override;
+
+    private:
+        using Owner = std::variant<ListenerBsd*, ConnectorBsd*, ConnectionBsd*, DatagramBsd*>;
+
+        struct Registration
+        {
+            Owner owner;
+            uint32_t events; // When empty, the file descriptor is taken out of the epoll set, so that hang-ups are not reported over and over
+            uint32_t generation;
+        };
+
+        static epoll_event MakeEvent(int fileDescriptor, uint32_t events, uint32_t generation);
+
+        void Watch(int fileDescriptor, uint32_t events, const Owner& owner);
+        void Unwatch(int fileDescriptor);
+        void UpdateEvents(int fileDescriptor, uint32_t events);
+        uint32_t RequiredEvents(const ConnectionBsd& connection) const;
+        uint32_t RequiredEvents(const DatagramBsd& datagram) const;
+        void ProcessChangedConnections();
+        void ProcessChangedDatagrams();
+        void HandleEvent(const epoll_event& event);
+        void HandleConnectionEvent(ConnectionBsd& connection, uint32_t events);
+        void HandleDatagramEvent(DatagramBsd& datagram, uint32_t events);
+        DatagramBsd* FindDatagram(const infra::SharedPtr<DatagramExchange>& datagramExchange) const;
+        void ClearWakeUpEvent();
+
+    private:
+        int epollFileDescriptor = -1;
+        int wakeUpEvent = -1;
+        std::unordered_map<int, Registration> registrations;
+        uint32_t nextGeneration = 0;
+        std::list<ConnectorBsd> connectors;
+        std::vector<ConnectionBsd*> changedConnections;
+        std::vector<DatagramBsd*> changedDatagrams;
+        std::array<epoll_event, 64> events;
+    };
+}
+
+#endif
@@ -8,7 +8,9 @@
 #include "services/network_instantiations/EventDispatcherWithNetworkWin.hpp"
 #endif
 
-#ifdef EMIL_NETWORK_BSD
+#ifdef EMIL_NETWORK_EPOLL
+#include "services/network_instantiations/EventDispatcherWithNetworkEpoll.hpp"
+#elif defined(EMIL_NETWORK_BSD)
 #include "services/network_instantiations/EventDispatcherWithNetworkBsd.hpp"
 #endif
 
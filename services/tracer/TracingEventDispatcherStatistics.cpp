@@ -0,0 +1,35 @@
+#include "services/tracer/TracingEventDispatcherStatistics.hpp"
+#include <cstdint>
+
+namespace services
+{
+    TracingEventDispatcherStatistics::TracingEventDispatcherStatistics(const infra::EventDispatcherHistogramCollector& collector, services::Tracer& tracer)
+        : collector(collector)
+        , tracer(tracer)
+    {}
+
+    void TracingEventDispatcherStatistics::Trace()
+    {
+        TraceHistogram("latency", collector.Latencies());
+        TraceHistogram("duration", collector.Durations());
+
+        for (auto& source : collector.Sources())
+            tracer.Trace() << "Source 0x" << infra::hex << reinterpret_cast<uintptr_t>(source.source) << infra::dec
+                           << " executions " << source.executions
+                           << " total " << source.totalDuration
+                           << " max " << source.maxDuration
+                           << " max latency " << source.maxLatency;
+
+        if (collector.UntrackedExecutions() != 0)
+            tracer.Trace() << "Untracked executions " << collector.UntrackedExecutions();
+    }
+
+    void TracingEventDispatcherStatistics::TraceHistogram(const char* name, const infra::EventDispatcherHistogramCollector::Histogram& histogram)
+    {
+        tracer.Trace() << "Event dispatcher " << name << ":";
+
+        for (std::size_t bucket = 0; bucket != histogram.size(); ++bucket)
+            if (histogram[bucket] != 0)
+                tracer.Continue() << " " << bucket << ":" << histogram[bucket];
+    }
+}
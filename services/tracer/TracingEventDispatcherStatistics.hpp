@@ -0,0 +1,27 @@
+#ifndef SERVICES_TRACING_EVENT_DISPATCHER_STATISTICS_HPP
+#define SERVICES_TRACING_EVENT_DISPATCHER_STATISTICS_HPP
+
+#include "infra/event/EventDispatcherHistogramCollector.hpp"
+#include "services/tracer/Tracer.hpp"
+
+namespace services
+{
+    // Traces the histograms and per-source statistics of an EventDispatcherHistogramCollector. Histograms are traced
+    // as bucket:count pairs for non-empty buckets, sources are traced as addresses to be looked up in the linker map.
+    class TracingEventDispatcherStatistics
+    {
+    public:
+        TracingEventDispatcherStatistics(const infra::EventDispatcherHistogramCollector& collector, services::Tracer& tracer);
+
+        void Trace();
+
+    private:
+        void TraceHistogram(const char* name, const infra::EventDispatcherHistogramCollector::Histogram& histogram);
+
+    private:
+        const infra::EventDispatcherHistogramCollector& collector;
+        services::Tracer& tracer;
+    };
+}
+
+#endif
@@ -0,0 +1,60 @@
+#include "infra/stream/StringOutputStream.hpp"
+#include "services/tracer/TracingEventDispatcherStatistics.hpp"
+#include "gmock/gmock.h"
+
+class TracingEventDispatcherStatisticsTest
+    : public testing::Test
+{
+public:
+    void Execute(const void* source, uint32_t latency, uint32_t duration)
+    {
+        collector.Scheduled(0, source);
+        time += latency;
+        collector.Started(0, source);
+        time += duration;
+        collector.Finished(0, source);
+    }
+
+    uint32_t time = 0;
+    infra::EventDispatcherHistogramCollector::WithSize<1, 1> collector{ [this]()
+        {
+            return time;
+        } };
+    infra::StringOutputStream::WithStorage<256> stream;
+    services::TracerToStream tracer{ stream };
+    services::TracingEventDispatcherStatistics statistics{ collector, tracer };
+};
+
+TEST_F(TracingEventDispatcherStatisticsTest, traces_empty_histograms)
+{
+    statistics.Trace();
+
+    EXPECT_EQ("\r\nEvent dispatcher latency:\r\nEvent dispatcher duration:", stream.Storage());
+}
+
+TEST_F(TracingEventDispatcherStatisticsTest, traces_histograms_and_sources)
+{
+    Execute(reinterpret_cast<const void*>(0x1234), 1, 4);
+    Execute(reinterpret_cast<const void*>(0x1234), 2, 4);
+    Execute(reinterpret_cast<const void*>(0x5678), 0, 0);
+
+    statistics.Trace();
+
+    EXPECT_EQ("\r\nEvent dispatcher latency: 0:1 1:1 2:1"
+              "\r\nEvent dispatcher duration: 0:1 3:2"
+              "\r\nSource 0x1234 executions 2 total 8 max 4 max latency 2"
+              "\r\nUntracked executions 1",
+        stream.Storage());
+}
+
+TEST_F(TracingEventDispatcherStatisticsTest, traces_source_statistics_in_decimal)
+{
+    Execute(reinterpret_cast<const void*>(0x1234), 20, 100);
+
+    statistics.Trace();
+
+    EXPECT_EQ("\r\nEvent dispatcher latency: 5:1"
+              "\r\nEvent dispatcher duration: 7:1"
+              "\r\nSource 0x1234 executions 1 total 100 max 100 max latency 20",
+        stream.Storage());
+}
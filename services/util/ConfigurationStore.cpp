@@ -1,8 +1,152 @@
 #include "services/util/ConfigurationStore.hpp"
+#include "infra/event/EventDispatcher.hpp"
 #include <algorithm>
 
 namespace services
 {
+    namespace
+    {
+        struct ProtoEntry
+        {
+            uint32_t fieldNumber;
+            infra::ConstByteRange bytes;
+        };
+
+        std::optional<uint64_t> ExtractVarInt(infra::ConstByteRange& range)
+        {
+            uint64_t result = 0;
+
+            for (uint32_t shift = 0; !range.empty() && shift < 64; shift += 7)
+            {
+                uint8_t byte = range.front();
+                range.pop_front();
+                result |= static_cast<uint64_t>(byte & 0x7f) << shift;
+
+                if ((byte & 0x80) == 0)
+                    return result;
+            }
+
+            return std::nullopt;
+        }
+
+        // Extracts one top-level field, including its key, from a serialized message
+        std::optional<ProtoEntry> ExtractEntry(infra::ConstByteRange& range)
+        {
+            auto start = range.begin();
+            auto key = ExtractVarInt(range);
+            if (key == std::nullopt)
+                return std::nullopt;
+
+            std::size_t size = 0;
+            switch (*key & 7)
+            {
+                case 0:
+                    if (ExtractVarInt(range) == std::nullopt)
+                        return std::nullopt;
+                    break;
+                case 1:
+                    size = 8;
+                    break;
+                case 2:
+                {
+                    auto length = ExtractVarInt(range);
+                    if (length == std::nullopt)
+                        return std::nullopt;
+                    size = static_cast<std::size_t>(*length);
+                    break;
+                }
+                case 5:
+                    size = 4;
+                    break;
+                default:
+                    return std::nullopt;
+            }
+
+            if (size > range.size())
+                return std::nullopt;
+
+            range.pop_front(size);
+            return ProtoEntry{ static_cast<uint32_t>(*key >> 3), infra::ConstByteRange(start, range.begin()) };
+        }
+
+        bool IsWellFormed(infra::ConstByteRange message)
+        {
+            while (!message.empty())
+                if (ExtractEntry(message) == std::nullopt)
+                    return false;
+
+            return true;
+        }
+
+        bool ContainsField(infra::ConstByteRange message, uint32_t fieldNumber)
+        {
+            while (!message.empty())
+                if (ExtractEntry(message)->fieldNumber == fieldNumber)
+                    return true;
+
+            return false;
+        }
+
+        bool FieldsEqual(infra::ConstByteRange first, infra::ConstByteRange second, uint32_t fieldNumber)
+        {
+            while (true)
+            {
+                std::optional<ProtoEntry> firstEntry;
+                while (!first.empty() && (firstEntry = ExtractEntry(first))->fieldNumber != fieldNumber)
+                    firstEntry = std::nullopt;
+
+                std::optional<ProtoEntry> secondEntry;
+                while (!second.empty() && (secondEntry = ExtractEntry(second))->fieldNumber != fieldNumber)
+                    secondEntry = std::nullopt;
+
+                if (firstEntry == std::nullopt || secondEntry == std::nullopt)
+                    return firstEntry == std::nullopt && secondEntry == std::nullopt;
+
+                if (!infra::ContentsEqual(firstEntry->bytes, secondEntry->bytes))
+                    return false;
+            }
+        }
+
+        // fieldNumbers is a sequence of varints, as found in the header of a delta
+        bool ContainsFieldNumber(infra::ConstByteRange fieldNumbers, uint32_t fieldNumber)
+        {
+            while (!fieldNumbers.empty())
+                if (*ExtractVarInt(fieldNumbers) == fieldNumber)
+                    return true;
+
+            return false;
+        }
+
+        bool FirstOccurrence(infra::ConstByteRange message, const uint8_t* position, uint32_t fieldNumber)
+        {
+            return !ContainsField(infra::ConstByteRange(message.begin(), position), fieldNumber);
+        }
+
+        // Invokes onChanged once for each field number of which the entries differ between previous and contents
+        template<class F>
+        void ForEachChangedField(infra::ConstByteRange previous, infra::ConstByteRange contents, F onChanged)
+        {
+            for (auto remaining = contents; !remaining.empty();)
+            {
+                auto entry = *ExtractEntry(remaining);
+                if (FirstOccurrence(contents, entry.bytes.begin(), entry.fieldNumber) && !FieldsEqual(previous, contents, entry.fieldNumber))
+                    onChanged(entry.fieldNumber);
+            }
+
+            for (auto remaining = previous; !remaining.empty();)
+            {
+                auto entry = *ExtractEntry(remaining);
+                if (FirstOccurrence(previous, entry.bytes.begin(), entry.fieldNumber) && !ContainsField(contents, entry.fieldNumber))
+                    onChanged(entry.fieldNumber);
+            }
+        }
+    }
+
+    bool ConfigurationBlob::WriteDelta(infra::ConstByteRange contents, const infra::Function<void()>& onDone)
+    {
+        return false;
+    }
+
     ConfigurationBlobFlash::ConfigurationBlobFlash(infra::ByteRange blob, infra::ByteRange verificationBuffer, hal::Flash& flash, services::Sha256& sha256)
         : blob(blob)
         , verificationBuffer(verificationBuffer)
@@ -44,7 +188,10 @@ namespace services
         PrepareBlobForWriting();
         flash.WriteBuffer(blob, 0, [this]()
             {
-                Verify();
+                Verify(blob, 0, [this]()
+                    {
+                        this->onDone();
+                    });
             });
     }
 
@@ -79,52 +226,68 @@ namespace services
         currentSize = header.size;
     }
 
-    bool ConfigurationBlobFlash::BlobIsValid() const
+    bool ConfigurationBlobFlash::HashIsValid(infra::ConstByteRange data) const
     {
         Header header;
-        infra::Copy(infra::Head(blob, sizeof(header)), infra::MakeByteRange(header));
+        infra::Copy(infra::Head(data, sizeof(header)), infra::MakeByteRange(header));
 
-        if (header.size + sizeof(Header) > blob.size())
+        if (header.size + sizeof(Header) > data.size())
             return false;
 
-        auto input = infra::Head(infra::DiscardHead(blob, sizeof(header.hash)), header.size + sizeof(Header::size));
+        auto input = infra::Head(infra::DiscardHead(data, sizeof(header.hash)), header.size + sizeof(Header::size));
         auto messageHash = sha256.Calculate(input);
 
         return infra::Head(infra::MakeRange(messageHash), sizeof(header.hash)) == header.hash;
     }
 
-    void ConfigurationBlobFlash::PrepareBlobForWriting()
+    void ConfigurationBlobFlash::AddHash(infra::ByteRange data) const
     {
         Header header;
-        header.size = currentSize;
-        infra::Copy(infra::MakeByteRange(header), infra::Head(blob, sizeof(header)));
+        infra::Copy(infra::Head(data, sizeof(header)), infra::MakeByteRange(header));
 
-        auto input = infra::Head(infra::DiscardHead(blob, sizeof(header.hash)), currentSize + sizeof(header.size));
+        auto input = infra::Head(infra::DiscardHead(data, sizeof(header.hash)), header.size + sizeof(header.size));
         auto messageHash = sha256.Calculate(input);
 
         infra::Copy(infra::Head(infra::MakeRange(messageHash), sizeof(header.hash)), infra::MakeRange(header.hash));
-        infra::Copy(infra::MakeByteRange(header), infra::Head(blob, sizeof(header)));
+        infra::Copy(infra::MakeByteRange(header), infra::Head(data, sizeof(header)));
     }
 
-    void ConfigurationBlobFlash::Verify()
+    void ConfigurationBlobFlash::Verify(infra::ConstByteRange data, uint32_t address, const infra::Function<void()>& onVerified)
     {
+        verificationData = data;
+        verificationAddress = address;
         currentVerificationIndex = 0;
+        this->onVerified = onVerified;
 
         VerifyBlock();
     }
 
+    bool ConfigurationBlobFlash::BlobIsValid() const
+    {
+        return HashIsValid(blob);
+    }
+
+    void ConfigurationBlobFlash::PrepareBlobForWriting()
+    {
+        Header header;
+        header.size = currentSize;
+        infra::Copy(infra::MakeByteRange(header), infra::Head(blob, sizeof(header)));
+
+        AddHash(blob);
+    }
+
     void ConfigurationBlobFlash::VerifyBlock()
     {
-        if (currentVerificationIndex != blob.size())
-            flash.ReadBuffer(infra::Head(verificationBuffer, blob.size() - currentVerificationIndex), currentVerificationIndex, [this]()
+        if (currentVerificationIndex != verificationData.size())
+            flash.ReadBuffer(infra::Head(verificationBuffer, verificationData.size() - currentVerificationIndex), verificationAddress + currentVerificationIndex, [this]()
                 {
-                    auto verificationBlock = infra::Head(verificationBuffer, blob.size() - currentVerificationIndex);
-                    really_assert(infra::ContentsEqual(verificationBlock, infra::Head(infra::DiscardHead(blob, currentVerificationIndex), verificationBuffer.size())));
+                    auto verificationBlock = infra::Head(verificationBuffer, verificationData.size() - currentVerificationIndex);
+                    really_assert(infra::ContentsEqual(verificationBlock, infra::Head(infra::DiscardHead(verificationData, currentVerificationIndex), verificationBuffer.size())));
                     currentVerificationIndex += verificationBlock.size();
                     VerifyBlock();
                 });
         else
-            onDone();
+            onVerified();
     }
 
     void ConfigurationBlobFlash::VerifyIfIsErased()
@@ -149,6 +312,258 @@ namespace services
             onErased(true);
     }
 
+    ConfigurationBlobFlashWithDeltas::ConfigurationBlobFlashWithDeltas(infra::ByteRange blob, infra::ByteRange verificationBuffer, infra::ByteRange shadow, infra::ByteRange deltaBuffer, hal::Flash& flash, services::Sha256& sha256)
+        : ConfigurationBlobFlash(blob, verificationBuffer, flash, sha256)
+        , shadow(shadow)
+        , deltaBuffer(deltaBuffer)
+    {
+        really_assert(shadow.size() == MaxBlob().size());
+        really_assert(deltaBuffer.size() > sizeof(Header));
+    }
+
+    void ConfigurationBlobFlashWithDeltas::Recover(const infra::Function<void(bool success)>& onRecovered)
+    {
+        this->onRecovered = onRecovered;
+        deltasAllowed = false;
+
+        ConfigurationBlobFlash::Recover([this](bool success)
+            {
+                if (success)
+                {
+                    deltaAddress = blob.size();
+                    deltasAllowed = true;
+                    RecoverDelta();
+                }
+                else
+                    this->onRecovered(false);
+            });
+    }
+
+    void ConfigurationBlobFlashWithDeltas::Write(uint32_t size, const infra::Function<void()>& onDone)
+    {
+        onWritten = onDone;
+
+        ConfigurationBlobFlash::Write(size, [this]()
+            {
+                deltaAddress = blob.size();
+                deltasAllowed = true;
+                UpdateShadow();
+                onWritten();
+            });
+    }
+
+    void ConfigurationBlobFlashWithDeltas::Erase(const infra::Function<void()>& onDone)
+    {
+        deltasAllowed = false;
+        ConfigurationBlobFlash::Erase(onDone);
+    }
+
+    bool ConfigurationBlobFlashWithDeltas::WriteDelta(infra::ConstByteRange contents, const infra::Function<void()>& onDone)
+    {
+        if (!deltasAllowed || contents.size() > MaxBlob().size() || !IsWellFormed(contents) || !IsWellFormed(infra::Head(shadow, currentSize)))
+            return false;
+
+        auto size = FormatDelta(infra::Head(shadow, currentSize), contents);
+        if (size == std::nullopt || deltaAddress + sizeof(Header) + *size > flash.TotalSize())
+            return false;
+
+        onWritten = onDone;
+
+        if (MaxBlob().begin() != contents.begin())
+            infra::Copy(contents, infra::Head(MaxBlob(), contents.size()));
+        currentSize = contents.size();
+
+        // An empty delta means that no field changed, so the flash already holds the configuration
+        if (*size == 0)
+        {
+            UpdateShadow();
+            infra::EventDispatcher::Instance().Schedule([this]()
+                {
+                    onWritten();
+                });
+            return true;
+        }
+
+        auto recordSize = static_cast<uint32_t>(sizeof(Header) + *size);
+        flash.WriteBuffer(infra::Head(deltaBuffer, recordSize), deltaAddress, [this, recordSize]()
+            {
+                Verify(infra::Head(deltaBuffer, recordSize), deltaAddress, [this, recordSize]()
+                    {
+                        deltaAddress += recordSize;
+                        UpdateShadow();
+                        onWritten();
+                    });
+            });
+
+        return true;
+    }
+
+    infra::ByteRange ConfigurationBlobFlashWithDeltas::Shadow()
+    {
+        return shadow;
+    }
+
+    infra::ByteRange ConfigurationBlobFlashWithDeltas::DeltaBuffer()
+    {
+        return deltaBuffer;
+    }
+
+    void ConfigurationBlobFlashWithDeltas::RecoverDelta()
+    {
+        if (deltaAddress + sizeof(Header) > flash.TotalSize())
+        {
+            deltasAllowed = false;
+            RecoverDone();
+            return;
+        }
+
+        flash.ReadBuffer(infra::Head(deltaBuffer, sizeof(Header)), deltaAddress, [this]()
+            {
+                auto header = infra::Head(deltaBuffer, sizeof(Header));
+
+                if (std::all_of(header.begin(), header.end(), [](uint8_t byte)
+                        {
+                            return byte == 0xff;
+                        }))
+                {
+                    RecoverDone();
+                    return;
+                }
+
+                Header recordHeader;
+                infra::Copy(header, infra::MakeByteRange(recordHeader));
+
+                if (recordHeader.size > deltaBuffer.size() - sizeof(Header) || deltaAddress + sizeof(Header) + recordHeader.size > flash.TotalSize())
+                {
+                    deltasAllowed = false;
+                    RecoverDone();
+                }
+                else
+                    RecoverDeltaPayload(recordHeader.size);
+            });
+    }
+
+    void ConfigurationBlobFlashWithDeltas::RecoverDeltaPayload(uint32_t size)
+    {
+        flash.ReadBuffer(infra::Head(infra::DiscardHead(deltaBuffer, sizeof(Header)), size), deltaAddress + sizeof(Header), [this, size]()
+            {
+                auto record = infra::Head(deltaBuffer, sizeof(Header) + size);
+
+                // An incomplete delta is the result of an interrupted write; nothing can be appended after it anymore
+                if (!HashIsValid(record) || !ApplyDelta(infra::DiscardHead(record, sizeof(Header))))
+                {
+                    deltasAllowed = false;
+                    RecoverDone();
+                }
+                else
+                {
+                    deltaAddress += record.size();
+                    RecoverDelta();
+                }
+            });
+    }
+
+    void ConfigurationBlobFlashWithDeltas::RecoverDone()
+    {
+        UpdateShadow();
+        onRecovered(true);
+    }
+
+    bool ConfigurationBlobFlashWithDeltas::ApplyDelta(infra::ConstByteRange payload)
+    {
+        auto numberOfFields = ExtractVarInt(payload);
+        if (numberOfFields == std::nullopt || *numberOfFields > payload.size())
+            return false;
+
+        auto fieldNumbers = payload;
+        for (uint64_t i = 0; i != *numberOfFields; ++i)
+            if (ExtractVarInt(payload) == std::nullopt)
+                return false;
+        fieldNumbers = infra::ConstByteRange(fieldNumbers.begin(), payload.begin());
+
+        infra::ConstByteRange current = infra::Head(MaxBlob(), currentSize);
+        if (!IsWellFormed(payload) || !IsWellFormed(current))
+            return false;
+
+        std::size_t keptSize = 0;
+        for (auto remaining = current; !remaining.empty();)
+        {
+            auto entry = *ExtractEntry(remaining);
+            if (!ContainsFieldNumber(fieldNumbers, entry.fieldNumber))
+                keptSize += entry.bytes.size();
+        }
+
+        if (keptSize + payload.size() > MaxBlob().size())
+            return false;
+
+        auto target = MaxBlob().begin();
+        for (auto remaining = current; !remaining.empty();)
+        {
+            auto entry = *ExtractEntry(remaining);
+            if (!ContainsFieldNumber(fieldNumbers, entry.fieldNumber))
+                target = std::copy(entry.bytes.begin(), entry.bytes.end(), target);
+        }
+
+        target = std::copy(payload.begin(), payload.end(), target);
+        currentSize = static_cast<uint32_t>(target - MaxBlob().begin());
+
+        return true;
+    }
+
+    std::optional<uint32_t> ConfigurationBlobFlashWithDeltas::FormatDelta(infra::ConstByteRange previous, infra::ConstByteRange contents)
+    {
+        // Payload: the number of replaced fields, their field numbers, and then all new entries of those fields.
+        // The changed fields are determined in a single pass: their numbers are formatted behind room for the largest
+        // count, and moved forward once the count is known.
+        static constexpr std::size_t maxCountSize = 5;
+        auto payload = infra::DiscardHead(deltaBuffer, sizeof(Header));
+
+        infra::ByteOutputStream fieldNumbersStream(infra::DiscardHead(payload, std::min(maxCountSize, payload.size())), infra::softFail);
+        infra::ProtoFormatter fieldNumbersFormatter(fieldNumbersStream);
+
+        uint32_t numberOfFields = 0;
+        ForEachChangedField(previous, contents, [&numberOfFields, &fieldNumbersFormatter](uint32_t fieldNumber)
+            {
+                ++numberOfFields;
+                fieldNumbersFormatter.PutVarInt(fieldNumber);
+            });
+
+        if (numberOfFields == 0)
+            return 0;
+        if (fieldNumbersStream.Failed())
+            return std::nullopt;
+
+        infra::ConstByteRange fieldNumbers = fieldNumbersStream.Writer().Processed();
+        infra::ByteOutputStream stream(payload, infra::softFail);
+        infra::ProtoFormatter formatter(stream);
+        formatter.PutVarInt(numberOfFields);
+        auto countSize = stream.Writer().Processed().size();
+        stream << fieldNumbers;
+        fieldNumbers = infra::Head(infra::DiscardHead(payload, countSize), fieldNumbers.size());
+
+        for (auto remaining = contents; !remaining.empty();)
+        {
+            auto entry = *ExtractEntry(remaining);
+            if (ContainsFieldNumber(fieldNumbers, entry.fieldNumber))
+                stream << entry.bytes;
+        }
+
+        if (stream.Failed())
+            return std::nullopt;
+
+        Header header;
+        header.size = stream.Writer().Processed().size();
+        infra::Copy(infra::MakeByteRange(header), infra::Head(deltaBuffer, sizeof(header)));
+        AddHash(deltaBuffer);
+
+        return header.size;
+    }
+
+    void ConfigurationBlobFlashWithDeltas::UpdateShadow()
+    {
+        infra::Copy(CurrentBlob(), infra::Head(shadow, currentSize));
+    }
+
     ConfigurationBlobReadOnlyMemory::ConfigurationBlobReadOnlyMemory(infra::ConstByteRange data)
         : data(data)
     {}
@@ -245,16 +660,27 @@ namespace services
             ++operationId;
             writeRequested = false;
             writingBlob = true;
-            Serialize(*activeBlob, [this, thisId]()
+            Serialize(writeTarget, [this, thisId]()
                 {
-                    inactiveBlob->Erase([this, thisId]()
-                        {
-                            BlobWriteDone();
-                            NotifyObservers([thisId](ConfigurationStoreObserver& observer)
-                                {
-                                    observer.OperationDone(thisId);
-                                });
-                        });
+                    if (writeTarget.WroteDelta())
+                    {
+                        BlobWriteDone();
+                        NotifyObservers([thisId](ConfigurationStoreObserver& observer)
+                            {
+                                observer.OperationDone(thisId);
+                            });
+                    }
+                    else
+                        inactiveBlob->Erase([this, thisId]()
+                            {
+                                std::swap(activeBlob, inactiveBlob);
+                                inactiveBlobIsCurrent = true;
+                                BlobWriteDone();
+                                NotifyObservers([thisId](ConfigurationStoreObserver& observer)
+                                    {
+                                        observer.OperationDone(thisId);
+                                    });
+                            });
                 });
         }
 
@@ -265,6 +691,7 @@ namespace services
     {
         uint32_t thisId = operationId;
         ++operationId;
+        inactiveBlobIsCurrent = false;
 
         inactiveBlob->Erase([this, thisId]()
             {
@@ -328,6 +755,7 @@ namespace services
     void ConfigurationStoreBase::OnBlobLoaded(bool success)
     {
         std::swap(activeBlob, inactiveBlob);
+        inactiveBlobIsCurrent = success;
 
         if (success)
             Deserialize(*inactiveBlob);
@@ -337,12 +765,54 @@ namespace services
 
     void ConfigurationStoreBase::BlobWriteDone()
     {
-        std::swap(activeBlob, inactiveBlob);
         writingBlob = false;
         if (writeRequested)
             Write();
     }
 
+    ConfigurationStoreBase::WriteTarget::WriteTarget(ConfigurationStoreBase& store)
+        : store(store)
+    {}
+
+    bool ConfigurationStoreBase::WriteTarget::WroteDelta() const
+    {
+        return wroteDelta;
+    }
+
+    infra::ConstByteRange ConfigurationStoreBase::WriteTarget::CurrentBlob()
+    {
+        return store.activeBlob->CurrentBlob();
+    }
+
+    infra::ByteRange ConfigurationStoreBase::WriteTarget::MaxBlob()
+    {
+        maxBlob = store.activeBlob->MaxBlob();
+        return maxBlob;
+    }
+
+    void ConfigurationStoreBase::WriteTarget::Recover(const infra::Function<void(bool success)>& onRecovered)
+    {
+        std::abort();
+    }
+
+    void ConfigurationStoreBase::WriteTarget::Write(uint32_t size, const infra::Function<void()>& onDone)
+    {
+        wroteDelta = store.inactiveBlobIsCurrent && store.inactiveBlob->WriteDelta(infra::Head(maxBlob, size), onDone);
+
+        if (!wroteDelta)
+            store.activeBlob->Write(size, onDone);
+    }
+
+    void ConfigurationStoreBase::WriteTarget::Erase(const infra::Function<void()>& onDone)
+    {
+        std::abort();
+    }
+
+    void ConfigurationStoreBase::WriteTarget::IsErased(const infra::Function<void(bool)>& onDone)
+    {
+        std::abort();
+    }
+
     FactoryDefaultConfigurationStoreBase::FactoryDefaultConfigurationStoreBase(ConfigurationStoreBase& configurationStore, ConfigurationBlob& factoryDefaultBlob)
         : configurationStore(configurationStore)
         , factoryDefaultBlob(factoryDefaultBlob)
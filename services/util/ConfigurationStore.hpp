@@ -12,6 +12,7 @@
 #include "infra/util/ReallyAssert.hpp"
 #include "infra/util/WithStorage.hpp"
 #include "services/util/Sha256.hpp"
+#include <optional>
 
 namespace services
 {
@@ -30,12 +31,16 @@ namespace services
         virtual void Write(uint32_t size, const infra::Function<void()>& onDone) = 0;
         virtual void Erase(const infra::Function<void()>& onDone) = 0;
         virtual void IsErased(const infra::Function<void(bool)>& onDone) = 0;
+
+        // Stores contents, the complete new configuration, as a delta on top of the configuration currently held by this blob.
+        // Returns false without writing anything when deltas are not supported or when the delta does not fit.
+        virtual bool WriteDelta(infra::ConstByteRange contents, const infra::Function<void()>& onDone);
     };
 
     class ConfigurationBlobFlash
         : public ConfigurationBlob
     {
-    private:
+    protected:
         struct Header
         {
             std::array<uint8_t, 8> hash;
@@ -60,26 +65,80 @@ namespace services
         infra::ByteRange Blob();
         infra::ByteRange VerificationBuffer();
 
+    protected:
+        bool HashIsValid(infra::ConstByteRange data) const;
+        void AddHash(infra::ByteRange data) const;
+        void Verify(infra::ConstByteRange data, uint32_t address, const infra::Function<void()>& onVerified);
+
     private:
         void RecoverCurrentSize();
         bool BlobIsValid() const;
         void PrepareBlobForWriting();
-        void Verify();
         void VerifyBlock();
         void VerifyIfIsErased();
 
-    private:
+    protected:
         infra::ByteRange blob;
         infra::ByteRange verificationBuffer;
         hal::Flash& flash;
         services::Sha256& sha256;
         uint32_t currentSize = 0;
+
+    private:
         uint32_t currentVerificationIndex = 0;
+        infra::ConstByteRange verificationData;
+        uint32_t verificationAddress = 0;
         infra::AutoResetFunction<void(bool success)> onRecovered;
         infra::AutoResetFunction<void()> onDone;
+        infra::AutoResetFunction<void()> onVerified;
         infra::AutoResetFunction<void(bool success)> onErased;
     };
 
+    // ConfigurationBlobFlashWithDeltas stores a full snapshot like ConfigurationBlobFlash, and behind it a sequence of deltas.
+    // A delta holds the top-level fields of the serialized configuration that changed since the previous write, so that
+    // changing a single setting results in a small append instead of writing the complete configuration, and writing an
+    // unchanged configuration does not touch the flash at all. When the flash is full, or when the delta does not fit in
+    // the delta buffer, WriteDelta returns false, upon which the configuration store writes a full snapshot into its other
+    // blob. The flash must therefore be larger than the blob to benefit.
+    // Blobs with deltas of one configuration store may share all their buffers.
+    class ConfigurationBlobFlashWithDeltas
+        : public ConfigurationBlobFlash
+    {
+    public:
+        template<std::size_t Size, std::size_t DeltaSize = 64, std::size_t VerificationSize = 256>
+        using WithStorage = infra::WithStorage<infra::WithStorage<infra::WithStorage<infra::WithStorage<ConfigurationBlobFlashWithDeltas,
+                                                                                         std::array<uint8_t, Size + sizeof(Header)>>,
+                                                                      std::array<uint8_t, VerificationSize>>,
+                                                   std::array<uint8_t, Size>>,
+            std::array<uint8_t, DeltaSize + sizeof(Header)>>;
+
+        ConfigurationBlobFlashWithDeltas(infra::ByteRange blob, infra::ByteRange verificationBuffer, infra::ByteRange shadow, infra::ByteRange deltaBuffer, hal::Flash& flash, services::Sha256& sha256);
+
+        void Recover(const infra::Function<void(bool success)>& onRecovered) override;
+        void Write(uint32_t size, const infra::Function<void()>& onDone) override;
+        void Erase(const infra::Function<void()>& onDone) override;
+        bool WriteDelta(infra::ConstByteRange contents, const infra::Function<void()>& onDone) override;
+
+        infra::ByteRange Shadow();
+        infra::ByteRange DeltaBuffer();
+
+    private:
+        void RecoverDelta();
+        void RecoverDeltaPayload(uint32_t size);
+        void RecoverDone();
+        bool ApplyDelta(infra::ConstByteRange payload);
+        std::optional<uint32_t> FormatDelta(infra::ConstByteRange previous, infra::ConstByteRange contents);
+        void UpdateShadow();
+
+    private:
+        infra::ByteRange shadow;
+        infra::ByteRange deltaBuffer;
+        uint32_t deltaAddress = 0;
+        bool deltasAllowed = false;
+        infra::AutoResetFunction<void(bool success)> onRecovered;
+        infra::AutoResetFunction<void()> onWritten;
+    };
+
     class ConfigurationBlobReadOnlyMemory
         : public ConfigurationBlob
     {
@@ -207,16 +266,41 @@ namespace services
         void Unlocked() override;
 
     private:
+        // Presented to Serialize on Write. The serialized configuration is first offered as a delta to the blob that
+        // holds the current configuration; only when that blob refuses, it is written as a full snapshot into the other blob.
+        class WriteTarget
+            : public ConfigurationBlob
+        {
+        public:
+            explicit WriteTarget(ConfigurationStoreBase& store);
+
+            bool WroteDelta() const;
+
+            infra::ConstByteRange CurrentBlob() override;
+            infra::ByteRange MaxBlob() override;
+            void Recover(const infra::Function<void(bool success)>& onRecovered) override;
+            void Write(uint32_t size, const infra::Function<void()>& onDone) override;
+            void Erase(const infra::Function<void()>& onDone) override;
+            void IsErased(const infra::Function<void(bool)>& onDone) override;
+
+        private:
+            ConfigurationStoreBase& store;
+            infra::ByteRange maxBlob;
+            bool wroteDelta = false;
+        };
+
         void OnBlobLoaded(bool success);
         void BlobWriteDone();
 
     private:
         ConfigurationBlob* activeBlob;
         ConfigurationBlob* inactiveBlob;
+        WriteTarget writeTarget{ *this };
         infra::AutoResetFunction<void(bool success)> onRecovered;
         uint32_t operationId = 0;
         bool writingBlob = false;
         bool writeRequested = false;
+        bool inactiveBlobIsCurrent = false;
     };
 
     template<class T>
@@ -239,6 +323,8 @@ namespace services
     public:
         template<std::size_t VerificationSize = 256>
         class WithBlobs;
+        template<std::size_t DeltaSize = 64, std::size_t VerificationSize = 256>
+        class WithDeltaBlobs;
 
         ConfigurationStoreImpl(ConfigurationBlob& blob1, ConfigurationBlob& blob2);
 
@@ -268,6 +354,19 @@ namespace services
         ConfigurationBlobFlash blob2;
     };
 
+    template<class T>
+    template<std::size_t DeltaSize, std::size_t VerificationSize>
+    class ConfigurationStoreImpl<T>::WithDeltaBlobs
+        : public ConfigurationStoreImpl<T>
+    {
+    public:
+        WithDeltaBlobs(hal::Flash& flashFirst, hal::Flash& flashSecond, services::Sha256& sha256, const infra::Function<void(bool success)>& onRecovered);
+
+    private:
+        typename ConfigurationBlobFlashWithDeltas::WithStorage<T::maxMessageSize, DeltaSize, VerificationSize> blob1;
+        ConfigurationBlobFlashWithDeltas blob2;
+    };
+
     class FactoryDefaultConfigurationStoreBase
         : public ConfigurationStoreInterface
         , protected ConfigurationStoreObserver
@@ -415,6 +514,16 @@ namespace services
         Recover(onRecovered);
     }
 
+    template<class T>
+    template<std::size_t DeltaSize, std::size_t VerificationSize>
+    ConfigurationStoreImpl<T>::WithDeltaBlobs<DeltaSize, VerificationSize>::WithDeltaBlobs(hal::Flash& flashFirst, hal::Flash& flashSecond, services::Sha256& sha256, const infra::Function<void(bool success)>& onRecovered)
+        : ConfigurationStoreImpl<T>(blob1, blob2)
+        , blob1(flashFirst, sha256)
+        , blob2(blob1.Blob(), blob1.VerificationBuffer(), blob1.Shadow(), blob1.DeltaBuffer(), flashSecond, sha256)
+    {
+        Recover(onRecovered);
+    }
+
     template<class T>
     ConfigurationStoreAccess<T>::ConfigurationStoreAccess(ConfigurationStoreInterface& configurationStore, T& configuration)
         : configurationStore(configurationStore)
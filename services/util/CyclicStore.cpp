@@ -112,6 +112,11 @@ namespace services
         return Iterator(*this);
     }
 
+    uint32_t CyclicStore::LastAddedAddress() const
+    {
+        return lastAddedAddress;
+    }
+
     void CyclicStore::Recover()
     {
         claimerRecover.Claim([this]()
@@ -579,6 +584,7 @@ namespace services
                         {
                             sequencer.Continue();
                         });
+                    lastAddedAddress = endAddress + 3;
                     endAddress += partialSizeWritten + 3;
                     partialSizeWritten = 0;
                     partialAddStarted = false;
@@ -714,6 +720,11 @@ namespace services
             });
     }
 
+    uint32_t CyclicStore::Iterator::AddressOfPrevious() const
+    {
+        return addressPreviousBlockHeader + sizeof(blockHeader);
+    }
+
     void CyclicStore::Iterator::SectorIsErased(uint32_t sectorIndex)
     {
         if (store.flash.SectorOfAddress(address) == sectorIndex)
@@ -735,8 +746,8 @@ namespace services
     {
         sequencer.Execute([this]()
             {
-                if (store.flash.SectorOfAddress(address) != store.flash.SectorOfAddress(address + sizeof(blockHeader) - 1))
-                    UpdateAddress(store.flash.StartOfNextSector(address));
+                if (store.flash.AddressOffsetInSector(address) + sizeof(blockHeader) > store.flash.SizeOfSector(store.flash.SectorOfAddress(address)))
+                    UpdateAddress(store.flash.StartOfNextSectorCyclical(address));
             });
         sequencer.If([this]()
             {
@@ -23,6 +23,8 @@ namespace services
         void ClearUrgent(const infra::Function<void()>& onDone);
 
         Iterator Begin() const;
+        // Flash address of the contents of the block added last, valid from the onDone of the Add that completes the block
+        uint32_t LastAddedAddress() const;
 
     private:
         void AddClaimed(infra::ConstByteRange range);
@@ -89,6 +91,7 @@ namespace services
 
             void Read(infra::ByteRange buffer, const infra::Function<void(infra::ByteRange result)>& onDone);
             void ErasePrevious(const infra::Function<void()>& onDone); // Erase the item that just hase been read
+            uint32_t AddressOfPrevious() const;                      // Flash address of the contents of the item that just has been read
 
             void SectorIsErased(uint32_t sectorIndex);
 
@@ -125,6 +128,7 @@ namespace services
         hal::Flash& flash;
         mutable uint32_t startAddress = 0; // In startAddress the starting point for reading is cached; this is not observable behaviour but a performance optimization. Therefore it is mutable.
         uint32_t endAddress = 0;
+        uint32_t lastAddedAddress = 0;
         uint32_t sanitizeAddress = 0;
         uint32_t endSanitizeSector = 0;
         infra::Sequencer sequencer;
@@ -0,0 +1,182 @@
+#include "services/util/FlashCached.hpp"
+#include "infra/event/EventDispatcher.hpp"
+#include "infra/util/ReallyAssert.hpp"
+#include <algorithm>
+#include <limits>
+
+namespace services
+{
+    FlashCached::FlashCached(infra::MemoryRange<Line> lines, infra::ByteRange data, hal::Flash& flash, uint32_t readAheadLines)
+        : FlashDelegate(flash)
+        , lines(lines)
+        , data(data)
+        , flash(flash)
+        , lineSize(lines.empty() ? 0 : static_cast<uint32_t>(data.size() / lines.size()))
+        , readAheadLines(readAheadLines)
+    {
+        really_assert(lineSize != 0 && data.size() == lineSize * lines.size());
+        really_assert(readAheadLines < lines.size());
+    }
+
+    void FlashCached::WriteBuffer(infra::ConstByteRange buffer, uint32_t address, infra::Function<void()> onDone)
+    {
+        Invalidate(address, address + buffer.size());
+        flash.WriteBuffer(buffer, address, onDone);
+    }
+
+    void FlashCached::ReadBuffer(infra::ByteRange buffer, uint32_t address, infra::Function<void()> onDone)
+    {
+        sequential = address == nextSequentialAddress;
+        nextSequentialAddress = address + buffer.size();
+
+        readBuffer = buffer;
+        readAddress = address;
+        onReadDone = onDone;
+
+        ReadFromCache();
+    }
+
+    void FlashCached::EraseSectors(uint32_t beginIndex, uint32_t endIndex, infra::Function<void()> onDone)
+    {
+        Invalidate(AddressOfSector(beginIndex), AddressOfSector(endIndex));
+        flash.EraseSectors(beginIndex, endIndex, onDone);
+    }
+
+    void FlashCached::Invalidate()
+    {
+        Invalidate(0, std::numeric_limits<uint32_t>::max());
+    }
+
+    FlashCached::Statistics FlashCached::GetStatistics() const
+    {
+        return statistics;
+    }
+
+    void FlashCached::ResetStatistics()
+    {
+        statistics = Statistics{};
+    }
+
+    uint32_t FlashCached::LineAddress(uint32_t address) const
+    {
+        return address - address % lineSize;
+    }
+
+    FlashCached::Line* FlashCached::Find(uint32_t lineAddress)
+    {
+        for (auto& line : lines)
+            if (line.valid && line.address == lineAddress)
+                return &line;
+
+        return nullptr;
+    }
+
+    std::size_t FlashCached::SelectVictims(uint32_t numberOfLines) const
+    {
+        // Lines that are fetched together are stored next to each other, so the consecutive lines
+        // of which the most recently used one is the least recently used are selected
+        std::size_t victim = 0;
+        uint32_t victimLastUse = std::numeric_limits<uint32_t>::max();
+
+        for (std::size_t first = 0; first + numberOfLines <= lines.size(); ++first)
+        {
+            uint32_t lastUse = 0;
+            for (std::size_t i = first; i != first + numberOfLines; ++i)
+                if (lines[i].valid)
+                    lastUse = std::max(lastUse, lines[i].lastUse);
+
+            if (lastUse < victimLastUse)
+            {
+                victim = first;
+                victimLastUse = lastUse;
+            }
+        }
+
+        return victim;
+    }
+
+    void FlashCached::Invalidate(uint32_t begin, uint32_t end)
+    {
+        for (auto& line : lines)
+            if (line.valid && line.address < end && line.address + lineSize > begin)
+            {
+                line.valid = false;
+                ++statistics.invalidations;
+            }
+    }
+
+    void FlashCached::ReadFromCache()
+    {
+        while (!readBuffer.empty())
+        {
+            auto line = Find(LineAddress(readAddress));
+
+            if (line == nullptr)
+            {
+                ++statistics.misses;
+                Fetch();
+                return;
+            }
+
+            ++statistics.hits;
+            CopyFromLine(*line);
+        }
+
+        infra::EventDispatcher::Instance().Schedule([this]()
+            {
+                onReadDone();
+            });
+    }
+
+    void FlashCached::CopyFromLine(Line& line)
+    {
+        line.lastUse = ++useCounter;
+
+        auto lineData = infra::ByteRange(data.begin() + (&line - lines.begin()) * lineSize, data.begin() + (&line - lines.begin() + 1) * lineSize);
+        auto size = std::min<std::size_t>(readBuffer.size(), line.address + lineSize - readAddress);
+        infra::Copy(infra::Head(infra::DiscardHead(lineData, readAddress - line.address), size), infra::Head(readBuffer, size));
+
+        readBuffer.pop_front(size);
+        readAddress += size;
+    }
+
+    void FlashCached::Fetch()
+    {
+        fetchLineAddress = LineAddress(readAddress);
+
+        uint32_t maxLines = 1 + readAheadLines;
+        if (!sequential)
+            maxLines = std::min<uint32_t>(maxLines, (readAddress + readBuffer.size() - fetchLineAddress + lineSize - 1) / lineSize);
+
+        fetchNumberOfLines = 1;
+        while (fetchNumberOfLines != maxLines && fetchLineAddress + fetchNumberOfLines * lineSize < flash.TotalSize() && Find(fetchLineAddress + fetchNumberOfLines * lineSize) == nullptr)
+            ++fetchNumberOfLines;
+
+        fetchFirstLine = SelectVictims(fetchNumberOfLines);
+        for (std::size_t i = fetchFirstLine; i != fetchFirstLine + fetchNumberOfLines; ++i)
+            lines[i].valid = false;
+
+        ++statistics.fetches;
+        statistics.linesFetched += fetchNumberOfLines;
+
+        auto size = std::min<uint32_t>(fetchNumberOfLines * lineSize, flash.TotalSize() - fetchLineAddress);
+        flash.ReadBuffer(infra::Head(infra::DiscardHead(data, fetchFirstLine * lineSize), size), fetchLineAddress, [this]()
+            {
+                FetchDone();
+            });
+    }
+
+    void FlashCached::FetchDone()
+    {
+        for (uint32_t i = 0; i != fetchNumberOfLines; ++i)
+        {
+            auto& line = lines[fetchFirstLine + i];
+            line.address = fetchLineAddress + i * lineSize;
+            line.lastUse = ++useCounter;
+            line.valid = true;
+        }
+
+        CopyFromLine(lines[fetchFirstLine]);
+        ReadFromCache();
+    }
+}
@@ -0,0 +1,87 @@
+#ifndef SERVICES_FLASH_CACHED_HPP
+#define SERVICES_FLASH_CACHED_HPP
+
+#include "hal/interfaces/Flash.hpp"
+#include "infra/util/AutoResetFunction.hpp"
+#include "infra/util/ByteRange.hpp"
+#include "infra/util/WithStorage.hpp"
+#include "services/util/FlashDelegate.hpp"
+#include <array>
+
+namespace services
+{
+    // FlashCached keeps recently read lines of the underlying flash in RAM, so that many small reads of the same
+    // region cost a single read of the underlying flash. Lines are aligned to their size and are replaced least
+    // recently used first. When a read misses while the reads are sequential, or when a read spans several lines,
+    // up to readAheadLines following lines are fetched in the same read of the underlying flash.
+    //
+    // Writes and erases are passed on directly, and invalidate the lines they touch. Changes made to the flash
+    // without passing through FlashCached are not seen until Invalidate is called.
+    class FlashCached
+        : public FlashDelegate
+    {
+    public:
+        struct Line
+        {
+            uint32_t address = 0;
+            uint32_t lastUse = 0;
+            bool valid = false;
+        };
+
+        struct Statistics
+        {
+            uint32_t hits;
+            uint32_t misses;
+            uint32_t fetches;
+            uint32_t linesFetched;
+            uint32_t invalidations;
+        };
+
+        template<std::size_t LineSize, std::size_t NumberOfLines>
+        using WithLines = infra::WithStorage<infra::WithStorage<FlashCached,
+                                                 std::array<Line, NumberOfLines>>,
+            std::array<uint8_t, LineSize * NumberOfLines>>;
+
+        FlashCached(infra::MemoryRange<Line> lines, infra::ByteRange data, hal::Flash& flash, uint32_t readAheadLines = 1);
+
+        void WriteBuffer(infra::ConstByteRange buffer, uint32_t address, infra::Function<void()> onDone) override;
+        void ReadBuffer(infra::ByteRange buffer, uint32_t address, infra::Function<void()> onDone) override;
+        void EraseSectors(uint32_t beginIndex, uint32_t endIndex, infra::Function<void()> onDone) override;
+
+        void Invalidate();
+        Statistics GetStatistics() const;
+        void ResetStatistics();
+
+    private:
+        uint32_t LineAddress(uint32_t address) const;
+        Line* Find(uint32_t lineAddress);
+        std::size_t SelectVictims(uint32_t numberOfLines) const;
+        void Invalidate(uint32_t begin, uint32_t end);
+
+        void ReadFromCache();
+        void CopyFromLine(Line& line);
+        void Fetch();
+        void FetchDone();
+
+    private:
+        infra::MemoryRange<Line> lines;
+        infra::ByteRange data;
+        hal::Flash& flash;
+        uint32_t lineSize;
+        uint32_t readAheadLines;
+        uint32_t useCounter = 0;
+        Statistics statistics{};
+
+        uint32_t nextSequentialAddress = 0;
+        bool sequential = false;
+        infra::ByteRange readBuffer;
+        uint32_t readAddress = 0;
+        infra::AutoResetFunction<void()> onReadDone;
+
+        std::size_t fetchFirstLine = 0;
+        uint32_t fetchLineAddress = 0;
+        uint32_t fetchNumberOfLines = 0;
+    };
+}
+
+#endif
@@ -0,0 +1,374 @@
+#include "services/util/KeyValueStore.hpp"
+#include "infra/util/ReallyAssert.hpp"
+#include <algorithm>
+#include <limits>
+
+namespace services
+{
+    KeyValueStore::KeyValueStore(infra::BoundedVector<IndexEntry>& index, infra::ByteRange recordBuffer, hal::Flash& flash, const infra::Function<void()>& onRecovered)
+        : index(index)
+        , recordBuffer(recordBuffer)
+        , flash(flash)
+        , cyclicStore(this->flash)
+        , oldest(cyclicStore.Begin())
+        , reader(cyclicStore.Begin())
+        , logCapacity(LogCapacity())
+        , claimerRecover(resource)
+        , claimerWrite(resource)
+        , claimerRead(resource)
+        , onRecovered(onRecovered)
+    {
+        really_assert(recordBuffer.size() >= sizeof(RecordHeader) && recordBuffer.size() <= std::numeric_limits<uint16_t>::max());
+        really_assert((index.max_size() + 2) * RecordCost(recordBuffer.size() - sizeof(RecordHeader)) <= logCapacity);
+
+        Recover();
+    }
+
+    bool KeyValueStore::Contains(Key key) const
+    {
+        return Find(key) != index.end();
+    }
+
+    std::optional<std::size_t> KeyValueStore::ValueSize(Key key) const
+    {
+        auto entry = Find(key);
+
+        if (entry == index.end())
+            return std::nullopt;
+
+        return entry->size;
+    }
+
+    KeyValueStore::Statistics KeyValueStore::GetStatistics() const
+    {
+        auto result = statistics;
+
+        result.liveRecords = index.size();
+        result.liveBytes = 0;
+        for (auto& entry : index)
+            result.liveBytes += RecordCost(entry.size);
+        result.supersededRecords = headSequence - tailSequence - index.size();
+        result.logBytes = logBytes;
+        result.logCapacity = logCapacity;
+        result.sectorErases = flash.erases;
+
+        return result;
+    }
+
+    void KeyValueStore::Read(Key key, infra::ByteRange buffer, const infra::Function<void(std::optional<infra::ByteRange> value)>& onDone)
+    {
+        readKey = key;
+        readBuffer = buffer;
+        onReadDone = onDone;
+
+        claimerRead.Claim([this]()
+            {
+                ReadClaimed();
+            });
+    }
+
+    void KeyValueStore::Write(Key key, infra::ConstByteRange value, const infra::Function<void()>& onDone)
+    {
+        really_assert(value.size() <= recordBuffer.size() - sizeof(RecordHeader));
+
+        writeKey = key;
+        writeHeader.kind = RecordKind::value;
+        writeValue = value;
+        onWriteDone = onDone;
+
+        claimerWrite.Claim([this]()
+            {
+                WriteClaimed();
+            });
+    }
+
+    void KeyValueStore::Remove(Key key, const infra::Function<void()>& onDone)
+    {
+        writeKey = key;
+        writeHeader.kind = RecordKind::removed;
+        writeValue = infra::ConstByteRange();
+        onWriteDone = onDone;
+
+        claimerWrite.Claim([this]()
+            {
+                WriteClaimed();
+            });
+    }
+
+    void KeyValueStore::EraseCountingFlash::EraseSectors(uint32_t beginIndex, uint32_t endIndex, infra::Function<void()> onDone)
+    {
+        erases += endIndex - beginIndex;
+        FlashDelegate::EraseSectors(beginIndex, endIndex, onDone);
+    }
+
+    std::optional<KeyValueStore::RecordHeader> KeyValueStore::HeaderOf(infra::ConstByteRange record)
+    {
+        if (record.size() < sizeof(RecordHeader))
+            return std::nullopt;
+
+        RecordHeader header;
+        std::copy(record.begin(), record.begin() + sizeof(RecordHeader), infra::MakeByteRange(header).begin());
+        return header;
+    }
+
+    KeyValueStore::Key KeyValueStore::KeyOf(const RecordHeader& header)
+    {
+        Key key = 0;
+
+        for (std::size_t i = header.key.size(); i != 0; --i)
+            key = (key << 8) | header.key[i - 1];
+
+        return key;
+    }
+
+    infra::BoundedVector<KeyValueStore::IndexEntry>::iterator KeyValueStore::Find(Key key)
+    {
+        auto entry = std::lower_bound(index.begin(), index.end(), key, [](const IndexEntry& entry, Key key)
+            {
+                return entry.key < key;
+            });
+
+        if (entry != index.end() && entry->key == key)
+            return entry;
+        else
+            return index.end();
+    }
+
+    infra::BoundedVector<KeyValueStore::IndexEntry>::const_iterator KeyValueStore::Find(Key key) const
+    {
+        return const_cast<KeyValueStore&>(*this).Find(key);
+    }
+
+    KeyValueStore::IndexEntry& KeyValueStore::FindOrInsert(Key key)
+    {
+        auto position = std::lower_bound(index.begin(), index.end(), key, [](const IndexEntry& entry, Key key)
+            {
+                return entry.key < key;
+            });
+
+        if (position == index.end() || position->key != key)
+            position = index.insert(position, IndexEntry{ key, 0, 0, 0 });
+
+        return *position;
+    }
+
+    uint32_t KeyValueStore::RecordCost(std::size_t valueSize) const
+    {
+        return blockHeaderSize + sizeof(RecordHeader) + valueSize;
+    }
+
+    uint32_t KeyValueStore::LogCapacity() const
+    {
+        // A sector is left for the next one when a block does not fit anymore, so each sector holds at least its
+        // size minus one sector status byte and minus one maximum sized block. The log is kept two sectors away from
+        // the oldest sector: one sector for the partially consumed oldest records, and one that is being filled.
+        really_assert(flash.NumberOfSectors() >= 3);
+
+        uint32_t minimumSectorSize = std::numeric_limits<uint32_t>::max();
+        for (uint32_t sector = 0; sector != flash.NumberOfSectors(); ++sector)
+            minimumSectorSize = std::min(minimumSectorSize, flash.SizeOfSector(sector));
+
+        auto maxRecordCost = RecordCost(recordBuffer.size() - sizeof(RecordHeader));
+        really_assert(minimumSectorSize > maxRecordCost + 1);
+
+        return (flash.NumberOfSectors() - 2) * (minimumSectorSize - 1 - maxRecordCost);
+    }
+
+    void KeyValueStore::Recover()
+    {
+        claimerRecover.Claim([this]()
+            {
+                reader.Read(recordBuffer, [this](infra::ByteRange record)
+                    {
+                        RecoverRecord(record);
+                    });
+            });
+    }
+
+    void KeyValueStore::RecoverRecord(infra::ConstByteRange record)
+    {
+        if (record.empty())
+        {
+            RecoverDone();
+            return;
+        }
+
+        logBytes += blockHeaderSize + record.size();
+
+        auto header = HeaderOf(record);
+        if (header != std::nullopt)
+        {
+            auto key = KeyOf(*header);
+            auto entry = Find(key);
+
+            if (header->kind == RecordKind::removed)
+            {
+                if (entry != index.end())
+                    index.erase(entry);
+            }
+            else
+            {
+                // Writes never exceed the index, so the keys in flash exceed it only when it has been made smaller
+                really_assert(entry != index.end() || !index.full());
+                auto& newEntry = FindOrInsert(key);
+                newEntry.sequence = headSequence;
+                newEntry.address = reader.AddressOfPrevious();
+                newEntry.size = static_cast<uint16_t>(record.size() - sizeof(RecordHeader));
+            }
+        }
+
+        ++headSequence;
+
+        reader.Read(recordBuffer, [this](infra::ByteRange record)
+            {
+                RecoverRecord(record);
+            });
+    }
+
+    void KeyValueStore::RecoverDone()
+    {
+        claimerRecover.Release();
+        onRecovered();
+    }
+
+    void KeyValueStore::WriteClaimed()
+    {
+        auto entry = Find(writeKey);
+
+        if (writeHeader.kind == RecordKind::removed && entry == index.end())
+        {
+            claimerWrite.Release();
+            onWriteDone();
+            return;
+        }
+
+        really_assert(entry != index.end() || !index.full());
+
+        for (std::size_t i = 0; i != writeHeader.key.size(); ++i)
+            writeHeader.key[i] = static_cast<uint8_t>(writeKey >> (8 * i));
+
+        CollectGarbage();
+    }
+
+    void KeyValueStore::CollectGarbage()
+    {
+        // Relocating a live record temporarily adds a record to the log, so room for one maximum sized record is kept
+        if (logBytes + RecordCost(writeValue.size()) + RecordCost(recordBuffer.size() - sizeof(RecordHeader)) <= logCapacity)
+        {
+            Append();
+            return;
+        }
+
+        oldest.Read(recordBuffer, [this](infra::ByteRange record)
+            {
+                really_assert(!record.empty());
+                CollectOldest(record);
+            });
+    }
+
+    void KeyValueStore::CollectOldest(infra::ConstByteRange record)
+    {
+        uint32_t cost = blockHeaderSize + record.size();
+        auto header = HeaderOf(record);
+        auto entry = header != std::nullopt && header->kind == RecordKind::value ? Find(KeyOf(*header)) : index.end();
+
+        if (entry != index.end() && entry->sequence == tailSequence)
+        {
+            ++statistics.recordsRelocated;
+            cyclicStore.Add(record, [this, cost, key = entry->key]()
+                {
+                    auto entry = Find(key);
+                    entry->sequence = headSequence++;
+                    entry->address = cyclicStore.LastAddedAddress();
+                    logBytes += cost;
+                    statistics.bytesWritten += cost;
+                    EraseOldest(cost);
+                });
+        }
+        else
+        {
+            ++statistics.recordsDiscarded;
+            EraseOldest(cost);
+        }
+    }
+
+    void KeyValueStore::EraseOldest(uint32_t cost)
+    {
+        oldest.ErasePrevious([this, cost]()
+            {
+                logBytes -= cost;
+                ++tailSequence;
+                CollectGarbage();
+            });
+    }
+
+    void KeyValueStore::Append()
+    {
+        auto header = infra::MakeByteRange(writeHeader);
+
+        if (writeValue.empty())
+            cyclicStore.Add(header, [this]()
+                {
+                    AppendDone();
+                });
+        else
+            cyclicStore.AddPartial(header, header.size() + writeValue.size(), [this]()
+                {
+                    cyclicStore.Add(writeValue, [this]()
+                        {
+                            AppendDone();
+                        });
+                });
+    }
+
+    void KeyValueStore::AppendDone()
+    {
+        auto cost = RecordCost(writeValue.size());
+
+        if (writeHeader.kind == RecordKind::removed)
+            index.erase(Find(writeKey));
+        else
+        {
+            auto& entry = FindOrInsert(writeKey);
+            entry.sequence = headSequence;
+            entry.address = cyclicStore.LastAddedAddress();
+            entry.size = static_cast<uint16_t>(writeValue.size());
+        }
+
+        ++headSequence;
+        logBytes += cost;
+        ++statistics.recordsWritten;
+        statistics.bytesWritten += cost;
+
+        claimerWrite.Release();
+        onWriteDone();
+    }
+
+    void KeyValueStore::ReadClaimed()
+    {
+        auto entry = Find(readKey);
+
+        if (entry == index.end())
+        {
+            ReadDone(std::nullopt);
+            return;
+        }
+
+        really_assert(entry->size <= readBuffer.size());
+        readBuffer.shrink_from_back_to(entry->size);
+
+        if (readBuffer.empty())
+            ReadDone(readBuffer);
+        else
+            flash.ReadBuffer(readBuffer, entry->address + sizeof(RecordHeader), [this]()
+                {
+                    ReadDone(readBuffer);
+                });
+    }
+
+    void KeyValueStore::ReadDone(std::optional<infra::ByteRange> value)
+    {
+        claimerRead.Release();
+        onReadDone(value);
+    }
+}
@@ -0,0 +1,155 @@
+#ifndef SERVICES_KEY_VALUE_STORE_HPP
+#define SERVICES_KEY_VALUE_STORE_HPP
+
+#include "hal/interfaces/Flash.hpp"
+#include "infra/event/ClaimableResource.hpp"
+#include "infra/util/AutoResetFunction.hpp"
+#include "infra/util/BoundedVector.hpp"
+#include "infra/util/WithStorage.hpp"
+#include "services/util/CyclicStore.hpp"
+#include "services/util/FlashDelegate.hpp"
+#include <array>
+#include <optional>
+
+namespace services
+{
+    // KeyValueStore keeps values as records in a CyclicStore, so that updating a single value costs one small append
+    // instead of rewriting all values. An index in RAM holds, for each key, the flash address of the record that contains
+    // its latest value, so that reading a value is a single flash read.
+    // Superseded records are reclaimed incrementally: before an append would make the log grow into the sector which
+    // CyclicStore erases next, the oldest records are visited. Records that are still live are appended again, all others
+    // are dropped. This only terminates when all live records fit in the log with room to spare, so on construction
+    // it is checked that the flash minus two sectors holds every key at its maximum size plus two more records.
+    //
+    // Only one Read and one Write or Remove may be outstanding at any time. Operations issued before recovery
+    // has finished are executed after recovery.
+    class KeyValueStore
+    {
+    public:
+        using Key = uint32_t;
+
+        struct IndexEntry
+        {
+            Key key;
+            uint32_t sequence;
+            uint32_t address;
+            uint16_t size;
+        };
+
+        // Counters are kept in RAM and start at zero on construction. Since CyclicStore erases its sectors
+        // round-robin, every sector has been erased sectorErases / NumberOfSectors() times, give or take one.
+        struct Statistics
+        {
+            uint32_t liveRecords;
+            uint32_t liveBytes;
+            uint32_t supersededRecords;
+            uint32_t logBytes;
+            uint32_t logCapacity;
+
+            uint32_t recordsWritten;
+            uint32_t recordsRelocated;
+            uint32_t recordsDiscarded;
+            uint32_t bytesWritten;
+            uint32_t sectorErases;
+        };
+
+    private:
+        enum class RecordKind : uint8_t
+        {
+            value,
+            removed
+        };
+
+        struct RecordHeader
+        {
+            std::array<uint8_t, sizeof(Key)> key;
+            RecordKind kind;
+        };
+
+    public:
+        template<std::size_t MaxKeys, std::size_t MaxValueSize>
+        using WithMaxKeys = infra::WithStorage<infra::WithStorage<KeyValueStore,
+                                                   infra::BoundedVector<IndexEntry>::WithMaxSize<MaxKeys>>,
+            std::array<uint8_t, MaxValueSize + sizeof(RecordHeader)>>;
+
+        KeyValueStore(infra::BoundedVector<IndexEntry>& index, infra::ByteRange recordBuffer, hal::Flash& flash, const infra::Function<void()>& onRecovered = infra::emptyFunction);
+        KeyValueStore(const KeyValueStore& other) = delete;
+        KeyValueStore& operator=(const KeyValueStore& other) = delete;
+
+        bool Contains(Key key) const;
+        std::optional<std::size_t> ValueSize(Key key) const;
+        Statistics GetStatistics() const;
+
+        void Read(Key key, infra::ByteRange buffer, const infra::Function<void(std::optional<infra::ByteRange> value)>& onDone);
+        void Write(Key key, infra::ConstByteRange value, const infra::Function<void()>& onDone);
+        void Remove(Key key, const infra::Function<void()>& onDone);
+
+    private:
+        class EraseCountingFlash
+            : public FlashDelegate
+        {
+        public:
+            using FlashDelegate::FlashDelegate;
+
+            void EraseSectors(uint32_t beginIndex, uint32_t endIndex, infra::Function<void()> onDone) override;
+
+            uint32_t erases = 0;
+        };
+
+        static std::optional<RecordHeader> HeaderOf(infra::ConstByteRange record);
+        static Key KeyOf(const RecordHeader& header);
+
+        infra::BoundedVector<IndexEntry>::iterator Find(Key key);
+        infra::BoundedVector<IndexEntry>::const_iterator Find(Key key) const;
+        IndexEntry& FindOrInsert(Key key);
+        uint32_t RecordCost(std::size_t valueSize) const;
+        uint32_t LogCapacity() const;
+
+        void Recover();
+        void RecoverRecord(infra::ConstByteRange record);
+        void RecoverDone();
+
+        void WriteClaimed();
+        void CollectGarbage();
+        void CollectOldest(infra::ConstByteRange record);
+        void EraseOldest(uint32_t cost);
+        void Append();
+        void AppendDone();
+
+        void ReadClaimed();
+        void ReadDone(std::optional<infra::ByteRange> value);
+
+    private:
+        static constexpr uint32_t blockHeaderSize = 3; // CyclicStore prefixes each block with status and length
+
+        infra::BoundedVector<IndexEntry>& index;
+        infra::ByteRange recordBuffer;
+        EraseCountingFlash flash;
+        CyclicStore cyclicStore;
+        CyclicStore::Iterator oldest;
+        CyclicStore::Iterator reader;
+        uint32_t logCapacity;
+
+        uint32_t headSequence = 0;
+        uint32_t tailSequence = 0;
+        uint32_t logBytes = 0;
+        Statistics statistics{};
+
+        infra::ClaimableResource resource;
+        infra::ClaimableResource::Claimer claimerRecover;
+        infra::ClaimableResource::Claimer claimerWrite;
+        infra::ClaimableResource::Claimer claimerRead;
+        infra::AutoResetFunction<void()> onRecovered;
+        infra::AutoResetFunction<void()> onWriteDone;
+        infra::AutoResetFunction<void(std::optional<infra::ByteRange> value)> onReadDone;
+
+        Key writeKey = 0;
+        RecordHeader writeHeader;
+        infra::ConstByteRange writeValue;
+
+        Key readKey = 0;
+        infra::ByteRange readBuffer;
+    };
+}
+
+#endif
@@ -0,0 +1,172 @@
+#include "hal/interfaces/Flash.hpp"
+#include "infra/event/EventDispatcher.hpp"
+#include "services/util/FlashCached.hpp"
+#include <benchmark/benchmark.h>
+#include <chrono>
+#include <cstdint>
+#include <numeric>
+#include <vector>
+
+namespace
+{
+    // Models a serial flash on which each read pays a fixed command and address overhead, plus time per byte
+    class SimulatedLatencyFlash
+        : public hal::Flash
+    {
+    public:
+        SimulatedLatencyFlash(uint32_t numberOfSectors, uint32_t sizeOfSector, std::chrono::nanoseconds commandOverhead, std::chrono::nanoseconds timePerByte)
+            : contents(numberOfSectors * sizeOfSector)
+            , numberOfSectors(numberOfSectors)
+            , sizeOfSector(sizeOfSector)
+            , commandOverhead(commandOverhead)
+            , timePerByte(timePerByte)
+        {
+            std::iota(contents.begin(), contents.end(), 0);
+        }
+
+        uint32_t NumberOfSectors() const override
+        {
+            return numberOfSectors;
+        }
+
+        uint32_t SizeOfSector(uint32_t sectorIndex) const override
+        {
+            return sizeOfSector;
+        }
+
+        uint32_t SectorOfAddress(uint32_t address) const override
+        {
+            return address / sizeOfSector;
+        }
+
+        uint32_t AddressOfSector(uint32_t sectorIndex) const override
+        {
+            return sectorIndex * sizeOfSector;
+        }
+
+        void WriteBuffer(infra::ConstByteRange buffer, uint32_t address, infra::Function<void()> onDone) override
+        {
+            for (std::size_t i = 0; i != buffer.size(); ++i)
+                contents[address + i] &= buffer[i];
+
+            Complete(buffer.size(), onDone);
+        }
+
+        void ReadBuffer(infra::ByteRange buffer, uint32_t address, infra::Function<void()> onDone) override
+        {
+            std::copy(contents.begin() + address, contents.begin() + address + buffer.size(), buffer.begin());
+
+            Complete(buffer.size(), onDone);
+        }
+
+        void EraseSectors(uint32_t beginIndex, uint32_t endIndex, infra::Function<void()> onDone) override
+        {
+            std::fill(contents.begin() + beginIndex * sizeOfSector, contents.begin() + endIndex * sizeOfSector, 0xff);
+
+            Complete(0, onDone);
+        }
+
+        uint32_t commands = 0;
+
+    private:
+        void Complete(std::size_t size, const infra::Function<void()>& onDone)
+        {
+            ++commands;
+
+            auto end = std::chrono::steady_clock::now() + commandOverhead + timePerByte * size;
+            while (std::chrono::steady_clock::now() < end)
+            {}
+
+            infra::EventDispatcher::Instance().Schedule(onDone);
+        }
+
+    private:
+        std::vector<uint8_t> contents;
+        uint32_t numberOfSectors;
+        uint32_t sizeOfSector;
+        std::chrono::nanoseconds commandOverhead;
+        std::chrono::nanoseconds timePerByte;
+    };
+
+    constexpr uint32_t regionSize = 4096;
+
+    struct Fixture
+    {
+        infra::EventDispatcher::WithSize<16> dispatcher;
+        SimulatedLatencyFlash flash{ 16, 4096, std::chrono::microseconds(2), std::chrono::nanoseconds(20) };
+        services::FlashCached::WithLines<256, 8> cached{ flash, 3 };
+        std::vector<uint8_t> buffer;
+
+        void Read(hal::Flash& target, uint32_t address)
+        {
+            bool done = false;
+            target.ReadBuffer(buffer, address, [&done]()
+                {
+                    done = true;
+                });
+            dispatcher.ExecuteUntil([&done]()
+                {
+                    return done;
+                });
+        }
+
+        void Report(benchmark::State& state, bool isCached)
+        {
+            state.SetBytesProcessed(state.iterations() * regionSize);
+            state.counters["commands"] = benchmark::Counter(flash.commands, benchmark::Counter::kAvgIterations);
+
+            if (isCached)
+            {
+                auto statistics = cached.GetStatistics();
+                state.counters["hitRate"] = static_cast<double>(statistics.hits) / (statistics.hits + statistics.misses);
+            }
+        }
+    };
+
+    template<bool Cached>
+    void SequentialSmallReads(benchmark::State& state)
+    {
+        Fixture fixture;
+        fixture.buffer.resize(static_cast<std::size_t>(state.range(0)));
+        hal::Flash& target = Cached ? static_cast<hal::Flash&>(fixture.cached) : fixture.flash;
+
+        for (auto _ : state)
+        {
+            fixture.cached.Invalidate();
+
+            for (uint32_t address = 0; address + fixture.buffer.size() <= regionSize; address += fixture.buffer.size())
+                fixture.Read(target, address);
+
+            benchmark::DoNotOptimize(fixture.buffer.data());
+        }
+
+        fixture.Report(state, Cached);
+    }
+
+    template<bool Cached>
+    void RepeatedSmallReadsInWorkingSet(benchmark::State& state)
+    {
+        Fixture fixture;
+        fixture.buffer.resize(static_cast<std::size_t>(state.range(0)));
+        hal::Flash& target = Cached ? static_cast<hal::Flash&>(fixture.cached) : fixture.flash;
+        uint32_t seed = 1;
+
+        for (auto _ : state)
+        {
+            for (uint32_t read = 0; read != regionSize / fixture.buffer.size(); ++read)
+            {
+                seed = seed * 1103515245 + 12345;
+                fixture.Read(target, (seed >> 8) % (1024 - fixture.buffer.size()));
+            }
+
+            benchmark::DoNotOptimize(fixture.buffer.data());
+        }
+
+        fixture.Report(state, Cached);
+    }
+}
+
+BENCHMARK_TEMPLATE(SequentialSmallReads, false)->Arg(3)->Arg(16)->Arg(64);
+BENCHMARK_TEMPLATE(SequentialSmallReads, true)->Arg(3)->Arg(16)->Arg(64);
+BENCHMARK_TEMPLATE(RepeatedSmallReadsInWorkingSet, false)->Arg(3)->Arg(16)->Arg(64);
+BENCHMARK_TEMPLATE(RepeatedSmallReadsInWorkingSet, true)->Arg(3)->Arg(16)->Arg(64);
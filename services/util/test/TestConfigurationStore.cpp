@@ -1129,3 +1129,202 @@ TEST_F(FactoryDefaultConfigurationStoreReadOnlyMemoryIntegrationTest, factory_de
                   0xff, 0xff, 0xff, 0xff, 0xff, 0xff, 0xff, 0xff, 0xff, 0xff, 0xff, 0xff, 0xff, 0xff, 0xff, 0xff }),
         flashBlob2.sectors[0]);
 }
+
+class ConfigurationStoreWithDeltasIntegrationTest
+    : public testing::Test
+    , public infra::EventDispatcherFixture
+{
+public:
+    void ConstructConfigurationStore()
+    {
+        configurationStore.emplace(flashBlob1, flashBlob2, sha256, [this](bool success)
+            {
+                OnRecovered(success);
+            });
+        ExecuteAllActions();
+    }
+
+    void Write()
+    {
+        configurationStore->Write();
+        ExecuteAllActions();
+    }
+
+    std::vector<uint8_t> Flash(hal::FlashStub& flash, std::size_t address, std::size_t size)
+    {
+        return std::vector<uint8_t>(flash.sectors[0].begin() + address, flash.sectors[0].begin() + address + size);
+    }
+
+    MOCK_METHOD1(OnRecovered, void(bool success));
+
+    struct Data
+    {
+        void Serialize(infra::ProtoFormatter& formatter)
+        {
+            formatter.PutVarIntField(first, 1);
+            formatter.PutVarIntField(second, 2);
+            formatter.PutBytesField(infra::MakeRange(name), 3);
+        }
+
+        void Deserialize(infra::ProtoParser& parser)
+        {
+            while (!parser.Empty())
+            {
+                infra::ProtoParser::Field field = parser.GetField();
+                if (field.second == 1)
+                    first = static_cast<uint32_t>(std::get<uint64_t>(field.first));
+                else if (field.second == 2)
+                    second = static_cast<uint32_t>(std::get<uint64_t>(field.first));
+                else
+                {
+                    infra::ConstByteRange bytes;
+                    std::get<infra::ProtoLengthDelimited>(field.first).GetBytesReference(bytes);
+                    infra::Copy(bytes, infra::MakeRange(name));
+                }
+            }
+        }
+
+    public:
+        static const uint32_t maxMessageSize = 24;
+
+        uint32_t first = 0;
+        uint32_t second = 0;
+        std::array<uint8_t, 8> name{ { 'c', 'o', 'n', 'f', 'i', 'g', 0, 0 } };
+    };
+
+public:
+    services::Sha256MbedTls sha256;
+    hal::FlashStub flashBlob1{ 1, 128 };
+    hal::FlashStub flashBlob2{ 1, 128 };
+    std::optional<services::ConfigurationStoreImpl<Data>::WithDeltaBlobs<16, 16>> configurationStore;
+};
+
+TEST_F(ConfigurationStoreWithDeltasIntegrationTest, first_Write_stores_snapshot)
+{
+    EXPECT_CALL(*this, OnRecovered(false));
+    ConstructConfigurationStore();
+
+    configurationStore->Configuration().first = 5;
+    Write();
+
+    EXPECT_EQ((std::vector<uint8_t>{ 0x08, 0x05, 0x10, 0x00, 0x1a, 0x08, 'c', 'o', 'n', 'f', 'i', 'g', 0, 0 }), Flash(flashBlob1, 12, 14));
+    EXPECT_EQ(std::vector<uint8_t>(128, 0xff), flashBlob2.sectors[0]);
+}
+
+TEST_F(ConfigurationStoreWithDeltasIntegrationTest, changed_field_is_appended_as_delta)
+{
+    EXPECT_CALL(*this, OnRecovered(false));
+    ConstructConfigurationStore();
+    Write();
+    auto snapshot = Flash(flashBlob1, 0, 36);
+
+    configurationStore->Configuration().second = 7;
+    Write();
+
+    EXPECT_EQ(snapshot, Flash(flashBlob1, 0, 36));
+    EXPECT_EQ((std::vector<uint8_t>{ 4, 0, 0, 0, 0x01, 0x02, 0x10, 0x07 }), Flash(flashBlob1, 36 + 8, 8));
+    EXPECT_EQ(std::vector<uint8_t>(128 - 36 - 12 - 4, 0xff), Flash(flashBlob1, 36 + 12 + 4, 128 - 36 - 12 - 4));
+    EXPECT_EQ(std::vector<uint8_t>(128, 0xff), flashBlob2.sectors[0]);
+}
+
+TEST_F(ConfigurationStoreWithDeltasIntegrationTest, unchanged_configuration_is_not_written)
+{
+    EXPECT_CALL(*this, OnRecovered(false));
+    ConstructConfigurationStore();
+    Write();
+    auto flash = flashBlob1.sectors[0];
+
+    Write();
+
+    EXPECT_EQ(flash, flashBlob1.sectors[0]);
+    EXPECT_EQ(std::vector<uint8_t>(128, 0xff), flashBlob2.sectors[0]);
+}
+
+TEST_F(ConfigurationStoreWithDeltasIntegrationTest, multiple_changed_fields_are_appended_as_one_delta)
+{
+    EXPECT_CALL(*this, OnRecovered(false));
+    ConstructConfigurationStore();
+    Write();
+
+    configurationStore->Configuration().first = 3;
+    configurationStore->Configuration().second = 7;
+    Write();
+
+    EXPECT_EQ((std::vector<uint8_t>{ 7, 0, 0, 0, 0x02, 0x01, 0x02, 0x08, 0x03, 0x10, 0x07 }), Flash(flashBlob1, 36 + 8, 11));
+}
+
+TEST_F(ConfigurationStoreWithDeltasIntegrationTest, deltas_are_recovered)
+{
+    EXPECT_CALL(*this, OnRecovered(false));
+    ConstructConfigurationStore();
+    Write();
+
+    configurationStore->Configuration().second = 7;
+    Write();
+    configurationStore->Configuration().first = 300;
+    configurationStore->Configuration().name[7] = 'x';
+    Write();
+
+    EXPECT_CALL(*this, OnRecovered(true));
+    ConstructConfigurationStore();
+
+    EXPECT_EQ(300, configurationStore->Configuration().first);
+    EXPECT_EQ(7, configurationStore->Configuration().second);
+    EXPECT_EQ((std::array<uint8_t, 8>{ { 'c', 'o', 'n', 'f', 'i', 'g', 0, 'x' } }), configurationStore->Configuration().name);
+    EXPECT_EQ(std::vector<uint8_t>(128, 0xff), flashBlob2.sectors[0]);
+}
+
+TEST_F(ConfigurationStoreWithDeltasIntegrationTest, full_blob_is_compacted_into_other_blob)
+{
+    EXPECT_CALL(*this, OnRecovered(false));
+    ConstructConfigurationStore();
+    Write();
+
+    for (uint32_t i = 0; i != 5; ++i)
+    {
+        configurationStore->Configuration().second = i + 1;
+        Write();
+    }
+
+    EXPECT_EQ(std::vector<uint8_t>(128, 0xff), flashBlob2.sectors[0]);
+
+    configurationStore->Configuration().second = 6;
+    Write();
+
+    EXPECT_EQ(std::vector<uint8_t>(128, 0xff), flashBlob1.sectors[0]);
+    EXPECT_EQ((std::vector<uint8_t>{ 0x08, 0x00, 0x10, 0x06 }), Flash(flashBlob2, 12, 4));
+
+    configurationStore->Configuration().first = 1;
+    Write();
+
+    EXPECT_CALL(*this, OnRecovered(true));
+    ConstructConfigurationStore();
+
+    EXPECT_EQ(1, configurationStore->Configuration().first);
+    EXPECT_EQ(6, configurationStore->Configuration().second);
+    EXPECT_EQ(std::vector<uint8_t>(128, 0xff), flashBlob1.sectors[0]);
+}
+
+TEST_F(ConfigurationStoreWithDeltasIntegrationTest, interrupted_delta_is_ignored_and_next_Write_stores_snapshot)
+{
+    EXPECT_CALL(*this, OnRecovered(false));
+    ConstructConfigurationStore();
+    Write();
+
+    configurationStore->Configuration().second = 7;
+    Write();
+    flashBlob1.sectors[0][36 + 12 + 3] = 0x00;
+
+    EXPECT_CALL(*this, OnRecovered(true));
+    ConstructConfigurationStore();
+    EXPECT_EQ(0, configurationStore->Configuration().second);
+
+    configurationStore->Configuration().second = 9;
+    Write();
+
+    EXPECT_EQ(std::vector<uint8_t>(128, 0xff), flashBlob1.sectors[0]);
+
+    EXPECT_CALL(*this, OnRecovered(true));
+    ConstructConfigurationStore();
+    EXPECT_EQ(9, configurationStore->Configuration().second);
+}
@@ -354,6 +354,17 @@ TEST_F(CyclicStoreTest, ReadPastEndInAFullFlashYieldsEmptyRange)
     EXPECT_EQ((std::vector<uint8_t>{}), Read(iterator));
 }
 
+TEST_F(CyclicStoreTest, ReadPastEndWithLessThanABlockHeaderLeftInLastSectorYieldsEmptyRange)
+{
+    AddItem(KeepBytesAlive({ 11, 12, 13, 14, 15 }));
+    AddItem(KeepBytesAlive({ 21, 22, 23, 24, 25 }));
+
+    services::CyclicStore::Iterator iterator = cyclicStore.Begin();
+    Read(iterator);
+    EXPECT_EQ((std::vector<uint8_t>{ 21, 22, 23, 24, 25 }), Read(iterator));
+    EXPECT_EQ((std::vector<uint8_t>{}), Read(iterator));
+}
+
 TEST_F(CyclicStoreTest, ReadWhileAddWaitsForAddToFinish)
 {
     std::vector<uint8_t> data = { 11, 12 };
@@ -0,0 +1,176 @@
+#include "hal/interfaces/test_doubles/FlashMock.hpp"
+#include "infra/event/test_helper/EventDispatcherFixture.hpp"
+#include "infra/util/test_helper/MockCallback.hpp"
+#include "services/util/FlashCached.hpp"
+#include "gmock/gmock.h"
+#include "gtest/gtest.h"
+
+class FlashCachedTest
+    : public testing::Test
+    , public infra::EventDispatcherFixture
+{
+public:
+    void ExpectFetch(uint32_t address, std::size_t size)
+    {
+        EXPECT_CALL(flash, ReadBuffer(testing::_, address, testing::_)).WillOnce(testing::Invoke([size](infra::ByteRange buffer, uint32_t address, const infra::Function<void()>& onDone)
+            {
+                EXPECT_EQ(size, buffer.size());
+                for (auto& byte : buffer)
+                    byte = static_cast<uint8_t>(address++);
+                onDone();
+            }));
+    }
+
+    std::vector<uint8_t> Read(services::FlashCached& cache, uint32_t address, std::size_t size)
+    {
+        std::vector<uint8_t> result(size, 0);
+        infra::VerifyingFunction<void()> onDone;
+        cache.ReadBuffer(result, address, onDone);
+        ExecuteAllActions();
+        return result;
+    }
+
+    std::vector<uint8_t> Read(uint32_t address, std::size_t size)
+    {
+        return Read(cache, address, size);
+    }
+
+    testing::StrictMock<hal::CleanFlashMock> flash{ 4, 64 };
+    services::FlashCached::WithLines<16, 4> cache{ flash };
+};
+
+TEST_F(FlashCachedTest, read_fetches_line)
+{
+    ExpectFetch(16, 16);
+
+    EXPECT_EQ((std::vector<uint8_t>{ 20, 21, 22, 23 }), Read(20, 4));
+}
+
+TEST_F(FlashCachedTest, read_from_cached_line_does_not_access_flash)
+{
+    ExpectFetch(16, 16);
+    Read(20, 4);
+
+    EXPECT_EQ((std::vector<uint8_t>{ 17, 18 }), Read(17, 2));
+
+    auto statistics = cache.GetStatistics();
+    EXPECT_EQ(1, statistics.hits);
+    EXPECT_EQ(1, statistics.misses);
+    EXPECT_EQ(1, statistics.fetches);
+}
+
+TEST_F(FlashCachedTest, read_spanning_lines_fetches_them_in_one_read)
+{
+    ExpectFetch(32, 32);
+
+    EXPECT_EQ((std::vector<uint8_t>{ 46, 47, 48, 49 }), Read(46, 4));
+}
+
+TEST_F(FlashCachedTest, sequential_read_reads_ahead)
+{
+    ExpectFetch(16, 16);
+    Read(20, 12);
+
+    ExpectFetch(32, 32);
+    EXPECT_EQ((std::vector<uint8_t>{ 32, 33 }), Read(32, 2));
+    EXPECT_EQ((std::vector<uint8_t>{ 48, 49 }), Read(48, 2));
+
+    EXPECT_EQ(3, cache.GetStatistics().linesFetched);
+}
+
+TEST_F(FlashCachedTest, read_ahead_stops_at_end_of_flash)
+{
+    ExpectFetch(224, 16);
+    Read(236, 4);
+
+    ExpectFetch(240, 16);
+    EXPECT_EQ((std::vector<uint8_t>{ 240 }), Read(240, 1));
+}
+
+TEST_F(FlashCachedTest, read_ahead_stops_at_cached_line)
+{
+    ExpectFetch(48, 16);
+    Read(48, 1);
+    ExpectFetch(16, 16);
+    Read(20, 12);
+
+    ExpectFetch(32, 16);
+    EXPECT_EQ((std::vector<uint8_t>{ 32 }), Read(32, 1));
+    EXPECT_EQ((std::vector<uint8_t>{ 48 }), Read(48, 1));
+}
+
+TEST_F(FlashCachedTest, least_recently_used_line_is_replaced)
+{
+    services::FlashCached::WithLines<16, 4> cache{ flash, 0 };
+
+    for (uint32_t address : { 1, 17, 33, 49 })
+    {
+        ExpectFetch(address - 1, 16);
+        Read(cache, address, 1);
+    }
+
+    Read(cache, 2, 1);
+
+    ExpectFetch(64, 16);
+    Read(cache, 65, 1);
+
+    Read(cache, 3, 1);
+    ExpectFetch(16, 16);
+    Read(cache, 18, 1);
+}
+
+TEST_F(FlashCachedTest, write_is_passed_on_and_invalidates_line)
+{
+    ExpectFetch(16, 16);
+    Read(20, 4);
+
+    std::array<uint8_t, 2> buffer{ 1, 2 };
+    infra::VerifyingFunction<void()> onDone;
+    EXPECT_CALL(flash, WriteBuffer(infra::ConstByteRange(buffer), 30, testing::_)).WillOnce(testing::InvokeArgument<2>());
+    cache.WriteBuffer(buffer, 30, onDone);
+
+    ExpectFetch(16, 16);
+    Read(20, 4);
+
+    EXPECT_EQ(1, cache.GetStatistics().invalidations);
+}
+
+TEST_F(FlashCachedTest, erase_is_passed_on_and_invalidates_lines_in_sectors)
+{
+    ExpectFetch(16, 16);
+    Read(20, 4);
+    ExpectFetch(80, 16);
+    Read(80, 4);
+
+    infra::VerifyingFunction<void()> onDone;
+    EXPECT_CALL(flash, EraseSectors(1, 2, testing::_)).WillOnce(testing::InvokeArgument<2>());
+    cache.EraseSectors(1, 2, onDone);
+
+    Read(20, 4);
+    ExpectFetch(80, 16);
+    Read(80, 4);
+}
+
+TEST_F(FlashCachedTest, Invalidate_drops_all_lines)
+{
+    ExpectFetch(16, 16);
+    Read(20, 4);
+
+    cache.Invalidate();
+
+    ExpectFetch(16, 16);
+    Read(20, 4);
+}
+
+TEST_F(FlashCachedTest, ResetStatistics_clears_counters)
+{
+    ExpectFetch(16, 16);
+    Read(20, 4);
+
+    cache.ResetStatistics();
+
+    auto statistics = cache.GetStatistics();
+    EXPECT_EQ(0, statistics.hits);
+    EXPECT_EQ(0, statistics.misses);
+    EXPECT_EQ(0, statistics.fetches);
+}
@@ -0,0 +1,227 @@
+#include "hal/interfaces/test_doubles/FlashStub.hpp"
+#include "infra/timer/test_helper/ClockFixture.hpp"
+#include "infra/util/test_helper/MockCallback.hpp"
+#include "services/util/KeyValueStore.hpp"
+#include "gtest/gtest.h"
+
+class KeyValueStoreTest
+    : public testing::Test
+    , public infra::ClockFixture
+{
+public:
+    KeyValueStoreTest()
+    {
+        ExecuteAllActions();
+    }
+
+    void Write(services::KeyValueStore::Key key, std::vector<uint8_t> value)
+    {
+        infra::VerifyingFunction<void()> done;
+        store->Write(key, value, done);
+        ExecuteAllActions();
+    }
+
+    void Remove(services::KeyValueStore::Key key)
+    {
+        infra::VerifyingFunction<void()> done;
+        store->Remove(key, done);
+        ExecuteAllActions();
+    }
+
+    std::optional<std::vector<uint8_t>> Read(services::KeyValueStore::Key key)
+    {
+        std::array<uint8_t, 8> buffer;
+        std::optional<std::vector<uint8_t>> result;
+        bool done = false;
+
+        store->Read(key, buffer, [&](std::optional<infra::ByteRange> value)
+            {
+                done = true;
+                if (value != std::nullopt)
+                    result.emplace(value->begin(), value->end());
+            });
+        ExecuteAllActions();
+
+        EXPECT_TRUE(done);
+        return result;
+    }
+
+    void ReConstruct()
+    {
+        store.emplace(flash);
+        ExecuteAllActions();
+    }
+
+    hal::FlashStub flash{ 4, 64 };
+    std::optional<services::KeyValueStore::WithMaxKeys<2, 8>> store{ std::in_place, flash };
+};
+
+TEST_F(KeyValueStoreTest, recovery_of_empty_flash_reports_recovered)
+{
+    infra::VerifyingFunction<void()> recovered;
+
+    services::KeyValueStore::WithMaxKeys<2, 8> otherStore(flash, recovered);
+    ExecuteAllActions();
+
+    EXPECT_FALSE(otherStore.Contains(1));
+}
+
+TEST_F(KeyValueStoreTest, written_value_is_read_back)
+{
+    Write(1, { 1, 2, 3 });
+
+    EXPECT_TRUE(store->Contains(1));
+    EXPECT_EQ(std::optional<std::size_t>(3), store->ValueSize(1));
+    EXPECT_EQ((std::vector<uint8_t>{ 1, 2, 3 }), Read(1));
+}
+
+TEST_F(KeyValueStoreTest, reading_unknown_key_results_in_nullopt)
+{
+    Write(1, { 1, 2, 3 });
+
+    EXPECT_FALSE(store->Contains(2));
+    EXPECT_EQ(std::nullopt, store->ValueSize(2));
+    EXPECT_EQ(std::nullopt, Read(2));
+}
+
+TEST_F(KeyValueStoreTest, empty_value_is_stored)
+{
+    Write(1, {});
+
+    EXPECT_EQ(std::vector<uint8_t>{}, Read(1));
+}
+
+TEST_F(KeyValueStoreTest, latest_value_is_read)
+{
+    Write(1, { 1, 2, 3 });
+    Write(2, { 4 });
+    Write(1, { 5, 6 });
+
+    EXPECT_EQ((std::vector<uint8_t>{ 5, 6 }), Read(1));
+    EXPECT_EQ((std::vector<uint8_t>{ 4 }), Read(2));
+}
+
+TEST_F(KeyValueStoreTest, update_appends_a_single_record)
+{
+    Write(1, { 1, 2, 3 });
+    auto before = store->GetStatistics();
+
+    Write(1, { 4, 5, 6 });
+    auto after = store->GetStatistics();
+
+    EXPECT_EQ(before.recordsWritten + 1, after.recordsWritten);
+    EXPECT_EQ(before.bytesWritten + 3 + 5 + 3, after.bytesWritten);
+    EXPECT_EQ(before.sectorErases, after.sectorErases);
+    EXPECT_EQ(1, after.liveRecords);
+    EXPECT_EQ(1, after.supersededRecords);
+}
+
+TEST_F(KeyValueStoreTest, removed_key_is_not_found)
+{
+    Write(1, { 1, 2, 3 });
+    Remove(1);
+
+    EXPECT_FALSE(store->Contains(1));
+    EXPECT_EQ(std::nullopt, Read(1));
+}
+
+TEST_F(KeyValueStoreTest, removing_unknown_key_does_not_write)
+{
+    Remove(1);
+
+    EXPECT_EQ(0, store->GetStatistics().recordsWritten);
+}
+
+TEST_F(KeyValueStoreTest, values_are_recovered)
+{
+    Write(1, { 1, 2, 3 });
+    Write(2, { 4 });
+    Write(1, { 5, 6 });
+
+    ReConstruct();
+
+    EXPECT_EQ((std::vector<uint8_t>{ 5, 6 }), Read(1));
+    EXPECT_EQ((std::vector<uint8_t>{ 4 }), Read(2));
+    EXPECT_EQ(1, store->GetStatistics().supersededRecords);
+}
+
+TEST_F(KeyValueStoreTest, removal_is_recovered)
+{
+    Write(1, { 1, 2, 3 });
+    Remove(1);
+
+    ReConstruct();
+
+    EXPECT_FALSE(store->Contains(1));
+}
+
+TEST_F(KeyValueStoreTest, superseded_records_are_collected_while_live_records_are_kept)
+{
+    Write(1, { 1, 2, 3, 4, 5, 6, 7, 8 });
+
+    for (uint8_t i = 0; i != 100; ++i)
+        Write(2, { i });
+
+    auto statistics = store->GetStatistics();
+    EXPECT_LE(statistics.logBytes, statistics.logCapacity);
+    EXPECT_LT(0, statistics.recordsRelocated);
+    EXPECT_LT(0, statistics.recordsDiscarded);
+    EXPECT_LT(flash.NumberOfSectors(), statistics.sectorErases);
+
+    EXPECT_EQ((std::vector<uint8_t>{ 1, 2, 3, 4, 5, 6, 7, 8 }), Read(1));
+    EXPECT_EQ((std::vector<uint8_t>{ 99 }), Read(2));
+
+    ReConstruct();
+
+    EXPECT_EQ((std::vector<uint8_t>{ 1, 2, 3, 4, 5, 6, 7, 8 }), Read(1));
+    EXPECT_EQ((std::vector<uint8_t>{ 99 }), Read(2));
+}
+
+TEST_F(KeyValueStoreTest, removed_keys_are_collected)
+{
+    for (uint8_t i = 0; i != 50; ++i)
+    {
+        Write(1, { i, i, i, i, i, i, i, i });
+        Remove(1);
+    }
+
+    Write(2, { 7 });
+
+    auto statistics = store->GetStatistics();
+    EXPECT_EQ(0, statistics.recordsRelocated);
+    EXPECT_EQ(1, statistics.liveRecords);
+
+    ReConstruct();
+
+    EXPECT_FALSE(store->Contains(1));
+    EXPECT_EQ((std::vector<uint8_t>{ 7 }), Read(2));
+}
+
+TEST_F(KeyValueStoreTest, value_is_read_from_its_recovered_address)
+{
+    Write(1, { 1, 2, 3 });
+    Write(2, { 4, 5 });
+    Remove(1);
+    Write(1, { 6 });
+
+    ReConstruct();
+
+    EXPECT_EQ((std::vector<uint8_t>{ 6 }), Read(1));
+    EXPECT_EQ((std::vector<uint8_t>{ 4, 5 }), Read(2));
+}
+
+#ifndef EMIL_MUTATION_TESTING
+TEST_F(KeyValueStoreTest, recovering_more_keys_than_the_index_holds_asserts)
+{
+    Write(1, { 1 });
+    Write(2, { 2 });
+
+    using SmallerStore = services::KeyValueStore::WithMaxKeys<1, 8>;
+    EXPECT_DEATH(
+        {
+            SmallerStore smallerStore(flash);
+            ExecuteAllActions();
+        },
+        "");
+}
+#endif